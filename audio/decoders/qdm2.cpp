@@ -148,7 +148,8 @@ private:
 	QDM2FFT _fft;
 
 	// I/O data
-	uint8 *_compressedData;
+	uint8 *_compressedData; // the current packet, followed by FF_INPUT_BUFFER_PADDING_SIZE zero bytes
+	uint32 compressedDataLeft(const uint8 *data) const;
 	float _outputBuffer[1024];
 
 	// Synthesis filter
@@ -669,6 +670,69 @@ void ff_mpa_synth_filter(int16 *synth_buf_ptr, int *synth_buf_offset,
 	*synth_buf_offset = offset;
 }
 
+/**
+ * A bit stream over (sub)packet data, with the layout of
+ * Common::BitStream32LELSB. Like the bit reader of FFmpeg, it reads zero
+ * bits past the end of the data instead of failing, since damaged or
+ * truncated packets make the decoder read further than the packet.
+ */
+class QDM2BitStream : public Common::BitStream {
+public:
+	QDM2BitStream(Common::MemoryReadStream *stream) :
+		_data(stream->getData()), _size(stream->size()), _pos(0) {
+	}
+
+	uint32 pos() const { return _pos; }
+	uint32 size() const { return _size * 8; }
+	bool eos() const { return _pos >= size(); }
+	void rewind() { _pos = 0; }
+	void skip(uint32 n) { _pos += n; }
+	bool isMSBFirst() const { return false; }
+
+	uint32 getBit() {
+		return getBits(1);
+	}
+
+	uint32 getBits(uint8 n) {
+		const uint32 v = peekBits(n);
+		_pos += n;
+		return v;
+	}
+
+	uint32 peekBit() {
+		return peekBits(1);
+	}
+
+	uint32 peekBits(uint8 n) {
+		if (n == 0)
+			return 0;
+
+		if (n > 32)
+			error("QDM2BitStream::peekBits(): Too many bits requested to be read");
+
+		// The bits of 32 bit little-endian values, LSB first, are the bits
+		// of the bytes in order, LSB first
+		const uint32 start = _pos / 8;
+		uint64 value = 0;
+		for (uint32 i = 0; i < 5 && start + i < _size; ++i)
+			value |= (uint64)_data[start + i] << (i * 8);
+
+		return (uint32)(value >> (_pos % 8)) & (0xFFFFFFFF >> (32 - n));
+	}
+
+	void addBit(uint32 &x, uint32 n) {
+		if (n >= 32)
+			error("QDM2BitStream::addBit(): Too many bits requested to be read");
+
+		x = (x & ~(1 << n)) | (getBits(1) << n);
+	}
+
+private:
+	const byte *_data;
+	uint32 _size; ///< Size of the data in bytes
+	uint32 _pos;  ///< Position in bits, may be past the end of the data
+};
+
 /**
  * parses a vlc code, faster then get_vlc()
  * @param bits is the number of bits which will be read at once, must be
@@ -1216,7 +1280,8 @@ QDM2Stream::QDM2Stream(Common::SeekableReadStream *extraData, DisposeAfterUse::F
 	rndTableInit();
 	initNoiseSamples();
 
-	_compressedData = new uint8[_packetSize];
+	_compressedData = new uint8[_packetSize + FF_INPUT_BUFFER_PADDING_SIZE];
+	memset(_compressedData + _packetSize, 0, FF_INPUT_BUFFER_PADDING_SIZE);
 
 	if (disposeExtraData == DisposeAfterUse::YES)
 		delete extraData;
@@ -1227,6 +1292,16 @@ QDM2Stream::~QDM2Stream() {
 	delete[] _compressedData;
 }
 
+/**
+ * Return the number of bytes the bit stream of (sub)packet data may read,
+ * up to the end of the padding of the packet. Bits past that are read as
+ * zeros by QDM2BitStream.
+ */
+uint32 QDM2Stream::compressedDataLeft(const uint8 *data) const {
+	const uint8 *end = _compressedData + _packetSize + FF_INPUT_BUFFER_PADDING_SIZE;
+	return (data >= _compressedData && data < end) ? end - data : 0;
+}
+
 static int qdm2_get_vlc(Common::BitStream *gb, VLC *vlc, int flag, int depth) {
 	int value = getVlc2(gb, vlc->table, vlc->bits, depth);
 
@@ -1886,8 +1961,8 @@ void QDM2Stream::init_tone_level_dequantization(Common::BitStream *gb, int lengt
 void QDM2Stream::process_subpacket_9(QDM2SubPNode *node) {
 	int i, j, k, n, ch, run, level, diff;
 
-	Common::MemoryReadStream d(node->packet->data, node->packet->size*8);
-	Common::BitStream32LELSB gb(&d);
+	Common::MemoryReadStream d(node->packet->data, compressedDataLeft(node->packet->data));
+	QDM2BitStream gb(&d);
 
 	n = coeff_per_sb_for_avg[_coeffPerSbSelect][QDM2_SB_USED(_subSampling) - 1] + 1; // same as averagesomething function
 
@@ -1920,8 +1995,8 @@ void QDM2Stream::process_subpacket_9(QDM2SubPNode *node) {
  * @param length    packet length in bits
  */
 void QDM2Stream::process_subpacket_10(QDM2SubPNode *node, int length) {
-	Common::MemoryReadStream d(((node == NULL) ? _emptyBuffer : node->packet->data), ((node == NULL) ? 0 : node->packet->size*8));
-	Common::BitStream32LELSB gb(&d);
+	Common::MemoryReadStream d(((node == NULL) ? _emptyBuffer : node->packet->data), ((node == NULL) ? 0 : compressedDataLeft(node->packet->data)));
+	QDM2BitStream gb(&d);
 
 	if (length != 0) {
 		init_tone_level_dequantization(&gb, length);
@@ -1938,8 +2013,8 @@ void QDM2Stream::process_subpacket_10(QDM2SubPNode *node, int length) {
  * @param length    packet length in bit
  */
 void QDM2Stream::process_subpacket_11(QDM2SubPNode *node, int length) {
-	Common::MemoryReadStream d(((node == NULL) ? _emptyBuffer : node->packet->data), ((node == NULL) ? 0 : node->packet->size*8));
-	Common::BitStream32LELSB gb(&d);
+	Common::MemoryReadStream d(((node == NULL) ? _emptyBuffer : node->packet->data), ((node == NULL) ? 0 : compressedDataLeft(node->packet->data)));
+	QDM2BitStream gb(&d);
 
 	if (length >= 32) {
 		int c = gb.getBits(13);
@@ -1959,8 +2034,8 @@ void QDM2Stream::process_subpacket_11(QDM2SubPNode *node, int length) {
  * @param length    packet length in bits
  */
 void QDM2Stream::process_subpacket_12(QDM2SubPNode *node, int length) {
-	Common::MemoryReadStream d(((node == NULL) ? _emptyBuffer : node->packet->data), ((node == NULL) ? 0 : node->packet->size*8));
-	Common::BitStream32LELSB gb(&d);
+	Common::MemoryReadStream d(((node == NULL) ? _emptyBuffer : node->packet->data), ((node == NULL) ? 0 : compressedDataLeft(node->packet->data)));
+	QDM2BitStream gb(&d);
 
 	synthfilt_build_sb_samples(&gb, length, 8, QDM2_SB_USED(_subSampling));
 }
@@ -2014,8 +2089,8 @@ void QDM2Stream::qdm2_decode_super_block(void) {
 
 	average_quantized_coeffs(); // average elements in quantized_coeffs[max_ch][10][8]
 
-	Common::MemoryReadStream *d = new Common::MemoryReadStream(_compressedData, _packetSize*8);
-	Common::BitStream *gb = new Common::BitStream32LELSB(d);
+	Common::MemoryReadStream *d = new Common::MemoryReadStream(_compressedData, compressedDataLeft(_compressedData));
+	Common::BitStream *gb = new QDM2BitStream(d);
 	//qdm2_decode_sub_packet_header
 	header.type = gb->getBits(8);
 
@@ -2048,8 +2123,8 @@ void QDM2Stream::qdm2_decode_super_block(void) {
 
 	delete gb;
 	delete d;
-	d = new Common::MemoryReadStream(header.data, header.size*8);
-	gb = new Common::BitStream32LELSB(d);
+	d = new Common::MemoryReadStream(header.data, compressedDataLeft(header.data));
+	gb = new QDM2BitStream(d);
 
 	if (header.type == 2 || header.type == 4 || header.type == 5) {
 		int csum = 257 * gb->getBits(8) + 2 * gb->getBits(8);
@@ -2081,8 +2156,8 @@ void QDM2Stream::qdm2_decode_super_block(void) {
 			// seek to next block
 			delete gb;
 			delete d;
-			d = new Common::MemoryReadStream(header.data, header.size*8);
-			gb = new Common::BitStream32LELSB(d);
+			d = new Common::MemoryReadStream(header.data, compressedDataLeft(header.data));
+			gb = new QDM2BitStream(d);
 			gb->skip(next_index*8);
 
 			if (next_index >= header.size)
@@ -2291,8 +2366,8 @@ void QDM2Stream::qdm2_decode_fft_packets(void) {
 			return;
 
 		// decode FFT tones
-		Common::MemoryReadStream d(packet->data, packet->size*8);
-		Common::BitStream32LELSB gb(&d);
+		Common::MemoryReadStream d(packet->data, compressedDataLeft(packet->data));
+		QDM2BitStream gb(&d);
 
 		if (packet->type >= 32 && packet->type < 48 && !fft_subpackets[packet->type - 16])
 			unknown_flag = 1;
@@ -42,7 +42,7 @@ namespace Audio {
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, RateConverterQuality quality);
 	~Channel();
 
 	/**
@@ -59,7 +59,7 @@ public:
 	/**
 	 * Queries whether the channel is still playing or not.
 	 */
-	bool isFinished() const { return _stream->endOfStream(); }
+	bool isFinished() const { return _stream->endOfStream() && !_converter->hasPendingOutput(); }
 
 	/**
 	 * Queries whether the channel is a permanent channel.
@@ -163,6 +163,17 @@ private:
 	uint32 _pauseStartTime;
 	uint32 _pauseTime;
 
+	/**
+	 * Sequence counter guarding the timing fields above. It is odd while
+	 * they are being updated, which allows getElapsedTime() to take a
+	 * consistent snapshot while the audio thread mixes the channel in
+	 * lock-free mode.
+	 */
+	volatile uint32 _timeSeq;
+
+	void beginTimingUpdate() { _timeSeq++; MIXER_MEMORY_BARRIER(); }
+	void endTimingUpdate() { MIXER_MEMORY_BARRIER(); _timeSeq++; }
+
 	RateConverter *_converter;
 	Common::DisposablePtr<AudioStream> _stream;
 };
@@ -172,16 +183,33 @@ private:
 #pragma mark -
 
 
-MixerImpl::MixerImpl(OSystem *system, uint sampleRate)
-	: _syst(system), _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+MixerImpl::MixerImpl(OSystem *system, uint sampleRate, bool lockFree)
+	: _syst(system), _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _lockFree(false), _rateConverterQuality(kRateConverterLinear), _soundTypeSettings(),
+	  _channelOwner(kOwnerNone), _mixPasses(0) {
 
 	assert(sampleRate > 0);
 
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		_channels[i] = 0;
+
+#ifdef MIXER_LOCKFREE_SUPPORTED
+	_lockFree = lockFree;
+#else
+	if (lockFree)
+		warning("MixerImpl: lock-free mode is not supported on this platform");
+#endif
 }
 
 MixerImpl::~MixerImpl() {
+	// Channels of play commands which the audio thread never picked up
+	// are not referenced anywhere else.
+	Command cmd;
+	while (_commands.pop(cmd)) {
+		if (cmd.type == kCommandPlay)
+			delete cmd.chan;
+	}
+	collectRetiredChannels();
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
 }
@@ -194,10 +222,15 @@ uint MixerImpl::getOutputRate() const {
 	return _sampleRate;
 }
 
+void MixerImpl::setRateConverterQuality(RateConverterQuality quality) {
+	Common::StackLock lock(_mutex);
+	_rateConverterQuality = quality;
+}
+
 void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	int index = -1;
 	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] == 0) {
+		if (_lockFree ? _slots[i].chan == 0 : _channels[i] == 0) {
 			index = i;
 			break;
 		}
@@ -208,8 +241,6 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 		return;
 	}
 
-	_channels[index] = chan;
-
 	SoundHandle chanHandle;
 	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
 
@@ -217,6 +248,138 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	_handleSeed++;
 	if (handle)
 		*handle = chanHandle;
+
+	if (!_lockFree) {
+		_channels[index] = chan;
+		return;
+	}
+
+	ChannelSlot &slot = _slots[index];
+	slot.chan = chan;
+	slot.handle = chanHandle._val;
+	slot.id = chan->getId();
+	slot.type = chan->getType();
+	slot.volume = chan->getVolume();
+	slot.balance = chan->getBalance();
+	slot.permanent = chan->isPermanent();
+	slot.active = true;
+
+	postCommand(kCommandPlay, chanHandle._val, chan);
+}
+
+MixerImpl::ChannelSlot *MixerImpl::findSlot(SoundHandle handle) {
+	ChannelSlot &slot = _slots[handle._val % NUM_CHANNELS];
+	if (!slot.active || slot.handle != handle._val)
+		return 0;
+	return &slot;
+}
+
+void MixerImpl::postCommand(CommandType type, uint32 handle, Channel *chan, int value, int8 balance) {
+	Command cmd;
+	cmd.type = type;
+	cmd.handle = handle;
+	cmd.chan = chan;
+	cmd.value = value;
+	cmd.balance = balance;
+
+	// The audio thread drains the queue on every callback, so it should
+	// only ever be full for a very short time.
+	uint32 passes = _mixPasses;
+	uint32 lastPass = _syst->getMillis();
+	while (!_commands.push(cmd))
+		waitForAudioThread(passes, lastPass);
+}
+
+void MixerImpl::waitForAudioThread(uint32 &passes, uint32 &lastPass) {
+	const uint32 now = _syst->getMillis();
+	if (_mixPasses != passes) {
+		passes = _mixPasses;
+		lastPass = now;
+	} else if (!_mixerReady || now - lastPass >= AUDIO_THREAD_TIMEOUT) {
+		// Execute the commands here, unless the audio thread just woke up.
+		// Its next pass then plays silence, since we own the channels.
+		if (MIXER_COMPARE_AND_SWAP(&_channelOwner, kOwnerNone, kOwnerControl)) {
+			processCommands();
+			MIXER_COMPARE_AND_SWAP(&_channelOwner, kOwnerControl, kOwnerNone);
+			return;
+		}
+	}
+
+	_syst->delayMillis(1);
+}
+
+void MixerImpl::collectRetiredChannels() {
+	Channel *chan;
+	while (_retired.pop(chan)) {
+		ChannelSlot &slot = _slots[chan->getHandle()._val % NUM_CHANNELS];
+		assert(slot.chan == chan);
+		slot = ChannelSlot();
+		delete chan;
+	}
+}
+
+void MixerImpl::waitForStoppedChannels() {
+	uint32 passes = _mixPasses;
+	uint32 lastPass = _syst->getMillis();
+	for (;;) {
+		collectRetiredChannels();
+
+		bool pending = false;
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_slots[i].chan && !_slots[i].active)
+				pending = true;
+		}
+		if (!pending)
+			return;
+
+		waitForAudioThread(passes, lastPass);
+	}
+}
+
+void MixerImpl::processCommands() {
+	Command cmd;
+	while (_commands.pop(cmd)) {
+		const int index = cmd.handle % NUM_CHANNELS;
+		Channel *chan = _channels[index];
+
+		if (cmd.type == kCommandPlay) {
+			assert(!chan);
+			_channels[index] = cmd.chan;
+			continue;
+		} else if (cmd.type == kCommandUpdateVolumes) {
+			for (int i = 0; i != NUM_CHANNELS; ++i) {
+				if (_channels[i] && _channels[i]->getType() == cmd.value)
+					_channels[i]->notifyGlobalVolChange();
+			}
+			continue;
+		}
+
+		// Simply ignore requests for sounds that already terminated
+		if (!chan || chan->getHandle()._val != cmd.handle)
+			continue;
+
+		switch (cmd.type) {
+		case kCommandStop:
+			retireChannel(index);
+			break;
+		case kCommandPause:
+			chan->pause(cmd.value != 0);
+			break;
+		case kCommandSetVolume:
+			chan->setVolume(cmd.value);
+			chan->setBalance(cmd.balance);
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+void MixerImpl::retireChannel(int index) {
+	// The queue has room for one entry per slot, and a slot is only reused
+	// after its channel got collected. Thus this can never fail.
+	_retired.push(_channels[index]);
+	_channels[index] = 0;
 }
 
 void MixerImpl::playStream(
@@ -237,10 +400,13 @@ void MixerImpl::playStream(
 
 	assert(_mixerReady);
 
+	if (_lockFree)
+		collectRetiredChannels();
+
 	// Prevent duplicate sounds
 	if (id != -1) {
 		for (int i = 0; i != NUM_CHANNELS; i++)
-			if (_channels[i] != 0 && _channels[i]->getId() == id) {
+			if (_lockFree ? (_slots[i].active && _slots[i].id == id) : (_channels[i] != 0 && _channels[i]->getId() == id)) {
 				// Delete the stream if were asked to auto-dispose it.
 				// Note: This could cause trouble if the client code does not
 				// yet expect the stream to be gone. The primary example to
@@ -258,7 +424,7 @@ void MixerImpl::playStream(
 #endif
 
 	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent, _rateConverterQuality);
 	chan->setVolume(volume);
 	chan->setBalance(balance);
 	insertChannel(handle, chan);
@@ -267,8 +433,28 @@ void MixerImpl::playStream(
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
+	// In lock-free mode the channels belong to the audio thread, all
+	// changes to them arrive through the command queue.
+	if (_lockFree) {
+		// The control side only takes the channels while we stalled
+		if (!MIXER_COMPARE_AND_SWAP(&_channelOwner, kOwnerNone, kOwnerAudio)) {
+			memset(samples, 0, len);
+			return 0;
+		}
+		_mixPasses++;
+
+		processCommands();
+		const int res = mixChannels(samples, len);
+
+		MIXER_COMPARE_AND_SWAP(&_channelOwner, kOwnerAudio, kOwnerNone);
+		return res;
+	}
+
 	Common::StackLock lock(_mutex);
+	return mixChannels(samples, len);
+}
 
+int MixerImpl::mixChannels(byte *samples, uint len) {
 	int16 *buf = (int16 *)samples;
 	// we store stereo, 16-bit samples
 	assert(len % 4 == 0);
@@ -285,8 +471,12 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i]) {
 			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = 0;
+				if (_lockFree) {
+					retireChannel(i);
+				} else {
+					delete _channels[i];
+					_channels[i] = 0;
+				}
 			} else if (!_channels[i]->isPaused()) {
 				tmp = _channels[i]->mix(buf, len);
 
@@ -300,6 +490,19 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
+
+	if (_lockFree) {
+		collectRetiredChannels();
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_slots[i].active && !_slots[i].permanent) {
+				postCommand(kCommandStop, _slots[i].handle);
+				_slots[i].active = false;
+			}
+		}
+		waitForStoppedChannels();
+		return;
+	}
+
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != 0 && !_channels[i]->isPermanent()) {
 			delete _channels[i];
@@ -310,6 +513,19 @@ void MixerImpl::stopAll() {
 
 void MixerImpl::stopID(int id) {
 	Common::StackLock lock(_mutex);
+
+	if (_lockFree) {
+		collectRetiredChannels();
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_slots[i].active && _slots[i].id == id) {
+				postCommand(kCommandStop, _slots[i].handle);
+				_slots[i].active = false;
+			}
+		}
+		waitForStoppedChannels();
+		return;
+	}
+
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != 0 && _channels[i]->getId() == id) {
 			delete _channels[i];
@@ -321,6 +537,17 @@ void MixerImpl::stopID(int id) {
 void MixerImpl::stopHandle(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
+	if (_lockFree) {
+		collectRetiredChannels();
+		ChannelSlot *slot = findSlot(handle);
+		if (slot) {
+			postCommand(kCommandStop, handle._val);
+			slot->active = false;
+			waitForStoppedChannels();
+		}
+		return;
+	}
+
 	// Simply ignore stop requests for handles of sounds that already terminated
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
@@ -334,6 +561,12 @@ void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= type && type < ARRAYSIZE(_soundTypeSettings));
 	_soundTypeSettings[type].mute = mute;
 
+	if (_lockFree) {
+		Common::StackLock lock(_mutex);
+		postCommand(kCommandUpdateVolumes, 0, 0, type);
+		return;
+	}
+
 	for (int i = 0; i != NUM_CHANNELS; ++i) {
 		if (_channels[i] && _channels[i]->getType() == type)
 			_channels[i]->notifyGlobalVolChange();
@@ -348,6 +581,16 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
 	Common::StackLock lock(_mutex);
 
+	if (_lockFree) {
+		collectRetiredChannels();
+		ChannelSlot *slot = findSlot(handle);
+		if (slot) {
+			slot->volume = volume;
+			postCommand(kCommandSetVolume, handle._val, 0, slot->volume, slot->balance);
+		}
+		return;
+	}
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return;
@@ -356,6 +599,13 @@ void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
+	if (_lockFree) {
+		Common::StackLock lock(_mutex);
+		collectRetiredChannels();
+		ChannelSlot *slot = findSlot(handle);
+		return slot ? slot->volume : 0;
+	}
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return 0;
@@ -366,6 +616,16 @@ byte MixerImpl::getChannelVolume(SoundHandle handle) {
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
 	Common::StackLock lock(_mutex);
 
+	if (_lockFree) {
+		collectRetiredChannels();
+		ChannelSlot *slot = findSlot(handle);
+		if (slot) {
+			slot->balance = balance;
+			postCommand(kCommandSetVolume, handle._val, 0, slot->volume, slot->balance);
+		}
+		return;
+	}
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return;
@@ -374,6 +634,13 @@ void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
+	if (_lockFree) {
+		Common::StackLock lock(_mutex);
+		collectRetiredChannels();
+		ChannelSlot *slot = findSlot(handle);
+		return slot ? slot->balance : 0;
+	}
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return 0;
@@ -388,6 +655,17 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
 
+	if (_lockFree) {
+		collectRetiredChannels();
+		ChannelSlot *slot = findSlot(handle);
+		if (!slot)
+			return Timestamp(0, _sampleRate);
+
+		// The channel is only destroyed on this side, so it is safe to
+		// query it even though the audio thread might be mixing it.
+		return slot->chan->getElapsedTime();
+	}
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return Timestamp(0, _sampleRate);
@@ -397,6 +675,16 @@ Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 
 void MixerImpl::pauseAll(bool paused) {
 	Common::StackLock lock(_mutex);
+
+	if (_lockFree) {
+		collectRetiredChannels();
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_slots[i].active)
+				postCommand(kCommandPause, _slots[i].handle, 0, paused);
+		}
+		return;
+	}
+
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != 0) {
 			_channels[i]->pause(paused);
@@ -406,6 +694,18 @@ void MixerImpl::pauseAll(bool paused) {
 
 void MixerImpl::pauseID(int id, bool paused) {
 	Common::StackLock lock(_mutex);
+
+	if (_lockFree) {
+		collectRetiredChannels();
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_slots[i].active && _slots[i].id == id) {
+				postCommand(kCommandPause, _slots[i].handle, 0, paused);
+				return;
+			}
+		}
+		return;
+	}
+
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != 0 && _channels[i]->getId() == id) {
 			_channels[i]->pause(paused);
@@ -417,6 +717,13 @@ void MixerImpl::pauseID(int id, bool paused) {
 void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 	Common::StackLock lock(_mutex);
 
+	if (_lockFree) {
+		collectRetiredChannels();
+		if (findSlot(handle))
+			postCommand(kCommandPause, handle._val, 0, paused);
+		return;
+	}
+
 	// Simply ignore (un)pause requests for sounds that already terminated
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
@@ -427,6 +734,15 @@ void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 
 bool MixerImpl::isSoundIDActive(int id) {
 	Common::StackLock lock(_mutex);
+
+	if (_lockFree) {
+		collectRetiredChannels();
+		for (int i = 0; i != NUM_CHANNELS; i++)
+			if (_slots[i].active && _slots[i].id == id)
+				return true;
+		return false;
+	}
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i] && _channels[i]->getId() == id)
 			return true;
@@ -435,6 +751,13 @@ bool MixerImpl::isSoundIDActive(int id) {
 
 int MixerImpl::getSoundID(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+
+	if (_lockFree) {
+		collectRetiredChannels();
+		ChannelSlot *slot = findSlot(handle);
+		return slot ? slot->id : 0;
+	}
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
 		return _channels[index]->getId();
@@ -443,12 +766,27 @@ int MixerImpl::getSoundID(SoundHandle handle) {
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+
+	if (_lockFree) {
+		collectRetiredChannels();
+		return findSlot(handle) != 0;
+	}
+
 	const int index = handle._val % NUM_CHANNELS;
 	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
 	Common::StackLock lock(_mutex);
+
+	if (_lockFree) {
+		collectRetiredChannels();
+		for (int i = 0; i != NUM_CHANNELS; i++)
+			if (_slots[i].active && _slots[i].type == type)
+				return true;
+		return false;
+	}
+
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i] && _channels[i]->getType() == type)
 			return true;
@@ -470,6 +808,11 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	Common::StackLock lock(_mutex);
 	_soundTypeSettings[type].volume = volume;
 
+	if (_lockFree) {
+		postCommand(kCommandUpdateVolumes, 0, 0, type);
+		return;
+	}
+
 	for (int i = 0; i != NUM_CHANNELS; ++i) {
 		if (_channels[i] && _channels[i]->getType() == type)
 			_channels[i]->notifyGlobalVolChange();
@@ -488,16 +831,16 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 #pragma mark -
 
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
-                 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
+                 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, RateConverterQuality quality)
     : _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
       _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
-      _pauseStartTime(0), _pauseTime(0), _converter(0),
+      _pauseStartTime(0), _pauseTime(0), _timeSeq(0), _converter(0),
       _stream(stream, autofreeStream) {
 	assert(mixer);
 	assert(stream);
 
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo);
+	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo, quality);
 }
 
 Channel::~Channel() {
@@ -552,6 +895,8 @@ void Channel::updateChannelVolumes() {
 void Channel::pause(bool paused) {
 	//assert((paused && _pauseLevel >= 0) || (!paused && _pauseLevel));
 
+	beginTimingUpdate();
+
 	if (paused) {
 		_pauseLevel++;
 
@@ -565,6 +910,8 @@ void Channel::pause(bool paused) {
 			_pauseStartTime = 0;
 		}
 	}
+
+	endTimingUpdate();
 }
 
 Timestamp Channel::getElapsedTime() {
@@ -573,17 +920,32 @@ Timestamp Channel::getElapsedTime() {
 
 	Audio::Timestamp ts(0, rate);
 
-	if (_mixerTimeStamp == 0)
+	// Take a consistent snapshot of the timing fields, they might be
+	// updated concurrently by the audio thread in lock-free mode.
+	uint32 seq, samplesConsumed, mixerTimeStamp, pauseStartTime, pauseTime;
+	bool paused;
+	do {
+		seq = _timeSeq;
+		MIXER_MEMORY_BARRIER();
+		samplesConsumed = _samplesConsumed;
+		mixerTimeStamp = _mixerTimeStamp;
+		pauseStartTime = _pauseStartTime;
+		pauseTime = _pauseTime;
+		paused = isPaused();
+		MIXER_MEMORY_BARRIER();
+	} while ((seq & 1) || seq != _timeSeq);
+
+	if (mixerTimeStamp == 0)
 		return ts;
 
-	if (isPaused())
-		delta = _pauseStartTime - _mixerTimeStamp;
+	if (paused)
+		delta = pauseStartTime - mixerTimeStamp;
 	else
-		delta = g_system->getMillis() - _mixerTimeStamp - _pauseTime;
+		delta = g_system->getMillis() - mixerTimeStamp - pauseTime;
 
 	// Convert the number of samples into a time duration.
 
-	ts = ts.addFrames(_samplesConsumed);
+	ts = ts.addFrames(samplesConsumed);
 	ts = ts.addMsecs(delta);
 
 	// In theory it would seem like a good idea to limit the approximation
@@ -600,13 +962,14 @@ int Channel::mix(int16 *data, uint len) {
 
 	int res = 0;
 
-	if (_stream->endOfData()) {
-		// TODO: call drain method
-	} else {
+	// Once the stream ended, the converter may still hold back some samples
+	if (!_stream->endOfData() || (_stream->endOfStream() && _converter->hasPendingOutput())) {
 		assert(_converter);
+		beginTimingUpdate();
 		_samplesConsumed = _samplesDecoded;
 		_mixerTimeStamp = g_system->getMillis();
 		_pauseTime = 0;
+		endTimingUpdate();
 		res = _converter->flow(*_stream, data, len, _volL, _volR);
 		_samplesDecoded += res;
 	}
@@ -26,9 +26,71 @@
 #include "common/scummsys.h"
 #include "common/mutex.h"
 #include "audio/mixer.h"
+#include "audio/rate.h"
+
+/**
+ * The lock-free mixing mode relies on a full memory barrier to publish
+ * queue entries between the control threads and the audio thread, and on
+ * an atomic compare and swap to hand the channels over when the audio
+ * thread stalls. On compilers where we do not know how to emit these,
+ * MixerImpl silently falls back to the mutex protected mode.
+ */
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 1))
+#define MIXER_LOCKFREE_SUPPORTED
+#define MIXER_MEMORY_BARRIER() __sync_synchronize()
+#define MIXER_COMPARE_AND_SWAP(ptr, oldValue, newValue) __sync_bool_compare_and_swap(ptr, oldValue, newValue)
+#else
+#define MIXER_MEMORY_BARRIER() do {} while (0)
+#define MIXER_COMPARE_AND_SWAP(ptr, oldValue, newValue) (*(ptr) == (oldValue) ? (*(ptr) = (newValue), true) : false)
+#endif
 
 namespace Audio {
 
+/**
+ * Fixed size single producer / single consumer ring buffer. push() may only
+ * be called from one thread and pop() only from one (other) thread; neither
+ * of them ever blocks.
+ *
+ * N must be a power of two.
+ */
+template<class T, uint N>
+class SingleProducerQueue {
+public:
+	SingleProducerQueue() : _head(0), _tail(0) {}
+
+	bool empty() const { return _head == _tail; }
+
+	bool push(const T &item) {
+		const uint32 tail = _tail;
+		if (tail - _head == N)
+			return false;
+
+		_items[tail & (N - 1)] = item;
+		// Make sure the item is visible before the consumer sees the new tail
+		MIXER_MEMORY_BARRIER();
+		_tail = tail + 1;
+		return true;
+	}
+
+	bool pop(T &item) {
+		const uint32 head = _head;
+		if (head == _tail)
+			return false;
+
+		MIXER_MEMORY_BARRIER();
+		item = _items[head & (N - 1)];
+		// Do not release the slot to the producer before we have read it
+		MIXER_MEMORY_BARRIER();
+		_head = head + 1;
+		return true;
+	}
+
+private:
+	T _items[N];
+	volatile uint32 _head;
+	volatile uint32 _tail;
+};
+
 /**
  * The (default) implementation of the ScummVM audio mixing subsystem.
  *
@@ -46,12 +108,37 @@ namespace Audio {
  * (partial) alternative implementations of the mixer, e.g. to make
  * better use of native sound mixing support on low-end devices.
  *
+ * Backends may construct the mixer in lock-free mode. In that mode all
+ * control operations (playStream, stopHandle, setChannelVolume, ...) are
+ * posted to a command queue which mixCallback() drains at the start of each
+ * pass, and the channels are owned exclusively by the audio thread. The
+ * callback therefore never has to wait for an engine thread. Channels which
+ * finished playing are handed back through a second queue and destroyed on
+ * the control side. The mixer mutex is then only used to serialize the
+ * (possibly several) control threads among themselves. Stopping a sound
+ * waits until the audio thread has handed back its channel, so callers may
+ * free the stream (or its data) right after the stop call returns.
+ *
  * @see OSystem::getMixer()
  */
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 16
+		NUM_CHANNELS = 16,
+		COMMAND_QUEUE_SIZE = 256,
+		/**
+		 * Time in ms after which the control side considers the audio
+		 * thread stalled, if it did not start a mixing pass. The SDL
+		 * backend uses buffers of at most 1/8th of a second.
+		 */
+		AUDIO_THREAD_TIMEOUT = 250
+	};
+
+	/** The thread which currently owns the channels, in lock-free mode */
+	enum ChannelOwner {
+		kOwnerNone,
+		kOwnerAudio,
+		kOwnerControl
 	};
 
 	OSystem *_syst;
@@ -60,6 +147,8 @@ private:
 	const uint _sampleRate;
 	bool _mixerReady;
 	uint32 _handleSeed;
+	bool _lockFree;
+	RateConverterQuality _rateConverterQuality;
 
 	struct SoundTypeSettings {
 		SoundTypeSettings() : mute(false), volume(kMaxMixerVolume) {}
@@ -71,10 +160,58 @@ private:
 	SoundTypeSettings _soundTypeSettings[4];
 	Channel *_channels[NUM_CHANNELS];
 
+	/**
+	 * Control side view of a channel slot, only used in lock-free mode.
+	 * A slot stays in use until the audio thread has handed back its
+	 * channel, even if the sound was already stopped (i.e. is no longer
+	 * active).
+	 */
+	struct ChannelSlot {
+		ChannelSlot() : chan(0), handle(0), id(-1), type(kPlainSoundType), volume(0), balance(0), permanent(false), active(false) {}
+
+		Channel *chan;
+		uint32 handle;
+		int id;
+		SoundType type;
+		byte volume;
+		int8 balance;
+		bool permanent;
+		bool active;
+	};
+
+	enum CommandType {
+		kCommandPlay,
+		kCommandStop,
+		kCommandPause,
+		kCommandSetVolume,
+		kCommandUpdateVolumes
+	};
+
+	struct Command {
+		CommandType type;
+		uint32 handle;
+		Channel *chan;
+		int value;
+		int8 balance;
+	};
+
+	ChannelSlot _slots[NUM_CHANNELS];
+	SingleProducerQueue<Command, COMMAND_QUEUE_SIZE> _commands;
+	SingleProducerQueue<Channel *, NUM_CHANNELS> _retired;
+	/** One of ChannelOwner, only changed through MIXER_COMPARE_AND_SWAP */
+	volatile int _channelOwner;
+	/** Number of mixing passes the audio thread started */
+	volatile uint32 _mixPasses;
+
 
 public:
 
-	MixerImpl(OSystem *system, uint sampleRate);
+	/**
+	 * @param system     the OSystem instance
+	 * @param sampleRate the hardware output sample rate
+	 * @param lockFree   whether to use the lock-free mixing mode
+	 */
+	MixerImpl(OSystem *system, uint sampleRate, bool lockFree = false);
 	~MixerImpl();
 
 	virtual bool isReady() const { return _mixerReady; }
@@ -119,9 +256,53 @@ public:
 
 	virtual uint getOutputRate() const;
 
+	/**
+	 * Queries whether the mixer operates in lock-free mode.
+	 */
+	bool isLockFree() const { return _lockFree; }
+
+	/**
+	 * Set the quality of the rate conversion used for sounds started from
+	 * now on. Sounds which are already playing are not affected.
+	 */
+	void setRateConverterQuality(RateConverterQuality quality);
+
+	/**
+	 * Queries the quality of the rate conversion.
+	 */
+	RateConverterQuality getRateConverterQuality() const { return _rateConverterQuality; }
+
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
+private:
+	/** Returns the active control side slot for the given handle, or 0. */
+	ChannelSlot *findSlot(SoundHandle handle);
+	/**
+	 * Posts a command to the audio thread. If the queue is full, this waits
+	 * until the audio thread drained it.
+	 */
+	void postCommand(CommandType type, uint32 handle, Channel *chan = 0, int value = 0, int8 balance = 0);
+	/**
+	 * Waits a moment for the audio thread to execute the pending commands.
+	 * If it did not start a pass for a while (e.g. because audio got
+	 * suspended), the commands are executed on the calling thread instead.
+	 *
+	 * @param passes   the pass counter seen by the previous call
+	 * @param lastPass the time the pass counter last changed
+	 */
+	void waitForAudioThread(uint32 &passes, uint32 &lastPass);
+	/** Destroys all channels the audio thread has handed back. */
+	void collectRetiredChannels();
+	/** Waits until the audio thread handed back the channels of all stopped sounds. */
+	void waitForStoppedChannels();
+	/** Executes all pending commands. Only called from mixCallback(). */
+	void processCommands();
+	/** Hands a channel back to the control side. Only called from mixCallback(). */
+	void retireChannel(int index);
+	/** Mixes all channels into the given buffer. */
+	int mixChannels(byte *samples, uint len);
+
 public:
 	/**
 	 * The mixer callback function, to be called at regular intervals by
@@ -57,7 +57,8 @@ MODULE_OBJS := \
 
 ifndef USE_ARM_SOUND_ASM
 MODULE_OBJS += \
-	rate.o
+	rate.o \
+	rate_simd.o
 else
 MODULE_OBJS += \
 	rate_arm.o \
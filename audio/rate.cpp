@@ -30,8 +30,11 @@
 
 #include "audio/audiostream.h"
 #include "audio/rate.h"
+#include "audio/rate_simd.h"
 #include "audio/mixer.h"
+#include "common/algorithm.h"
 #include "common/frac.h"
+#include "common/math.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
@@ -46,6 +49,21 @@ namespace Audio {
  */
 #define INTERMEDIATE_BUFFER_SIZE 512
 
+/**
+ * Scale the converted samples in 'in' by the channel volumes and mix them
+ * into the output buffer, using the fastest available mixing kernel.
+ */
+template<bool stereo, bool reverseStereo>
+static inline void mixConverted(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	const RateMixKernels &kernels = getRateMixKernels();
+	if (stereo)
+		kernels.mixStereo(obuf, in, frames, vol_l, vol_r, reverseStereo);
+	else if (reverseStereo)
+		kernels.mixMono(obuf, in, frames, vol_r, vol_l);
+	else
+		kernels.mixMono(obuf, in, frames, vol_l, vol_r);
+}
+
 
 /**
  * Audio rate converter based on simple resampling. Used when no
@@ -60,6 +78,9 @@ protected:
 	const st_sample_t *inPtr;
 	int inLen;
 
+	/** converted samples, waiting to be mixed into the output */
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+
 	/** position of how far output is ahead of input */
 	/** Holds what would have been opos-ipos */
 	long opos;
@@ -108,38 +129,47 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 	ostart = obuf;
 	oend = obuf + osamp * 2;
 
-	while (obuf < oend) {
+	bool inputDone = false;
+	while (obuf < oend && !inputDone) {
+		// Convert as many samples as fit into the intermediate output
+		// buffer, then mix them all at once
+		st_sample_t *out = outBuf;
+		st_sample_t *outEnd = outBuf + MIN<st_size_t>((oend - obuf) / 2, ARRAYSIZE(outBuf) / 2) * (stereo ? 2 : 1);
+
+		while (out < outEnd) {
+
+			// read enough input samples so that opos >= 0
+			do {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						inputDone = true;
+						break;
+					}
+				}
+				inLen -= (stereo ? 2 : 1);
+				opos--;
+				if (opos >= 0) {
+					inPtr += (stereo ? 2 : 1);
+				}
+			} while (opos >= 0);
+
+			if (inputDone)
+				break;
+
+			*out++ = *inPtr++;
+			if (stereo)
+				*out++ = *inPtr++;
 
-		// read enough input samples so that opos >= 0
-		do {
-			// Check if we have to refill the buffer
-			if (inLen == 0) {
-				inPtr = inBuf;
-				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
-					return (obuf - ostart) / 2;
-			}
-			inLen -= (stereo ? 2 : 1);
-			opos--;
-			if (opos >= 0) {
-				inPtr += (stereo ? 2 : 1);
-			}
-		} while (opos >= 0);
-
-		st_sample_t out0, out1;
-		out0 = *inPtr++;
-		out1 = (stereo ? *inPtr++ : out0);
-
-		// Increment output position
-		opos += opos_inc;
-
-		// output left channel
-		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-		// output right channel
-		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+			// Increment output position
+			opos += opos_inc;
+		}
 
-		obuf += 2;
+		const st_size_t frames = (out - outBuf) / (stereo ? 2 : 1);
+		mixConverted<stereo, reverseStereo>(obuf, outBuf, frames, vol_l, vol_r);
+		obuf += frames * 2;
 	}
 	return (obuf - ostart) / 2;
 }
@@ -173,6 +203,9 @@ protected:
 	/** current sample(s) in the input stream (left/right channel) */
 	st_sample_t icur0, icur1;
 
+	/** converted samples, waiting to be mixed into the output */
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+
 public:
 	LinearRateConverter(st_rate_t inrate, st_rate_t outrate);
 	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
@@ -217,48 +250,314 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 	ostart = obuf;
 	oend = obuf + osamp * 2;
 
-	while (obuf < oend) {
-
-		// read enough input samples so that opos < 0
-		while ((frac_t)FRAC_ONE <= opos) {
-			// Check if we have to refill the buffer
-			if (inLen == 0) {
-				inPtr = inBuf;
-				inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
-				if (inLen <= 0)
-					return (obuf - ostart) / 2;
+	bool inputDone = false;
+	while (obuf < oend && !inputDone) {
+		// Convert as many samples as fit into the intermediate output
+		// buffer, then mix them all at once
+		st_sample_t *out = outBuf;
+		st_sample_t *outEnd = outBuf + MIN<st_size_t>((oend - obuf) / 2, ARRAYSIZE(outBuf) / 2) * (stereo ? 2 : 1);
+
+		while (out < outEnd) {
+
+			// read enough input samples so that opos < 0
+			while ((frac_t)FRAC_ONE <= opos) {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen <= 0) {
+						inputDone = true;
+						break;
+					}
+				}
+				inLen -= (stereo ? 2 : 1);
+				ilast0 = icur0;
+				icur0 = *inPtr++;
+				if (stereo) {
+					ilast1 = icur1;
+					icur1 = *inPtr++;
+				}
+				opos -= FRAC_ONE;
 			}
-			inLen -= (stereo ? 2 : 1);
-			ilast0 = icur0;
-			icur0 = *inPtr++;
-			if (stereo) {
-				ilast1 = icur1;
-				icur1 = *inPtr++;
+
+			if (inputDone)
+				break;
+
+			// Loop as long as the outpos trails behind, and as long as there is
+			// still space in the output buffer.
+			while (opos < (frac_t)FRAC_ONE && out < outEnd) {
+				// interpolate
+				*out++ = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF) >> FRAC_BITS));
+				if (stereo)
+					*out++ = (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF) >> FRAC_BITS));
+
+				// Increment output position
+				opos += opos_inc;
 			}
-			opos -= FRAC_ONE;
 		}
 
-		// Loop as long as the outpos trails behind, and as long as there is
-		// still space in the output buffer.
-		while (opos < (frac_t)FRAC_ONE && obuf < oend) {
-			// interpolate
-			st_sample_t out0, out1;
-			out0 = (st_sample_t)(ilast0 + (((icur0 - ilast0) * opos + FRAC_HALF) >> FRAC_BITS));
-			out1 = (stereo ?
-						  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF) >> FRAC_BITS)) :
-						  out0);
+		const st_size_t frames = (out - outBuf) / (stereo ? 2 : 1);
+		mixConverted<stereo, reverseStereo>(obuf, outBuf, frames, vol_l, vol_r);
+		obuf += frames * 2;
+	}
+	return (obuf - ostart) / 2;
+}
+
+
+#pragma mark -
+
+
+/**
+ * Precision of the polyphase filter coefficients. The coefficients of each
+ * phase add up to 1 << SINC_COEF_BITS. With 14 bits the filter sum cannot
+ * overflow 32 bits, even for full scale input.
+ */
+#define SINC_COEF_BITS 14
+
+/**
+ * Modified Bessel function of the first kind, order 0. Needed for the
+ * Kaiser window.
+ */
+static double besselI0(double x) {
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 64; ++k) {
+		const double t = x / (2 * k);
+		term *= t * t;
+		sum += term;
+		if (term < sum * 1e-12)
+			break;
+	}
+	return sum;
+}
+
+/**
+ * Audio rate converter based on band-limited interpolation with a Kaiser
+ * windowed sinc filter. The filter is precomputed for a fixed number of
+ * fractional positions (phases) between two input samples, i.e. it is a
+ * polyphase filter. When reducing the sample rate, the cutoff frequency is
+ * lowered and the filter made longer accordingly to avoid aliasing.
+ *
+ * The output lags behind the input by half the filter length. Once the
+ * input stream ended, the converter feeds a filter length of zero samples
+ * into the filter, so that the last input samples make it to the output
+ * including their full impulse response.
+ *
+ * Unlike the other converters, this one is not limited to rates <= 65535 Hz.
+ */
+template<bool stereo, bool reverseStereo>
+class SincRateConverter : public RateConverter {
+protected:
+	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+	const st_sample_t *inPtr;
+	int inLen;
+
+	/** converted samples, waiting to be mixed into the output */
+	st_sample_t outBuf[INTERMEDIATE_BUFFER_SIZE];
+
+	/** input and output rate, divided by their greatest common divisor */
+	st_rate_t _inRate, _outRate;
+
+	/** position of the output stream in units of 1 / _outRate input samples */
+	st_rate_t _opos;
+
+	/** number of filter taps (per phase) */
+	int _taps;
+
+	/** number of filter phases */
+	int _phases;
+
+	/** filter coefficients, _taps for each phase */
+	int16 *_filter;
+
+	/**
+	 * The last _taps input samples (left/right channel). Every sample is
+	 * stored twice, so that the filter window starting at _historyPos is
+	 * always contiguous.
+	 */
+	st_sample_t *_history0, *_history1;
+	int _historyPos;
+
+	/** number of zero samples still to feed in after the end of the input */
+	int _tailLeft;
+
+	static st_sample_t convolve(const st_sample_t *window, const int16 *coefs, int taps) {
+		int32 sum = 1 << (SINC_COEF_BITS - 1);
+		for (int i = 0; i < taps; ++i)
+			sum += window[i] * coefs[i];
+		return (st_sample_t)CLIP<int32>(sum >> SINC_COEF_BITS, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+	}
+
+public:
+	SincRateConverter(st_rate_t inrate, st_rate_t outrate, RateConverterQuality quality);
+	~SincRateConverter();
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
+		return ST_SUCCESS;
+	}
+	bool hasPendingOutput() const { return _tailLeft > 0; }
+};
+
+
+/*
+ * Prepare processing.
+ */
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::SincRateConverter(st_rate_t inrate, st_rate_t outrate, RateConverterQuality quality) {
+	static const struct {
+		int taps;
+		int phases;
+		double cutoff;
+		double beta;
+	} params[] = {
+		{  8,  64, 0.85, 5.0 },
+		{ 16, 128, 0.90, 6.5 },
+		{ 32, 256, 0.94, 8.0 }
+	};
+
+	if (inrate >= (1 << 24) || outrate >= (1 << 24)) {
+		error("rate effect can only handle rates < 16777216");
+	}
+
+	assert(quality >= kRateConverterSincLow && quality <= kRateConverterSincHigh);
+	const int q = quality - kRateConverterSincLow;
+
+	const st_rate_t divisor = Common::gcd(inrate, outrate);
+	_inRate = inrate / divisor;
+	_outRate = outrate / divisor;
+	_opos = _outRate;
+
+	// When downsampling the cutoff has to be below the output's Nyquist
+	// frequency, which requires a correspondingly longer filter. Limit the
+	// length to keep the cost for extreme ratios at bay.
+	const double ratio = MIN<double>(1.0, (double)outrate / inrate);
+	const double cutoff = params[q].cutoff * ratio;
+	_taps = MIN<int>(params[q].taps * 4, (int)ceil(params[q].taps / ratio));
+	_taps = (_taps + 1) & ~1;
+	_phases = params[q].phases;
+
+	// Make sure (_opos * _phases) cannot overflow
+	while (_phases > 1 && _outRate > 0xFFFFFFFFU / _phases)
+		_phases >>= 1;
+
+	_filter = new int16[_phases * _taps];
+
+	const double half = _taps / 2;
+	const double windowScale = 1.0 / besselI0(params[q].beta);
+	double *row = new double[_taps];
+
+	for (int phase = 0; phase < _phases; ++phase) {
+		// Tap k is applied to the input sample at distance x from the
+		// output position.
+		const double fraction = (double)phase / _phases;
+		double sum = 0.0;
+
+		for (int k = 0; k < _taps; ++k) {
+			const double x = half - 1 - k + fraction;
+			const double r = x / half;
+			const double window = (r <= -1.0 || r >= 1.0) ? 0.0 : besselI0(params[q].beta * sqrt(1.0 - r * r)) * windowScale;
+			const double arg = M_PI * cutoff * x;
+			const double sinc = (x == 0.0) ? 1.0 : sin(arg) / arg;
+
+			row[k] = sinc * window;
+			sum += row[k];
+		}
+
+		// Normalize every phase to unity gain, so a constant signal stays
+		// constant. The rounding error is put on the largest coefficient.
+		int16 *coefs = _filter + phase * _taps;
+		int total = 0, largest = 0;
+		for (int k = 0; k < _taps; ++k) {
+			coefs[k] = (int16)floor(row[k] / sum * (1 << SINC_COEF_BITS) + 0.5);
+			total += coefs[k];
+			if (coefs[k] > coefs[largest])
+				largest = k;
+		}
+		coefs[largest] += (1 << SINC_COEF_BITS) - total;
+	}
+
+	delete[] row;
 
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+	_history0 = new st_sample_t[_taps * 2];
+	_history1 = stereo ? new st_sample_t[_taps * 2] : 0;
+	memset(_history0, 0, _taps * 2 * sizeof(st_sample_t));
+	if (stereo)
+		memset(_history1, 0, _taps * 2 * sizeof(st_sample_t));
+	_historyPos = 0;
+	_tailLeft = 0;
 
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+	inLen = 0;
+}
 
-			obuf += 2;
+template<bool stereo, bool reverseStereo>
+SincRateConverter<stereo, reverseStereo>::~SincRateConverter() {
+	delete[] _filter;
+	delete[] _history0;
+	delete[] _history1;
+}
+
+/*
+ * Processed signed long samples from ibuf to obuf.
+ * Return number of sample pairs processed.
+ */
+template<bool stereo, bool reverseStereo>
+int SincRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t *ostart, *oend;
+
+	ostart = obuf;
+	oend = obuf + osamp * 2;
+
+	bool inputDone = false;
+	while (obuf < oend && !inputDone) {
+		st_sample_t *out = outBuf;
+		st_sample_t *outEnd = outBuf + MIN<st_size_t>((oend - obuf) / 2, ARRAYSIZE(outBuf) / 2) * (stereo ? 2 : 1);
+
+		while (out < outEnd) {
+
+			// read enough input samples so that the output position lies
+			// between the two newest input samples
+			while (_opos >= _outRate) {
+				// Check if we have to refill the buffer
+				if (inLen == 0) {
+					inPtr = inBuf;
+					inLen = input.readBuffer(inBuf, ARRAYSIZE(inBuf));
+					if (inLen > 0) {
+						_tailLeft = _taps;
+					} else if (_tailLeft > 0 && input.endOfStream()) {
+						_tailLeft--;
+						inBuf[0] = inBuf[1] = 0;
+						inLen = stereo ? 2 : 1;
+					} else {
+						inLen = 0;
+						inputDone = true;
+						break;
+					}
+				}
+				inLen -= (stereo ? 2 : 1);
+
+				_history0[_historyPos] = _history0[_historyPos + _taps] = *inPtr++;
+				if (stereo)
+					_history1[_historyPos] = _history1[_historyPos + _taps] = *inPtr++;
+				if (++_historyPos == _taps)
+					_historyPos = 0;
+
+				_opos -= _outRate;
+			}
+
+			if (inputDone)
+				break;
+
+			const int16 *coefs = _filter + ((_opos * _phases) / _outRate) * _taps;
+			*out++ = convolve(_history0 + _historyPos, coefs, _taps);
+			if (stereo)
+				*out++ = convolve(_history1 + _historyPos, coefs, _taps);
 
 			// Increment output position
-			opos += opos_inc;
+			_opos += _inRate;
 		}
+
+		const st_size_t frames = (out - outBuf) / (stereo ? 2 : 1);
+		mixConverted<stereo, reverseStereo>(obuf, outBuf, frames, vol_l, vol_r);
+		obuf += frames * 2;
 	}
 	return (obuf - ostart) / 2;
 }
@@ -283,11 +582,8 @@ public:
 	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
 		assert(input.isStereo() == stereo);
 
-		st_sample_t *ptr;
 		st_size_t len;
 
-		st_sample_t *ostart = obuf;
-
 		if (stereo)
 			osamp *= 2;
 
@@ -305,21 +601,9 @@ public:
 		len = input.readBuffer(_buffer, osamp);
 
 		// Mix the data into the output buffer
-		ptr = _buffer;
-		for (; len > 0; len -= (stereo ? 2 : 1)) {
-			st_sample_t out0, out1;
-			out0 = *ptr++;
-			out1 = (stereo ? *ptr++ : out0);
-
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
-			obuf += 2;
-		}
-		return (obuf - ostart) / 2;
+		const st_size_t frames = len / (stereo ? 2 : 1);
+		mixConverted<stereo, reverseStereo>(obuf, _buffer, frames, vol_l, vol_r);
+		return frames;
 	}
 
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
@@ -331,9 +615,11 @@ public:
 #pragma mark -
 
 template<bool stereo, bool reverseStereo>
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, RateConverterQuality quality) {
 	if (inrate != outrate) {
-		if ((inrate % outrate) == 0) {
+		if (quality != kRateConverterLinear) {
+			return new SincRateConverter<stereo, reverseStereo>(inrate, outrate, quality);
+		} else if ((inrate % outrate) == 0) {
 			return new SimpleRateConverter<stereo, reverseStereo>(inrate, outrate);
 		} else {
 			return new LinearRateConverter<stereo, reverseStereo>(inrate, outrate);
@@ -346,14 +632,14 @@ RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
 /**
  * Create and return a RateConverter object for the specified input and output rates.
  */
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, RateConverterQuality quality) {
 	if (stereo) {
 		if (reverseStereo)
-			return makeRateConverter<true, true>(inrate, outrate);
+			return makeRateConverter<true, true>(inrate, outrate, quality);
 		else
-			return makeRateConverter<true, false>(inrate, outrate);
+			return makeRateConverter<true, false>(inrate, outrate, quality);
 	} else
-		return makeRateConverter<false, false>(inrate, outrate);
+		return makeRateConverter<false, false>(inrate, outrate, quality);
 }
 
 } // End of namespace Audio
@@ -76,9 +76,26 @@ public:
 	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) = 0;
 
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) = 0;
+
+	/**
+	 * Queries whether flow() still has samples to output once the input
+	 * stream ended, e.g. because the converter's filter delays them.
+	 */
+	virtual bool hasPendingOutput() const { return false; }
+};
+
+/**
+ * Quality settings for the rate conversion. The sinc based converters
+ * trade CPU time for less aliasing and a flatter frequency response.
+ */
+enum RateConverterQuality {
+	kRateConverterLinear,     ///< Nearest neighbour / linear interpolation (default)
+	kRateConverterSincLow,    ///< Windowed sinc, 8 taps
+	kRateConverterSincMedium, ///< Windowed sinc, 16 taps
+	kRateConverterSincHigh    ///< Windowed sinc, 32 taps
 };
 
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false);
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false, RateConverterQuality quality = kRateConverterLinear);
 
 } // End of namespace Audio
 
@@ -436,7 +436,9 @@ public:
 /**
  * Create and return a RateConverter object for the specified input and output rates.
  */
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, RateConverterQuality quality) {
+	// The sinc based converters are not available in the ARM assembly
+	// implementation, the quality setting is ignored here.
 	if (inrate != outrate) {
 		if ((inrate % outrate) == 0) {
 			if (stereo) {
@@ -0,0 +1,294 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/rate_simd.h"
+#include "audio/mixer.h"
+#include "common/cpudetect.h"
+
+// The vectorized kernels rely on the output buffer holding plain signed
+// samples, thus they are not used for backends requiring unsigned output.
+#ifndef OUTPUT_UNSIGNED_AUDIO
+#ifdef SCUMMVM_HAVE_X86_SIMD
+#define RATE_USE_X86_SIMD
+#include <immintrin.h>
+#endif
+#ifdef SCUMMVM_HAVE_NEON
+#define RATE_USE_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace Audio {
+
+#pragma mark -
+#pragma mark --- Scalar kernels ---
+#pragma mark -
+
+static void mixStereoScalar(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r, bool reverseStereo) {
+	const int left = reverseStereo ? 1 : 0;
+
+	for (; frames > 0; --frames) {
+		clampedAdd(obuf[left    ], (in[0] * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+		clampedAdd(obuf[left ^ 1], (in[1] * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		obuf += 2;
+		in += 2;
+	}
+}
+
+static void mixMonoScalar(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	for (; frames > 0; --frames) {
+		clampedAdd(obuf[0], (*in * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+		clampedAdd(obuf[1], (*in * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		obuf += 2;
+		in++;
+	}
+}
+
+static const RateMixKernels s_scalarKernels = { mixStereoScalar, mixMonoScalar, "scalar" };
+
+/*
+ * All vectorized kernels work the same way: the samples are multiplied by
+ * the volume to 32 bit products, which are divided by kMaxMixerVolume (256)
+ * rounding towards zero like the C division does. That is done by adding
+ * 255 to negative products before shifting. Since the volume never exceeds
+ * kMaxMixerVolume, the quotients always fit into 16 bits again, so they can
+ * be packed and added to the output with a saturating add, which matches
+ * clampedAdd.
+ */
+
+#ifdef RATE_USE_X86_SIMD
+
+#pragma mark -
+#pragma mark --- SSE2 kernels ---
+#pragma mark -
+
+SCUMMVM_TARGET_SSE2
+static inline __m128i scaleSSE2(__m128i samples, __m128i vol) {
+	const __m128i lo = _mm_mullo_epi16(samples, vol);
+	const __m128i hi = _mm_mulhi_epi16(samples, vol);
+	__m128i p0 = _mm_unpacklo_epi16(lo, hi);
+	__m128i p1 = _mm_unpackhi_epi16(lo, hi);
+	p0 = _mm_srai_epi32(_mm_add_epi32(p0, _mm_srli_epi32(_mm_srai_epi32(p0, 31), 24)), 8);
+	p1 = _mm_srai_epi32(_mm_add_epi32(p1, _mm_srli_epi32(_mm_srai_epi32(p1, 31), 24)), 8);
+	return _mm_packs_epi32(p0, p1);
+}
+
+SCUMMVM_TARGET_SSE2
+static void mixStereoSSE2(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r, bool reverseStereo) {
+	// Swapping the input channels and the volumes is the same as swapping
+	// the output channels.
+	const int16 v0 = reverseStereo ? vol_r : vol_l;
+	const int16 v1 = reverseStereo ? vol_l : vol_r;
+	const __m128i vol = _mm_set_epi16(v1, v0, v1, v0, v1, v0, v1, v0);
+
+	for (; frames >= 4; frames -= 4) {
+		__m128i samples = _mm_loadu_si128((const __m128i *)in);
+		if (reverseStereo)
+			samples = _mm_shufflehi_epi16(_mm_shufflelo_epi16(samples, 0xB1), 0xB1);
+
+		const __m128i out = _mm_loadu_si128((const __m128i *)obuf);
+		_mm_storeu_si128((__m128i *)obuf, _mm_adds_epi16(out, scaleSSE2(samples, vol)));
+
+		obuf += 8;
+		in += 8;
+	}
+
+	mixStereoScalar(obuf, in, frames, vol_l, vol_r, reverseStereo);
+}
+
+SCUMMVM_TARGET_SSE2
+static void mixMonoSSE2(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	const __m128i vol = _mm_set_epi16(vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l);
+
+	for (; frames >= 8; frames -= 8) {
+		const __m128i mono = _mm_loadu_si128((const __m128i *)in);
+		const __m128i samples0 = _mm_unpacklo_epi16(mono, mono);
+		const __m128i samples1 = _mm_unpackhi_epi16(mono, mono);
+
+		const __m128i out0 = _mm_loadu_si128((const __m128i *)obuf);
+		const __m128i out1 = _mm_loadu_si128((const __m128i *)(obuf + 8));
+		_mm_storeu_si128((__m128i *)obuf, _mm_adds_epi16(out0, scaleSSE2(samples0, vol)));
+		_mm_storeu_si128((__m128i *)(obuf + 8), _mm_adds_epi16(out1, scaleSSE2(samples1, vol)));
+
+		obuf += 16;
+		in += 8;
+	}
+
+	mixMonoScalar(obuf, in, frames, vol_l, vol_r);
+}
+
+static const RateMixKernels s_sse2Kernels = { mixStereoSSE2, mixMonoSSE2, "SSE2" };
+
+#pragma mark -
+#pragma mark --- AVX2 kernels ---
+#pragma mark -
+
+// Note that the unpack and pack instructions work on the two 128 bit lanes
+// separately, so the sample order is preserved just like in the SSE2 case.
+SCUMMVM_TARGET_AVX2
+static inline __m256i scaleAVX2(__m256i samples, __m256i vol) {
+	const __m256i lo = _mm256_mullo_epi16(samples, vol);
+	const __m256i hi = _mm256_mulhi_epi16(samples, vol);
+	__m256i p0 = _mm256_unpacklo_epi16(lo, hi);
+	__m256i p1 = _mm256_unpackhi_epi16(lo, hi);
+	p0 = _mm256_srai_epi32(_mm256_add_epi32(p0, _mm256_srli_epi32(_mm256_srai_epi32(p0, 31), 24)), 8);
+	p1 = _mm256_srai_epi32(_mm256_add_epi32(p1, _mm256_srli_epi32(_mm256_srai_epi32(p1, 31), 24)), 8);
+	return _mm256_packs_epi32(p0, p1);
+}
+
+SCUMMVM_TARGET_AVX2
+static void mixStereoAVX2(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r, bool reverseStereo) {
+	const int16 v0 = reverseStereo ? vol_r : vol_l;
+	const int16 v1 = reverseStereo ? vol_l : vol_r;
+	const __m256i vol = _mm256_set_epi16(v1, v0, v1, v0, v1, v0, v1, v0, v1, v0, v1, v0, v1, v0, v1, v0);
+
+	for (; frames >= 8; frames -= 8) {
+		__m256i samples = _mm256_loadu_si256((const __m256i *)in);
+		if (reverseStereo)
+			samples = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(samples, 0xB1), 0xB1);
+
+		const __m256i out = _mm256_loadu_si256((const __m256i *)obuf);
+		_mm256_storeu_si256((__m256i *)obuf, _mm256_adds_epi16(out, scaleAVX2(samples, vol)));
+
+		obuf += 16;
+		in += 16;
+	}
+
+	mixStereoScalar(obuf, in, frames, vol_l, vol_r, reverseStereo);
+}
+
+SCUMMVM_TARGET_AVX2
+static void mixMonoAVX2(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	const __m256i vol = _mm256_set_epi16(vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l, vol_r, vol_l);
+
+	for (; frames >= 16; frames -= 16) {
+		// Duplicate every sample, the permutation makes sure that the
+		// lane-wise unpacks produce the samples in their original order.
+		const __m256i mono = _mm256_permute4x64_epi64(_mm256_loadu_si256((const __m256i *)in), 0xD8);
+		const __m256i samples0 = _mm256_unpacklo_epi16(mono, mono);
+		const __m256i samples1 = _mm256_unpackhi_epi16(mono, mono);
+
+		const __m256i out0 = _mm256_loadu_si256((const __m256i *)obuf);
+		const __m256i out1 = _mm256_loadu_si256((const __m256i *)(obuf + 16));
+		_mm256_storeu_si256((__m256i *)obuf, _mm256_adds_epi16(out0, scaleAVX2(samples0, vol)));
+		_mm256_storeu_si256((__m256i *)(obuf + 16), _mm256_adds_epi16(out1, scaleAVX2(samples1, vol)));
+
+		obuf += 32;
+		in += 16;
+	}
+
+	mixMonoSSE2(obuf, in, frames, vol_l, vol_r);
+}
+
+static const RateMixKernels s_avx2Kernels = { mixStereoAVX2, mixMonoAVX2, "AVX2" };
+
+#endif // RATE_USE_X86_SIMD
+
+#ifdef RATE_USE_NEON
+
+#pragma mark -
+#pragma mark --- NEON kernels ---
+#pragma mark -
+
+static inline int32x4_t divideNEON(int32x4_t p) {
+	const uint32x4_t bias = vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(p, 31)), 24);
+	return vshrq_n_s32(vaddq_s32(p, vreinterpretq_s32_u32(bias)), 8);
+}
+
+static inline int16x8_t scaleNEON(int16x8_t samples, int16x8_t vol) {
+	const int32x4_t p0 = divideNEON(vmull_s16(vget_low_s16(samples), vget_low_s16(vol)));
+	const int32x4_t p1 = divideNEON(vmull_s16(vget_high_s16(samples), vget_high_s16(vol)));
+	return vcombine_s16(vqmovn_s32(p0), vqmovn_s32(p1));
+}
+
+static void mixStereoNEON(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r, bool reverseStereo) {
+	const int16 v0 = reverseStereo ? vol_r : vol_l;
+	const int16 v1 = reverseStereo ? vol_l : vol_r;
+	const int16 volumes[8] = { v0, v1, v0, v1, v0, v1, v0, v1 };
+	const int16x8_t vol = vld1q_s16(volumes);
+
+	for (; frames >= 4; frames -= 4) {
+		int16x8_t samples = vld1q_s16(in);
+		if (reverseStereo)
+			samples = vrev32q_s16(samples);
+
+		vst1q_s16(obuf, vqaddq_s16(vld1q_s16(obuf), scaleNEON(samples, vol)));
+
+		obuf += 8;
+		in += 8;
+	}
+
+	mixStereoScalar(obuf, in, frames, vol_l, vol_r, reverseStereo);
+}
+
+static void mixMonoNEON(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r) {
+	const int16 volumes[8] = { (int16)vol_l, (int16)vol_r, (int16)vol_l, (int16)vol_r, (int16)vol_l, (int16)vol_r, (int16)vol_l, (int16)vol_r };
+	const int16x8_t vol = vld1q_s16(volumes);
+
+	for (; frames >= 4; frames -= 4) {
+		const int16x4_t mono = vld1_s16(in);
+		const int16x4x2_t zipped = vzip_s16(mono, mono);
+		const int16x8_t samples = vcombine_s16(zipped.val[0], zipped.val[1]);
+
+		vst1q_s16(obuf, vqaddq_s16(vld1q_s16(obuf), scaleNEON(samples, vol)));
+
+		obuf += 8;
+		in += 4;
+	}
+
+	mixMonoScalar(obuf, in, frames, vol_l, vol_r);
+}
+
+static const RateMixKernels s_neonKernels = { mixStereoNEON, mixMonoNEON, "NEON" };
+
+#endif // RATE_USE_NEON
+
+#pragma mark -
+
+static const RateMixKernels *detectRateMixKernels() {
+#ifdef RATE_USE_X86_SIMD
+	if (Common::hasCPUFeature(Common::kCPUFeatureAVX2))
+		return &s_avx2Kernels;
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2))
+		return &s_sse2Kernels;
+#endif
+#ifdef RATE_USE_NEON
+	if (Common::hasCPUFeature(Common::kCPUFeatureNEON))
+		return &s_neonKernels;
+#endif
+	return &s_scalarKernels;
+}
+
+const RateMixKernels &getRateMixKernels() {
+	// Detection always yields the same result, so it does not matter if
+	// two threads happen to run it at the same time.
+	static const RateMixKernels *kernels = 0;
+	if (!kernels)
+		kernels = detectRateMixKernels();
+	return *kernels;
+}
+
+const RateMixKernels &getScalarRateMixKernels() {
+	return s_scalarKernels;
+}
+
+} // End of namespace Audio
@@ -0,0 +1,67 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_RATE_SIMD_H
+#define AUDIO_RATE_SIMD_H
+
+#include "audio/rate.h"
+
+namespace Audio {
+
+/**
+ * Mixing kernels used by the rate converters. They scale already converted
+ * samples by the channel volumes and add them to the (stereo) output buffer
+ * with clamping. The result is bit-identical to doing
+ *
+ *   clampedAdd(obuf[0], (sampleL * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+ *   clampedAdd(obuf[1], (sampleR * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+ *
+ * for every frame, whichever implementation is selected.
+ */
+struct RateMixKernels {
+	/**
+	 * Mix interleaved stereo input. If reverseStereo is set, the left input
+	 * channel goes to the right output channel and vice versa.
+	 */
+	void (*mixStereo)(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r, bool reverseStereo);
+
+	/** Mix mono input into both output channels. */
+	void (*mixMono)(st_sample_t *obuf, const st_sample_t *in, st_size_t frames, st_volume_t vol_l, st_volume_t vol_r);
+
+	/** Name of the implementation, for debugging purposes. */
+	const char *name;
+};
+
+/**
+ * Return the fastest mixing kernels supported by the CPU we are running on.
+ */
+const RateMixKernels &getRateMixKernels();
+
+/**
+ * Return the plain C++ mixing kernels. These serve as the reference for the
+ * vectorized implementations.
+ */
+const RateMixKernels &getScalarRateMixKernels();
+
+} // End of namespace Audio
+
+#endif
@@ -36,6 +36,7 @@
 #include "common/error.h"
 #include "common/events.h"
 #include "common/file.h"
+#include "common/mutex.h"
 #include "common/system.h"
 #include "common/util.h"
 #include "common/archive.h"
@@ -109,6 +110,22 @@ private:
 
 	int _outputRate;
 
+	// Samples requested by generateSamples() which have not been rendered
+	// yet. The synth is only run when a MIDI message has to be played, or
+	// at the end of readBuffer(), so it renders larger blocks at once.
+	int16 *_pendingBuf;
+	int _pendingLen;
+	void renderPendingSamples();
+
+	// The timer callback of the client, called by timerCallbackProxy().
+	// _timerMutex is held while calling it, so setTimerCallback() does not
+	// return while the old callback is still running.
+	Common::Mutex _timerMutex;
+	void *_clientTimerParam;
+	Common::TimerManager::TimerProc _clientTimerProc;
+	bool _inTimerCallback;
+	static void timerCallbackProxy(void *param);
+
 protected:
 	void generateSamples(int16 *buf, int len);
 
@@ -127,8 +144,10 @@ public:
 	uint32 property(int prop, uint32 param);
 	MidiChannel *allocateChannel();
 	MidiChannel *getPercussionChannel();
+	void setTimerCallback(void *timer_param, Common::TimerManager::TimerProc timer_proc);
 
 	// AudioStream API
+	int readBuffer(int16 *data, const int numSamples);
 	bool isStereo() const { return true; }
 	int getRate() const { return _outputRate; }
 };
@@ -156,6 +175,11 @@ MidiDriver_MT32::MidiDriver_MT32(Audio::Mixer *mixer) : MidiDriver_Emulated(mixe
 	// rely on Mixer to convert.
 	_outputRate = 32000; //_mixer->getOutputRate();
 	_initializing = false;
+	_pendingBuf = NULL;
+	_pendingLen = 0;
+	_clientTimerParam = NULL;
+	_clientTimerProc = NULL;
+	_inTimerCallback = false;
 }
 
 MidiDriver_MT32::~MidiDriver_MT32() {
@@ -233,6 +257,12 @@ int MidiDriver_MT32::open() {
 }
 
 void MidiDriver_MT32::send(uint32 b) {
+	// Messages sent by the timer callback take effect at the sample where
+	// the callback happened, just like when every tick is rendered right away.
+	// Clients sending from other threads are not synchronized with the
+	// rendering anyway, their messages are played immediately as before.
+	if (_inTimerCallback)
+		renderPendingSamples();
 	_synth->playMsg(b);
 }
 
@@ -254,6 +284,8 @@ void MidiDriver_MT32::setPitchBendRange(byte channel, uint range) {
 }
 
 void MidiDriver_MT32::sysEx(const byte *msg, uint16 length) {
+	if (_inTimerCallback)
+		renderPendingSamples();
 	if (msg[0] == 0xf0) {
 		_synth->playSysex(msg, length);
 	} else {
@@ -275,8 +307,48 @@ void MidiDriver_MT32::close() {
 	deleteMuntStructures();
 }
 
+void MidiDriver_MT32::setTimerCallback(void *timer_param, Common::TimerManager::TimerProc timer_proc) {
+	Common::StackLock lock(_timerMutex);
+	_clientTimerParam = timer_param;
+	_clientTimerProc = timer_proc;
+	MidiDriver_Emulated::setTimerCallback(this, timer_proc ? timerCallbackProxy : NULL);
+}
+
+void MidiDriver_MT32::timerCallbackProxy(void *param) {
+	MidiDriver_MT32 *driver = (MidiDriver_MT32 *)param;
+
+	// close() may have removed the callback on another thread meanwhile
+	Common::StackLock lock(driver->_timerMutex);
+	if (!driver->_clientTimerProc)
+		return;
+
+	driver->_inTimerCallback = true;
+	(*driver->_clientTimerProc)(driver->_clientTimerParam);
+	driver->_inTimerCallback = false;
+}
+
+int MidiDriver_MT32::readBuffer(int16 *data, const int numSamples) {
+	const int result = MidiDriver_Emulated::readBuffer(data, numSamples);
+	renderPendingSamples();
+	return result;
+}
+
 void MidiDriver_MT32::generateSamples(int16 *data, int len) {
-	_synth->render(data, len);
+	// MidiDriver_Emulated::readBuffer() asks for the samples between two
+	// timer ticks, which are only a few at the high _baseFreq we use.
+	// Collect the consecutive requests instead of rendering each of them.
+	if (_pendingLen > 0 && data != _pendingBuf + _pendingLen * 2)
+		renderPendingSamples();
+	if (_pendingLen == 0)
+		_pendingBuf = data;
+	_pendingLen += len;
+}
+
+void MidiDriver_MT32::renderPendingSamples() {
+	if (_pendingLen > 0) {
+		_synth->render(_pendingBuf, _pendingLen);
+		_pendingLen = 0;
+	}
 }
 
 uint32 MidiDriver_MT32::property(int prop, uint32 param) {
@@ -298,14 +298,7 @@ bool Partial::produceOutput(float *leftBuf, float *rightBuf, unsigned long lengt
 		return false;
 	}
 	unsigned long numGenerated = generateSamples(myBuffer, length);
-	for (unsigned int i = 0; i < numGenerated; i++) {
-		*leftBuf++ = myBuffer[i] * stereoVolume.leftVol;
-		*rightBuf++ = myBuffer[i] * stereoVolume.rightVol;
-	}
-	for (; numGenerated < length; numGenerated++) {
-		*leftBuf++ = 0.0f;
-		*rightBuf++ = 0.0f;
-	}
+	synth->sampleKernels->mixPartial(leftBuf, rightBuf, myBuffer, numGenerated, stereoVolume.leftVol, stereoVolume.rightVol);
 	return true;
 }
 
@@ -0,0 +1,482 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "mt32emu.h"
+#include "common/cpudetect.h"
+
+#ifdef SCUMMVM_HAVE_X86_SIMD
+#define MT32EMU_USE_X86_SIMD
+#include <immintrin.h>
+#endif
+#ifdef SCUMMVM_HAVE_NEON
+#define MT32EMU_USE_NEON
+#include <arm_neon.h>
+#endif
+
+namespace MT32Emu {
+
+#pragma mark -
+#pragma mark --- Scalar kernels ---
+#pragma mark -
+
+static inline Bit16s clipBit16s(Bit32s a) {
+	// Clamp values above 32767 to 32767, and values below -32768 to -32768
+	if ((a + 32768) & ~65535) {
+		return (a >> 31) ^ 32767;
+	}
+	return a;
+}
+
+static void mixPartialScalar(float *leftBuf, float *rightBuf, const Bit16s *samples, Bit32u len, float leftVol, float rightVol) {
+	while (len--) {
+		const float left = *samples * leftVol;
+		const float right = *samples * rightVol;
+		*leftBuf++ += left;
+		*rightBuf++ += right;
+		samples++;
+	}
+}
+
+static void floatToBit16sNiceScalar(Bit16s *target, const float *source, Bit32u len, float outputGain) {
+	float gain = outputGain * 16384.0f;
+	while (len--) {
+		// Since we're not shooting for accuracy here, don't worry about the rounding mode.
+		*target = clipBit16s((Bit32s)(*source * gain));
+		source++;
+		target++;
+	}
+}
+
+static void floatToBit16sPureScalar(Bit16s *target, const float *source, Bit32u len, float /*outputGain*/) {
+	while (len--) {
+		*target = clipBit16s((Bit32s)floor(*source * 8192.0f));
+		source++;
+		target++;
+	}
+}
+
+static void floatToBit16sReverbScalar(Bit16s *target, const float *source, Bit32u len, float outputGain) {
+	float gain = outputGain * 8192.0f;
+	while (len--) {
+		*target = clipBit16s((Bit32s)floor(*source * gain));
+		source++;
+		target++;
+	}
+}
+
+static void floatToBit16sGeneration1Scalar(Bit16s *target, const float *source, Bit32u len, float outputGain) {
+	float gain = outputGain * 8192.0f;
+	while (len--) {
+		*target = clipBit16s((Bit32s)floor(*source * gain));
+		*target = (*target & 0x8000) | ((*target << 1) & 0x7FFE);
+		source++;
+		target++;
+	}
+}
+
+static void floatToBit16sGeneration2Scalar(Bit16s *target, const float *source, Bit32u len, float outputGain) {
+	float gain = outputGain * 8192.0f;
+	while (len--) {
+		*target = clipBit16s((Bit32s)floor(*source * gain));
+		*target = (*target & 0x8000) | ((*target << 1) & 0x7FFE) | ((*target >> 14) & 0x0001);
+		source++;
+		target++;
+	}
+}
+
+static void mixStreamsScalar(Bit16s *stream, const Bit16s *nonReverbLeft, const Bit16s *nonReverbRight, const Bit16s *reverbDryLeft, const Bit16s *reverbDryRight, const Bit16s *reverbWetLeft, const Bit16s *reverbWetRight, Bit32u len) {
+	for (Bit32u i = 0; i < len; i++) {
+		stream[0] = clipBit16s((Bit32s)nonReverbLeft[i] + (Bit32s)reverbDryLeft[i] + (Bit32s)reverbWetLeft[i]);
+		stream[1] = clipBit16s((Bit32s)nonReverbRight[i] + (Bit32s)reverbDryRight[i] + (Bit32s)reverbWetRight[i]);
+		stream += 2;
+	}
+}
+
+static const SampleKernels s_scalarKernels = {
+	mixPartialScalar,
+	floatToBit16sNiceScalar,
+	floatToBit16sPureScalar,
+	floatToBit16sReverbScalar,
+	floatToBit16sGeneration1Scalar,
+	floatToBit16sGeneration2Scalar,
+	mixStreamsScalar,
+	"scalar"
+};
+
+/*
+ * The vectorized conversions rely on the float to integer conversion of the
+ * CPU behaving like the C++ cast does on the same CPU: on x86 values out of
+ * range (and NaNs) yield 0x80000000, on ARM they saturate. Flooring is done
+ * by truncating and subtracting one where that rounded up. Clipping to 16 bit
+ * is a saturating pack, which matches clipBit16s().
+ *
+ * The partial mix keeps the multiplication and the addition separate, so the
+ * sums are rounded exactly like in the scalar code.
+ */
+
+#ifdef MT32EMU_USE_X86_SIMD
+
+#pragma mark -
+#pragma mark --- SSE2 kernels ---
+#pragma mark -
+
+SCUMMVM_TARGET_SSE2
+static void mixPartialSSE2(float *leftBuf, float *rightBuf, const Bit16s *samples, Bit32u len, float leftVol, float rightVol) {
+	const __m128 left = _mm_set1_ps(leftVol);
+	const __m128 right = _mm_set1_ps(rightVol);
+
+	for (; len >= 8; len -= 8) {
+		const __m128i s = _mm_loadu_si128((const __m128i *)samples);
+		const __m128 s0 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16));
+		const __m128 s1 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16));
+
+		_mm_storeu_ps(leftBuf, _mm_add_ps(_mm_loadu_ps(leftBuf), _mm_mul_ps(s0, left)));
+		_mm_storeu_ps(leftBuf + 4, _mm_add_ps(_mm_loadu_ps(leftBuf + 4), _mm_mul_ps(s1, left)));
+		_mm_storeu_ps(rightBuf, _mm_add_ps(_mm_loadu_ps(rightBuf), _mm_mul_ps(s0, right)));
+		_mm_storeu_ps(rightBuf + 4, _mm_add_ps(_mm_loadu_ps(rightBuf + 4), _mm_mul_ps(s1, right)));
+
+		leftBuf += 8;
+		rightBuf += 8;
+		samples += 8;
+	}
+
+	mixPartialScalar(leftBuf, rightBuf, samples, len, leftVol, rightVol);
+}
+
+SCUMMVM_TARGET_SSE2
+static inline __m128i floorSSE2(__m128 v) {
+	const __m128i t = _mm_cvttps_epi32(v);
+	// Values out of range are left alone, the C++ cast does not floor them either.
+	const __m128i roundedUp = _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(t), v));
+	const __m128i outOfRange = _mm_cmpeq_epi32(t, _mm_set1_epi32((Bit32s)0x80000000));
+	return _mm_add_epi32(t, _mm_andnot_si128(outOfRange, roundedUp));
+}
+
+SCUMMVM_TARGET_SSE2
+static inline __m128i convertSSE2(const float *source, __m128 gain, bool roundDown) {
+	const __m128 v0 = _mm_mul_ps(_mm_loadu_ps(source), gain);
+	const __m128 v1 = _mm_mul_ps(_mm_loadu_ps(source + 4), gain);
+	if (roundDown)
+		return _mm_packs_epi32(floorSSE2(v0), floorSSE2(v1));
+	return _mm_packs_epi32(_mm_cvttps_epi32(v0), _mm_cvttps_epi32(v1));
+}
+
+SCUMMVM_TARGET_SSE2
+static void floatToBit16sNiceSSE2(Bit16s *target, const float *source, Bit32u len, float outputGain) {
+	float gain = outputGain * 16384.0f;
+	const __m128 g = _mm_set1_ps(gain);
+
+	for (; len >= 8; len -= 8) {
+		_mm_storeu_si128((__m128i *)target, convertSSE2(source, g, false));
+		source += 8;
+		target += 8;
+	}
+
+	floatToBit16sNiceScalar(target, source, len, outputGain);
+}
+
+SCUMMVM_TARGET_SSE2
+static void floatToBit16sPureSSE2(Bit16s *target, const float *source, Bit32u len, float outputGain) {
+	const __m128 g = _mm_set1_ps(8192.0f);
+
+	for (; len >= 8; len -= 8) {
+		_mm_storeu_si128((__m128i *)target, convertSSE2(source, g, true));
+		source += 8;
+		target += 8;
+	}
+
+	floatToBit16sPureScalar(target, source, len, outputGain);
+}
+
+SCUMMVM_TARGET_SSE2
+static void floatToBit16sReverbSSE2(Bit16s *target, const float *source, Bit32u len, float outputGain) {
+	float gain = outputGain * 8192.0f;
+	const __m128 g = _mm_set1_ps(gain);
+
+	for (; len >= 8; len -= 8) {
+		_mm_storeu_si128((__m128i *)target, convertSSE2(source, g, true));
+		source += 8;
+		target += 8;
+	}
+
+	floatToBit16sReverbScalar(target, source, len, outputGain);
+}
+
+SCUMMVM_TARGET_SSE2
+static void floatToBit16sGeneration1SSE2(Bit16s *target, const float *source, Bit32u len, float outputGain) {
+	float gain = outputGain * 8192.0f;
+	const __m128 g = _mm_set1_ps(gain);
+	const __m128i signMask = _mm_set1_epi16((Bit16s)0x8000);
+	const __m128i bitMask = _mm_set1_epi16(0x7FFE);
+
+	for (; len >= 8; len -= 8) {
+		const __m128i t = convertSSE2(source, g, true);
+		const __m128i r = _mm_or_si128(_mm_and_si128(t, signMask), _mm_and_si128(_mm_slli_epi16(t, 1), bitMask));
+		_mm_storeu_si128((__m128i *)target, r);
+		source += 8;
+		target += 8;
+	}
+
+	floatToBit16sGeneration1Scalar(target, source, len, outputGain);
+}
+
+SCUMMVM_TARGET_SSE2
+static void floatToBit16sGeneration2SSE2(Bit16s *target, const float *source, Bit32u len, float outputGain) {
+	float gain = outputGain * 8192.0f;
+	const __m128 g = _mm_set1_ps(gain);
+	const __m128i signMask = _mm_set1_epi16((Bit16s)0x8000);
+	const __m128i bitMask = _mm_set1_epi16(0x7FFE);
+	const __m128i lowBitMask = _mm_set1_epi16(0x0001);
+
+	for (; len >= 8; len -= 8) {
+		const __m128i t = convertSSE2(source, g, true);
+		__m128i r = _mm_or_si128(_mm_and_si128(t, signMask), _mm_and_si128(_mm_slli_epi16(t, 1), bitMask));
+		r = _mm_or_si128(r, _mm_and_si128(_mm_srli_epi16(t, 14), lowBitMask));
+		_mm_storeu_si128((__m128i *)target, r);
+		source += 8;
+		target += 8;
+	}
+
+	floatToBit16sGeneration2Scalar(target, source, len, outputGain);
+}
+
+SCUMMVM_TARGET_SSE2
+static inline __m128i sumStreamsSSE2(const Bit16s *a, const Bit16s *b, const Bit16s *c) {
+	const __m128i va = _mm_loadu_si128((const __m128i *)a);
+	const __m128i vb = _mm_loadu_si128((const __m128i *)b);
+	const __m128i vc = _mm_loadu_si128((const __m128i *)c);
+
+	// Sign extend to 32 bit, so the sum cannot overflow before clipping
+	const __m128i lo = _mm_add_epi32(_mm_add_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(va, va), 16), _mm_srai_epi32(_mm_unpacklo_epi16(vb, vb), 16)), _mm_srai_epi32(_mm_unpacklo_epi16(vc, vc), 16));
+	const __m128i hi = _mm_add_epi32(_mm_add_epi32(_mm_srai_epi32(_mm_unpackhi_epi16(va, va), 16), _mm_srai_epi32(_mm_unpackhi_epi16(vb, vb), 16)), _mm_srai_epi32(_mm_unpackhi_epi16(vc, vc), 16));
+	return _mm_packs_epi32(lo, hi);
+}
+
+SCUMMVM_TARGET_SSE2
+static void mixStreamsSSE2(Bit16s *stream, const Bit16s *nonReverbLeft, const Bit16s *nonReverbRight, const Bit16s *reverbDryLeft, const Bit16s *reverbDryRight, const Bit16s *reverbWetLeft, const Bit16s *reverbWetRight, Bit32u len) {
+	Bit32u i = 0;
+	for (; i + 8 <= len; i += 8) {
+		const __m128i left = sumStreamsSSE2(nonReverbLeft + i, reverbDryLeft + i, reverbWetLeft + i);
+		const __m128i right = sumStreamsSSE2(nonReverbRight + i, reverbDryRight + i, reverbWetRight + i);
+		_mm_storeu_si128((__m128i *)stream, _mm_unpacklo_epi16(left, right));
+		_mm_storeu_si128((__m128i *)(stream + 8), _mm_unpackhi_epi16(left, right));
+		stream += 16;
+	}
+
+	mixStreamsScalar(stream, nonReverbLeft + i, nonReverbRight + i, reverbDryLeft + i, reverbDryRight + i, reverbWetLeft + i, reverbWetRight + i, len - i);
+}
+
+static const SampleKernels s_sse2Kernels = {
+	mixPartialSSE2,
+	floatToBit16sNiceSSE2,
+	floatToBit16sPureSSE2,
+	floatToBit16sReverbSSE2,
+	floatToBit16sGeneration1SSE2,
+	floatToBit16sGeneration2SSE2,
+	mixStreamsSSE2,
+	"SSE2"
+};
+
+#endif // MT32EMU_USE_X86_SIMD
+
+#ifdef MT32EMU_USE_NEON
+
+#pragma mark -
+#pragma mark --- NEON kernels ---
+#pragma mark -
+
+static void mixPartialNEON(float *leftBuf, float *rightBuf, const Bit16s *samples, Bit32u len, float leftVol, float rightVol) {
+	const float32x4_t left = vdupq_n_f32(leftVol);
+	const float32x4_t right = vdupq_n_f32(rightVol);
+
+	for (; len >= 8; len -= 8) {
+		const int16x8_t s = vld1q_s16(samples);
+		const float32x4_t s0 = vcvtq_f32_s32(vmovl_s16(vget_low_s16(s)));
+		const float32x4_t s1 = vcvtq_f32_s32(vmovl_s16(vget_high_s16(s)));
+
+		vst1q_f32(leftBuf, vaddq_f32(vld1q_f32(leftBuf), vmulq_f32(s0, left)));
+		vst1q_f32(leftBuf + 4, vaddq_f32(vld1q_f32(leftBuf + 4), vmulq_f32(s1, left)));
+		vst1q_f32(rightBuf, vaddq_f32(vld1q_f32(rightBuf), vmulq_f32(s0, right)));
+		vst1q_f32(rightBuf + 4, vaddq_f32(vld1q_f32(rightBuf + 4), vmulq_f32(s1, right)));
+
+		leftBuf += 8;
+		rightBuf += 8;
+		samples += 8;
+	}
+
+	mixPartialScalar(leftBuf, rightBuf, samples, len, leftVol, rightVol);
+}
+
+static inline int32x4_t floorNEON(float32x4_t v) {
+	const int32x4_t t = vcvtq_s32_f32(v);
+	// Values out of range saturate, the C++ cast does not floor them either.
+	const uint32x4_t roundedUp = vcgtq_f32(vcvtq_f32_s32(t), v);
+	const uint32x4_t outOfRange = vceqq_s32(t, vdupq_n_s32((Bit32s)0x80000000));
+	return vaddq_s32(t, vreinterpretq_s32_u32(vbicq_u32(roundedUp, outOfRange)));
+}
+
+static inline int16x8_t convertNEON(const float *source, float32x4_t gain, bool roundDown) {
+	const float32x4_t v0 = vmulq_f32(vld1q_f32(source), gain);
+	const float32x4_t v1 = vmulq_f32(vld1q_f32(source + 4), gain);
+	if (roundDown)
+		return vcombine_s16(vqmovn_s32(floorNEON(v0)), vqmovn_s32(floorNEON(v1)));
+	return vcombine_s16(vqmovn_s32(vcvtq_s32_f32(v0)), vqmovn_s32(vcvtq_s32_f32(v1)));
+}
+
+static void floatToBit16sNiceNEON(Bit16s *target, const float *source, Bit32u len, float outputGain) {
+	float gain = outputGain * 16384.0f;
+	const float32x4_t g = vdupq_n_f32(gain);
+
+	for (; len >= 8; len -= 8) {
+		vst1q_s16(target, convertNEON(source, g, false));
+		source += 8;
+		target += 8;
+	}
+
+	floatToBit16sNiceScalar(target, source, len, outputGain);
+}
+
+static void floatToBit16sPureNEON(Bit16s *target, const float *source, Bit32u len, float outputGain) {
+	const float32x4_t g = vdupq_n_f32(8192.0f);
+
+	for (; len >= 8; len -= 8) {
+		vst1q_s16(target, convertNEON(source, g, true));
+		source += 8;
+		target += 8;
+	}
+
+	floatToBit16sPureScalar(target, source, len, outputGain);
+}
+
+static void floatToBit16sReverbNEON(Bit16s *target, const float *source, Bit32u len, float outputGain) {
+	float gain = outputGain * 8192.0f;
+	const float32x4_t g = vdupq_n_f32(gain);
+
+	for (; len >= 8; len -= 8) {
+		vst1q_s16(target, convertNEON(source, g, true));
+		source += 8;
+		target += 8;
+	}
+
+	floatToBit16sReverbScalar(target, source, len, outputGain);
+}
+
+static void floatToBit16sGeneration1NEON(Bit16s *target, const float *source, Bit32u len, float outputGain) {
+	float gain = outputGain * 8192.0f;
+	const float32x4_t g = vdupq_n_f32(gain);
+	const int16x8_t signMask = vdupq_n_s16((Bit16s)0x8000);
+	const int16x8_t bitMask = vdupq_n_s16(0x7FFE);
+
+	for (; len >= 8; len -= 8) {
+		const int16x8_t t = convertNEON(source, g, true);
+		vst1q_s16(target, vorrq_s16(vandq_s16(t, signMask), vandq_s16(vshlq_n_s16(t, 1), bitMask)));
+		source += 8;
+		target += 8;
+	}
+
+	floatToBit16sGeneration1Scalar(target, source, len, outputGain);
+}
+
+static void floatToBit16sGeneration2NEON(Bit16s *target, const float *source, Bit32u len, float outputGain) {
+	float gain = outputGain * 8192.0f;
+	const float32x4_t g = vdupq_n_f32(gain);
+	const int16x8_t signMask = vdupq_n_s16((Bit16s)0x8000);
+	const int16x8_t bitMask = vdupq_n_s16(0x7FFE);
+	const int16x8_t lowBitMask = vdupq_n_s16(0x0001);
+
+	for (; len >= 8; len -= 8) {
+		const int16x8_t t = convertNEON(source, g, true);
+		int16x8_t r = vorrq_s16(vandq_s16(t, signMask), vandq_s16(vshlq_n_s16(t, 1), bitMask));
+		r = vorrq_s16(r, vandq_s16(vshrq_n_s16(t, 14), lowBitMask));
+		vst1q_s16(target, r);
+		source += 8;
+		target += 8;
+	}
+
+	floatToBit16sGeneration2Scalar(target, source, len, outputGain);
+}
+
+static inline int16x8_t sumStreamsNEON(const Bit16s *a, const Bit16s *b, const Bit16s *c) {
+	const int16x8_t va = vld1q_s16(a);
+	const int16x8_t vb = vld1q_s16(b);
+	const int16x8_t vc = vld1q_s16(c);
+
+	// Widen to 32 bit, so the sum cannot overflow before clipping
+	const int32x4_t lo = vaddw_s16(vaddl_s16(vget_low_s16(va), vget_low_s16(vb)), vget_low_s16(vc));
+	const int32x4_t hi = vaddw_s16(vaddl_s16(vget_high_s16(va), vget_high_s16(vb)), vget_high_s16(vc));
+	return vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi));
+}
+
+static void mixStreamsNEON(Bit16s *stream, const Bit16s *nonReverbLeft, const Bit16s *nonReverbRight, const Bit16s *reverbDryLeft, const Bit16s *reverbDryRight, const Bit16s *reverbWetLeft, const Bit16s *reverbWetRight, Bit32u len) {
+	Bit32u i = 0;
+	for (; i + 8 <= len; i += 8) {
+		int16x8x2_t out;
+		out.val[0] = sumStreamsNEON(nonReverbLeft + i, reverbDryLeft + i, reverbWetLeft + i);
+		out.val[1] = sumStreamsNEON(nonReverbRight + i, reverbDryRight + i, reverbWetRight + i);
+		vst2q_s16(stream, out);
+		stream += 16;
+	}
+
+	mixStreamsScalar(stream, nonReverbLeft + i, nonReverbRight + i, reverbDryLeft + i, reverbDryRight + i, reverbWetLeft + i, reverbWetRight + i, len - i);
+}
+
+static const SampleKernels s_neonKernels = {
+	mixPartialNEON,
+	floatToBit16sNiceNEON,
+	floatToBit16sPureNEON,
+	floatToBit16sReverbNEON,
+	floatToBit16sGeneration1NEON,
+	floatToBit16sGeneration2NEON,
+	mixStreamsNEON,
+	"NEON"
+};
+
+#endif // MT32EMU_USE_NEON
+
+#pragma mark -
+
+static const SampleKernels *detectSampleKernels() {
+#ifdef MT32EMU_USE_X86_SIMD
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2))
+		return &s_sse2Kernels;
+#endif
+#ifdef MT32EMU_USE_NEON
+	if (Common::hasCPUFeature(Common::kCPUFeatureNEON))
+		return &s_neonKernels;
+#endif
+	return &s_scalarKernels;
+}
+
+const SampleKernels &getSampleKernels() {
+	// Detection always yields the same result, so it does not matter if
+	// two threads happen to run it at the same time.
+	static const SampleKernels *kernels = 0;
+	if (!kernels)
+		kernels = detectSampleKernels();
+	return *kernels;
+}
+
+const SampleKernels &getScalarSampleKernels() {
+	return s_scalarKernels;
+}
+
+}
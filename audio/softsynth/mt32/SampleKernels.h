@@ -0,0 +1,73 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef MT32EMU_SAMPLEKERNELS_H
+#define MT32EMU_SAMPLEKERNELS_H
+
+namespace MT32Emu {
+
+/**
+ * The per-sample loops of Synth::render(), which run over whole blocks of
+ * up to MAX_SAMPLES_PER_RUN samples. The vectorized implementations produce
+ * exactly the same output as the plain C++ ones.
+ */
+struct SampleKernels {
+	/**
+	 * Add the output of a partial to the mix buffers, scaled by its stereo
+	 * volume: leftBuf[i] += samples[i] * leftVol, same for the right side.
+	 */
+	void (*mixPartial)(float *leftBuf, float *rightBuf, const Bit16s *samples, Bit32u len, float leftVol, float rightVol);
+
+	/**
+	 * Conversions of the float mix to 16 bit samples for the different
+	 * DACInputModes, see Synth::setDACInputMode().
+	 */
+	FloatToBit16sFunc floatToBit16sNice;
+	FloatToBit16sFunc floatToBit16sPure;
+	FloatToBit16sFunc floatToBit16sReverb;
+	FloatToBit16sFunc floatToBit16sGeneration1;
+	FloatToBit16sFunc floatToBit16sGeneration2;
+
+	/**
+	 * Sum up the non-reverb, reverb dry and reverb wet streams with clipping,
+	 * and interleave them into a stereo stream.
+	 */
+	void (*mixStreams)(Bit16s *stream, const Bit16s *nonReverbLeft, const Bit16s *nonReverbRight, const Bit16s *reverbDryLeft, const Bit16s *reverbDryRight, const Bit16s *reverbWetLeft, const Bit16s *reverbWetRight, Bit32u len);
+
+	/** Name of the implementation, for debugging purposes. */
+	const char *name;
+};
+
+/**
+ * Return the fastest kernels supported by the CPU we are running on.
+ */
+const SampleKernels &getSampleKernels();
+
+/**
+ * Return the plain C++ kernels. These serve as the reference for the
+ * vectorized implementations.
+ */
+const SampleKernels &getScalarSampleKernels();
+
+}
+
+#endif
@@ -58,6 +58,8 @@ enum DACInputMode {
 	DACInputMode_GENERATION2
 };
 
+struct SampleKernels;
+
 typedef void (*FloatToBit16sFunc)(Bit16s *target, const float *source, Bit32u len, float outputGain);
 
 const Bit8u SYSEX_MANUFACTURER_ROLAND = 0x41;
@@ -298,6 +300,7 @@ private:
 	bool reverbEnabled;
 	bool reverbOverridden;
 
+	const SampleKernels *sampleKernels;
 	FloatToBit16sFunc la32FloatToBit16sFunc;
 	FloatToBit16sFunc reverbFloatToBit16sFunc;
 	float outputGain;
@@ -313,9 +316,8 @@ private:
 
 	// FIXME: We can reorganise things so that we don't need all these separate tmpBuf, tmp and prerender buffers.
 	// This should be rationalised when things have stabilised a bit (if prerender buffers don't die in the mean time).
+	// Partials add their output straight to the tmpBufMix buffers.
 
-	float tmpBufPartialLeft[MAX_SAMPLES_PER_RUN];
-	float tmpBufPartialRight[MAX_SAMPLES_PER_RUN];
 	float tmpBufMixLeft[MAX_SAMPLES_PER_RUN];
 	float tmpBufMixRight[MAX_SAMPLES_PER_RUN];
 	float tmpBufReverbOutLeft[MAX_SAMPLES_PER_RUN];
@@ -13,6 +13,7 @@ MODULE_OBJS := \
 	PartialManager.o \
 	Poly.o \
 	ROMInfo.o \
+	SampleKernels.o \
 	Synth.o \
 	TVA.o \
 	TVF.o \
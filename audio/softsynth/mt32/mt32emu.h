@@ -111,5 +111,6 @@ const unsigned int MAX_PRERENDER_SAMPLES = 1024;
 #include "Part.h"
 #include "ROMInfo.h"
 #include "Synth.h"
+#include "SampleKernels.h"
 
 #endif
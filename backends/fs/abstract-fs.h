@@ -158,6 +158,23 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Returns the time the object referred by this path was last modified,
+	 * as a number of seconds since an arbitrary, but fixed point in time.
+	 * This is used to tell whether data derived from a file is outdated.
+	 *
+	 * @return the modification time, or 0 if it is not available.
+	 */
+	virtual uint32 getModificationTime() const { return 0; }
+
+	/**
+	 * Returns the size of the file referred by this path, without opening
+	 * it. Like the modification time, it tells whether data derived from
+	 * the file is outdated.
+	 *
+	 * @return the size in bytes, or -1 if it is not available.
+	 */
+	virtual int32 getFileSize() const { return -1; }
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
@@ -25,6 +25,7 @@
 
 #include "backends/graphics/graphics.h"
 #include "backends/graphics/sdl/sdl-graphics.h"
+#include "backends/graphics/surfacesdl/surfacesdl-scalerjobs.h"
 #include "graphics/pixelformat.h"
 #include "graphics/scaler.h"
 #include "common/events.h"
@@ -230,6 +231,8 @@ protected:
 
 	ScalerProc *_scalerProc;
 	int _scalerType;
+	/** Splits the dirty rects up and scales them on several threads */
+	ScalerJobQueue *_scalerJobs;
 	int _transactionMode;
 
 	bool _screenIsLocked;
@@ -0,0 +1,196 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Needed for sysconf()
+#define FORBIDDEN_SYMBOL_EXCEPTION_unistd_h
+
+#include "common/scummsys.h"
+
+#if defined(SDL_BACKEND)
+
+#include "backends/graphics/surfacesdl/surfacesdl-scalerjobs.h"
+#include "common/textconsole.h"
+
+#if defined(POSIX) && !SDL_VERSION_ATLEAST(1, 3, 0)
+#include <unistd.h>
+#endif
+
+ScalerJobQueue::ScalerJobQueue(int threadCount)
+	: _runBands(0), _nextBand(0), _pendingBands(0), _scalerProc(0), _workerCount(0),
+	  _mutex(0), _workCond(0), _doneCond(0), _quit(false) {
+
+	if (threadCount <= 0)
+		threadCount = getDefaultThreadCount();
+	threadCount = CLIP<int>(threadCount, 1, kMaxThreads);
+
+	if (threadCount == 1)
+		return;
+
+	_mutex = SDL_CreateMutex();
+	_workCond = SDL_CreateCond();
+	_doneCond = SDL_CreateCond();
+
+	while (_workerCount < threadCount - 1) {
+		_workers[_workerCount] = SDL_CreateThread(workerThreadEntry, this);
+		if (!_workers[_workerCount]) {
+			warning("Could not create scaler thread: %s", SDL_GetError());
+			break;
+		}
+		++_workerCount;
+	}
+}
+
+ScalerJobQueue::~ScalerJobQueue() {
+	if (!_mutex)
+		return;
+
+	// Signal the workers to end, and wait for them to actually finish
+	SDL_LockMutex(_mutex);
+	_quit = true;
+	SDL_CondBroadcast(_workCond);
+	SDL_UnlockMutex(_mutex);
+
+	for (int i = 0; i < _workerCount; ++i)
+		SDL_WaitThread(_workers[i], NULL);
+
+	SDL_DestroyCond(_doneCond);
+	SDL_DestroyCond(_workCond);
+	SDL_DestroyMutex(_mutex);
+}
+
+void ScalerJobQueue::addJob(const uint8 *src, uint32 srcPitch, uint8 *dst, uint32 dstPitch, int width, int height, int scale) {
+	if (width <= 0 || height <= 0)
+		return;
+
+	// Use about two bands per thread, so a thread that is done early can
+	// help with another rect. Bands start at even rows, see the header.
+	int bandHeight = height;
+	if (_workerCount > 0) {
+		const int bandCount = (_workerCount + 1) * 2;
+		bandHeight = MAX<int>((height + bandCount - 1) / bandCount, kMinBandHeight);
+		bandHeight = (bandHeight + 1) & ~1;
+	}
+
+	Band band;
+	band.srcPitch = srcPitch;
+	band.dstPitch = dstPitch;
+	band.width = width;
+
+	for (int y = 0; y < height; y += band.height) {
+		band.src = src + y * srcPitch;
+		band.dst = dst + y * scale * dstPitch;
+		band.height = bandHeight;
+
+		// Rather make the last band a bit larger than leaving a small one,
+		// some scalers need at least two rows.
+		if (height - y < bandHeight + kMinBandHeight)
+			band.height = height - y;
+
+		_bands.push_back(band);
+	}
+}
+
+void ScalerJobQueue::run(ScalerProc *scalerProc) {
+	assert(scalerProc);
+
+	if (_workerCount == 0 || _bands.size() <= 1 || !isReentrant(scalerProc)) {
+		for (uint i = 0; i < _bands.size(); ++i) {
+			const Band &band = _bands[i];
+			scalerProc(band.src, band.srcPitch, band.dst, band.dstPitch, band.width, band.height);
+		}
+		_bands.resize(0);
+		return;
+	}
+
+	SDL_LockMutex(_mutex);
+	_scalerProc = scalerProc;
+	_runBands = _bands.size();
+	_nextBand = 0;
+	_pendingBands = _runBands;
+	SDL_CondBroadcast(_workCond);
+
+	scaleBands();
+	while (_pendingBands > 0)
+		SDL_CondWait(_doneCond, _mutex);
+
+	_runBands = 0;
+	_nextBand = 0;
+	SDL_UnlockMutex(_mutex);
+
+	// Keep the storage, there will be more bands on the next screen update
+	_bands.resize(0);
+}
+
+void ScalerJobQueue::scaleBands() {
+	while (_nextBand < _runBands) {
+		const Band band = _bands[_nextBand++];
+
+		SDL_UnlockMutex(_mutex);
+		_scalerProc(band.src, band.srcPitch, band.dst, band.dstPitch, band.width, band.height);
+		SDL_LockMutex(_mutex);
+
+		if (--_pendingBands == 0)
+			SDL_CondSignal(_doneCond);
+	}
+}
+
+void ScalerJobQueue::workerThread() {
+	SDL_LockMutex(_mutex);
+	while (true) {
+		// Wait till there is something to scale
+		while (!_quit && _nextBand >= _runBands)
+			SDL_CondWait(_workCond, _mutex);
+
+		if (_quit)
+			break;
+
+		scaleBands();
+	}
+	SDL_UnlockMutex(_mutex);
+}
+
+int SDLCALL ScalerJobQueue::workerThreadEntry(void *arg) {
+	ScalerJobQueue *queue = (ScalerJobQueue *)arg;
+	assert(queue);
+	queue->workerThread();
+	return 0;
+}
+
+bool ScalerJobQueue::isReentrant(ScalerProc *scalerProc) {
+#if defined(USE_HQ_SCALERS) && defined(USE_NASM)
+	if (scalerProc == HQ2x || scalerProc == HQ3x)
+		return false;
+#endif
+	return true;
+}
+
+int ScalerJobQueue::getDefaultThreadCount() {
+	int cpuCount = 1;
+#if SDL_VERSION_ATLEAST(1, 3, 0)
+	cpuCount = SDL_GetCPUCount();
+#elif defined(POSIX) && defined(_SC_NPROCESSORS_ONLN)
+	cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	return CLIP<int>(cpuCount, 1, kMaxThreads);
+}
+
+#endif
@@ -0,0 +1,121 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BACKENDS_GRAPHICS_SURFACESDL_SCALERJOBS_H
+#define BACKENDS_GRAPHICS_SURFACESDL_SCALERJOBS_H
+
+#include "backends/platform/sdl/sdl-sys.h"
+#include "graphics/scaler.h"
+#include "common/array.h"
+
+/**
+ * Runs a scaler over a set of rects on a small pool of worker threads.
+ *
+ * Every rect is cut into horizontal bands which are scaled independently.
+ * The scalers only read the source surface, so each band can still look at
+ * the rows just above and below it while another thread scales those. Bands
+ * always start at an even row of their rect, which keeps the scalers that
+ * process two rows at once (and the DotMatrix pattern) exactly as they are
+ * with a single call for the whole rect.
+ *
+ * The thread calling run() scales bands as well, so a queue with a thread
+ * count of one does not start any worker threads at all.
+ */
+class ScalerJobQueue {
+public:
+	/**
+	 * @param threadCount	Number of threads scaling, including the caller
+	 *						of run(). Zero uses getDefaultThreadCount().
+	 */
+	explicit ScalerJobQueue(int threadCount = 0);
+	~ScalerJobQueue();
+
+	int getThreadCount() const { return _workerCount + 1; }
+
+	/**
+	 * Queue scaling a rect.
+	 *
+	 * @param src, srcPitch		The top left source pixel and source pitch, as
+	 *							passed to the scaler
+	 * @param dst, dstPitch		The top left target pixel and target pitch
+	 * @param width, height		The size of the rect in source pixels
+	 * @param scale				The number of target rows per source row
+	 */
+	void addJob(const uint8 *src, uint32 srcPitch, uint8 *dst, uint32 dstPitch, int width, int height, int scale);
+
+	/**
+	 * Scale all queued rects and wait for the result.
+	 */
+	void run(ScalerProc *scalerProc);
+
+	/**
+	 * Whether the given scaler may run on several threads at once. This is
+	 * not the case for the assembly HQ scalers, which keep their state in
+	 * global variables.
+	 */
+	static bool isReentrant(ScalerProc *scalerProc);
+
+	/** The number of CPU cores, capped to kMaxThreads */
+	static int getDefaultThreadCount();
+
+	enum {
+		kMaxThreads = 8
+	};
+
+private:
+	enum {
+		/** Bands are never smaller than this, in source rows */
+		kMinBandHeight = 16
+	};
+
+	struct Band {
+		const uint8 *src;
+		uint8 *dst;
+		uint32 srcPitch, dstPitch;
+		int width, height;
+	};
+
+	/** Scale bands until none are left, with _mutex held on entry and exit */
+	void scaleBands();
+
+	void workerThread();
+	static int SDLCALL workerThreadEntry(void *arg);
+
+	/** Filled by addJob(), only read by the workers while run() is active */
+	Common::Array<Band> _bands;
+	/** Number of bands of the active run(), zero if there is none */
+	uint _runBands;
+	uint _nextBand;
+	uint _pendingBands;
+	ScalerProc *_scalerProc;
+
+	int _workerCount;
+	SDL_Thread *_workers[kMaxThreads];
+	SDL_mutex *_mutex;
+	/** Signalled when new bands are queued or the workers should quit */
+	SDL_cond *_workCond;
+	/** Signalled when the last band of a run() is done */
+	SDL_cond *_doneCond;
+	bool _quit;
+};
+
+#endif
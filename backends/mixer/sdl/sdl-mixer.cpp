@@ -91,14 +91,36 @@ void SdlMixerManager::init() {
 			error("SDL mixer output requires stereo output device");
 #endif
 
-		_mixer = new Audio::MixerImpl(g_system, _obtained.freq);
+		// Optionally keep the audio callback from ever blocking on the
+		// engine threads, see Audio::MixerImpl for details.
+		const bool lockFree = ConfMan.hasKey("lockfree_mixer") && ConfMan.getBool("lockfree_mixer");
+
+		_mixer = new Audio::MixerImpl(g_system, _obtained.freq, lockFree);
 		assert(_mixer);
+		_mixer->setRateConverterQuality(getRateConverterQuality());
 		_mixer->setReady(true);
 
 		startAudio();
 	}
 }
 
+Audio::RateConverterQuality SdlMixerManager::getRateConverterQuality() {
+	if (!ConfMan.hasKey("resampler"))
+		return Audio::kRateConverterLinear;
+
+	const Common::String resampler = ConfMan.get("resampler");
+	if (resampler == "sinc_low")
+		return Audio::kRateConverterSincLow;
+	else if (resampler == "sinc_medium")
+		return Audio::kRateConverterSincMedium;
+	else if (resampler == "sinc_high")
+		return Audio::kRateConverterSincHigh;
+	else if (resampler != "linear")
+		warning("Unknown resampler '%s', using linear interpolation", resampler.c_str());
+
+	return Audio::kRateConverterLinear;
+}
+
 SDL_AudioSpec SdlMixerManager::getAudioSpec(uint32 outputRate) {
 	SDL_AudioSpec desired;
 
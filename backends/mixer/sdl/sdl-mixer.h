@@ -77,6 +77,11 @@ protected:
 	 */
 	virtual SDL_AudioSpec getAudioSpec(uint32 rate);
 
+	/**
+	 * Returns the rate conversion quality selected by the user
+	 */
+	Audio::RateConverterQuality getRateConverterQuality();
+
 	/**
 	 * Starts SDL audio
 	 */
@@ -93,6 +93,57 @@ Common::String OSystem_POSIX::getDefaultConfigFileName() {
 	return configFile;
 }
 
+/**
+ * Create the directory at path, unless it exists already.
+ *
+ * @return true if there is a directory at path now
+ */
+static bool createDirectory(const Common::String &path) {
+	struct stat sb;
+
+	if (stat(path.c_str(), &sb) == -1) {
+		// The dir does not exist, or stat failed for some other reason.
+		return errno == ENOENT && mkdir(path.c_str(), 0755) == 0;
+	}
+
+	return S_ISDIR(sb.st_mode);
+}
+
+Common::String OSystem_POSIX::getDefaultCachePath() {
+	const char *home = getenv("HOME");
+
+#ifdef MACOSX
+	if (home == NULL)
+		return Common::String();
+
+	Common::String cachePath(home);
+	cachePath += "/Library/Caches";
+	if (!createDirectory(cachePath))
+		return Common::String();
+	cachePath += "/ScummVM";
+#else
+	// Follow the XDG Base Directory Specification
+	Common::String cachePath;
+	const char *cacheHome = getenv("XDG_CACHE_HOME");
+	if (cacheHome != NULL && *cacheHome == '/') {
+		cachePath = cacheHome;
+	} else if (home != NULL) {
+		cachePath = home;
+		cachePath += "/.cache";
+	} else {
+		return Common::String();
+	}
+
+	if (!createDirectory(cachePath))
+		return Common::String();
+	cachePath += "/scummvm";
+#endif
+
+	if (!createDirectory(cachePath))
+		return Common::String();
+	return cachePath;
+}
+
 Common::WriteStream *OSystem_POSIX::createLogFile() {
 	// Start out by resetting _logFilePath, so that in case
 	// of a failure, we know that no log file is open.
@@ -57,6 +57,7 @@ protected:
 	Common::String _logFilePath;
 
 	virtual Common::String getDefaultConfigFileName();
+	virtual Common::String getDefaultCachePath();
 
 	virtual Common::WriteStream *createLogFile();
 };
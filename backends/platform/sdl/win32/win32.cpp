@@ -212,6 +212,24 @@ Common::String OSystem_Win32::getDefaultConfigFileName() {
 	return configFile;
 }
 
+Common::String OSystem_Win32::getDefaultCachePath() {
+	char cachePath[MAXPATHLEN];
+
+	// Caches are not roamed with the user profile, prefer the local
+	// Application Data directory, which exists since Windows 2000
+	if (!GetEnvironmentVariable("LOCALAPPDATA", cachePath, sizeof(cachePath))
+	        && !GetEnvironmentVariable("APPDATA", cachePath, sizeof(cachePath)))
+		return Common::String();
+
+	strcat(cachePath, "\\ScummVM");
+	CreateDirectory(cachePath, NULL);
+	strcat(cachePath, "\\Cache");
+	if (!CreateDirectory(cachePath, NULL) && GetLastError() != ERROR_ALREADY_EXISTS)
+		return Common::String();
+
+	return cachePath;
+}
+
 Common::WriteStream *OSystem_Win32::createLogFile() {
 	// Start out by resetting _logFilePath, so that in case
 	// of a failure, we know that no log file is open.
@@ -49,6 +49,7 @@ protected:
 
 	virtual void setupIcon();
 	virtual Common::String getDefaultConfigFileName();
+	virtual Common::String getDefaultCachePath();
 	virtual Common::WriteStream *createLogFile();
 };
 
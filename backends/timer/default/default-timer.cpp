@@ -22,90 +22,128 @@
 #include "common/scummsys.h"
 #include "backends/timer/default/default-timer.h"
 #include "common/util.h"
+#include "common/debug.h"
 #include "common/system.h"
 
 struct TimerSlot {
 	Common::TimerManager::TimerProc callback;
 	void *refCon;
-	Common::String id;
-	uint32 interval;	// in microseconds
 
-	uint32 nextFireTime;	// in milliseconds
-	uint32 nextFireTimeMicro;	// microseconds part of nextFire
+	uint64 nextFireTime;	// in microseconds, see DefaultTimerManager::_time
+	uint64 lastFireTime;	// in microseconds, when the callback was last invoked
 
-	TimerSlot *next;
+	DefaultTimerManager::TimerStats stats;
 };
 
-void insertPrioQueue(TimerSlot *head, TimerSlot *newSlot) {
-	// The head points to a fake anchor TimerSlot; this common
-	// trick allows us to get rid of many special cases.
+DefaultTimerManager::DefaultTimerManager() :
+	_runningProc(0), _time(0), _lastMillis(0) {
+}
 
-	const uint32 nextFireTime = newSlot->nextFireTime;
-	TimerSlot *slot = head;
-	newSlot->next = 0;
+DefaultTimerManager::~DefaultTimerManager() {
+	Common::StackLock lock(_mutex);
 
-	// Insert the new slot into the sorted list of already scheduled
-	// timers in such a way that the list stays sorted...
-	while (true) {
-		assert(slot);
-		if (slot->next == 0 || nextFireTime < slot->next->nextFireTime) {
-			newSlot->next = slot->next;
-			slot->next = newSlot;
-			return;
-		}
-		slot = slot->next;
-	}
+	for (uint i = 0; i < _queue.size(); ++i)
+		delete _queue[i];
+	_queue.clear();
+}
+
+void DefaultTimerManager::updateTime() {
+	// getMillis() wraps after about 49 days, which the difference to the
+	// last call does not care about. _time does not wrap in practice. The
+	// jump on the first call does not matter either.
+	const uint32 millis = g_system->getMillis();
+	_time += (uint64)(millis - _lastMillis) * 1000;
+	_lastMillis = millis;
 }
 
+void DefaultTimerManager::siftUp(uint index) {
+	TimerSlot *slot = _queue[index];
 
-DefaultTimerManager::DefaultTimerManager() :
-	_head(0) {
+	while (index > 0) {
+		const uint parent = (index - 1) / 2;
+		if (slot->nextFireTime >= _queue[parent]->nextFireTime)
+			break;
+		_queue[index] = _queue[parent];
+		index = parent;
+	}
 
-	_head = new TimerSlot();
-	memset(_head, 0, sizeof(TimerSlot));
+	_queue[index] = slot;
 }
 
-DefaultTimerManager::~DefaultTimerManager() {
-	Common::StackLock lock(_mutex);
+void DefaultTimerManager::siftDown(uint index) {
+	TimerSlot *slot = _queue[index];
+	const uint size = _queue.size();
 
-	TimerSlot *slot = _head;
-	while (slot) {
-		TimerSlot *next = slot->next;
-		delete slot;
-		slot = next;
+	while (true) {
+		uint child = index * 2 + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size && _queue[child + 1]->nextFireTime < _queue[child]->nextFireTime)
+			++child;
+		if (_queue[child]->nextFireTime >= slot->nextFireTime)
+			break;
+		_queue[index] = _queue[child];
+		index = child;
 	}
-	_head = 0;
+
+	_queue[index] = slot;
 }
 
 void DefaultTimerManager::handler() {
-	Common::StackLock lock(_mutex);
+	// removeTimerProc() waits on this to make sure the removed callback
+	// does not run anymore. The mutex is recursive, so callbacks can
+	// still remove timers.
+	Common::StackLock handlerLock(_handlerMutex);
 
-	const uint32 curTime = g_system->getMillis();
+	_mutex.lock();
+	updateTime();
 
 	// Repeat as long as there is a TimerSlot that is scheduled to fire.
-	TimerSlot *slot = _head->next;
-	while (slot && slot->nextFireTime < curTime) {
-		// Remove the slot from the priority queue
-		_head->next = slot->next;
-
-		// Update the fire time and reinsert the TimerSlot into the priority
-		// queue.
-		assert(slot->interval > 0);
-		slot->nextFireTime += (slot->interval / 1000);
-		slot->nextFireTimeMicro += (slot->interval % 1000);
-		if (slot->nextFireTimeMicro > 1000) {
-			slot->nextFireTime += slot->nextFireTimeMicro / 1000;
-			slot->nextFireTimeMicro %= 1000;
+	while (!_queue.empty() && _time >= _queue[0]->nextFireTime) {
+		TimerSlot *slot = _queue[0];
+		TimerStats &stats = slot->stats;
+
+		// The statistics are 32 bit, late calls by more than an hour are
+		// not worth telling apart
+		const uint32 lateness = (uint32)MIN<uint64>(_time - slot->nextFireTime, 0xFFFFFFFF);
+		stats.maxLateness = MAX(stats.maxLateness, lateness);
+		if (stats.calls == 0) {
+			stats.lateness = lateness;
+		} else {
+			const uint32 period = (uint32)MIN<uint64>(_time - slot->lastFireTime, 0xFFFFFFFF);
+			const uint32 deviation = ABS((int32)(period - stats.interval));
+			stats.lateness = stats.lateness - stats.lateness / 16 + lateness / 16;
+			stats.jitter = stats.jitter - stats.jitter / 16 + deviation / 16;
 		}
-		insertPrioQueue(_head, slot);
-
-		// Invoke the timer callback
-		assert(slot->callback);
-		slot->callback(slot->refCon);
-
-		// Look at the next scheduled timer
-		slot = _head->next;
+		stats.calls++;
+		slot->lastFireTime = _time;
+
+		// Advance from the deadline rather than the current time, so late
+		// calls do not delay the following ones. A timer which fell more
+		// than one interval behind, e.g. because handler() was not called
+		// for a while, starts over from now instead of making up for all
+		// the calls it missed in one go.
+		assert(stats.interval > 0);
+		if (lateness > stats.interval)
+			slot->nextFireTime = _time + stats.interval;
+		else
+			slot->nextFireTime += stats.interval;
+		siftDown(0);
+
+		// Invoke the timer callback. The slot may be removed meanwhile, so
+		// do not touch it afterwards.
+		const TimerProc callback = slot->callback;
+		void *refCon = slot->refCon;
+		assert(callback);
+
+		_runningProc = callback;
+		_mutex.unlock();
+		callback(refCon);
+		_mutex.lock();
+		_runningProc = 0;
 	}
+
+	_mutex.unlock();
 }
 
 bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, void *refCon, const Common::String &id) {
@@ -126,49 +164,85 @@ bool DefaultTimerManager::installTimerProc(TimerProc callback, int32 interval, v
 	}
 	_callbacks[id] = callback;
 
+	updateTime();
+
 	TimerSlot *slot = new TimerSlot;
 	slot->callback = callback;
 	slot->refCon = refCon;
-	slot->id = id;
-	slot->interval = interval;
-	slot->nextFireTime = g_system->getMillis() + interval / 1000;
-	slot->nextFireTimeMicro = interval % 1000;
-	slot->next = 0;
-
-	insertPrioQueue(_head, slot);
+	slot->nextFireTime = _time + interval;
+	slot->lastFireTime = _time;
+	slot->stats.id = id;
+	slot->stats.interval = interval;
+	slot->stats.calls = 0;
+	slot->stats.lateness = 0;
+	slot->stats.maxLateness = 0;
+	slot->stats.jitter = 0;
+
+	_queue.push_back(slot);
+	siftUp(_queue.size() - 1);
 
 	return true;
 }
 
 void DefaultTimerManager::removeTimerProc(TimerProc callback) {
-	Common::StackLock lock(_mutex);
+	bool running;
+
+	{
+		Common::StackLock lock(_mutex);
+
+		uint size = 0;
+		for (uint i = 0; i < _queue.size(); ++i) {
+			TimerSlot *slot = _queue[i];
+			if (slot->callback == callback) {
+				const TimerStats &stats = slot->stats;
+				debug(2, "Timer '%s' (%u us): %u calls, lateness %u us (max. %u us), jitter %u us",
+				      stats.id.c_str(), stats.interval, stats.calls, stats.lateness, stats.maxLateness, stats.jitter);
+				delete slot;
+			} else {
+				_queue[size++] = slot;
+			}
+		}
 
-	TimerSlot *slot = _head;
+		// Restore the heap order, if anything was removed
+		if (size != _queue.size()) {
+			_queue.resize(size);
+			for (uint i = size / 2; i-- > 0; )
+				siftDown(i);
+		}
 
-	while (slot->next) {
-		if (slot->next->callback == callback) {
-			TimerSlot *next = slot->next->next;
-			delete slot->next;
-			slot->next = next;
-		} else {
-			slot = slot->next;
+		// We need to remove all names referencing the timer proc here.
+		//
+		// Else we run into troubles, when the client code removes and readds timer
+		// callbacks.
+		//
+		// Another issues occurs when one plays a game with ALSA as music driver,
+		// does RTL and starts a different engine game with ALSA as music driver.
+		// In this case the MPU401 code will add different timer procs with the
+		// same name, resulting in two different callbacks added with the same
+		// name and causing installTimerProc to error out.
+		// A good test case is running a SCUMM with ALSA output and then a KYRA
+		// game for example.
+		for (TimerSlotMap::iterator i = _callbacks.begin(), end = _callbacks.end(); i != end; ++i) {
+			if (i->_value == callback)
+				_callbacks.erase(i);
 		}
+
+		running = (_runningProc == callback);
 	}
 
-	// We need to remove all names referencing the timer proc here.
-	//
-	// Else we run into troubles, when the client code removes and readds timer
-	// callbacks.
-	//
-	// Another issues occurs when one plays a game with ALSA as music driver,
-	// does RTL and starts a different engine game with ALSA as music driver.
-	// In this case the MPU401 code will add different timer procs with the
-	// same name, resulting in two different callbacks added with the same
-	// name and causing installTimerProc to error out.
-	// A good test case is running a SCUMM with ALSA output and then a KYRA
-	// game for example.
-	for (TimerSlotMap::iterator i = _callbacks.begin(), end = _callbacks.end(); i != end; ++i) {
-		if (i->_value == callback)
-			_callbacks.erase(i);
+	// The callback must not be running anymore when this returns. Wait for
+	// handler() to finish, unless the callback is removing itself, in which
+	// case the recursive mutex is already held by this thread.
+	if (running) {
+		Common::StackLock handlerLock(_handlerMutex);
 	}
 }
+
+Common::Array<DefaultTimerManager::TimerStats> DefaultTimerManager::getStats() {
+	Common::StackLock lock(_mutex);
+
+	Common::Array<TimerStats> stats;
+	for (uint i = 0; i < _queue.size(); ++i)
+		stats.push_back(_queue[i]->stats);
+	return stats;
+}
@@ -22,6 +22,7 @@
 #ifndef BACKENDS_TIMER_DEFAULT_H
 #define BACKENDS_TIMER_DEFAULT_H
 
+#include "common/array.h"
 #include "common/str.h"
 #include "common/hash-str.h"
 #include "common/timer.h"
@@ -29,14 +30,60 @@
 
 struct TimerSlot;
 
+/**
+ * Timer manager for backends which provide a regular tick, but no timers
+ * of their own.
+ *
+ * The timers are kept in a binary heap ordered by their next deadline.
+ * Deadlines are in microseconds and advance by exactly one interval per
+ * call, so timers do not drift when ticks arrive late. Timers which fall
+ * more than one interval behind are rescheduled from the current time.
+ *
+ * The callbacks run without the timer list being locked. They can thus
+ * install and remove timers, and a slow callback does not block timers
+ * being installed from other threads.
+ */
 class DefaultTimerManager : public Common::TimerManager {
+public:
+	/**
+	 * How punctual a timer fires. Lateness is measured against the
+	 * deadline, jitter against the interval since the previous call.
+	 * The averages are smoothed over about 16 calls, all times are in
+	 * microseconds, though only as precise as OSystem::getMillis().
+	 */
+	struct TimerStats {
+		Common::String id;
+		uint32 interval;
+		uint32 calls;
+		uint32 lateness;
+		uint32 maxLateness;
+		uint32 jitter;
+	};
+
 private:
 	typedef Common::HashMap<Common::String, TimerProc, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> TimerSlotMap;
 
+	/** Protects all members but _handlerMutex */
 	Common::Mutex _mutex;
-	TimerSlot *_head;
+	/** Held by handler() while calling the callbacks */
+	Common::Mutex _handlerMutex;
+
+	/** Binary heap, the slot with the earliest deadline comes first */
+	Common::Array<TimerSlot *> _queue;
 	TimerSlotMap _callbacks;
 
+	/** The callback handler() is calling right now, if any */
+	TimerProc _runningProc;
+
+	/** Time in microseconds, continued across wraps of getMillis() */
+	uint64 _time;
+	uint32 _lastMillis;
+
+	void updateTime();
+
+	void siftUp(uint index);
+	void siftDown(uint index);
+
 public:
 	DefaultTimerManager();
 	virtual ~DefaultTimerManager();
@@ -47,6 +94,12 @@ public:
 	 * Timer callback, to be invoked at regular time intervals by the backend.
 	 */
 	void handler();
+
+	/**
+	 * Return the statistics of all installed timers. They are also printed
+	 * at debug level 2 when a timer is removed.
+	 */
+	Common::Array<TimerStats> getStats();
 };
 
 #endif
@@ -25,6 +25,10 @@
 #include "common/func.h"
 #include "common/debug.h"
 #include "common/config-manager.h"
+#include "common/endian.h"
+#include "common/stream.h"
+#include "common/system.h"
+#include "common/textconsole.h"
 
 #ifdef DYNAMIC_MODULES
 #include "common/fs.h"
@@ -300,6 +304,19 @@ bool PluginManagerUncached::loadPluginFromGameId(const Common::String &gameId) {
 			}
 		}
 	}
+
+	// Otherwise look for a plugin which listed the game the last time it
+	// was loaded. The caller still checks whether it can handle the game.
+	for (PluginList::iterator p = _allEnginePlugins.begin(); p != _allEnginePlugins.end(); ++p) {
+		const PluginCacheEntry *entry = getPluginCacheEntry(*p);
+		if (!entry)
+			continue;
+
+		for (Common::StringArray::const_iterator id = entry->gameIds.begin(); id != entry->gameIds.end(); ++id) {
+			if (id->equalsIgnoreCase(gameId))
+				return loadPluginByFileName((*p)->getFileName());
+		}
+	}
 	return false;
 }
 
@@ -317,6 +334,8 @@ bool PluginManagerUncached::loadPluginByFileName(const Common::String &filename)
 		if (Common::String((*i)->getFileName()) == filename && (*i)->loadPlugin()) {
 			addToPluginsInMemList(*i);
 			_currentPlugin = i;
+			updatePluginCache(*i);
+			flushPluginCache();
 			return true;
 		}
 	}
@@ -339,29 +358,60 @@ void PluginManagerUncached::updateConfigWithFileName(const Common::String &gameI
 
 		ConfMan.flushToDisk();
 	}
+
+	flushPluginCache();
 }
 
 void PluginManagerUncached::loadFirstPlugin() {
-	unloadPluginsExcept(PLUGIN_TYPE_ENGINE, NULL, false);
+	_detectionScan = false;
+	_detectionFileNames.clear();
+	loadPluginFrom(_allEnginePlugins.begin());
+}
 
-	// let's try to find one we can load
-	for (_currentPlugin = _allEnginePlugins.begin(); _currentPlugin != _allEnginePlugins.end(); ++_currentPlugin) {
-		if ((*_currentPlugin)->loadPlugin()) {
-			addToPluginsInMemList(*_currentPlugin);
-			break;
-		}
+void PluginManagerUncached::loadFirstPluginForDetection(const Common::FSList &fslist) {
+	_detectionScan = true;
+	_detectionFileNames.clear();
+
+	// Collect the file names the same way AdvancedMetaEngine does. Only
+	// engines which do not look into subdirectories provide their file
+	// names, so the directories do not matter.
+	for (Common::FSList::const_iterator file = fslist.begin(); file != fslist.end(); ++file) {
+		if (file->isDirectory())
+			continue;
+
+		Common::String name = file->getName();
+		if (name.lastChar() == '.')
+			name.deleteLastChar();
+		_detectionFileNames[name] = true;
 	}
+
+	loadPluginFrom(_allEnginePlugins.begin());
 }
 
 bool PluginManagerUncached::loadNextPlugin() {
+	if (_currentPlugin == _allEnginePlugins.end())
+		return false;
+
+	return loadPluginFrom(++_currentPlugin);
+}
+
+bool PluginManagerUncached::loadPluginFrom(PluginList::iterator plugin) {
 	unloadPluginsExcept(PLUGIN_TYPE_ENGINE, NULL, false);
 
-	for (++_currentPlugin; _currentPlugin != _allEnginePlugins.end(); ++_currentPlugin) {
+	// let's try to find one we can load
+	for (_currentPlugin = plugin; _currentPlugin != _allEnginePlugins.end(); ++_currentPlugin) {
+		if (_detectionScan && isPluginUselessForDetection(*_currentPlugin))
+			continue;
+
 		if ((*_currentPlugin)->loadPlugin()) {
 			addToPluginsInMemList(*_currentPlugin);
+			updatePluginCache(*_currentPlugin);
 			return true;
 		}
 	}
+
+	// We went through all plugins, store what we learned about them
+	flushPluginCache();
 	return false;	// no more in list
 }
 
@@ -446,6 +496,172 @@ void PluginManager::addToPluginsInMemList(Plugin *plugin) {
 
 #include "engines/metaengine.h"
 
+enum {
+	kPluginCacheTag = MKTAG('P', 'L', 'G', 'C'),
+	kPluginCacheVersion = 1
+};
+
+static const char *const kPluginCacheFileName = "plugins.cache";
+
+static void writeString(Common::WriteStream &stream, const Common::String &str) {
+	stream.writeUint16BE(str.size());
+	stream.writeString(str);
+}
+
+static Common::String readString(Common::ReadStream &stream) {
+	Common::String str;
+	for (uint16 size = stream.readUint16BE(); size > 0 && !stream.eos(); --size)
+		str += (char)stream.readByte();
+	return str;
+}
+
+static void writeStringArray(Common::WriteStream &stream, const Common::StringArray &array) {
+	stream.writeUint16BE(array.size());
+	for (Common::StringArray::const_iterator i = array.begin(); i != array.end(); ++i)
+		writeString(stream, *i);
+}
+
+static void readStringArray(Common::ReadStream &stream, Common::StringArray &array) {
+	array.clear();
+	for (uint16 size = stream.readUint16BE(); size > 0 && !stream.eos(); --size)
+		array.push_back(readString(stream));
+}
+
+bool PluginManagerUncached::isPluginUselessForDetection(const Plugin *plugin) {
+	const PluginCacheEntry *entry = getPluginCacheEntry(plugin);
+	if (!entry || !entry->hasDetectionFileNames)
+		return false;
+
+	for (Common::StringArray::const_iterator name = entry->detectionFileNames.begin(); name != entry->detectionFileNames.end(); ++name) {
+		if (_detectionFileNames.contains(*name))
+			return false;
+	}
+	return true;
+}
+
+const PluginManagerUncached::PluginCacheEntry *PluginManagerUncached::getPluginCacheEntry(const Plugin *plugin) {
+	if (!plugin->getFileName())
+		return 0;
+
+	if (!_pluginCacheLoaded)
+		loadPluginCache();
+
+	PluginCache::const_iterator i = _pluginCache.find(plugin->getFileName());
+	if (i == _pluginCache.end())
+		return 0;
+
+	const uint32 modificationTime = Common::FSNode(plugin->getFileName()).getModificationTime();
+	if (modificationTime == 0 || modificationTime != i->_value.modificationTime)
+		return 0;
+
+	return &i->_value;
+}
+
+void PluginManagerUncached::updatePluginCache(const Plugin *plugin) {
+	if (!plugin->getFileName() || plugin->getType() != PLUGIN_TYPE_ENGINE)
+		return;
+
+	if (getPluginCacheEntry(plugin))
+		return;
+
+	// Without a modification time we could never tell whether the entry
+	// is still valid
+	const uint32 modificationTime = Common::FSNode(plugin->getFileName()).getModificationTime();
+	if (modificationTime == 0)
+		return;
+
+	const MetaEngine &metaEngine = **(const EnginePlugin *)plugin;
+	const GameList games = metaEngine.getSupportedGames();
+
+	PluginCacheEntry &entry = _pluginCache[plugin->getFileName()];
+	entry.modificationTime = modificationTime;
+	entry.gameIds.clear();
+	for (GameList::const_iterator game = games.begin(); game != games.end(); ++game)
+		entry.gameIds.push_back(game->gameid());
+	entry.detectionFileNames.clear();
+	entry.hasDetectionFileNames = metaEngine.getDetectionFileNames(entry.detectionFileNames);
+
+	_pluginCacheModified = true;
+}
+
+void PluginManagerUncached::loadPluginCache() {
+	_pluginCacheLoaded = true;
+
+	Common::SeekableReadStream *file = g_system->createCacheReadStream(kPluginCacheFileName);
+	if (!file)
+		return;
+
+	if (file->readUint32BE() != kPluginCacheTag || file->readUint32BE() != kPluginCacheVersion) {
+		debug(3, "Plugin cache file is outdated");
+		delete file;
+		return;
+	}
+
+	PluginCache cache;
+	const uint32 count = file->readUint32BE();
+	for (uint32 i = 0; i < count && !file->err() && !file->eos(); ++i) {
+		PluginCacheEntry &entry = cache[readString(*file)];
+		entry.modificationTime = file->readUint32BE();
+		readStringArray(*file, entry.gameIds);
+		entry.hasDetectionFileNames = file->readByte() != 0;
+		readStringArray(*file, entry.detectionFileNames);
+	}
+
+	// Do not use anything from a truncated or unreadable file
+	if (file->err() || file->eos() || cache.size() != count) {
+		warning("Plugin cache file is corrupted");
+	} else {
+		// Entries added before the file could be read are more recent
+		for (PluginCache::const_iterator i = cache.begin(); i != cache.end(); ++i) {
+			if (!_pluginCache.contains(i->_key))
+				_pluginCache[i->_key] = i->_value;
+		}
+	}
+
+	delete file;
+}
+
+void PluginManagerUncached::flushPluginCache() {
+	if (!_pluginCacheModified)
+		return;
+
+	// Do not overwrite entries we have not read yet
+	if (!_pluginCacheLoaded)
+		loadPluginCache();
+
+	Common::WriteStream *file = g_system->createCacheWriteStream(kPluginCacheFileName);
+	if (!file)
+		return;
+
+	// Only keep the plugins which still exist
+	PluginList plugins;
+	for (PluginList::const_iterator p = _allEnginePlugins.begin(); p != _allEnginePlugins.end(); ++p) {
+		if ((*p)->getFileName() && _pluginCache.contains((*p)->getFileName()))
+			plugins.push_back(*p);
+	}
+
+	file->writeUint32BE(kPluginCacheTag);
+	file->writeUint32BE(kPluginCacheVersion);
+	file->writeUint32BE(plugins.size());
+
+	for (PluginList::const_iterator p = plugins.begin(); p != plugins.end(); ++p) {
+		const PluginCacheEntry &entry = _pluginCache[(*p)->getFileName()];
+		writeString(*file, (*p)->getFileName());
+		file->writeUint32BE(entry.modificationTime);
+		writeStringArray(*file, entry.gameIds);
+		file->writeByte(entry.hasDetectionFileNames ? 1 : 0);
+		writeStringArray(*file, entry.detectionFileNames);
+	}
+
+	file->finalize();
+	if (file->err())
+		warning("Could not write plugin cache file");
+	else
+		_pluginCacheModified = false;
+
+	delete file;
+}
+
 namespace Common {
 DECLARE_SINGLETON(EngineManager);
 }
@@ -518,7 +734,7 @@ GameList EngineManager::detectGames(const Common::FSList &fslist) const {
 	GameList candidates;
 	EnginePlugin::List plugins;
 	EnginePlugin::List::const_iterator iter;
-	PluginManager::instance().loadFirstPlugin();
+	PluginManager::instance().loadFirstPluginForDetection(fslist);
 	do {
 		plugins = getPlugins();
 		// Iterate over all known games and for each check if it might be
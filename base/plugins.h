@@ -25,7 +25,10 @@
 
 #include "common/array.h"
 #include "common/fs.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
 #include "common/str.h"
+#include "common/str-array.h"
 #include "backends/plugins/elf/version.h"
 
 
@@ -329,6 +332,7 @@ public:
 	// Functions used by the uncached PluginManager
 	virtual void init()	{}
 	virtual void loadFirstPlugin() {}
+	virtual void loadFirstPluginForDetection(const Common::FSList &fslist) { loadFirstPlugin(); }
 	virtual bool loadNextPlugin() { return false; }
 	virtual bool loadPluginFromGameId(const Common::String &gameId) { return false; }
 	virtual void updateConfigWithFileName(const Common::String &gameId) {}
@@ -352,12 +356,57 @@ protected:
 	PluginList _allEnginePlugins;
 	PluginList::iterator _currentPlugin;
 
-	PluginManagerUncached() {}
+	/**
+	 * What is known about an engine plugin file without loading it. The
+	 * entries are kept in the cache directory of the backend, and are
+	 * valid as long as the modification time of the plugin file is
+	 * unchanged.
+	 */
+	struct PluginCacheEntry {
+		uint32 modificationTime;
+		Common::StringArray gameIds;
+		/** Whether detectionFileNames is complete, see MetaEngine::getDetectionFileNames() */
+		bool hasDetectionFileNames;
+		Common::StringArray detectionFileNames;
+	};
+
+	typedef Common::HashMap<Common::String, PluginCacheEntry> PluginCache;
+	typedef Common::HashMap<Common::String, bool, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FileNameSet;
+
+	PluginCache _pluginCache;
+	bool _pluginCacheLoaded;
+	bool _pluginCacheModified;
+
+	/** The files passed to loadFirstPluginForDetection(), if that started the current scan */
+	FileNameSet _detectionFileNames;
+	bool _detectionScan;
+
+	PluginManagerUncached() : _pluginCacheLoaded(false), _pluginCacheModified(false), _detectionScan(false) {}
 	bool loadPluginByFileName(const Common::String &filename);
 
+	/**
+	 * Load the first loadable plugin starting at the given one. During a
+	 * detection scan, plugins which cannot detect any of the files are
+	 * skipped.
+	 */
+	bool loadPluginFrom(PluginList::iterator plugin);
+
+	/** Whether the cache tells that the plugin cannot detect any of the files */
+	bool isPluginUselessForDetection(const Plugin *plugin);
+
+	/** Returns the valid cache entry of the plugin, or 0 if there is none */
+	const PluginCacheEntry *getPluginCacheEntry(const Plugin *plugin);
+
+	/** Adds the plugin to the cache if needed, the plugin has to be loaded */
+	void updatePluginCache(const Plugin *plugin);
+
+	void loadPluginCache();
+	void flushPluginCache();
+
 public:
 	virtual void init();
 	virtual void loadFirstPlugin();
+	virtual void loadFirstPluginForDetection(const Common::FSList &fslist);
 	virtual bool loadNextPlugin();
 	virtual bool loadPluginFromGameId(const Common::String &gameId);
 	virtual void updateConfigWithFileName(const Common::String &gameId);
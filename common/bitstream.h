@@ -26,8 +26,11 @@
 #define COMMON_BITSTREAM_H
 
 #include "common/scummsys.h"
+#include "common/endian.h"
 #include "common/textconsole.h"
 #include "common/stream.h"
+#include "common/memstream.h"
+#include "common/util.h"
 
 namespace Common {
 
@@ -67,6 +70,9 @@ public:
 	/** Add a bit to the value x, making it an n+1-bit value. */
 	virtual void addBit(uint32 &x, uint32 n) = 0;
 
+	/** Are the bits handed out in the order of MSB to LSB? */
+	virtual bool isMSBFirst() const = 0;
+
 protected:
 	BitStream() {
 	}
@@ -81,67 +87,185 @@ protected:
  * For example, a bit stream with the layout parameters 32, true, false
  * for valueBits, isLE and isMSB2LSB, reads 32bit little-endian values
  * from the data stream and hands out the bits in the order of LSB to MSB.
+ *
+ * The values are read ahead into a 64 bit cache, from which getBits(),
+ * peekBits() and skip() take the bits without looping over single bits.
+ * A MemoryReadStream is read directly from its memory. Other streams are
+ * read in blocks of kBufferSize bytes, so the position of the underlying
+ * stream is generally ahead of the bit stream's position.
+ *
+ * When the type of the bit stream is known to the compiler, calling these
+ * methods does not need to go through the BitStream vtable.
  */
 template<int valueBits, bool isLE, bool isMSB2LSB>
 class BitStreamImpl : public BitStream {
 private:
+	enum {
+		kValueBytes = valueBits / 8,
+		kBufferSize = 256 ///< Size of the read buffer for streams not in memory.
+	};
+
 	SeekableReadStream *_stream; ///< The input stream.
 	bool _disposeAfterUse;       ///< Should we delete the stream on destruction?
 
-	uint32 _value;   ///< Current value.
-	uint8  _inValue; ///< Position within the current value.
+	const byte *_data; ///< The data of a MemoryReadStream, or the read buffer.
+	uint32 _dataStart; ///< Stream offset of the first byte in _data.
+	uint32 _dataEnd;   ///< Stream offset after the last byte in _data.
+	uint32 _dataPos;   ///< Stream offset of the next value to go into the cache.
+	uint32 _dataSize;  ///< Stream size, rounded down to whole values.
+
+	uint64 _cache;     ///< The read-ahead bits, with the next bit at the MSB resp. LSB.
+	uint8  _cacheBits; ///< Number of bits in the cache.
+
+	byte _buffer[kBufferSize]; ///< The read buffer for streams not in memory.
+
+	void init() {
+		if ((valueBits != 8) && (valueBits != 16) && (valueBits != 32))
+			error("BitStreamImpl: Invalid memory layout %d, %d, %d", valueBits, isLE, isMSB2LSB);
+
+		_dataSize = _stream->size() & ~((uint32) (kValueBytes - 1));
+		_dataPos  = _stream->pos();
+
+		_cache     = 0;
+		_cacheBits = 0;
+	}
 
 	/** Read a data value. */
-	inline uint32 readData() {
+	static inline uint32 readData(const byte *data) {
+		if (valueBits == 8)
+			return *data;
+
 		if (isLE) {
-			if (valueBits ==  8)
-				return _stream->readByte();
 			if (valueBits == 16)
-				return _stream->readUint16LE();
-			if (valueBits == 32)
-				return _stream->readUint32LE();
+				return READ_LE_UINT16(data);
+			return READ_LE_UINT32(data);
 		} else {
-			if (valueBits ==  8)
-				return _stream->readByte();
 			if (valueBits == 16)
-				return _stream->readUint16BE();
-			if (valueBits == 32)
-				return _stream->readUint32BE();
+				return READ_BE_UINT16(data);
+			return READ_BE_UINT32(data);
 		}
+	}
+
+	/** Read the next block of data from a stream not in memory. */
+	void fillBuffer() {
+		const uint32 n = MIN<uint32>(kBufferSize, _dataSize - _dataPos);
+
+		if ((uint32)_stream->pos() != _dataPos)
+			_stream->seek(_dataPos);
 
-		assert(false);
-		return 0;
+		if (_stream->read(_buffer, n) != n)
+			error("BitStreamImpl::fillBuffer(): Read error");
+
+		_data      = _buffer;
+		_dataStart = _dataPos;
+		_dataEnd   = _dataPos + n;
 	}
 
-	/** Read the next data value. */
-	inline void readValue() {
-		if ((size() - pos()) < valueBits)
-			error("BitStreamImpl::readValue(): End of bit stream reached");
+	/** Put as many whole data values into the cache as fit. */
+	inline void fillCache() {
+		while ((_cacheBits <= 64 - valueBits) && (_dataPos + kValueBytes <= _dataSize)) {
+			if ((_dataPos < _dataStart) || (_dataPos + kValueBytes > _dataEnd))
+				fillBuffer();
+
+			const uint64 value = readData(_data + (_dataPos - _dataStart));
+
+			if (isMSB2LSB)
+				_cache |= value << (64 - valueBits - _cacheBits);
+			else
+				_cache |= value << _cacheBits;
 
-		_value = readData();
-		if (_stream->err() || _stream->eos())
-			error("BitStreamImpl::readValue(): Read error");
+			_cacheBits += valueBits;
+			_dataPos   += kValueBytes;
+		}
+	}
 
-		// If we're reading the bits MSB first, we need to shift the value to that position
+	/** Make sure there are n bits in the cache. */
+	inline void needBits(uint8 n) {
+		if (_cacheBits >= n)
+			return;
+
+		fillCache();
+
+		if (_cacheBits < n)
+			error("BitStreamImpl: End of bit stream reached");
+	}
+
+	/** Return the next 1 to 32 bits in the cache. */
+	inline uint32 peekCache(uint8 n) const {
+		if (isMSB2LSB)
+			return (uint32) (_cache >> (64 - n));
+		else
+			return ((uint32) _cache) & (0xFFFFFFFF >> (32 - n));
+	}
+
+	/** Remove the next n bits, fewer than 64, from the cache. */
+	inline void skipCache(uint8 n) {
 		if (isMSB2LSB)
-			_value <<= 32 - valueBits;
+			_cache <<= n;
+		else
+			_cache >>= n;
+
+		_cacheBits -= n;
+	}
+
+	/** Read 1 to 32 bits, without going through the vtable. */
+	inline uint32 readBits(uint8 n) {
+		needBits(n);
+
+		const uint32 v = peekCache(n);
+		skipCache(n);
+
+		return v;
+	}
+
+	/** Continue reading at the bit position p. */
+	void seekBits(uint32 p) {
+		if (p > size())
+			error("BitStreamImpl::skip(): End of bit stream reached");
+
+		_dataPos   = (p / valueBits) * kValueBytes;
+		_cache     = 0;
+		_cacheBits = 0;
+
+		if (p % valueBits) {
+			fillCache();
+			skipCache(p % valueBits);
 		}
+	}
 
 public:
 	/** Create a bit stream using this input data stream and optionally delete it on destruction. */
 	BitStreamImpl(SeekableReadStream *stream, bool disposeAfterUse = false) :
-		_stream(stream), _disposeAfterUse(disposeAfterUse), _value(0), _inValue(0) {
+		_stream(stream), _disposeAfterUse(disposeAfterUse), _data(_buffer), _dataStart(0), _dataEnd(0) {
 
-		if ((valueBits != 8) && (valueBits != 16) && (valueBits != 32))
-			error("BitStreamImpl: Invalid memory layout %d, %d, %d", valueBits, isLE, isMSB2LSB);
+		init();
 	}
 
 	/** Create a bit stream using this input data stream. */
 	BitStreamImpl(SeekableReadStream &stream) :
-		_stream(&stream), _disposeAfterUse(false), _value(0), _inValue(0) {
+		_stream(&stream), _disposeAfterUse(false), _data(_buffer), _dataStart(0), _dataEnd(0) {
 
-		if ((valueBits != 8) && (valueBits != 16) && (valueBits != 32))
-			error("BitStreamImpl: Invalid memory layout %d, %d, %d", valueBits, isLE, isMSB2LSB);
+		init();
+	}
+
+	/**
+	 * Create a bit stream reading directly from the memory of this stream,
+	 * and optionally delete it on destruction. The position of the memory
+	 * stream is not changed by reading from the bit stream.
+	 */
+	BitStreamImpl(MemoryReadStream *stream, bool disposeAfterUse = false) :
+		_stream(stream), _disposeAfterUse(disposeAfterUse), _data(stream->getData()), _dataStart(0) {
+
+		init();
+		_dataEnd = _dataSize;
+	}
+
+	/** Create a bit stream reading directly from the memory of this stream. */
+	BitStreamImpl(MemoryReadStream &stream) :
+		_stream(&stream), _disposeAfterUse(false), _data(stream.getData()), _dataStart(0) {
+
+		init();
+		_dataEnd = _dataSize;
 	}
 
 	~BitStreamImpl() {
@@ -151,27 +275,7 @@ public:
 
 	/** Read a bit from the bit stream. */
 	uint32 getBit() {
-		// Check if we need the next value
-		if (_inValue == 0)
-			readValue();
-
-		// Get the current bit
-		int b = 0;
-		if (isMSB2LSB)
-			b = ((_value & 0x80000000) == 0) ? 0 : 1;
-		else
-			b = ((_value & 1) == 0) ? 0 : 1;
-
-		// Shift to the next bit
-		if (isMSB2LSB)
-			_value <<= 1;
-		else
-			_value >>= 1;
-
-		// Increase the position within the current value
-		_inValue = (_inValue + 1) % valueBits;
-
-		return b;
+		return readBits(1);
 	}
 
 	/**
@@ -191,35 +295,14 @@ public:
 		if (n > 32)
 			error("BitStreamImpl::getBits(): Too many bits requested to be read");
 
-		// Read the number of bits
-		uint32 v = 0;
-
-		if (isMSB2LSB) {
-			while (n-- > 0)
-				v = (v << 1) | getBit();
-		} else {
-			for (uint32 i = 0; i < n; i++)
-				v = (v >> 1) | (((uint32) getBit()) << 31);
-
-			v >>= (32 - n);
-		}
-
-		return v;
+		return readBits(n);
 	}
 
 	/** Read a bit from the bit stream, without changing the stream's position. */
 	uint32 peekBit() {
-		uint32 value   = _value;
-		uint8  inValue = _inValue;
-		uint32 curPos  = _stream->pos();
-
-		uint32 v = getBit();
-
-		_stream->seek(curPos);
-		_inValue = inValue;
-		_value   = value;
+		needBits(1);
 
-		return v;
+		return peekCache(1);
 	}
 
 	/**
@@ -228,17 +311,15 @@ public:
 	 * The bit order is the same as in getBits().
 	 */
 	uint32 peekBits(uint8 n) {
-		uint32 value   = _value;
-		uint8  inValue = _inValue;
-		uint32 curPos  = _stream->pos();
+		if (n == 0)
+			return 0;
 
-		uint32 v = getBits(n);
+		if (n > 32)
+			error("BitStreamImpl::peekBits(): Too many bits requested to be read");
 
-		_stream->seek(curPos);
-		_inValue = inValue;
-		_value   = value;
+		needBits(n);
 
-		return v;
+		return peekCache(n);
 	}
 
 	/**
@@ -257,41 +338,44 @@ public:
 			error("BitStreamImpl::addBit(): Too many bits requested to be read");
 
 		if (isMSB2LSB)
-			x = (x << 1) | getBit();
+			x = (x << 1) | readBits(1);
 		else
-			x = (x & ~(1 << n)) | (getBit() << n);
+			x = (x & ~(1 << n)) | (readBits(1) << n);
+	}
+
+	/** Are the bits handed out in the order of MSB to LSB? */
+	bool isMSBFirst() const {
+		return isMSB2LSB;
 	}
 
 	/** Rewind the bit stream back to the start. */
 	void rewind() {
-		_stream->seek(0);
-
-		_value   = 0;
-		_inValue = 0;
+		seekBits(0);
 	}
 
 	/** Skip the specified amount of bits. */
 	void skip(uint32 n) {
-		while (n-- > 0)
-			getBit();
+		// Skip bits in the cache at once
+		if (n < _cacheBits) {
+			skipCache(n);
+			return;
+		}
+
+		seekBits(pos() + n);
 	}
 
 	/** Return the stream position in bits. */
 	uint32 pos() const {
-		if (_stream->pos() == 0)
-			return 0;
-
-		uint32 p = (_inValue == 0) ? _stream->pos() : ((_stream->pos() - 1) & ~((uint32) ((valueBits >> 3) - 1)));
-		return p * 8 + _inValue;
+		return _dataPos * 8 - _cacheBits;
 	}
 
 	/** Return the stream size in bits. */
 	uint32 size() const {
-		return (_stream->size() & ~((uint32) ((valueBits >> 3) - 1))) * 8;
+		return _dataSize * 8;
 	}
 
 	bool eos() const {
-		return _stream->eos() || (pos() >= size());
+		return pos() >= size();
 	}
 };
 
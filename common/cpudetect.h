@@ -0,0 +1,68 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_CPUDETECT_H
+#define COMMON_CPUDETECT_H
+
+#include "common/scummsys.h"
+
+/**
+ * @file
+ * Runtime detection of SIMD instruction set extensions.
+ *
+ * Code using SIMD intrinsics should always provide a plain C++ fallback and
+ * only call its vectorized variants when hasCPUFeature() reports support for
+ * the required extension.
+ *
+ * On x86 the vectorized functions are compiled with a per-function target
+ * attribute (see SCUMMVM_TARGET_SSE2/SCUMMVM_TARGET_AVX2), so that the rest
+ * of the binary does not depend on the extension being present. NEON code is
+ * only built when the compiler already targets NEON.
+ */
+
+#if (defined(__i386__) || defined(__x86_64__)) && ((defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))) || defined(__clang__))
+#define SCUMMVM_HAVE_X86_SIMD
+#define SCUMMVM_TARGET_SSE2 __attribute__((target("sse2")))
+#define SCUMMVM_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define SCUMMVM_HAVE_NEON
+#endif
+
+namespace Common {
+
+enum CPUFeature {
+	kCPUFeatureSSE2,
+	kCPUFeatureAVX2,
+	kCPUFeatureNEON
+};
+
+/**
+ * Check whether the CPU we are running on supports the given feature, and
+ * whether this build is able to make use of it.
+ */
+bool hasCPUFeature(CPUFeature feature);
+
+} // End of namespace Common
+
+#endif
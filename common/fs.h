@@ -205,6 +205,23 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Returns the time the object referred by this node was last modified,
+	 * as a number of seconds since an arbitrary, but fixed point in time.
+	 * Not all backends support this.
+	 *
+	 * @return the modification time, or 0 if it is not available.
+	 */
+	uint32 getModificationTime() const;
+
+	/**
+	 * Returns the size of the file referred by this node, without opening
+	 * it. Not all backends support this.
+	 *
+	 * @return the size in bytes, or -1 if it is not available.
+	 */
+	int32 getFileSize() const;
+
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -48,6 +48,8 @@ Huffman::Huffman(uint8 maxLength, uint32 codeCount, const uint32 *codes, const u
 	_codes.resize(maxLength);
 	_symbols.resize(codeCount);
 
+	_lookupBits = MIN<uint8>(maxLength, kLookupBits);
+
 	for (uint32 i = 0; i < codeCount; i++) {
 		// The symbol. If none were specified, just assume it's identical to the code index
 		uint32 symbol = symbols ? symbols[i] : i;
@@ -66,9 +68,44 @@ Huffman::~Huffman() {
 void Huffman::setSymbols(const uint32 *symbols) {
 	for (uint32 i = 0; i < _symbols.size(); i++)
 		_symbols[i]->symbol = symbols ? *symbols++ : i;
+
+	// The lookup tables contain the symbols
+	_lookup[0].clear();
+	_lookup[1].clear();
 }
 
 uint32 Huffman::getSymbol(BitStream &bits) const {
+	// The lookup tables peek at up to the maximal code length. Close to
+	// the end of the stream, decode the last codes one bit at a time.
+	if (bits.size() - bits.pos() < _codes.size())
+		return getSymbolSlow(bits);
+
+	const LookupTable &lookup = getLookup(bits.isMSBFirst());
+
+	uint32 offset = 0;
+	uint8 tableBits = _lookupBits;
+
+	while (true) {
+		const LookupEntry &entry = lookup[offset + bits.peekBits(tableBits)];
+
+		if (entry.subtableBits == 0) {
+			if (entry.length == 0)
+				break;
+
+			bits.skip(entry.length);
+			return entry.value;
+		}
+
+		bits.skip(tableBits);
+		offset = entry.value;
+		tableBits = entry.subtableBits;
+	}
+
+	error("Unknown Huffman code");
+	return 0;
+}
+
+uint32 Huffman::getSymbolSlow(BitStream &bits) const {
 	uint32 code = 0;
 
 	for (uint32 i = 0; i < _codes.size(); i++) {
@@ -83,4 +120,105 @@ uint32 Huffman::getSymbol(BitStream &bits) const {
 	return 0;
 }
 
+const Huffman::LookupTable &Huffman::getLookup(bool isMSB2LSB) const {
+	LookupTable &lookup = _lookup[isMSB2LSB ? 1 : 0];
+
+	if (lookup.empty()) {
+		lookup.resize(1 << _lookupBits);
+		buildTable(lookup, isMSB2LSB, 0, _lookupBits, 0, 0);
+	}
+
+	return lookup;
+}
+
+/** The lowest n bits of a value. */
+static inline uint32 lowBits(uint32 value, uint32 n) {
+	return (n >= 32) ? value : (value & ((1u << n) - 1));
+}
+
+/** The value without its lowest n bits. */
+static inline uint32 highBits(uint32 value, uint32 n) {
+	return (n >= 32) ? 0 : (value >> n);
+}
+
+void Huffman::buildTable(LookupTable &lookup, bool isMSB2LSB, uint32 offset, uint8 tableBits, uint32 prefix, uint8 prefixLength) const {
+	const LookupEntry emptyEntry = { 0, 0, 0 };
+	for (uint32 i = 0; i < (1u << tableBits); i++)
+		lookup[offset + i] = emptyEntry;
+
+	// Codes continuing in a subtable. The subtable has to cover the longest
+	// of them, so remember the number of bits they have left.
+	for (uint32 length = _codes.size(); length > prefixLength + tableBits; length--) {
+		const uint32 restLength = length - prefixLength;
+
+		for (CodeList::const_iterator cCode = _codes[length - 1].begin(); cCode != _codes[length - 1].end(); ++cCode) {
+			uint32 index;
+			if (isMSB2LSB) {
+				if (highBits(cCode->code, restLength) != prefix)
+					continue;
+				index = lowBits(cCode->code, restLength) >> (restLength - tableBits);
+			} else {
+				if (lowBits(cCode->code, prefixLength) != prefix || highBits(cCode->code, length) != 0)
+					continue;
+				index = lowBits(cCode->code >> prefixLength, tableBits);
+			}
+
+			LookupEntry &entry = lookup[offset + index];
+			entry.length = tableBits;
+			entry.subtableBits = MAX<uint8>(entry.subtableBits, restLength - tableBits);
+		}
+	}
+
+	// Codes ending within this table fill all entries starting with them.
+	// Shorter codes and codes listed earlier take precedence, as they
+	// would when decoding bit by bit, so they are filled in last.
+	for (uint32 length = MIN<uint32>(_codes.size(), prefixLength + tableBits); length > prefixLength; length--) {
+		const uint32 restLength = length - prefixLength;
+		const CodeList &codes = _codes[length - 1];
+
+		for (CodeList::const_iterator cCode = codes.reverse_begin(); cCode != codes.end(); --cCode) {
+			if (highBits(cCode->code, length) != 0)
+				continue;
+
+			LookupEntry entry;
+			entry.value = cCode->symbol;
+			entry.length = restLength;
+			entry.subtableBits = 0;
+
+			if (isMSB2LSB) {
+				if (highBits(cCode->code, restLength) != prefix)
+					continue;
+
+				const uint32 first = lowBits(cCode->code, restLength) << (tableBits - restLength);
+				for (uint32 i = 0; i < (1u << (tableBits - restLength)); i++)
+					lookup[offset + first + i] = entry;
+			} else {
+				if (lowBits(cCode->code, prefixLength) != prefix)
+					continue;
+
+				const uint32 rest = cCode->code >> prefixLength;
+				for (uint32 i = 0; i < (1u << (tableBits - restLength)); i++)
+					lookup[offset + (rest | (i << restLength))] = entry;
+			}
+		}
+	}
+
+	// Build the subtables of the entries which still lead to one
+	for (uint32 i = 0; i < (1u << tableBits); i++) {
+		if (lookup[offset + i].subtableBits == 0)
+			continue;
+
+		const uint8 subtableBits = MIN<uint8>(lookup[offset + i].subtableBits, kLookupBits);
+		const uint32 subtableOffset = lookup.size();
+
+		lookup[offset + i].value = subtableOffset;
+		lookup[offset + i].subtableBits = subtableBits;
+
+		const uint32 subtablePrefix = isMSB2LSB ? ((prefix << tableBits) | i) : (prefix | (i << prefixLength));
+
+		lookup.resize(subtableOffset + (1 << subtableBits));
+		buildTable(lookup, isMSB2LSB, subtableOffset, subtableBits, subtablePrefix, prefixLength + tableBits);
+	}
+}
+
 } // End of namespace Common
@@ -36,6 +36,10 @@ class BitStream;
 /**
  * Huffman bitstream decoding
  *
+ * Symbols are decoded through lookup tables indexed by the next bits of
+ * the stream, see buildTable(). Codes longer than a table's index point
+ * to a subtable for their remaining bits.
+ *
  * Used in engines:
  *  - scumm
  */
@@ -70,11 +74,49 @@ private:
 	typedef Array<CodeList> CodeLists;
 	typedef Array<Symbol *> SymbolList;
 
+	/** An entry of a lookup table. */
+	struct LookupEntry {
+		/** The symbol, or the offset of the subtable in _lookup. */
+		uint32 value;
+		/** Number of bits of the code within this table, 0 if there is no code. */
+		uint8 length;
+		/** Number of bits indexing the subtable, 0 if the entry holds a symbol. */
+		uint8 subtableBits;
+	};
+
+	typedef Array<LookupEntry> LookupTable;
+
+	enum {
+		/** Maximum number of bits indexing a lookup table. */
+		kLookupBits = 9
+	};
+
 	/** Lists of codes and their symbols, sorted by code length. */
 	CodeLists _codes;
 
 	/** Sorted list of pointers to the symbols. */
 	SymbolList _symbols;
+
+	/**
+	 * All lookup tables for LSB2MSB and for MSB2LSB bit streams, each
+	 * starting with the primary table. They are built when first needed.
+	 */
+	mutable LookupTable _lookup[2];
+
+	/** Number of bits indexing the primary lookup table. */
+	uint8 _lookupBits;
+
+	/** Get the lookup tables for the given bit order, building them if necessary. */
+	const LookupTable &getLookup(bool isMSB2LSB) const;
+
+	/**
+	 * Build the lookup table for the codes starting with the given prefix
+	 * at the given offset, and all its subtables.
+	 */
+	void buildTable(LookupTable &lookup, bool isMSB2LSB, uint32 offset, uint8 tableBits, uint32 prefix, uint8 prefixLength) const;
+
+	/** Decode a symbol bit by bit, without the lookup tables. */
+	uint32 getSymbolSlow(BitStream &bits) const;
 };
 
 } // End of namespace Common
@@ -5,6 +5,7 @@ MODULE_OBJS := \
 	config-file.o \
 	config-manager.o \
 	coroutines.o \
+	cpudetect.o \
 	dcl.o \
 	debug.o \
 	error.o \
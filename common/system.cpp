@@ -149,6 +149,28 @@ Common::String OSystem::getDefaultConfigFileName() {
 	return "scummvm.ini";
 }
 
+Common::SeekableReadStream *OSystem::createCacheReadStream(const Common::String &name) {
+	const Common::String path = getDefaultCachePath();
+	if (path.empty())
+		return 0;
+
+	Common::FSNode file = Common::FSNode(path).getChild(name);
+	return file.exists() ? file.createReadStream() : 0;
+}
+
+Common::WriteStream *OSystem::createCacheWriteStream(const Common::String &name) {
+	const Common::String path = getDefaultCachePath();
+	if (path.empty())
+		return 0;
+
+	Common::FSNode file = Common::FSNode(path).getChild(name);
+	return file.createWriteStream();
+}
+
+Common::String OSystem::getDefaultCachePath() {
+	return Common::String();
+}
+
 Common::String OSystem::getSystemLanguage() const {
 	return "en_US";
 }
@@ -1156,6 +1156,36 @@ public:
 	 */
 	virtual Common::String getDefaultConfigFileName();
 
+	/**
+	 * Open a file in the cache of ScummVM for reading, by returning a
+	 * suitable SeekableReadStream instance. The cache holds data derived
+	 * from other files, like parsed themes, which is recreated when it is
+	 * missing. It is the callers responsiblity to delete the stream after
+	 * use.
+	 *
+	 * May return 0 to indicate that the file does not exist, or that this
+	 * port keeps no cache.
+	 *
+	 * @param name	the file name, without a path
+	 */
+	virtual Common::SeekableReadStream *createCacheReadStream(const Common::String &name);
+
+	/**
+	 * Open a file in the cache of ScummVM for writing, by returning a
+	 * suitable WriteStream instance. See createCacheReadStream().
+	 *
+	 * May return 0 to indicate that writing to the cache is not possible.
+	 */
+	virtual Common::WriteStream *createCacheWriteStream(const Common::String &name);
+
+	/**
+	 * Get the path of the directory where ScummVM keeps its cache, see
+	 * createCacheReadStream(). The directory is created if needed.
+	 * The default implementation returns an empty string, meaning that
+	 * there is no cache.
+	 */
+	virtual Common::String getDefaultCachePath();
+
 	/**
 	 * Logs a given message.
 	 *
@@ -105,6 +105,10 @@ typedef struct {
 #include "common/fs.h"
 #include "common/unzip.h"
 #include "common/memstream.h"
+#include "common/mutex.h"
+#include "common/ptr.h"
+#include "common/substream.h"
+#include "common/textconsole.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -375,9 +379,30 @@ typedef struct {
 typedef Common::HashMap<Common::String, cached_file_in_zip, Common::IgnoreCase_Hash,
 	Common::IgnoreCase_EqualTo> ZipHash;
 
+namespace Common {
+
+/**
+ * The stream of a zipfile. It is shared by the archive and all member
+ * streams opened from it, so that the members stay usable after the archive
+ * itself has been deleted. Since every user seeks the stream before reading
+ * from it, all accesses have to be done while holding the mutex.
+ */
+struct ZipSharedStream {
+	ZipSharedStream(SeekableReadStream *s) : stream(s) {}
+	~ZipSharedStream() { delete stream; }
+
+	SeekableReadStream *stream;
+	Mutex mutex;
+};
+
+typedef SharedPtr<ZipSharedStream> ZipSharedStreamPtr;
+
+} // End of namespace Common
+
 /* unz_s contain internal information about the zipfile
 */
 typedef struct {
+	Common::ZipSharedStreamPtr _sharedStream;		/* owner of _stream */
 	Common::SeekableReadStream *_stream;				/* io structore of the zipfile */
 	unz_global_info gi;				/* public global information */
 	uLong byte_before_the_zipfile;	/* byte before the zipfile, (>0 for sfx)*/
@@ -540,6 +565,7 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 
 	int err=UNZ_OK;
 
+	us->_sharedStream = Common::ZipSharedStreamPtr(new Common::ZipSharedStream(stream));
 	us->_stream = stream;
 
 	central_pos = unzlocal_SearchCentralDir(*us->_stream);
@@ -592,7 +618,6 @@ unzFile unzOpen(Common::SeekableReadStream *stream) {
 		err=UNZ_BADZIPFILE;
 
 	if (err != UNZ_OK) {
-		delete us->_stream;
 		delete us;
 		return NULL;
 	}
@@ -641,7 +666,7 @@ int unzClose(unzFile file) {
 	if (s->pfile_in_zip_read != NULL)
 		unzCloseCurrentFile(file);
 
-	delete s->_stream;
+	// The stream itself is deleted once the last member stream using it is gone
 	delete s;
 	return UNZ_OK;
 }
@@ -1122,6 +1147,33 @@ int unzOpenCurrentFile (unzFile file) {
 }
 
 
+/*
+  Get the position of the data of the current file in the zipfile stream,
+    i.e. the position after its local header.
+  return UNZ_OK if there is no problem.
+*/
+static int unzGetCurrentFileDataPosition(unzFile file, uLong *ppos) {
+	uInt iSizeVar;
+	unz_s* s;
+	uLong offset_local_extrafield;
+	uInt  size_local_extrafield;
+
+	if (file==NULL)
+		return UNZ_PARAMERROR;
+	s=(unz_s*)file;
+	if (!s->current_file_ok)
+		return UNZ_PARAMERROR;
+
+	if (unzlocal_CheckCurrentFileCoherencyHeader(s,&iSizeVar,
+				&offset_local_extrafield,&size_local_extrafield)!=UNZ_OK)
+		return UNZ_BADZIPFILE;
+
+	*ppos = s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER +
+	        iSizeVar + s->byte_before_the_zipfile;
+	return UNZ_OK;
+}
+
+
 /*
   Read bytes from the current file.
   buf contain buffer where data must be copied
@@ -1416,9 +1468,316 @@ int unzGetGlobalComment(unzFile file, char *szComment, uLong uSizeBuf) {
 
 namespace Common {
 
+/**
+ * A stored (uncompressed) member of a zipfile. The data is read directly
+ * from the zipfile stream.
+ */
+class ZipStoredStream : public SeekableSubReadStream {
+	ZipSharedStreamPtr _shared;
+
+public:
+	// The caller has to hold the mutex of the shared stream, since the
+	// SeekableSubReadStream constructor repositions it.
+	ZipStoredStream(const ZipSharedStreamPtr &shared, uint32 begin, uint32 end)
+		: SeekableSubReadStream(shared->stream, begin, end), _shared(shared) {
+	}
+
+	virtual bool seek(int32 offset, int whence = SEEK_SET) {
+		StackLock lock(_shared->mutex);
+		return SeekableSubReadStream::seek(offset, whence);
+	}
+
+	virtual uint32 read(void *dataPtr, uint32 dataSize) {
+		StackLock lock(_shared->mutex);
+
+		// Other members may have moved the zipfile stream since our last access
+		SeekableSubReadStream::seek(0, SEEK_CUR);
+		return SeekableSubReadStream::read(dataPtr, dataSize);
+	}
+};
+
+#ifdef USE_ZLIB
+
+// inflateGetDictionary() is needed to build the seek index
+#if ZLIB_VERNUM >= 0x1271
+#define ZIP_SEEK_INDEX
+#endif
+
+/**
+ * A deflated member of a zipfile, which is inflated on demand while reading.
+ *
+ * Seeking forward simply skips the data in between. Seeking backward would
+ * require to restart the decompression from the start of the member. To avoid
+ * that, an access point is remembered roughly every kSeekPointSpan bytes of
+ * output the first time the data is inflated. It holds the state needed to
+ * resume the decompression at a deflate block boundary: the position in the
+ * compressed data and the last 32 KB of output, the dictionary for the
+ * following blocks.
+ */
+class ZipInflateStream : public SeekableReadStream {
+public:
+	ZipInflateStream(const ZipSharedStreamPtr &shared, uint32 dataPos, uint32 compressedSize, uint32 size, uint32 crc)
+		: _shared(shared), _dataPos(dataPos), _compressedSize(compressedSize), _size(size), _crc(crc),
+		  _inPos(0), _pos(0), _crcData(0), _crcValid(true), _eos(false), _err(false) {
+		memset(&_zStream, 0, sizeof(_zStream));
+		_initialized = (inflateInit2(&_zStream, -MAX_WBITS) == Z_OK);
+	}
+
+	~ZipInflateStream() {
+		if (_initialized)
+			inflateEnd(&_zStream);
+
+		for (uint i = 0; i < _index.size(); ++i)
+			delete[] _index[i].window;
+	}
+
+	bool isValid() const { return _initialized; }
+
+	bool err() const { return _err; }
+	void clearErr() { _err = false; }
+	bool eos() const { return _eos; }
+
+	int32 pos() const { return _pos; }
+	int32 size() const { return _size; }
+
+	uint32 read(void *dataPtr, uint32 dataSize);
+	bool seek(int32 offset, int whence = SEEK_SET);
+
+private:
+	enum {
+		kSeekPointSpan = 1024 * 1024,
+		kWindowSize = 32768
+	};
+
+	struct SeekPoint {
+		uint32 out;     ///< position in the uncompressed data
+		uint32 in;      ///< position in the compressed data
+		int bits;       ///< number of bits of the byte before 'in' still to be used
+		byte *window;   ///< the output preceding 'out'
+		uInt windowSize;
+	};
+
+	bool fillInput();
+	uint32 inflateData(byte *dst, uint32 len);
+	void addSeekPoint(uint32 out);
+	bool restart(const SeekPoint *point);
+
+	ZipSharedStreamPtr _shared;
+	const uint32 _dataPos;
+	const uint32 _compressedSize;
+	const uint32 _size;
+	const uint32 _crc;
+
+	z_stream _zStream;
+	bool _initialized;
+	byte _inBuf[UNZ_BUFSIZE];
+	uint32 _inPos;
+
+	uint32 _pos;
+	uLong _crcData;
+	bool _crcValid;
+	bool _eos;
+	bool _err;
+
+	Array<SeekPoint> _index;
+};
+
+bool ZipInflateStream::fillInput() {
+	const uint32 len = MIN<uint32>(sizeof(_inBuf), _compressedSize - _inPos);
+	if (len == 0)
+		return false;
+
+	StackLock lock(_shared->mutex);
+
+	_shared->stream->seek(_dataPos + _inPos, SEEK_SET);
+	if (_shared->stream->read(_inBuf, len) != len)
+		return false;
+
+	_inPos += len;
+	_zStream.next_in = _inBuf;
+	_zStream.avail_in = len;
+	return true;
+}
+
+uint32 ZipInflateStream::inflateData(byte *dst, uint32 len) {
+	_zStream.next_out = dst;
+	_zStream.avail_out = len;
+
+	while (_zStream.avail_out > 0) {
+		if (_zStream.avail_in == 0 && !fillInput())
+			break;
+
+#ifdef ZIP_SEEK_INDEX
+		// Stop at every block boundary to give us a chance to add a seek point
+		const int ret = inflate(&_zStream, Z_BLOCK);
+#else
+		const int ret = inflate(&_zStream, Z_SYNC_FLUSH);
+#endif
+		if (ret == Z_STREAM_END)
+			break;
+
+		if (ret != Z_OK) {
+			warning("ZipInflateStream: Decompression error %d", ret);
+			_err = true;
+			break;
+		}
+
+#ifdef ZIP_SEEK_INDEX
+		// Bit 7 of data_type is set at the end of a block, bit 6 when it
+		// was the last one.
+		if ((_zStream.data_type & 128) && !(_zStream.data_type & 64))
+			addSeekPoint(_pos + len - _zStream.avail_out);
+#endif
+	}
+
+	const uint32 produced = len - _zStream.avail_out;
+	if (_crcValid)
+		_crcData = crc32(_crcData, dst, produced);
+	_pos += produced;
+	return produced;
+}
+
+void ZipInflateStream::addSeekPoint(uint32 out) {
+#ifdef ZIP_SEEK_INDEX
+	// Only index data we have not seen before
+	if (out < (_index.empty() ? 0 : _index.back().out) + kSeekPointSpan)
+		return;
+
+	SeekPoint point;
+	point.out = out;
+	point.in = _inPos - _zStream.avail_in;
+	point.bits = _zStream.data_type & 7;
+	point.window = new byte[kWindowSize];
+	if (inflateGetDictionary(&_zStream, point.window, &point.windowSize) != Z_OK) {
+		delete[] point.window;
+		return;
+	}
+
+	_index.push_back(point);
+#endif
+}
+
+bool ZipInflateStream::restart(const SeekPoint *point) {
+	if (inflateReset(&_zStream) != Z_OK)
+		return false;
+
+	_zStream.avail_in = 0;
+
+	if (!point) {
+		_inPos = 0;
+		_pos = 0;
+		_crcData = 0;
+		_crcValid = true;
+		return true;
+	}
+
+#ifdef ZIP_SEEK_INDEX
+	_inPos = point->in - (point->bits ? 1 : 0);
+	if (point->bits) {
+		if (!fillInput())
+			return false;
+
+		const int value = *_zStream.next_in;
+		++_zStream.next_in;
+		--_zStream.avail_in;
+		inflatePrime(&_zStream, point->bits, value >> (8 - point->bits));
+	}
+
+	if (inflateSetDictionary(&_zStream, point->window, point->windowSize) != Z_OK)
+		return false;
+#endif
+
+	_pos = point->out;
+	// Only data inflated from the start is checked
+	_crcValid = false;
+	return true;
+}
+
+uint32 ZipInflateStream::read(void *dataPtr, uint32 dataSize) {
+	if (dataSize > _size - _pos) {
+		dataSize = _size - _pos;
+		_eos = true;
+	}
+
+	const uint32 actual = inflateData((byte *)dataPtr, dataSize);
+	if (actual < dataSize) {
+		if (!_err)
+			warning("ZipInflateStream: Unexpected end of compressed data");
+		_err = true;
+		_eos = true;
+	}
+
+	if (_pos == _size && _crcValid) {
+		if (_crcData != _crc) {
+			warning("ZipInflateStream: CRC mismatch");
+			_err = true;
+		}
+
+		// Check it only once
+		_crcValid = false;
+	}
+
+	return actual;
+}
+
+bool ZipInflateStream::seek(int32 offset, int whence) {
+	int32 newPos = 0;
+	switch (whence) {
+	case SEEK_END:
+		newPos = _size + offset;
+		break;
+	case SEEK_SET:
+		newPos = offset;
+		break;
+	case SEEK_CUR:
+		newPos = _pos + offset;
+	}
+
+	if (newPos < 0 || (uint32)newPos > _size)
+		return false;
+
+	// Find the closest seek point before the target
+	const SeekPoint *point = 0;
+	for (uint i = 0; i < _index.size() && _index[i].out <= (uint32)newPos; ++i)
+		point = &_index[i];
+
+	if ((uint32)newPos < _pos) {
+		if (!restart(point)) {
+			_err = true;
+			return false;
+		}
+	} else if (point && point->out > _pos) {
+		// Jumping ahead is cheaper than inflating everything in between
+		if (!restart(point)) {
+			_err = true;
+			return false;
+		}
+	}
+
+	byte tmpBuf[4096];
+	while (!_err && _pos < (uint32)newPos) {
+		if (inflateData(tmpBuf, MIN<uint32>(sizeof(tmpBuf), newPos - _pos)) == 0)
+			_err = true;
+	}
+
+	_eos = false;
+	return !_err;
+}
+
+#endif // USE_ZLIB
+
 
 class ZipArchive : public Archive {
 	unzFile _zipFile;
+	ZipSharedStreamPtr _shared;
+
+	/**
+	 * Members smaller than this are inflated into memory at once, which is
+	 * cheaper than keeping a decompressor and its buffers around.
+	 */
+	static const uint32 kInflateToMemoryThreshold = 32 * 1024;
+
+	SeekableReadStream *inflateToMemory() const;
 
 public:
 	ZipArchive(unzFile zipFile);
@@ -1452,6 +1811,7 @@ public:
 
 ZipArchive::ZipArchive(unzFile zipFile) : _zipFile(zipFile) {
 	assert(_zipFile);
+	_shared = ((unz_s *)_zipFile)->_sharedStream;
 }
 
 ZipArchive::~ZipArchive() {
@@ -1459,6 +1819,7 @@ ZipArchive::~ZipArchive() {
 }
 
 bool ZipArchive::hasFile(const String &name) const {
+	StackLock lock(_shared->mutex);
 	return (unzLocateFile(_zipFile, name.c_str(), 2) == UNZ_OK);
 }
 
@@ -1483,9 +1844,44 @@ const ArchiveMemberPtr ZipArchive::getMember(const String &name) const {
 }
 
 SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) const {
+	StackLock lock(_shared->mutex);
+
 	if (unzLocateFile(_zipFile, name.c_str(), 2) != UNZ_OK)
 		return 0;
 
+	unz_file_info fileInfo;
+	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, NULL, 0, NULL, 0, NULL, 0) != UNZ_OK)
+		return 0;
+
+	uLong dataPos;
+	if (unzGetCurrentFileDataPosition(_zipFile, &dataPos) != UNZ_OK)
+		return 0;
+
+	// Stored members are read directly from the zipfile
+	if (fileInfo.compression_method == 0) {
+		if (fileInfo.compressed_size != fileInfo.uncompressed_size)
+			return 0;
+
+		return new ZipStoredStream(_shared, dataPos, dataPos + fileInfo.uncompressed_size);
+	}
+
+#ifdef USE_ZLIB
+	if (fileInfo.compression_method == Z_DEFLATED && fileInfo.uncompressed_size >= kInflateToMemoryThreshold) {
+		ZipInflateStream *stream = new ZipInflateStream(_shared, dataPos, fileInfo.compressed_size,
+		                                                fileInfo.uncompressed_size, fileInfo.crc);
+		if (!stream->isValid()) {
+			delete stream;
+			return 0;
+		}
+
+		return stream;
+	}
+#endif
+
+	return inflateToMemory();
+}
+
+SeekableReadStream *ZipArchive::inflateToMemory() const {
 	unz_file_info fileInfo;
 	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
 		return 0;
@@ -1507,11 +1903,6 @@ SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) co
 	}
 
 	return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
-
-	// FIXME: instead of reading all into a memory stream, we could
-	// instead create a new ZipStream class. But then we have to be
-	// careful to handle the case where the client code opens multiple
-	// files in the archive and tries to use them independently.
 }
 
 Archive *makeZipArchive(const String &name) {
@@ -22,6 +22,7 @@
 
 #include "common/debug.h"
 #include "common/util.h"
+#include "common/algorithm.h"
 #include "common/file.h"
 #include "common/macresman.h"
 #include "common/md5.h"
@@ -31,6 +32,7 @@
 #include "common/translation.h"
 
 #include "engines/advancedDetector.h"
+#include "engines/md5cache.h"
 #include "engines/obsolete.h"
 
 static GameDescriptor toGameDescriptor(const ADGameDescription &g, const PlainGameDescriptor *sg) {
@@ -166,6 +168,24 @@ GameList AdvancedMetaEngine::detectGames(const Common::FSList &fslist) const {
 	return detectedGames;
 }
 
+bool AdvancedMetaEngine::getDetectionFileNames(Common::StringArray &fileNames) const {
+	// Files in subdirectories would be missing their path, and resource
+	// forks may be stored in files of other names
+	if (_directoryGlobs)
+		return false;
+
+	if (!_fileIndexBuilt)
+		buildFileIndex();
+
+	// Games without any files are matched in every directory
+	if (!_resForkFiles.empty() || !_filelessGames.empty())
+		return false;
+
+	for (FileIndex::const_iterator i = _fileIndex.begin(); i != _fileIndex.end(); ++i)
+		fileNames.push_back(i->_value.fileName);
+	return true;
+}
+
 const ExtraGuiOptions AdvancedMetaEngine::getExtraGuiOptions(const Common::String &target) const {
 	if (!_extraGuiOptions)
 		return ExtraGuiOptions();
@@ -385,52 +405,124 @@ bool AdvancedMetaEngine::getFileProperties(const Common::FSNode &parent, const F
 	if (!allFiles.contains(fname))
 		return false;
 
+	const Common::FSNode &node = allFiles[fname];
+	if (MD5Cache.lookup(node, _md5Bytes, fileProps.md5, fileProps.size))
+		return true;
+
 	Common::File testFile;
 
-	if (!testFile.open(allFiles[fname]))
+	if (!testFile.open(node))
 		return false;
 
 	fileProps.size = (int32)testFile.size();
 	fileProps.md5 = Common::computeStreamMD5AsString(testFile, _md5Bytes);
+	MD5Cache.store(node, _md5Bytes, fileProps.md5, fileProps.size);
 	return true;
 }
 
+void AdvancedMetaEngine::buildFileIndex() const {
+	_fileIndexBuilt = true;
+
+	uint i = 0;
+	for (const byte *descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameid != 0; descPtr += _descItemSize, ++i) {
+		const ADGameDescription *g = (const ADGameDescription *)descPtr;
+
+		if (!g->filesDescriptions[0].fileName) {
+			_filelessGames.push_back(i);
+			continue;
+		}
+
+		for (const ADGameFileDescription *fileDesc = g->filesDescriptions; fileDesc->fileName; fileDesc++) {
+			FileIndexEntry &entry = _fileIndex[fileDesc->fileName];
+			if (entry.fileName.empty())
+				entry.fileName = fileDesc->fileName;
+
+			if (g->flags & ADGF_MACRESFORK) {
+				if (!entry.resForkGame) {
+					entry.resForkGame = g;
+					_resForkFiles.push_back(entry.fileName);
+				}
+			} else if (!entry.plainGame) {
+				entry.plainGame = g;
+			}
+
+			if (fileDesc == g->filesDescriptions)
+				entry.firstFileOf.push_back(i);
+		}
+	}
+}
+
+bool AdvancedMetaEngine::getIndexedFileProperties(const Common::FSNode &parent, const FileMap &allFiles, const FileIndexEntry &entry, ADFileProperties &fileProps) const {
+	// Try the game descriptions in the order in which they use the file, up
+	// to the first one for which the file was found
+	const ADGameDescription *first = entry.plainGame;
+	const ADGameDescription *second = entry.resForkGame;
+	if (!first || (second && second < first))
+		SWAP(first, second);
+
+	return getFileProperties(parent, allFiles, *first, entry.fileName, fileProps)
+	    || (second && getFileProperties(parent, allFiles, *second, entry.fileName, fileProps));
+}
+
 ADGameDescList AdvancedMetaEngine::detectGame(const Common::FSNode &parent, const FileMap &allFiles, Common::Language language, Common::Platform platform, const Common::String &extra) const {
 	ADFilePropertiesMap filesProps;
 
 	const ADGameFileDescription *fileDesc;
 	const ADGameDescription *g;
-	const byte *descPtr;
 
-	debug(3, "Starting detection in dir '%s'", parent.getPath().c_str());
+	// detectGame() runs for every engine in every scanned directory, do
+	// not build the path unless it is actually printed
+	if (gDebugLevel >= 3)
+		debug(3, "Starting detection in dir '%s'", parent.getPath().c_str());
+
+	if (!_fileIndexBuilt)
+		buildFileIndex();
 
 	// Check which files are included in some ADGameDescription *and* are present.
 	// Compute MD5s and file sizes for these files.
-	for (descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameid != 0; descPtr += _descItemSize) {
-		g = (const ADGameDescription *)descPtr;
+	for (FileMap::const_iterator file = allFiles.begin(); file != allFiles.end(); ++file) {
+		FileIndex::const_iterator entry = _fileIndex.find(file->_key);
 
-		for (fileDesc = g->filesDescriptions; fileDesc->fileName; fileDesc++) {
-			Common::String fname = fileDesc->fileName;
-			ADFileProperties tmp;
+		// Resource forks are handled below
+		if (entry == _fileIndex.end() || entry->_value.resForkGame)
+			continue;
 
-			if (filesProps.contains(fname))
-				continue;
+		ADFileProperties tmp;
+		if (getIndexedFileProperties(parent, allFiles, entry->_value, tmp)) {
+			debug(3, "> '%s': '%s'", entry->_value.fileName.c_str(), tmp.md5.c_str());
+			filesProps[entry->_value.fileName] = tmp;
+		}
+	}
 
-			if (getFileProperties(parent, allFiles, *g, fname, tmp)) {
-				debug(3, "> '%s': '%s'", fname.c_str(), tmp.md5.c_str());
-				filesProps[fname] = tmp;
-			}
+	for (uint i = 0; i < _resForkFiles.size(); ++i) {
+		const FileIndexEntry &entry = _fileIndex[_resForkFiles[i]];
+
+		ADFileProperties tmp;
+		if (getIndexedFileProperties(parent, allFiles, entry, tmp)) {
+			debug(3, "> '%s': '%s'", entry.fileName.c_str(), tmp.md5.c_str());
+			filesProps[entry.fileName] = tmp;
 		}
 	}
 
+	// Only game descriptions whose first file is present can match
+	Common::Array<uint> candidates(_filelessGames);
+	for (ADFilePropertiesMap::const_iterator file = filesProps.begin(); file != filesProps.end(); ++file) {
+		const Common::Array<uint> &games = _fileIndex[file->_key].firstFileOf;
+		for (uint i = 0; i < games.size(); ++i)
+			candidates.push_back(games[i]);
+	}
+
+	// Keep the order of the game descriptions
+	Common::sort(candidates.begin(), candidates.end());
+
 	ADGameDescList matched;
 	int maxFilesMatched = 0;
 	bool gotAnyMatchesWithAllFiles = false;
 
 	// MD5 based matching
-	uint i;
-	for (i = 0, descPtr = _gameDescriptors; ((const ADGameDescription *)descPtr)->gameid != 0; descPtr += _descItemSize, ++i) {
-		g = (const ADGameDescription *)descPtr;
+	for (uint c = 0; c < candidates.size(); ++c) {
+		const uint i = candidates[c];
+		g = (const ADGameDescription *)(_gameDescriptors + i * _descItemSize);
 		bool fileMissing = false;
 
 		// Do not even bother to look at entries which do not have matching
@@ -597,7 +689,7 @@ GameDescriptor AdvancedMetaEngine::findGame(const char *gameid) const {
 
 AdvancedMetaEngine::AdvancedMetaEngine(const void *descs, uint descItemSize, const PlainGameDescriptor *gameids, const ADExtraGuiOptionsMap *extraGuiOptions)
 	: _gameDescriptors((const byte *)descs), _descItemSize(descItemSize), _gameids(gameids),
-	  _extraGuiOptions(extraGuiOptions) {
+	  _extraGuiOptions(extraGuiOptions), _fileIndexBuilt(false) {
 
 	_md5Bytes = 5000;
 	_singleid = NULL;
@@ -262,6 +262,8 @@ public:
 
 	virtual GameList detectGames(const Common::FSList &fslist) const;
 
+	virtual bool getDetectionFileNames(Common::StringArray &fileNames) const;
+
 	virtual Common::Error createInstance(OSystem *syst, Engine **engine) const;
 
 	virtual const ExtraGuiOptions getExtraGuiOptions(const Common::String &target) const;
@@ -275,6 +277,9 @@ protected:
 	/**
 	 * An (optional) generic fallback detect function which is invoked
 	 * if the regular MD5 based detection failed to detect anything.
+	 *
+	 * @note Engines implementing this have to override
+	 * getDetectionFileNames() to return false.
 	 */
 	virtual const ADGameDescription *fallbackDetect(const FileMap &allFiles, const Common::FSList &fslist) const {
 		return 0;
@@ -324,7 +329,53 @@ protected:
 	void composeFileHashMap(FileMap &allFiles, const Common::FSList &fslist, int depth) const;
 
 	/** Get the properties (size and MD5) of this file. */
-	bool getFileProperties(const Common::FSNode &parent, const FileMap &allFiles, const ADGameDescription &game, const Common::String fname, ADFileProperties &fileProps) const;
+	virtual bool getFileProperties(const Common::FSNode &parent, const FileMap &allFiles, const ADGameDescription &game, const Common::String fname, ADFileProperties &fileProps) const;
+
+private:
+	/**
+	 * The use of a file name in the game descriptions, see buildFileIndex().
+	 */
+	struct FileIndexEntry {
+		FileIndexEntry() : plainGame(0), resForkGame(0) {}
+
+		/** The file name as spelled in the first game description using it */
+		Common::String fileName;
+
+		/** The first game descriptions using the file as a plain file and as a resource fork */
+		const ADGameDescription *plainGame, *resForkGame;
+
+		/** Indices of the game descriptions listing this file first */
+		Common::Array<uint> firstFileOf;
+	};
+
+	typedef Common::HashMap<Common::String, FileIndexEntry, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FileIndex;
+
+	/**
+	 * Indexes the game descriptions by file name. This lets detectGame()
+	 * look only at the files present in a directory, and only at the game
+	 * descriptions whose first file is present, instead of checking every
+	 * file of every game description.
+	 */
+	void buildFileIndex() const;
+
+	/**
+	 * Get the properties of a file listed in the file index, the same way
+	 * the first game description using it would.
+	 */
+	bool getIndexedFileProperties(const Common::FSNode &parent, const FileMap &allFiles, const FileIndexEntry &entry, ADFileProperties &fileProps) const;
+
+	mutable FileIndex _fileIndex;
+
+	/**
+	 * The files used as resource forks. These can be stored in files with
+	 * other names, so they always have to be checked.
+	 */
+	mutable Common::Array<Common::String> _resForkFiles;
+
+	/** Indices of the game descriptions without any files */
+	mutable Common::Array<uint> _filelessGames;
+
+	mutable bool _fileIndexBuilt;
 };
 
 #endif
@@ -174,6 +174,8 @@ public:
 	virtual void removeSaveState(const char *target, int slot) const;
 	SaveStateDescriptor querySaveMetaInfos(const char *target, int slot) const;
 
+	virtual bool getDetectionFileNames(Common::StringArray &fileNames) const { return false; }
+
 	const ADGameDescription *fallbackDetect(const FileMap &allFiles, const Common::FSList &fslist) const;
 };
 
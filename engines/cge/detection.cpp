@@ -107,6 +107,8 @@ public:
 		_singleid = "soltys";
 	}
 
+	virtual bool getDetectionFileNames(Common::StringArray &fileNames) const { return false; }
+
 	virtual const ADGameDescription *fallbackDetect(const FileMap &allFiles, const Common::FSList &fslist) const {
 		return detectGameFilebased(allFiles, fslist, CGE::fileBasedFallback);
 	}
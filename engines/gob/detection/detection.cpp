@@ -35,6 +35,8 @@ public:
 
 	virtual GameDescriptor findGame(const char *gameid) const;
 
+	virtual bool getDetectionFileNames(Common::StringArray &fileNames) const { return false; }
+
 	virtual const ADGameDescription *fallbackDetect(const FileMap &allFiles, const Common::FSList &fslist) const;
 
 	virtual const char *getName() const;
@@ -0,0 +1,188 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "engines/md5cache.h"
+
+#include "common/array.h"
+#include "common/debug.h"
+#include "common/endian.h"
+#include "common/fs.h"
+#include "common/stream.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+namespace Common {
+DECLARE_SINGLETON(DetectionMD5Cache);
+}
+
+enum {
+	kMD5CacheTag = MKTAG('D', 'M', 'D', '5'),
+	kMD5CacheVersion = 2
+};
+
+static const char *const kMD5CacheFileName = "detection-md5.cache";
+
+static void writeString(Common::WriteStream &stream, const Common::String &str) {
+	stream.writeUint16BE(str.size());
+	stream.writeString(str);
+}
+
+static Common::String readString(Common::ReadStream &stream) {
+	Common::String str;
+	for (uint16 size = stream.readUint16BE(); size > 0 && !stream.eos(); --size)
+		str += (char)stream.readByte();
+	return str;
+}
+
+DetectionMD5Cache::DetectionMD5Cache() : _loaded(false), _modified(false) {
+}
+
+bool DetectionMD5Cache::lookup(const Common::FSNode &node, uint32 length, Common::String &md5, int32 &size) {
+	if (!_loaded)
+		load();
+
+	EntryMap::const_iterator i = _entries.find(makeKey(node, length));
+	if (i == _entries.end())
+		return false;
+
+	// The modification time has only a resolution of seconds, and can be
+	// preserved by copying. Files changing their size are caught anyway.
+	const uint32 modificationTime = node.getModificationTime();
+	if (modificationTime == 0 || modificationTime != i->_value.modificationTime)
+		return false;
+	if (node.getFileSize() != i->_value.fileSize)
+		return false;
+
+	md5 = i->_value.md5;
+	size = i->_value.size;
+	return true;
+}
+
+void DetectionMD5Cache::store(const Common::FSNode &node, uint32 length, const Common::String &md5, int32 size) {
+	const uint32 modificationTime = node.getModificationTime();
+	const int32 fileSize = node.getFileSize();
+	if (modificationTime == 0 || fileSize < 0)
+		return;
+
+	if (!_loaded)
+		load();
+
+	Entry &entry = _entries[makeKey(node, length)];
+	entry.modificationTime = modificationTime;
+	entry.fileSize = fileSize;
+	entry.size = size;
+	entry.md5 = md5;
+	_modified = true;
+}
+
+Common::String DetectionMD5Cache::makeKey(const Common::FSNode &node, uint32 length) {
+	return Common::String::format("%u:", length) + node.getPath();
+}
+
+void DetectionMD5Cache::load() {
+	_loaded = true;
+
+	Common::SeekableReadStream *file = g_system->createCacheReadStream(kMD5CacheFileName);
+	if (!file)
+		return;
+
+	if (file->readUint32BE() != kMD5CacheTag || file->readUint32BE() != kMD5CacheVersion) {
+		debug(3, "Detection MD5 cache file is outdated");
+		delete file;
+		return;
+	}
+
+	const uint32 count = file->readUint32BE();
+	for (uint32 i = 0; i < count && !file->err() && !file->eos(); ++i) {
+		Entry &entry = _entries[readString(*file)];
+		entry.modificationTime = file->readUint32BE();
+		entry.fileSize = file->readSint32BE();
+		entry.size = file->readSint32BE();
+		entry.md5 = readString(*file);
+	}
+
+	// Do not use anything from a truncated or unreadable file
+	if (file->err() || file->eos() || _entries.size() != count) {
+		warning("Detection MD5 cache file is corrupted");
+		_entries.clear();
+	}
+
+	delete file;
+}
+
+void DetectionMD5Cache::prune() {
+	if (!_loaded)
+		load();
+
+	Common::Array<Common::String> staleKeys;
+
+	for (EntryMap::const_iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		// The key is the number of hashed bytes and the path, see makeKey()
+		const char *path = strchr(i->_key.c_str(), ':');
+		if (!path) {
+			staleKeys.push_back(i->_key);
+			continue;
+		}
+
+		const Common::FSNode node(path + 1);
+		if (!node.exists() || node.getModificationTime() != i->_value.modificationTime || node.getFileSize() != i->_value.fileSize)
+			staleKeys.push_back(i->_key);
+	}
+
+	for (uint i = 0; i < staleKeys.size(); ++i)
+		_entries.erase(staleKeys[i]);
+
+	if (!staleKeys.empty()) {
+		debug(3, "Dropped %u outdated entries from the detection MD5 cache", staleKeys.size());
+		_modified = true;
+	}
+}
+
+void DetectionMD5Cache::flush() {
+	if (!_modified)
+		return;
+
+	Common::WriteStream *file = g_system->createCacheWriteStream(kMD5CacheFileName);
+	if (!file)
+		return;
+
+	file->writeUint32BE(kMD5CacheTag);
+	file->writeUint32BE(kMD5CacheVersion);
+	file->writeUint32BE(_entries.size());
+
+	for (EntryMap::const_iterator i = _entries.begin(); i != _entries.end(); ++i) {
+		writeString(*file, i->_key);
+		file->writeUint32BE(i->_value.modificationTime);
+		file->writeSint32BE(i->_value.fileSize);
+		file->writeSint32BE(i->_value.size);
+		writeString(*file, i->_value.md5);
+	}
+
+	file->finalize();
+	if (file->err())
+		warning("Could not write detection MD5 cache file");
+	else
+		_modified = false;
+
+	delete file;
+}
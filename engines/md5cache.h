@@ -0,0 +1,104 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef ENGINES_MD5CACHE_H
+#define ENGINES_MD5CACHE_H
+
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/singleton.h"
+#include "common/str.h"
+
+namespace Common {
+class FSNode;
+}
+
+/**
+ * Persistent cache of the MD5 sums computed while detecting games.
+ *
+ * Detecting games in a directory hashes the beginning of every file some
+ * engine knows about, and several engines often look at the same files.
+ * Scanning a large collection again, e.g. with the mass add dialog, would
+ * hash all of them once more. The sums are therefore remembered by file
+ * path and number of hashed bytes, together with the modification time
+ * and size of the file, and are stored in the cache directory of the
+ * backend between runs.
+ *
+ * Files for which the backend cannot tell a modification time or size
+ * are never cached.
+ */
+class DetectionMD5Cache : public Common::Singleton<DetectionMD5Cache> {
+public:
+	DetectionMD5Cache();
+
+	/**
+	 * Looks up the MD5 sum of the first bytes of a file.
+	 *
+	 * @param node		The file
+	 * @param length	Number of bytes hashed, 0 for the whole file
+	 * @param md5		Receives the MD5 sum
+	 * @param size		Receives the size of the file
+	 * @return true if the sum is known for the current version of the file
+	 */
+	bool lookup(const Common::FSNode &node, uint32 length, Common::String &md5, int32 &size);
+
+	/**
+	 * Remembers the MD5 sum of the first bytes of a file, see lookup().
+	 */
+	void store(const Common::FSNode &node, uint32 length, const Common::String &md5, int32 size);
+
+	/**
+	 * Writes the cache to its file, if anything was added since it was
+	 * read.
+	 */
+	void flush();
+
+	/**
+	 * Removes the entries whose file was deleted or modified. This looks
+	 * at every file in the cache, so it is only done after a mass add.
+	 */
+	void prune();
+
+private:
+	struct Entry {
+		uint32 modificationTime;
+		int32 fileSize; ///< Size of the file when it was hashed, see FSNode::getFileSize()
+		int32 size;
+		Common::String md5;
+	};
+
+	typedef Common::HashMap<Common::String, Entry> EntryMap;
+
+	static Common::String makeKey(const Common::FSNode &node, uint32 length);
+
+	void load();
+
+	EntryMap _entries;
+	bool _loaded;
+	bool _modified;
+};
+
+/** Shortcut for accessing the detection MD5 cache. */
+#define MD5Cache DetectionMD5Cache::instance()
+
+#endif
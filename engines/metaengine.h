@@ -25,6 +25,7 @@
 #include "common/scummsys.h"
 #include "common/error.h"
 #include "common/array.h"
+#include "common/str-array.h"
 
 #include "engines/game.h"
 #include "engines/savestate.h"
@@ -80,6 +81,20 @@ public:
 	 */
 	virtual GameList detectGames(const Common::FSList &fslist) const = 0;
 
+	/**
+	 * Returns the names of all files detectGames() can detect a game by.
+	 * The uncached plugin manager remembers them, and does not even load
+	 * the plugin for a directory which contains none of these files. An
+	 * engine which may detect games by any other means, e.g. by looking
+	 * into subdirectories or through a fallback detector, must not
+	 * provide a list.
+	 *
+	 * @param fileNames	the list to add the names to, they are compared
+	 *					case-insensitively
+	 * @return true if the list is complete, false if there is none
+	 */
+	virtual bool getDetectionFileNames(Common::StringArray &fileNames) const { return false; }
+
 	/**
 	 * Tries to instantiate an engine instance based on the settings of
 	 * the currently active ConfMan target. That is, the MetaEngine should
@@ -29,6 +29,7 @@
 #include "sci/resource.h"
 #include "sci/engine/state.h"
 #include "sci/engine/kernel.h"
+#include "sci/engine/pathfinding.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/savegame.h"
 #include "sci/engine/gc.h"
@@ -92,8 +93,10 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("opcodes",			WRAP_METHOD(Console, cmdOpcodes));
 	DCmd_Register("selector",			WRAP_METHOD(Console, cmdSelector));
 	DCmd_Register("selectors",			WRAP_METHOD(Console, cmdSelectors));
+	DCmd_Register("selector_cache",		WRAP_METHOD(Console, cmdSelectorCache));
 	DCmd_Register("functions",			WRAP_METHOD(Console, cmdKernelFunctions));
 	DCmd_Register("class_table",		WRAP_METHOD(Console, cmdClassTable));
+	DCmd_Register("avoidpath_bench",	WRAP_METHOD(Console, cmdAvoidPathBench));
 	// Parser
 	DCmd_Register("suffixes",			WRAP_METHOD(Console, cmdSuffixes));
 	DCmd_Register("parse_grammar",		WRAP_METHOD(Console, cmdParseGrammar));
@@ -112,6 +115,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	DCmd_Register("list",				WRAP_METHOD(Console, cmdList));
 	DCmd_Register("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
 	DCmd_Register("verify_scripts",		WRAP_METHOD(Console, cmdVerifyScripts));
+	DCmd_Register("resource_cache",		WRAP_METHOD(Console, cmdResourceCache));
 	// Game
 	DCmd_Register("save_game",			WRAP_METHOD(Console, cmdSaveGame));
 	DCmd_Register("restore_game",		WRAP_METHOD(Console, cmdRestoreGame));
@@ -328,8 +332,10 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf(" opcodes - Lists the opcode names\n");
 	DebugPrintf(" selectors - Lists the selector names\n");
 	DebugPrintf(" selector - Attempts to find the requested selector by name\n");
+	DebugPrintf(" selector_cache - Shows the hit rate of the selector lookup cache, or turns it on or off\n");
 	DebugPrintf(" functions - Lists the kernel functions\n");
 	DebugPrintf(" class_table - Shows the available classes\n");
+	DebugPrintf(" avoidpath_bench - Measures and verifies the pathfinding on the polygons of the last kAvoidPath call\n");
 	DebugPrintf("\n");
 	DebugPrintf("Parser:\n");
 	DebugPrintf(" suffixes - Lists the vocabulary suffixes\n");
@@ -350,6 +356,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	DebugPrintf(" list - Lists all the resources of a given type\n");
 	DebugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
 	DebugPrintf(" verify_scripts - Performs sanity checks on SCI1.1-SCI2.1 game scripts (e.g. if they're up to 64KB in total)\n");
+	DebugPrintf(" resource_cache - Shows the memory usage and hit rate of the resource cache\n");
 	DebugPrintf("\n");
 	DebugPrintf("Game:\n");
 	DebugPrintf(" save_game - Saves the current game state to the hard disk\n");
@@ -582,6 +589,38 @@ bool Console::cmdSelectors(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdSelectorCache(int argc, const char **argv) {
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "reset") && strcmp(argv[1], "on") && strcmp(argv[1], "off"))) {
+		DebugPrintf("Shows the hit rate of the selector lookup cache.\n");
+		DebugPrintf("Usage: %s [reset|on|off]\n", argv[0]);
+		DebugPrintf("The cache can be turned off to compare the speed of the VM without it.\n");
+		return true;
+	}
+
+	SelectorLookupCache &cache = _engine->_gamestate->_segMan->getSelectorLookupCache();
+
+	if (argc == 2) {
+		if (!strcmp(argv[1], "reset")) {
+			cache.resetStats();
+			DebugPrintf("Selector cache statistics reset\n");
+		} else {
+			cache.setEnabled(!strcmp(argv[1], "on"));
+			cache.resetStats();
+			DebugPrintf("Selector cache turned %s\n", argv[1]);
+		}
+		return true;
+	}
+
+	const uint32 lookups = cache.getHits() + cache.getMisses();
+
+	DebugPrintf("Selector cache is %s\n", cache.isEnabled() ? "on" : "off");
+	DebugPrintf("Lookups: %u, hits: %u (%.1f%%), misses: %u\n", lookups, cache.getHits(),
+				lookups ? cache.getHits() * 100.0 / lookups : 0.0, cache.getMisses());
+	DebugPrintf("Invalidations (script loads and unloads): %u\n", cache.getInvalidations());
+
+	return true;
+}
+
 bool Console::cmdKernelFunctions(int argc, const char **argv) {
 	DebugPrintf("Kernel function names in numeric order:\n");
 	for (uint seeker = 0; seeker <  _engine->getKernel()->getKernelNamesSize(); seeker++) {
@@ -791,6 +830,34 @@ bool Console::cmdResourceTypes(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceCache(int argc, const char **argv) {
+	if (argc > 2 || (argc == 2 && strcmp(argv[1], "reset"))) {
+		DebugPrintf("Shows the memory usage and hit rate of the resource cache.\n");
+		DebugPrintf("Usage: %s [reset]\n", argv[0]);
+		DebugPrintf("The budget can be set with the resource_cache_size config key (in KB).\n");
+		return true;
+	}
+
+	ResourceManager *resMan = _engine->getResMan();
+
+	if (argc == 2) {
+		resMan->resetCacheStats();
+		DebugPrintf("Resource cache statistics reset\n");
+		return true;
+	}
+
+	const ResourceCacheStats &stats = resMan->getCacheStats();
+	const uint32 lookups = stats.hits + stats.misses;
+
+	DebugPrintf("Budget: %d KB\n", resMan->getMaxMemory() / 1024);
+	DebugPrintf("Under LRU control: %d KB, locked: %d KB\n", resMan->getLRUMemory() / 1024, resMan->getLockedMemory() / 1024);
+	DebugPrintf("Lookups: %u, hits: %u (%.1f%%), misses: %u\n", lookups, stats.hits,
+				lookups ? stats.hits * 100.0 / lookups : 0.0, stats.misses);
+	DebugPrintf("Evictions: %u, reloads: %u (%u KB)\n", stats.evictions, stats.reloads, stats.bytesReloaded / 1024);
+
+	return true;
+}
+
 bool Console::cmdHexgrep(int argc, const char **argv) {
 	if (argc < 4) {
 		DebugPrintf("Searches some resources for a particular sequence of bytes, represented as decimal or hexadecimal numbers.\n");
@@ -1255,6 +1322,21 @@ bool Console::cmdClassTable(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdAvoidPathBench(int argc, const char **argv) {
+	int iterations = 1;
+
+	if (argc > 2 || (argc == 2 && (iterations = atoi(argv[1])) <= 0)) {
+		DebugPrintf("Finds paths between a grid of points on the polygons of the last kAvoidPath call,\n");
+		DebugPrintf("using the reference A* search and the optimized one with and without\n");
+		DebugPrintf("visibility cache. Shows the time taken and checks that the paths are the same.\n");
+		DebugPrintf("Usage: %s [iterations]\n", argv[0]);
+		return true;
+	}
+
+	benchmarkAvoidPath(_engine->_gamestate, this, iterations);
+	return true;
+}
+
 bool Console::cmdSentenceFragments(int argc, const char **argv) {
 	DebugPrintf("Sentence fragments (used to build Parse trees)\n");
 
@@ -24,6 +24,8 @@
 #include "sci/engine/state.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/kernel.h"
+#include "sci/engine/pathfinding.h"
+#include "sci/console.h"
 #include "sci/graphics/paint16.h"
 #include "sci/graphics/palette.h"
 #include "sci/graphics/screen.h"
@@ -111,10 +113,28 @@ struct Vertex {
 	// Previous vertex in shortest path
 	Vertex *path_prev;
 
+	// A* open and closed set membership
+	bool inOpenSet;
+	bool inClosedSet;
+
+	// Order in which the vertex was added to the open set
+	uint32 openOrder;
+
+	// Position in the vertex index
+	int index;
+
+	// Position in the cached visibility graph, -1 if not cached
+	int cacheIndex;
+
 public:
 	Vertex(const Common::Point &p) : v(p) {
 		costG = HUGE_DISTANCE;
 		path_prev = NULL;
+		inOpenSet = false;
+		inClosedSet = false;
+		openOrder = 0;
+		index = -1;
+		cacheIndex = -1;
 	}
 };
 
@@ -250,6 +270,15 @@ struct PathfindingState {
 	// Total number of vertices
 	int vertices;
 
+	// Cached visibility graph of the polygons, without start and end point
+	PathfindingCache::Entry *visibility;
+
+	// Vertices of the cached visibility graph, by cache index
+	Common::Array<Vertex *> cachedVertices;
+
+	// Vertices not in the cached visibility graph, in vertex index order
+	Common::Array<Vertex *> uncachedVertices;
+
 	// Point to prepend and append to final path
 	Common::Point *_prependPoint;
 	Common::Point *_appendPoint;
@@ -264,6 +293,7 @@ struct PathfindingState {
 		_prependPoint = NULL;
 		_appendPoint = NULL;
 		vertices = 0;
+		visibility = NULL;
 	}
 
 	~PathfindingState() {
@@ -660,7 +690,48 @@ static int inside(const Common::Point &p, Vertex *vertex) {
 }
 
 /**
- * Returns a list of all vertices that are visible from a particular vertex.
+ * Determines whether a vertex is visible from another one, i.e. whether the
+ * line between them does not intersect any polygon.
+ * @param s				the pathfinding state
+ * @param vertex_cur	the vertex to look from
+ * @param vertex		the vertex to check
+ * @return true if vertex is visible from vertex_cur
+ */
+static bool is_visible(PathfindingState *s, Vertex *vertex_cur, Vertex *vertex) {
+	// Make sure we don't intersect a polygon locally at the vertices
+	if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
+		return false;
+
+	// Check for intersecting edges
+	for (int j = 0; j < s->vertices; j++) {
+		Vertex *edge = s->vertex_index[j];
+		if (VERTEX_HAS_EDGES(edge)) {
+			if (between(vertex_cur->v, vertex->v, edge->v)) {
+				// If we hit a vertex, make sure we can pass through it without intersecting its polygon
+				if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
+					return false;
+
+				// This edge won't properly intersect, so we continue
+				continue;
+			}
+
+			if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Returns a list of all vertices that are visible from a particular vertex,
+ * in reverse vertex index order.
+ *
+ * Between the vertices of the polygons, the result is taken from the
+ * visibility cache. Adding the start and end point to the polygons, even
+ * when they split an edge, does not change whether two of the original
+ * vertices can see each other, so only the uncached vertices need to be
+ * checked.
  * @param s				the pathfinding state
  * @param vertex_cur	the vertex
  * @return list of vertices that are visible from vert
@@ -668,34 +739,47 @@ static int inside(const Common::Point &p, Vertex *vertex) {
 static VertexList *visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
 	VertexList *visVerts = new VertexList();
 
-	for (int i = 0; i < s->vertices; i++) {
-		Vertex *vertex = s->vertex_index[i];
+	if (!s->visibility || vertex_cur->cacheIndex == -1) {
+		for (int i = 0; i < s->vertices; i++) {
+			Vertex *vertex = s->vertex_index[i];
 
-		// Make sure we don't intersect a polygon locally at the vertices
-		if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
-			continue;
+			if (is_visible(s, vertex_cur, vertex))
+				visVerts->push_front(vertex);
+		}
 
-		// Check for intersecting edges
-		int j;
-		for (j = 0; j < s->vertices; j++) {
-			Vertex *edge = s->vertex_index[j];
-			if (VERTEX_HAS_EDGES(edge)) {
-				if (between(vertex_cur->v, vertex->v, edge->v)) {
-					// If we hit a vertex, make sure we can pass through it without intersecting its polygon
-					if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
-						break;
+		return visVerts;
+	}
 
-					// This edge won't properly intersect, so we continue
-					continue;
-				}
+	Common::Array<uint16> &cached = s->visibility->visible[vertex_cur->cacheIndex];
 
-				if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
-					break;
-			}
+	if (!s->visibility->computed[vertex_cur->cacheIndex]) {
+		for (int i = 0; i < s->vertices; i++) {
+			Vertex *vertex = s->vertex_index[i];
+
+			if (vertex->cacheIndex != -1 && is_visible(s, vertex_cur, vertex))
+				cached.push_back(vertex->cacheIndex);
+		}
+
+		s->visibility->computed[vertex_cur->cacheIndex] = true;
+	}
+
+	// Merge the uncached vertices in, keeping the vertex index order
+	uint j = 0;
+
+	for (uint i = 0; i < cached.size(); i++) {
+		Vertex *vertex = s->cachedVertices[cached[i]];
+
+		for (; j < s->uncachedVertices.size() && s->uncachedVertices[j]->index < vertex->index; j++) {
+			if (is_visible(s, vertex_cur, s->uncachedVertices[j]))
+				visVerts->push_front(s->uncachedVertices[j]);
 		}
 
-		if (j == s->vertices)
-			visVerts->push_front(vertex);
+		visVerts->push_front(vertex);
+	}
+
+	for (; j < s->uncachedVertices.size(); j++) {
+		if (is_visible(s, vertex_cur, s->uncachedVertices[j]))
+			visVerts->push_front(s->uncachedVertices[j]);
 	}
 
 	return visVerts;
@@ -1186,39 +1270,75 @@ static void change_polygons_opt_0(PathfindingState *s) {
 }
 
 /**
- * Converts the SCI input data for pathfinding
+ * Stores the vertices of a polygon list in an array: for every polygon
+ * optionally its type, then the number of vertices and their coordinates.
+ * Parameters: (const PolygonList &) polygons: The polygons
+ *             (Common::Array<int16> &) geometry: The array to fill
+ *             (bool) withTypes: Whether to include the polygon types
+ * Returns   : (int) The total number of vertices
+ */
+static int encode_polygons(const PolygonList &polygons, Common::Array<int16> &geometry, bool withTypes) {
+	int count = 0;
+
+	geometry.clear();
+
+	for (PolygonList::const_iterator it = polygons.begin(); it != polygons.end(); ++it) {
+		Polygon *polygon = *it;
+		Vertex *vertex;
+
+		if (withTypes)
+			geometry.push_back(polygon->type);
+
+		const uint sizePos = geometry.size();
+		geometry.push_back(0);
+
+		CLIST_FOREACH(vertex, &polygon->vertices) {
+			geometry.push_back(vertex->v.x);
+			geometry.push_back(vertex->v.y);
+			geometry[sizePos]++;
+			count++;
+		}
+	}
+
+	return count;
+}
+
+/**
+ * Recreates a polygon list stored by encode_polygons() with types
+ * Parameters: (const Common::Array<int16> &) geometry: The stored polygons
+ *             (PolygonList &) polygons: The list to add the polygons to
+ */
+static void decode_polygons(const Common::Array<int16> &geometry, PolygonList &polygons) {
+	uint pos = 0;
+
+	while (pos + 2 <= geometry.size()) {
+		Polygon *polygon = new Polygon(geometry[pos++]);
+		const int size = geometry[pos++];
+
+		for (int i = 0; i < size; i++, pos += 2)
+			polygon->vertices.insertAtEnd(new Vertex(Common::Point(geometry[pos], geometry[pos + 1])));
+
+		polygons.push_back(polygon);
+	}
+}
+
+/**
+ * Prepares the pathfinding state for a set of polygons
  * Parameters: (EngineState *) s: The game state
- *             (reg_t) poly_list: Polygon list
+ *             (const PolygonList &) polygons: The polygons, ownership is
+ *                                   transferred to the pathfinding state
  *             (Common::Point) start: The start point
  *             (Common::Point) end: The end point
  *             (int) opt: Optimization level (0, 1 or 2)
+ *             (PathfindingCache *) cache: The visibility cache to use, or NULL
  * Returns   : (PathfindingState *) On success a newly allocated pathfinding state,
  *                            NULL otherwise
  */
-static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Common::Point start, Common::Point end, int width, int height, int opt) {
-	SegManager *segMan = s->_segMan;
+static PathfindingState *create_pathfinding_state(EngineState *s, const PolygonList &polygons, Common::Point start, Common::Point end, int width, int height, int opt, PathfindingCache *cache) {
 	Polygon *polygon;
-	int count = 0;
 	PathfindingState *pf_s = new PathfindingState(width, height);
 
-	// Convert all polygons
-	if (poly_list.getSegment()) {
-		List *list = s->_segMan->lookupList(poly_list);
-		Node *node = s->_segMan->lookupNode(list->first);
-
-		while (node) {
-			// The node value might be null, in which case there's no polygon to parse.
-			// Happens in LB2 floppy - refer to bug #3041232
-			polygon = !node->value.isNull() ? convert_polygon(s, node->value) : NULL;
-
-			if (polygon) {
-				pf_s->polygons.push_back(polygon);
-				count += readSelectorValue(segMan, node->value, SELECTOR(size));
-			}
-
-			node = s->_segMan->lookupNode(node->succ);
-		}
-	}
+	pf_s->polygons = polygons;
 
 	if (opt == 0)
 		change_polygons_opt_0(pf_s);
@@ -1276,6 +1396,24 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 		}
 	}
 
+	// Look up the visibility graph of the remaining polygons
+	if (cache) {
+		Common::Array<int16> geometry;
+		const int count = encode_polygons(pf_s->polygons, geometry, false);
+
+		pf_s->visibility = cache->lookup(geometry, count);
+		pf_s->cachedVertices.reserve(count);
+
+		for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it) {
+			Vertex *vertex;
+
+			CLIST_FOREACH(vertex, &(*it)->vertices) {
+				vertex->cacheIndex = pf_s->cachedVertices.size();
+				pf_s->cachedVertices.push_back(vertex);
+			}
+		}
+	}
+
 	// Merge start and end points into polygon set
 	pf_s->vertex_start = merge_point(pf_s, *new_start);
 	pf_s->vertex_end = merge_point(pf_s, *new_end);
@@ -1284,7 +1422,12 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 	delete new_end;
 
 	// Allocate and build vertex index
-	pf_s->vertex_index = (Vertex**)malloc(sizeof(Vertex *) * (count + 2));
+	int count = 0;
+
+	for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it)
+		count += (*it)->vertices.size();
+
+	pf_s->vertex_index = (Vertex**)malloc(sizeof(Vertex *) * count);
 
 	count = 0;
 
@@ -1293,7 +1436,11 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 		Vertex *vertex;
 
 		CLIST_FOREACH(vertex, &polygon->vertices) {
+			vertex->index = count;
 			pf_s->vertex_index[count++] = vertex;
+
+			if (vertex->cacheIndex == -1)
+				pf_s->uncachedVertices.push_back(vertex);
 		}
 	}
 
@@ -1302,6 +1449,173 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 	return pf_s;
 }
 
+/**
+ * Converts the SCI input data for pathfinding
+ * Parameters: (EngineState *) s: The game state
+ *             (reg_t) poly_list: Polygon list
+ *             (Common::Point) start: The start point
+ *             (Common::Point) end: The end point
+ *             (int) opt: Optimization level (0, 1 or 2)
+ * Returns   : (PathfindingState *) On success a newly allocated pathfinding state,
+ *                            NULL otherwise
+ */
+static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Common::Point start, Common::Point end, int width, int height, int opt) {
+	PolygonList polygons;
+
+	// Convert all polygons
+	if (poly_list.getSegment()) {
+		List *list = s->_segMan->lookupList(poly_list);
+		Node *node = s->_segMan->lookupNode(list->first);
+
+		while (node) {
+			// The node value might be null, in which case there's no polygon to parse.
+			// Happens in LB2 floppy - refer to bug #3041232
+			Polygon *polygon = !node->value.isNull() ? convert_polygon(s, node->value) : NULL;
+
+			if (polygon)
+				polygons.push_back(polygon);
+
+			node = s->_segMan->lookupNode(node->succ);
+		}
+	}
+
+	if (!s->_pathfindingCache)
+		s->_pathfindingCache = new PathfindingCache();
+
+	PathfindingCache *cache = s->_pathfindingCache;
+
+	// Remember the input for the "avoidpath_bench" debugger command
+	encode_polygons(polygons, cache->_lastInput, true);
+	cache->_lastWidth = width;
+	cache->_lastHeight = height;
+	cache->_lastOpt = opt;
+
+	return create_pathfinding_state(s, polygons, start, end, width, height, opt, cache);
+}
+
+/**
+ * Computes the cost of travelling between two visible vertices
+ * Parameters: (PathfindingState *) s: The pathfinding state
+ *             (Vertex *) from, to: The vertices
+ *             (bool) borderPenalty: Whether to penalize the screen border
+ * Returns   : (uint32) The cost
+ */
+static uint32 travel_cost(PathfindingState *s, Vertex *from, Vertex *to, bool borderPenalty) {
+	uint32 dist = (uint32)sqrt((float)from->v.sqrDist(to->v));
+
+	// When travelling to a vertex on the screen edge, we
+	// add a penalty score to make this path less appealing.
+	// NOTE: If an obstacle has only one vertex on a screen edge,
+	// later SSCI pathfinders will treat that vertex like any
+	// other, while we apply a penalty to paths traversing it.
+	// This difference might lead to problems, but none are
+	// known at the time of writing.
+	if (borderPenalty && s->pointOnScreenBorder(to->v))
+		dist += 10000;
+
+	return dist;
+}
+
+/**
+ * Whether travelling to the screen border is penalized in AStar.
+ */
+static bool use_border_penalty() {
+	// WORKAROUND: This check fails in QFG1VGA, room 81 (bug report #3568452).
+	// However, it is needed in other SCI1.1 games, such as LB2. Therefore, we
+	// add this workaround for that scene in QFG1VGA, until our algorithm matches
+	// better what SSCI is doing. With this workaround, QFG1VGA no longer freezes
+	// in that scene.
+	return !(g_sci->getGameId() == GID_QFG1VGA &&
+			 g_sci->getEngineState()->currentRoomNumber() == 81);
+}
+
+/**
+ * The open set of AStar, a binary heap ordered by F cost. A vertex is added
+ * again whenever its cost decreases; the outdated entries are skipped when
+ * they come up. Between vertices with the same cost, the one that was added
+ * to the open set last comes first. This is the order in which the original
+ * list based implementation picked them, so the resulting paths are the same.
+ */
+class OpenSet {
+public:
+	struct Entry {
+		uint32 costF;
+		uint32 order;
+		Vertex *vertex;
+	};
+
+	OpenSet() : _nextOrder(0) {}
+
+	bool empty() const { return _heap.empty(); }
+
+	void push(Vertex *vertex) {
+		if (!vertex->inOpenSet) {
+			vertex->inOpenSet = true;
+			vertex->openOrder = _nextOrder++;
+		}
+
+		Entry entry;
+		entry.costF = vertex->costF;
+		entry.order = vertex->openOrder;
+		entry.vertex = vertex;
+
+		uint pos = _heap.size();
+		_heap.push_back(entry);
+
+		while (pos > 0 && before(entry, _heap[(pos - 1) / 2])) {
+			_heap[pos] = _heap[(pos - 1) / 2];
+			pos = (pos - 1) / 2;
+		}
+
+		_heap[pos] = entry;
+	}
+
+	/**
+	 * Removes the vertex with the lowest F cost from the open set.
+	 * Returns NULL when the open set is empty.
+	 */
+	Vertex *pop() {
+		while (!_heap.empty()) {
+			const Entry top = _heap[0];
+			const Entry last = _heap.back();
+			_heap.pop_back();
+
+			if (!_heap.empty()) {
+				const uint size = _heap.size();
+				uint pos = 0;
+
+				while (2 * pos + 1 < size) {
+					uint child = 2 * pos + 1;
+					if (child + 1 < size && before(_heap[child + 1], _heap[child]))
+						child++;
+					if (!before(_heap[child], last))
+						break;
+					_heap[pos] = _heap[child];
+					pos = child;
+				}
+
+				_heap[pos] = last;
+			}
+
+			// Skip entries of vertices whose cost has decreased since
+			if (top.vertex->inOpenSet && top.costF == top.vertex->costF) {
+				top.vertex->inOpenSet = false;
+				return top.vertex;
+			}
+		}
+
+		return NULL;
+	}
+
+private:
+	static bool before(const Entry &a, const Entry &b) {
+		return (a.costF < b.costF) || ((a.costF == b.costF) && (a.order > b.order));
+	}
+
+	Common::Array<Entry> _heap;
+	uint32 _nextOrder;
+};
+
 /**
  * Computes a shortest path from vertex_start to vertex_end. The caller can
  * construct the resulting path by following the path_prev links from
@@ -1310,85 +1624,48 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
  * Parameters: (PathfindingState *) s: The pathfinding state
  */
 static void AStar(PathfindingState *s) {
-	// Vertices of which the shortest path is known
-	VertexList closedSet;
-
-	// The remaining vertices
-	VertexList openSet;
+	const bool borderPenalty = use_border_penalty();
+	OpenSet openSet;
+	bool found = false;
 
-	openSet.push_front(s->vertex_start);
 	s->vertex_start->costG = 0;
 	s->vertex_start->costF = (uint32)sqrt((float)s->vertex_start->v.sqrDist(s->vertex_end->v));
+	openSet.push(s->vertex_start);
 
-	while (!openSet.empty()) {
-		// Find vertex in open set with lowest F cost
-		VertexList::iterator vertex_min_it = openSet.end();
-		Vertex *vertex_min = 0;
-		uint32 min = HUGE_DISTANCE;
-
-		for (VertexList::iterator it = openSet.begin(); it != openSet.end(); ++it) {
-			Vertex *vertex = *it;
-			if (vertex->costF < min) {
-				vertex_min_it = it;
-				vertex_min = *vertex_min_it;
-				min = vertex->costF;
-			}
-		}
-
-		assert(vertex_min != 0);	// the vertex cost should never be bigger than HUGE_DISTANCE
-
+	while (Vertex *vertex_min = openSet.pop()) {
 		// Check if we are done
-		if (vertex_min == s->vertex_end)
+		if (vertex_min == s->vertex_end) {
+			found = true;
 			break;
+		}
 
 		// Move vertex from set open to set closed
-		closedSet.push_front(vertex_min);
-		openSet.erase(vertex_min_it);
+		vertex_min->inClosedSet = true;
 
 		VertexList *visVerts = visible_vertices(s, vertex_min);
 
 		for (VertexList::iterator it = visVerts->begin(); it != visVerts->end(); ++it) {
-			uint32 new_dist;
 			Vertex *vertex = *it;
 
-			if (closedSet.contains(vertex))
+			if (vertex->inClosedSet)
 				continue;
 
-			if (!openSet.contains(vertex))
-				openSet.push_front(vertex);
-
-			new_dist = vertex_min->costG + (uint32)sqrt((float)vertex_min->v.sqrDist(vertex->v));
-
-			// When travelling to a vertex on the screen edge, we
-			// add a penalty score to make this path less appealing.
-			// NOTE: If an obstacle has only one vertex on a screen edge,
-			// later SSCI pathfinders will treat that vertex like any
-			// other, while we apply a penalty to paths traversing it.
-			// This difference might lead to problems, but none are
-			// known at the time of writing.
-
-			// WORKAROUND: This check fails in QFG1VGA, room 81 (bug report #3568452).
-			// However, it is needed in other SCI1.1 games, such as LB2. Therefore, we
-			// add this workaround for that scene in QFG1VGA, until our algorithm matches
-			// better what SSCI is doing. With this workaround, QFG1VGA no longer freezes
-			// in that scene.
-			bool qfg1VgaWorkaround = (g_sci->getGameId() == GID_QFG1VGA &&
-									  g_sci->getEngineState()->currentRoomNumber() == 81);
-
-			if (s->pointOnScreenBorder(vertex->v) && !qfg1VgaWorkaround)
-				new_dist += 10000;
+			const uint32 new_dist = vertex_min->costG + travel_cost(s, vertex_min, vertex, borderPenalty);
 
 			if (new_dist < vertex->costG) {
 				vertex->costG = new_dist;
 				vertex->costF = vertex->costG + (uint32)sqrt((float)vertex->v.sqrDist(s->vertex_end->v));
 				vertex->path_prev = vertex_min;
+				openSet.push(vertex);
+			} else if (!vertex->inOpenSet) {
+				openSet.push(vertex);
 			}
 		}
 
 		delete visVerts;
 	}
 
-	if (openSet.empty())
+	if (!found)
 		debugC(kDebugLevelAvoidPath, "AvoidPath: End point (%i, %i) is unreachable", s->vertex_end->v.x, s->vertex_end->v.y);
 }
 
@@ -1579,6 +1856,223 @@ reg_t kAvoidPath(EngineState *s, int argc, reg_t *argv) {
 	}
 }
 
+PathfindingCache::PathfindingCache()
+	: _lastWidth(0), _lastHeight(0), _lastOpt(0), _hits(0), _misses(0) {
+}
+
+PathfindingCache::~PathfindingCache() {
+	for (Common::List<Entry *>::iterator it = _entries.begin(); it != _entries.end(); ++it)
+		delete *it;
+}
+
+PathfindingCache::Entry *PathfindingCache::lookup(const Common::Array<int16> &geometry, uint vertexCount) {
+	for (Common::List<Entry *>::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+		Entry *entry = *it;
+
+		if (entry->geometry == geometry) {
+			_entries.erase(it);
+			_entries.push_front(entry);
+			_hits++;
+			return entry;
+		}
+	}
+
+	_misses++;
+
+	Entry *entry;
+	if (_entries.size() >= kMaxEntries) {
+		entry = _entries.back();
+		_entries.pop_back();
+	} else {
+		entry = new Entry();
+	}
+
+	entry->geometry = geometry;
+	entry->visible.clear();
+	entry->visible.resize(vertexCount);
+	entry->computed.clear();
+	entry->computed.resize(vertexCount);
+
+	_entries.push_front(entry);
+	return entry;
+}
+
+/**
+ * The A* search as originally implemented, scanning the whole open list for
+ * the vertex with the lowest cost. Only used to verify AStar's results in
+ * benchmarkAvoidPath.
+ * Parameters: (PathfindingState *) s: The pathfinding state
+ */
+static void AStarReference(PathfindingState *s) {
+	const bool borderPenalty = use_border_penalty();
+
+	// Vertices of which the shortest path is known
+	VertexList closedSet;
+
+	// The remaining vertices
+	VertexList openSet;
+
+	openSet.push_front(s->vertex_start);
+	s->vertex_start->costG = 0;
+	s->vertex_start->costF = (uint32)sqrt((float)s->vertex_start->v.sqrDist(s->vertex_end->v));
+
+	while (!openSet.empty()) {
+		// Find vertex in open set with lowest F cost
+		VertexList::iterator vertex_min_it = openSet.end();
+		Vertex *vertex_min = 0;
+		uint32 min = HUGE_DISTANCE;
+
+		for (VertexList::iterator it = openSet.begin(); it != openSet.end(); ++it) {
+			Vertex *vertex = *it;
+			if (vertex->costF < min) {
+				vertex_min_it = it;
+				vertex_min = *vertex_min_it;
+				min = vertex->costF;
+			}
+		}
+
+		assert(vertex_min != 0);	// the vertex cost should never be bigger than HUGE_DISTANCE
+
+		// Check if we are done
+		if (vertex_min == s->vertex_end)
+			break;
+
+		// Move vertex from set open to set closed
+		closedSet.push_front(vertex_min);
+		openSet.erase(vertex_min_it);
+
+		VertexList *visVerts = visible_vertices(s, vertex_min);
+
+		for (VertexList::iterator it = visVerts->begin(); it != visVerts->end(); ++it) {
+			Vertex *vertex = *it;
+
+			if (closedSet.contains(vertex))
+				continue;
+
+			if (!openSet.contains(vertex))
+				openSet.push_front(vertex);
+
+			const uint32 new_dist = vertex_min->costG + travel_cost(s, vertex_min, vertex, borderPenalty);
+
+			if (new_dist < vertex->costG) {
+				vertex->costG = new_dist;
+				vertex->costF = vertex->costG + (uint32)sqrt((float)vertex->v.sqrDist(s->vertex_end->v));
+				vertex->path_prev = vertex_min;
+			}
+		}
+
+		delete visVerts;
+	}
+}
+
+/**
+ * Collects the path found by AStar, including the prepended and appended points
+ * Parameters: (PathfindingState *) p: The pathfinding state
+ *             (Common::Array<Common::Point> &) path: The array to fill
+ */
+static void collect_path(PathfindingState *p, Common::Array<Common::Point> &path) {
+	path.clear();
+
+	if (p->_prependPoint)
+		path.push_back(*p->_prependPoint);
+
+	if (!p->vertex_end->path_prev) {
+		path.push_back(p->vertex_start->v);
+		return;
+	}
+
+	const uint first = path.size();
+	for (Vertex *vertex = p->vertex_end; vertex; vertex = vertex->path_prev)
+		path.insert_at(first, vertex->v);
+
+	if (p->_appendPoint)
+		path.push_back(*p->_appendPoint);
+}
+
+void benchmarkAvoidPath(EngineState *s, Console *con, int iterations) {
+	const PathfindingCache *lastCall = s->_pathfindingCache;
+
+	if (!lastCall || lastCall->_lastInput.empty()) {
+		con->DebugPrintf("No polygons to test, kAvoidPath has not been called yet\n");
+		return;
+	}
+
+	const int width = lastCall->_lastWidth;
+	const int height = lastCall->_lastHeight;
+	const int opt = lastCall->_lastOpt;
+
+	// Start and end points on a grid covering the screen
+	enum {
+		kGridWidth = 8,
+		kGridHeight = 6
+	};
+
+	Common::Array<Common::Point> points;
+	for (int y = 0; y < kGridHeight; y++) {
+		for (int x = 0; x < kGridWidth; x++)
+			points.push_back(Common::Point((2 * x + 1) * width / (2 * kGridWidth), (2 * y + 1) * height / (2 * kGridHeight)));
+	}
+
+	static const char *const variantNames[] = {
+		"A* with linear open list",
+		"A* with binary heap",
+		"A* with binary heap and visibility cache"
+	};
+
+	Common::Array<Common::Array<Common::Point> > referencePaths;
+	Common::Array<Common::Point> path;
+	PathfindingCache cache;
+	int polygonCount = 0;
+	int mismatches = 0;
+	int runs = 0;
+
+	for (int variant = 0; variant < ARRAYSIZE(variantNames); variant++) {
+		const uint32 startTime = g_system->getMillis();
+		runs = 0;
+
+		for (int i = 0; i < iterations; i++) {
+			for (uint from = 0; from < points.size(); from++) {
+				for (uint to = 0; to < points.size(); to++) {
+					if (from == to)
+						continue;
+
+					PolygonList polygons;
+					decode_polygons(lastCall->_lastInput, polygons);
+					polygonCount = polygons.size();
+
+					PathfindingState *p = create_pathfinding_state(s, polygons, points[from], points[to],
+					                                               width, height, opt, (variant == 2) ? &cache : NULL);
+
+					path.clear();
+					if (p) {
+						if (variant == 0)
+							AStarReference(p);
+						else
+							AStar(p);
+						collect_path(p, path);
+						delete p;
+					}
+
+					if (variant == 0 && i == 0)
+						referencePaths.push_back(path);
+					else if (path != referencePaths[runs % referencePaths.size()])
+						mismatches++;
+
+					runs++;
+				}
+			}
+		}
+
+		con->DebugPrintf("%s: %d ms\n", variantNames[variant], g_system->getMillis() - startTime);
+	}
+
+	con->DebugPrintf("%d paths per variant over %d polygons (%s)\n", runs, polygonCount,
+	                 mismatches ? "results differ" : "all results identical");
+	if (mismatches)
+		con->DebugPrintf("%d paths differ from the reference\n", mismatches);
+	con->DebugPrintf("Visibility cache of the game: %u hits, %u misses\n", lastCall->_hits, lastCall->_misses);
+}
+
 static bool PointInRect(const Common::Point &point, int16 rectX1, int16 rectY1, int16 rectX2, int16 rectY2) {
 	int16 top = MIN<int16>(rectY1, rectY2);
 	int16 left = MIN<int16>(rectX1, rectX2);
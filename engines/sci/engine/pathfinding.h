@@ -0,0 +1,93 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCI_ENGINE_PATHFINDING_H
+#define SCI_ENGINE_PATHFINDING_H
+
+#include "common/array.h"
+#include "common/list.h"
+
+namespace Sci {
+
+class Console;
+struct EngineState;
+
+/**
+ * Visibility graphs of the polygon sets recently passed to kAvoidPath.
+ *
+ * Which polygon vertices can be seen from each other only depends on the
+ * polygons, not on the start and end points of the path. Rooms call
+ * kAvoidPath many times with the same obstacles, so the visible vertices
+ * are remembered per polygon set and only the start and end points have
+ * to be checked against the polygons on every call.
+ */
+class PathfindingCache {
+public:
+	struct Entry {
+		/** The vertices of all polygons, see kpathing.cpp */
+		Common::Array<int16> geometry;
+
+		/** For each vertex, the indices of the vertices visible from it */
+		Common::Array<Common::Array<uint16> > visible;
+
+		/** Whether visible has been filled in for a vertex yet */
+		Common::Array<bool> computed;
+	};
+
+	PathfindingCache();
+	~PathfindingCache();
+
+	/**
+	 * Returns the visibility graph of the given polygon set. A new, empty
+	 * one is created if the polygon set has not been seen recently.
+	 */
+	Entry *lookup(const Common::Array<int16> &geometry, uint vertexCount);
+
+	/** The polygons of the last kAvoidPath call, replayed by benchmarkAvoidPath */
+	Common::Array<int16> _lastInput;
+	int _lastWidth;
+	int _lastHeight;
+	int _lastOpt;
+
+	uint32 _hits;
+	uint32 _misses;
+
+private:
+	enum {
+		kMaxEntries = 8
+	};
+
+	/** Most recently used entries first */
+	Common::List<Entry *> _entries;
+};
+
+/**
+ * Measures the pathfinding of kAvoidPath on the polygons of its last call,
+ * between a grid of start and end points. The results are compared with
+ * the straightforward A* search without visibility cache.
+ * Used by the "avoidpath_bench" debugger command.
+ */
+void benchmarkAvoidPath(EngineState *s, Console *con, int iterations);
+
+} // End of namespace Sci
+
+#endif // SCI_ENGINE_PATHFINDING_H
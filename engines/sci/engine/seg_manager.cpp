@@ -58,6 +58,7 @@ void SegManager::resetSegMan() {
 	}
 
 	_heap.clear();
+	_selectorLookupCache.invalidate();
 
 	// And reinitialize
 	_heap.push_back(0);
@@ -153,6 +154,7 @@ void SegManager::deallocate(SegmentId seg) {
 	if (mobj->getType() == SEG_TYPE_SCRIPT) {
 		Script *scr = (Script *)mobj;
 		_scriptSegMap.erase(scr->getScriptNumber());
+		_selectorLookupCache.invalidate();
 		if (scr->getLocalsSegment()) {
 			// Check if the locals segment has already been deallocated.
 			// If the locals block has been stored in a segment with an ID
@@ -974,6 +976,9 @@ int SegManager::instantiateScript(int scriptNum) {
 		scr = allocateScript(scriptNum, &segmentId);
 	}
 
+	// Cached selector lookups may refer to the old contents of the segment
+	_selectorLookupCache.invalidate();
+
 	scr->load(scriptNum, _resMan);
 	scr->initializeLocals(this);
 	scr->initializeClasses(this);
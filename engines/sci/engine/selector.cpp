@@ -250,38 +250,63 @@ void invokeSelector(EngineState *s, reg_t object, int selectorId,
 	run_vm(s); // Start a new vm
 }
 
-SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector selectorId, ObjVarRef *varp, reg_t *fptr) {
-	const Object *obj = segMan->getObject(obj_location);
-	int index;
-	bool oldScriptHeader = (getSciVersion() == SCI_VERSION_0_EARLY);
+SelectorLookupCache::SelectorLookupCache() {
+	memset(_entries, 0, sizeof(_entries));
+	_generation = 1;
+	_enabled = true;
+	resetStats();
+}
 
-	// Early SCI versions used the LSB in the selector ID as a read/write
-	// toggle, meaning that we must remove it for selector lookup.
-	if (oldScriptHeader)
-		selectorId &= ~1;
+bool SelectorLookupCache::isValid(const Entry &entry, reg_t obj, Selector selectorId, const Object *object) {
+	if (entry.generation == _generation && entry.obj == obj && entry.selectorId == selectorId
+		&& entry.baseObj == object->getBaseObject() && entry.superClass == object->getSuperClassSelector()) {
+		_hits++;
+		return true;
+	}
 
-	if (!obj) {
-		error("lookupSelector(): Attempt to send to non-object or invalid script. Address was %04x:%04x",
-				PRINT_REG(obj_location));
+	_misses++;
+	return false;
+}
+
+void SelectorLookupCache::store(Entry &entry, reg_t obj, Selector selectorId, const Object *object,
+		SelectorType type, int varIndex, reg_t funcAddr) {
+	if (!_enabled)
+		return;
+
+	entry.generation = _generation;
+	entry.obj = obj;
+	entry.selectorId = selectorId;
+	entry.baseObj = object->getBaseObject();
+	entry.superClass = object->getSuperClassSelector();
+	entry.type = type;
+	entry.varIndex = varIndex;
+	entry.funcAddr = funcAddr;
+}
+
+void SelectorLookupCache::invalidate() {
+	_invalidations++;
+
+	// Entries are marked with the generation they were stored in, so that
+	// we only have to clear them when the counter wraps around
+	if (++_generation == 0) {
+		memset(_entries, 0, sizeof(_entries));
+		_generation = 1;
 	}
+}
 
-	index = obj->locateVarSelector(segMan, selectorId);
+static SelectorType lookupSelectorUncached(SegManager *segMan, const Object *obj, Selector selectorId, int &varIndex, reg_t &funcAddr) {
+	int index = obj->locateVarSelector(segMan, selectorId);
 
 	if (index >= 0) {
 		// Found it as a variable
-		if (varp) {
-			varp->obj = obj_location;
-			varp->varindex = index;
-		}
+		varIndex = index;
 		return kSelectorVariable;
 	} else {
 		// Check if it's a method, with recursive lookup in superclasses
 		while (obj) {
 			index = obj->funcSelectorPosition(selectorId);
 			if (index >= 0) {
-				if (fptr)
-					*fptr = obj->getFunction(index);
-
+				funcAddr = obj->getFunction(index);
 				return kSelectorMethod;
 			} else {
 				obj = segMan->getObject(obj->getSuperClassSelector());
@@ -290,9 +315,45 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector sel
 
 		return kSelectorNone;
 	}
+}
+
+SelectorType lookupSelector(SegManager *segMan, reg_t obj_location, Selector selectorId, ObjVarRef *varp, reg_t *fptr) {
+	const Object *obj = segMan->getObject(obj_location);
+	bool oldScriptHeader = (getSciVersion() == SCI_VERSION_0_EARLY);
+
+	// Early SCI versions used the LSB in the selector ID as a read/write
+	// toggle, meaning that we must remove it for selector lookup.
+	if (oldScriptHeader)
+		selectorId &= ~1;
 
+	if (!obj) {
+		error("lookupSelector(): Attempt to send to non-object or invalid script. Address was %04x:%04x",
+				PRINT_REG(obj_location));
+	}
+
+	SelectorLookupCache &cache = segMan->getSelectorLookupCache();
+	SelectorLookupCache::Entry &entry = cache.getEntry(obj_location, selectorId);
+	SelectorType type;
+	int varIndex = -1;
+	reg_t funcAddr = NULL_REG;
+
+	if (cache.isValid(entry, obj_location, selectorId, obj)) {
+		type = entry.type;
+		varIndex = entry.varIndex;
+		funcAddr = entry.funcAddr;
+	} else {
+		type = lookupSelectorUncached(segMan, obj, selectorId, varIndex, funcAddr);
+		cache.store(entry, obj_location, selectorId, obj, type, varIndex, funcAddr);
+	}
+
+	if (type == kSelectorVariable && varp) {
+		varp->obj = obj_location;
+		varp->varindex = varIndex;
+	} else if (type == kSelectorMethod && fptr) {
+		*fptr = funcAddr;
+	}
 
-//	return _lookupSelector_function(segMan, obj, selectorId, fptr);
+	return type;
 }
 
 } // End of namespace Sci
@@ -47,6 +47,7 @@ class FileHandle;
 class DirSeeker;
 class EventManager;
 class MessageState;
+class PathfindingCache;
 class SoundCommandParser;
 class VirtualIndexFile;
 
@@ -187,6 +188,8 @@ public:
 
 	MessageState *_msgState;
 
+	PathfindingCache *_pathfindingCache; /**< Visibility graphs for kAvoidPath, created on first use */
+
 	// MemorySegment provides access to a 256-byte block of memory that remains
 	// intact across restarts and restores
 	enum {
@@ -348,6 +348,72 @@ void script_debug(EngineState *s);
 SelectorType lookupSelector(SegManager *segMan, reg_t obj, Selector selectorid,
 		ObjVarRef *varp, reg_t *fptr);
 
+/**
+ * Cache of recent lookupSelector() results, indexed by object address and
+ * selector. Every message send looks its selector up, which means searching
+ * the variable selectors of the class and the method selectors of the whole
+ * superclass chain, so the results are remembered here.
+ *
+ * An entry also records the base object and superclass of the object it was
+ * looked up in, so that a clone which reuses the address of a freed one can
+ * not pick up a stale result. The cache is emptied by the SegManager
+ * whenever a script is loaded or freed.
+ */
+class SelectorLookupCache {
+public:
+	struct Entry {
+		uint32 generation;
+		reg_t obj;
+		Selector selectorId;
+		const byte *baseObj;
+		reg_t superClass;
+		SelectorType type;
+		int varIndex;
+		reg_t funcAddr;
+	};
+
+	SelectorLookupCache();
+
+	/**
+	 * Returns the cache slot for the given object and selector. The caller
+	 * must check it with isValid() and fill it with store() on a miss.
+	 */
+	Entry &getEntry(reg_t obj, Selector selectorId) {
+		const uint hash = (obj.getOffset() ^ (obj.getSegment() << 6) ^ (selectorId * 41)) & (kSize - 1);
+		return _entries[hash];
+	}
+
+	/** Checks if an entry holds the result for the given object, and counts the hit or miss */
+	bool isValid(const Entry &entry, reg_t obj, Selector selectorId, const Object *object);
+
+	void store(Entry &entry, reg_t obj, Selector selectorId, const Object *object,
+			SelectorType type, int varIndex, reg_t funcAddr);
+
+	/** Forgets all entries */
+	void invalidate();
+
+	void setEnabled(bool enabled) { _enabled = enabled; invalidate(); }
+	bool isEnabled() const { return _enabled; }
+
+	uint32 getHits() const { return _hits; }
+	uint32 getMisses() const { return _misses; }
+	uint32 getInvalidations() const { return _invalidations; }
+	void resetStats() { _hits = _misses = _invalidations = 0; }
+
+private:
+	enum {
+		kSize = 1024 ///< Number of entries, must be a power of 2
+	};
+
+	Entry _entries[kSize];
+	uint32 _generation; ///< Entries of older generations are invalid
+	bool _enabled;
+
+	uint32 _hits;
+	uint32 _misses;
+	uint32 _invalidations;
+};
+
 /**
  * Read a PMachine instruction from a memory buffer and return its length.
  *
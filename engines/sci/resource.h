@@ -240,6 +240,9 @@ protected:
 	int32 _fileOffset; /**< Offset in file */
 	ResourceStatus _status;
 	uint16 _lockers; /**< Number of places where this resource was locked */
+	Resource *_lruPrev; /**< Next more recently used resource in the LRU list */
+	Resource *_lruNext; /**< Next less recently used resource in the LRU list */
+	bool _evicted; /**< Freed by the LRU since it was last loaded */
 	ResourceSource *_source;
 	ResourceManager *_resMan;
 
@@ -254,6 +257,15 @@ protected:
 
 typedef Common::HashMap<ResourceId, Resource *, ResourceIdHash> ResourceMap;
 
+/** Statistics about the resource cache, shown by the "resource_cache" debugger command */
+struct ResourceCacheStats {
+	uint32 hits;          ///< Lookups of resources which were in memory
+	uint32 misses;        ///< Lookups which required loading the resource
+	uint32 evictions;     ///< Resources freed by the LRU
+	uint32 reloads;       ///< Misses of resources which had been freed by the LRU
+	uint32 bytesReloaded; ///< Bytes loaded again because of these reloads
+};
+
 class ResourceManager {
 	// FIXME: These 'friend' declarations are meant to be a temporary hack to
 	// ease transition to the ResourceSource class system.
@@ -334,6 +346,12 @@ public:
 	const char *getVolVersionDesc() const { return versionDescription(_volVersion); }
 	ResVersion getVolVersion() const { return _volVersion; }
 
+	int getMaxMemory() const { return _maxMemory; }
+	int getLockedMemory() const { return _memoryLocked; }
+	int getLRUMemory() const { return _memoryLRU; }
+	const ResourceCacheStats &getCacheStats() const { return _cacheStats; }
+	void resetCacheStats();
+
 	/**
 	 * Adds the appropriate GM patch from the Sierra MIDI utility as 4.pat, without
 	 * requiring the user to rename the file to 4.pat. Thus, the original Sierra
@@ -379,19 +397,23 @@ public:
 	ResourceType convertResType(byte type);
 
 protected:
-	// Maximum number of bytes to allow being allocated for resources
+	// Default maximum number of bytes to allow being allocated for resources.
+	// It can be changed per game with the resource_cache_size config key (in KB).
 	// Note: maxMemory will not be interpreted as a hard limit, only as a restriction
 	// for resources which are not explicitly locked. However, a warning will be
 	// issued whenever this limit is exceeded.
 	enum {
-		MAX_MEMORY = 256 * 1024	// 256KB
+		DEFAULT_MAX_MEMORY = 256 * 1024	// 256KB
 	};
 
 	ViewType _viewType; // Used to determine if the game has EGA or VGA graphics
 	Common::List<ResourceSource *> _sources;
+	int _maxMemory;		///< Amount of resource bytes to keep under LRU control
 	int _memoryLocked;	///< Amount of resource bytes in locked memory
 	int _memoryLRU;		///< Amount of resource bytes under LRU control
-	Common::List<Resource *> _LRU; ///< Last Resource Used list
+	Resource *_lruFirst; ///< Most recently used resource under LRU control
+	Resource *_lruLast;	///< Least recently used resource, the next one to be freed
+	ResourceCacheStats _cacheStats;
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
@@ -241,6 +241,12 @@ SmushPlayer::SmushPlayer(ScummEngine_v7 *scumm) {
 	_paused = false;
 	_pauseStartTime = 0;
 	_pauseTime = 0;
+	_decodeAheadEnabled = false;
+	_aheadPos = 0;
+	_framesAhead = 0;
+	_shownFrames = 0;
+	_droppedFrames = 0;
+	_framesDecodedAhead = 0;
 }
 
 SmushPlayer::~SmushPlayer() {
@@ -298,6 +304,8 @@ void SmushPlayer::release() {
 
 	_IACTstream = NULL;
 
+	flushDecodedObjects();
+
 	_vm->_smushActive = false;
 	_vm->_fullRedraw = true;
 
@@ -722,20 +730,27 @@ void SmushPlayer::handleNewPalette(int32 subSize, Common::SeekableReadStream &b)
 
 void smush_decode_codec1(byte *dst, const byte *src, int left, int top, int width, int height, int pitch);
 
-void SmushPlayer::decodeFrameObject(int codec, const uint8 *src, int left, int top, int width, int height) {
-	if ((height == 242) && (width == 384)) {
-		if (_specialBuffer == 0)
-			_specialBuffer = (byte *)malloc(242 * 384);
-		_dst = _specialBuffer;
-	} else if ((height > _vm->_screenHeight) || (width > _vm->_screenWidth))
-		return;
+bool SmushPlayer::isFrameObjectDrawn(int width, int height) const {
+	if ((height == 242) && (width == 384))
+		return true;
+	if ((height > _vm->_screenHeight) || (width > _vm->_screenWidth))
+		return false;
 	// FT Insane uses smaller frames to draw overlays with moving objects
 	// Other .san files do have them as well but their purpose in unknown
 	// and often it causes memory overdraw. So just skip those frames
-	else if (!_insanity && ((height != _vm->_screenHeight) || (width != _vm->_screenWidth)))
+	if (!_insanity && ((height != _vm->_screenHeight) || (width != _vm->_screenWidth)))
+		return false;
+	return true;
+}
+
+void SmushPlayer::decodeFrameObject(int codec, const uint8 *src, int left, int top, int width, int height, const DecodedObject *decoded) {
+	if (!isFrameObjectDrawn(width, height))
 		return;
 
 	if ((height == 242) && (width == 384)) {
+		if (_specialBuffer == 0)
+			_specialBuffer = (byte *)malloc(242 * 384);
+		_dst = _specialBuffer;
 		_width = width;
 		_height = height;
 	} else {
@@ -749,16 +764,22 @@ void SmushPlayer::decodeFrameObject(int codec, const uint8 *src, int left, int t
 		smush_decode_codec1(_dst, src, left, top, width, height, _vm->_screenWidth);
 		break;
 	case 37:
-		if (!_codec37)
-			_codec37 = new Codec37Decoder(width, height);
-		if (_codec37)
-			_codec37->decode(_dst, src);
-		break;
 	case 47:
-		if (!_codec47)
-			_codec47 = new Codec47Decoder(width, height);
-		if (_codec47)
-			_codec47->decode(_dst, src);
+		if (decoded && decoded->pixels) {
+			memcpy(_dst, decoded->pixels, decoded->pixelsSize);
+			break;
+		}
+		if (codec == 37) {
+			if (!_codec37)
+				_codec37 = new Codec37Decoder(width, height);
+			if (_codec37)
+				_codec37->decode(_dst, src);
+		} else {
+			if (!_codec47)
+				_codec47 = new Codec47Decoder(width, height);
+			if (_codec47)
+				_codec47->decode(_dst, src);
+		}
 		break;
 	default:
 		error("Invalid codec for frame object : %d", codec);
@@ -780,6 +801,16 @@ void SmushPlayer::handleZlibFrameObject(int32 subSize, Common::SeekableReadStrea
 		return;
 	}
 
+	DecodedObject decoded;
+	if (takeDecodedObject(b.pos(), decoded)) {
+		const byte *ptr = decoded.data;
+		decodeFrameObject(READ_LE_UINT16(ptr), decoded.data + 14, READ_LE_UINT16(ptr + 2), READ_LE_UINT16(ptr + 4),
+		                  READ_LE_UINT16(ptr + 6), READ_LE_UINT16(ptr + 8), &decoded);
+		free(decoded.data);
+		free(decoded.pixels);
+		return;
+	}
+
 	int32 chunkSize = subSize;
 	byte *chunkBuffer = (byte *)malloc(chunkSize);
 	assert(chunkBuffer);
@@ -811,6 +842,7 @@ void SmushPlayer::handleFrameObject(int32 subSize, Common::SeekableReadStream &b
 		return;
 	}
 
+	const int32 offset = b.pos();
 	int codec = b.readUint16LE();
 	int left = b.readUint16LE();
 	int top = b.readUint16LE();
@@ -820,6 +852,13 @@ void SmushPlayer::handleFrameObject(int32 subSize, Common::SeekableReadStream &b
 	b.readUint16LE();
 	b.readUint16LE();
 
+	DecodedObject decoded;
+	if (takeDecodedObject(offset, decoded)) {
+		decodeFrameObject(codec, NULL, left, top, width, height, &decoded);
+		free(decoded.pixels);
+		return;
+	}
+
 	int32 chunk_size = subSize - 14;
 	byte *chunk_buffer = (byte *)malloc(chunk_size);
 	assert(chunk_buffer);
@@ -830,6 +869,130 @@ void SmushPlayer::handleFrameObject(int32 subSize, Common::SeekableReadStream &b
 	free(chunk_buffer);
 }
 
+bool SmushPlayer::decodeAhead() {
+	if (!_decodeAheadEnabled || !_base || _seekPos >= 0 || _framesAhead >= kMaxFramesAhead)
+		return false;
+
+	const int32 pos = _base->pos();
+	if (_aheadPos < pos)
+		_aheadPos = pos;
+	if (_aheadPos + 8 >= (int32)_baseSize)
+		return false;
+
+	_base->seek(_aheadPos, SEEK_SET);
+	const uint32 type = _base->readUint32BE();
+	const int32 size = _base->readUint32BE();
+	const int32 offset = _base->pos();
+
+	// Only frames are decoded ahead, anything else is left to parseNextFrame()
+	if (type != MKTAG('F','R','M','E')) {
+		_base->seek(pos, SEEK_SET);
+		return false;
+	}
+
+	// Walk through the sub chunks just like handleFrame() does
+	int32 frameSize = size;
+	while (frameSize > 0) {
+		const uint32 subType = _base->readUint32BE();
+		const int32 subSize = _base->readUint32BE();
+		const int32 subOffset = _base->pos();
+
+		if (subType == MKTAG('F','O','B','J') && subSize >= 14) {
+			const int codec = _base->readUint16LE();
+			_base->skip(4);
+			const int width = _base->readUint16LE();
+			const int height = _base->readUint16LE();
+
+			// Codec 1 draws over the previous frame, and is cheap anyway
+			if (codec == 37 || codec == 47) {
+				_base->skip(4);
+				byte *chunkBuffer = (byte *)malloc(subSize - 14);
+				assert(chunkBuffer);
+				_base->read(chunkBuffer, subSize - 14);
+				queueDecodedObject(subOffset, NULL, codec, chunkBuffer, width, height);
+				free(chunkBuffer);
+			}
+#ifdef USE_ZLIB
+		} else if (subType == MKTAG('Z','F','O','B')) {
+			byte *chunkBuffer = (byte *)malloc(subSize);
+			assert(chunkBuffer);
+			_base->read(chunkBuffer, subSize);
+
+			unsigned long decompressedSize = READ_BE_UINT32(chunkBuffer);
+			byte *fobjBuffer = (byte *)malloc(decompressedSize);
+			if (Common::uncompress(fobjBuffer, &decompressedSize, chunkBuffer + 4, subSize - 4)) {
+				queueDecodedObject(subOffset, fobjBuffer, READ_LE_UINT16(fobjBuffer), fobjBuffer + 14,
+				                   READ_LE_UINT16(fobjBuffer + 6), READ_LE_UINT16(fobjBuffer + 8));
+			} else {
+				// Let handleZlibFrameObject() report the error
+				free(fobjBuffer);
+			}
+			free(chunkBuffer);
+#endif
+		}
+
+		frameSize -= subSize + 8;
+		_base->seek(subOffset + subSize, SEEK_SET);
+		if (subSize & 1) {
+			_base->skip(1);
+			frameSize--;
+		}
+	}
+
+	_aheadPos = offset + size;
+	_framesAhead++;
+	_framesDecodedAhead++;
+
+	_base->seek(pos, SEEK_SET);
+	return true;
+}
+
+void SmushPlayer::queueDecodedObject(int32 offset, byte *data, int codec, const byte *src, int width, int height) {
+	DecodedObject obj;
+	obj.offset = offset;
+	obj.data = data;
+	obj.pixels = NULL;
+	obj.pixelsSize = 0;
+
+	// Objects which are not drawn are not decoded either, see decodeFrameObject()
+	if (isFrameObjectDrawn(width, height)) {
+		if (codec == 37) {
+			if (!_codec37)
+				_codec37 = new Codec37Decoder(width, height);
+			obj.pixels = (byte *)malloc(_codec37->getFrameSize());
+			_codec37->decode(obj.pixels, src);
+			obj.pixelsSize = _codec37->getFrameSize();
+		} else if (codec == 47) {
+			if (!_codec47)
+				_codec47 = new Codec47Decoder(width, height);
+			obj.pixels = (byte *)malloc(_codec47->getFrameSize());
+			if (_codec47->decode(obj.pixels, src))
+				obj.pixelsSize = _codec47->getFrameSize();
+		}
+	}
+
+	if (obj.data || obj.pixels)
+		_decodedObjects.push(obj);
+}
+
+bool SmushPlayer::takeDecodedObject(int32 offset, DecodedObject &obj) {
+	if (_decodedObjects.empty() || _decodedObjects.front().offset != offset)
+		return false;
+
+	obj = _decodedObjects.pop();
+	return true;
+}
+
+void SmushPlayer::flushDecodedObjects() {
+	while (!_decodedObjects.empty()) {
+		DecodedObject obj = _decodedObjects.pop();
+		free(obj.data);
+		free(obj.pixels);
+	}
+	_aheadPos = 0;
+	_framesAhead = 0;
+}
+
 void SmushPlayer::handleFrame(int32 frameSize, Common::SeekableReadStream &b) {
 	debugC(DEBUG_SMUSH, "SmushPlayer::handleFrame(%d)", _frame);
 	_skipNext = false;
@@ -972,6 +1135,8 @@ void SmushPlayer::parseNextFrame() {
 		if (_smixer)
 			_smixer->stop();
 
+		flushDecodedObjects();
+
 		if (_seekFile.size() > 0) {
 			delete _base;
 
@@ -1032,6 +1197,8 @@ void SmushPlayer::parseNextFrame() {
 		break;
 	case MKTAG('F','R','M','E'):
 		handleFrame(subSize, *_base);
+		if (subOffset < _aheadPos)
+			_framesAhead--;
 		break;
 	default:
 		error("Unknown Chunk found at %x: %s, %d", subOffset, tag2str(subType), subSize);
@@ -1087,6 +1254,9 @@ void SmushPlayer::seekSan(const char *file, int32 pos, int32 contFrame) {
 	_seekPos = pos;
 	_seekFrame = contFrame;
 	_pauseTime = 0;
+
+	// The frames decoded ahead belong to the old position
+	flushDecodedObjects();
 }
 
 void SmushPlayer::tryCmpFile(const char *filename) {
@@ -1173,6 +1343,13 @@ void SmushPlayer::play(const char *filename, int32 speed, int32 offset, int32 st
 
 	_pauseTime = 0;
 
+	// Insane decides which frame objects to skip while the game is running,
+	// so its videos are always decoded when the frame is shown.
+	_decodeAheadEnabled = !_insanity;
+	_shownFrames = 0;
+	_droppedFrames = 0;
+	_framesDecodedAhead = 0;
+
 	int skipped = 0;
 
 	for (;;) {
@@ -1203,6 +1380,9 @@ void SmushPlayer::play(const char *filename, int32 speed, int32 offset, int32 st
 				skipFrame = true;
 			else
 				skipFrame = false;
+			// The previous frame is replaced before it was shown
+			if (_updateNeeded)
+				_droppedFrames++;
 			timerCallback();
 		}
 
@@ -1238,6 +1418,7 @@ void SmushPlayer::play(const char *filename, int32 speed, int32 offset, int32 st
 				_vm->_system->copyRectToScreen(_dst, _width, 0, 0, w, h);
 				_vm->_system->updateScreen();
 				_updateNeeded = false;
+				_shownFrames++;
 			}
 		}
 		if (_endOfFile)
@@ -1249,9 +1430,16 @@ void SmushPlayer::play(const char *filename, int32 speed, int32 offset, int32 st
 			_IACTpos = 0;
 			break;
 		}
-		_vm->_system->delayMillis(10);
+
+		// Instead of waiting for the next frame, decode the frame objects
+		// of the upcoming ones, so that expensive frames do not delay their
+		// presentation.
+		if (!decodeAhead())
+			_vm->_system->delayMillis(10);
 	}
 
+	debugC(DEBUG_SMUSH, "Smush stats: %d frames shown, %d dropped, %d decoded ahead", _shownFrames, _droppedFrames, _framesDecodedAhead);
+
 	release();
 
 	// Reset mouse state
@@ -23,6 +23,7 @@
 #if !defined(SCUMM_SMUSH_PLAYER_H) && defined(ENABLE_SCUMM_7_8)
 #define SCUMM_SMUSH_PLAYER_H
 
+#include "common/queue.h"
 #include "common/util.h"
 #include "scumm/sound.h"
 
@@ -82,6 +83,36 @@ private:
 	bool _middleAudio;
 	bool _skipPalette;
 
+	/**
+	 * A frame object of an upcoming frame, prepared by decodeAhead(). The
+	 * codecs keep state between frames, so every frame object is decoded
+	 * exactly once and in order, the player just copies the result.
+	 */
+	struct DecodedObject {
+		/** Position of the FOBJ or ZFOB chunk data in _base */
+		int32 offset;
+		/** Inflated contents of a ZFOB chunk, NULL for FOBJ chunks */
+		byte *data;
+		/** Output of codec 37 or 47, NULL if the object has to be decoded when shown */
+		byte *pixels;
+		/** Number of bytes in pixels, zero if the codec did not output anything */
+		int32 pixelsSize;
+	};
+
+	enum {
+		kMaxFramesAhead = 4
+	};
+
+	bool _decodeAheadEnabled;
+	Common::Queue<DecodedObject> _decodedObjects;
+	/** Position in _base after the last frame handled by decodeAhead() */
+	int32 _aheadPos;
+	int _framesAhead;
+
+	uint32 _shownFrames;
+	uint32 _droppedFrames;
+	uint32 _framesDecodedAhead;
+
 public:
 	SmushPlayer(ScummEngine_v7 *scumm);
 	~SmushPlayer();
@@ -117,7 +148,8 @@ private:
 	void tryCmpFile(const char *filename);
 
 	bool readString(const char *file);
-	void decodeFrameObject(int codec, const uint8 *src, int left, int top, int width, int height);
+	bool isFrameObjectDrawn(int width, int height) const;
+	void decodeFrameObject(int codec, const uint8 *src, int left, int top, int width, int height, const DecodedObject *decoded = 0);
 	void handleAnimHeader(int32 subSize, Common::SeekableReadStream &);
 	void handleFrame(int32 frameSize, Common::SeekableReadStream &);
 	void handleNewPalette(int32 subSize, Common::SeekableReadStream &);
@@ -134,6 +166,11 @@ private:
 	void handleDeltaPalette(int32 subSize, Common::SeekableReadStream &);
 	void readPalette(byte *, Common::SeekableReadStream &);
 
+	bool decodeAhead();
+	void queueDecodedObject(int32 offset, byte *data, int codec, const byte *src, int width, int height);
+	bool takeDecodedObject(int32 offset, DecodedObject &obj);
+	void flushDecodedObjects();
+
 	void timerCallback();
 };
 
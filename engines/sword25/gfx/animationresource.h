@@ -48,6 +48,10 @@ public:
 	AnimationResource(const Common::String &filename);
 	virtual ~AnimationResource();
 
+	virtual uint getMemoryUsage() const {
+		return sizeof(*this) + _frames.size() * sizeof(Frame);
+	}
+
 	virtual const Frame &getFrame(uint index) const {
 		return _frames[index];
 	}
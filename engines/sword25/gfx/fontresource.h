@@ -52,6 +52,10 @@ public:
 	*/
 	FontResource(Kernel *pKernel, const Common::String &fileName);
 
+	virtual uint getMemoryUsage() const {
+		return sizeof(*this);
+	}
+
 	/**
 	    @brief Gibt true zurck, wenn das Objekt korrekt initialisiert wurde.
 
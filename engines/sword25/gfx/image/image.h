@@ -85,6 +85,11 @@ public:
 	*/
 	virtual GraphicEngine::COLOR_FORMATS getColorFormat() const = 0;
 
+	/**
+	    @brief Returns the number of bytes the image data takes up in memory
+	*/
+	virtual uint getMemoryUsage() const = 0;
+
 	//@}
 
 	//@{
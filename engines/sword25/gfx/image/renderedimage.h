@@ -68,6 +68,9 @@ public:
 	virtual GraphicEngine::COLOR_FORMATS getColorFormat() const {
 		return GraphicEngine::CF_ARGB32;
 	}
+	virtual uint getMemoryUsage() const {
+		return _doCleanup ? _width * _height * 4 : 0;
+	}
 
 	void copyDirectly(int posX, int posY);
 
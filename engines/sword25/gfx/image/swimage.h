@@ -53,6 +53,9 @@ public:
 	virtual GraphicEngine::COLOR_FORMATS getColorFormat() const {
 		return GraphicEngine::CF_ARGB32;
 	}
+	virtual uint getMemoryUsage() const {
+		return _width * _height * sizeof(uint);
+	}
 
 	virtual bool blit(int posX = 0, int posY = 0,
 	                  int flipping = Image::FLIP_NONE,
@@ -214,7 +214,7 @@ Common::Rect CalculateBoundingBox(const VectorImageElement &vectorImageElement)
 // Construction
 // -----------------------------------------------------------------------------
 
-VectorImage::VectorImage(const byte *pFileData, uint fileSize, bool &success, const Common::String &fname) : _pixelData(0), _fname(fname) {
+VectorImage::VectorImage(const byte *pFileData, uint fileSize, bool &success, const Common::String &fname) : _pixelData(0), _pixelDataSize(0), _fname(fname) {
 	success = false;
 
 	// Create bitstream object
@@ -576,6 +576,17 @@ bool VectorImage::parseStyles(uint shapeType, SWFBitStream &bs, uint &numFillBit
 }
 
 
+// -----------------------------------------------------------------------------
+
+uint VectorImage::getMemoryUsage() const {
+	uint size = _pixelDataSize;
+	for (uint e = 0; e < _elements.size(); ++e) {
+		for (uint p = 0; p < _elements[e].getPathCount(); ++p)
+			size += _elements[e].getPathInfo(p).getVecLen() * sizeof(ArtBpath);
+	}
+	return size;
+}
+
 // -----------------------------------------------------------------------------
 
 bool VectorImage::fill(const Common::Rect *pFillRect, uint color) {
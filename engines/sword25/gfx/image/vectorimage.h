@@ -181,6 +181,7 @@ public:
 	virtual GraphicEngine::COLOR_FORMATS getColorFormat() const {
 		return GraphicEngine::CF_ARGB32;
 	}
+	virtual uint getMemoryUsage() const;
 	virtual bool fill(const Common::Rect *pFillRect = 0, uint color = BS_RGB(0, 0, 0));
 
 	void render(int width, int height);
@@ -225,6 +226,7 @@ private:
 	Common::Rect                         _boundingBox;
 
 	byte *_pixelData;
+	uint _pixelDataSize;
 
 	Common::String _fname;
 };
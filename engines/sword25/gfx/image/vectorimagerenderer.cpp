@@ -410,8 +410,9 @@ void VectorImage::render(int width, int height) {
 	if (_pixelData)
 		free(_pixelData);
 
-	_pixelData = (byte *)malloc(width * height * 4);
-	memset(_pixelData, 0, width * height * 4);
+	_pixelDataSize = width * height * 4;
+	_pixelData = (byte *)malloc(_pixelDataSize);
+	memset(_pixelData, 0, _pixelDataSize);
 
 	for (uint e = 0; e < _elements.size(); e++) {
 
@@ -129,9 +129,13 @@ static int getSubversionRevision(lua_State *L) {
 }
 
 static int getUsedMemory(lua_State *L) {
-	// It doesn't really matter what this call returns,
-	// as it's used in a debug function.
-	lua_pushnumber(L, 0);
+	Kernel *pKernel = Kernel::getInstance();
+	assert(pKernel);
+	ResourceManager *pResource = pKernel->getResourceManager();
+	assert(pResource);
+
+	// This only covers the memory taken up by resources
+	lua_pushnumber(L, pResource->getUsedMemory());
 	return 1;
 }
 
@@ -339,9 +343,7 @@ static int getMaxMemoryUsage(lua_State *L) {
 	ResourceManager *pResource = pKernel->getResourceManager();
 	assert(pResource);
 
-	// This is used for debugging, so it doesn't really matter.
-	// The default value set by the scripts is 256000000 bytes
-	lua_pushnumber(L, 256000000);
+	lua_pushnumber(L, pResource->getMaxMemoryUsage());
 
 	return 1;
 }
@@ -352,8 +354,13 @@ static int setMaxMemoryUsage(lua_State *L) {
 	ResourceManager *pResource = pKernel->getResourceManager();
 	assert(pResource);
 
-	// This call is ignored, we set a limit on the number of
-	// simultaneous resources loaded instead.
+	// Negative, NaN and too large values do not convert to uint
+	lua_Number maxMemoryUsage = luaL_checknumber(L, 1);
+	if (!(maxMemoryUsage >= 0))
+		maxMemoryUsage = 0;
+	else if (maxMemoryUsage > 0xFFFFFFFF)
+		maxMemoryUsage = 0xFFFFFFFF;
+	pResource->setMaxMemoryUsage(static_cast<uint>(maxMemoryUsage));
 
 	return 0;
 }
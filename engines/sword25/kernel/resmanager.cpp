@@ -37,17 +37,30 @@
 
 namespace Sword25 {
 
-// Sets the amount of resources that are simultaneously loaded.
-// This needs to be a relatively high number, as all the animation
-// frames in each scene are loaded as separate resources.
-// Also, George's walk states are all loaded here (150 files)
-#define SWORD25_RESOURCECACHE_MIN 400
-// The maximum number of loaded resources. If more than these resources
-// are loaded, the resource manager will start purging resources till it
-// hits the minimum limit above
-#define SWORD25_RESOURCECACHE_MAX 500
+// The default number of bytes the loaded resources may take up in memory.
+// This is the same limit the game scripts set.
+#define SWORD25_RESOURCECACHE_MAX_MEMORY 256000000
+// If the loaded resources take up more memory than allowed, the resource
+// manager purges resources till they are below this percentage of the limit.
+// All the animation frames in each scene are loaded as separate resources,
+// so this avoids releasing a resource on nearly every load.
+#define SWORD25_RESOURCECACHE_MIN_PERCENT 80
+// The number of released resources remembered for counting reloads. The
+// list is cleared when it reaches this size, and when the cache is emptied.
+#define SWORD25_RESOURCECACHE_MAX_EVICTED 1024
+
+ResourceManager::ResourceManager(Kernel *pKernel) :
+	_kernelPtr(pKernel),
+	_usedMemory(0),
+	_maxMemoryUsage(SWORD25_RESOURCECACHE_MAX_MEMORY),
+	_evictionCount(0),
+	_reloadCount(0) {
+}
 
 ResourceManager::~ResourceManager() {
+	debugC(kDebugResource, "Resource cache: %u bytes used, %u resources released, %u reloaded",
+	       _usedMemory, _evictionCount, _reloadCount);
+
 	// Clear all unlocked resources
 	emptyCache();
 
@@ -86,32 +99,34 @@ bool ResourceManager::registerResourceService(ResourceService *pService) {
  * Deletes resources as necessary until the specified memory limit is not being exceeded.
  */
 void ResourceManager::deleteResourcesIfNecessary() {
-	// If enough memory is available, or no resources are loaded, then the function can immediately end
-	if (_resources.size() < SWORD25_RESOURCECACHE_MAX)
+	// If enough memory is available, then the function can immediately end
+	if (_usedMemory <= _maxMemoryUsage)
 		return;
 
-	// Keep deleting resources until the memory usage of the process falls below the set maximum limit.
+	const uint minMemoryUsage = _maxMemoryUsage / 100 * SWORD25_RESOURCECACHE_MIN_PERCENT;
+
+	// Keep deleting resources until the memory usage falls below the minimum limit.
 	// The list is processed backwards in order to first release those resources that have been
-	// not been accessed for the longest
+	// not been accessed for the longest. The most recently loaded resource at the front is kept.
 	Common::List<Resource *>::iterator iter = _resources.end();
-	do {
+	while (iter != _resources.begin() && _usedMemory > minMemoryUsage) {
 		--iter;
 
 		// The resource may be released only if it isn't locked
 		if ((*iter)->getLockCount() == 0)
-			iter = deleteResource(*iter);
-	} while (iter != _resources.begin() && _resources.size() >= SWORD25_RESOURCECACHE_MIN);
+			iter = evictResource(*iter);
+	}
 
-	// Are we still above the minimum? If yes, then start releasing locked resources
+	// Are we still above the maximum? If yes, then start releasing locked resources
 	// FIXME: This code shouldn't be needed at all, but it seems like there is a bug
 	// in the resource lock code, and resources are not unlocked when changing rooms.
 	// Only image/animation resources are unlocked forcibly, thus this shouldn't have
 	// any impact on the game itself.
-	if (_resources.size() <= SWORD25_RESOURCECACHE_MIN)
+	if (_usedMemory <= _maxMemoryUsage)
 		return;
 
 	iter = _resources.end();
-	do {
+	while (iter != _resources.begin() && _usedMemory > minMemoryUsage) {
 		--iter;
 
 		// Only unlock image/animation resources
@@ -124,9 +139,14 @@ void ResourceManager::deleteResourcesIfNecessary() {
 			while ((*iter)->getLockCount() > 0)
 				(*iter)->release();
 
-			iter = deleteResource(*iter);
+			iter = evictResource(*iter);
 		}
-	} while (iter != _resources.begin() && _resources.size() >= SWORD25_RESOURCECACHE_MIN);
+	}
+}
+
+void ResourceManager::setMaxMemoryUsage(uint maxMemoryUsage) {
+	_maxMemoryUsage = maxMemoryUsage;
+	deleteResourcesIfNecessary();
 }
 
 /**
@@ -142,6 +162,9 @@ void ResourceManager::emptyCache() {
 		} else
 			++iter;
 	}
+
+	// Loading resources again is expected after this, and not a reload
+	_evictedResources.clear();
 }
 
 void ResourceManager::emptyThumbnailCache() {
@@ -176,6 +199,7 @@ Resource *ResourceManager::requestResource(const Common::String &fileName) {
 		pResource = loadResource(uniqueFileName);
 	if (pResource) {
 		moveToFront(pResource);
+		updateMemoryUsage(pResource);
 		(pResource)->addReference();
 		return pResource;
 	}
@@ -243,9 +267,6 @@ Resource *ResourceManager::loadResource(const Common::String &fileName) {
 	// ResourceService finden, der die Resource laden kann.
 	for (uint i = 0; i < _resourceServices.size(); ++i) {
 		if (_resourceServices[i]->canLoadResource(fileName)) {
-			// If more memory is desired, memory must be released
-			deleteResourcesIfNecessary();
-
 			// Load the resource
 			Resource *pResource = _resourceServices[i]->loadResource(fileName);
 			if (!pResource) {
@@ -260,6 +281,16 @@ Resource *ResourceManager::loadResource(const Common::String &fileName) {
 			// Also store the resource in the hash table for quick lookup
 			_resourceHashMap[pResource->getFileName()] = pResource;
 
+			if (_evictedResources.contains(pResource->getFileName())) {
+				debugC(kDebugResource, "Reloading released resource \"%s\"", pResource->getFileName().c_str());
+				_evictedResources.erase(pResource->getFileName());
+				++_reloadCount;
+			}
+
+			// If more memory is used than allowed, memory must be released
+			updateMemoryUsage(pResource);
+			deleteResourcesIfNecessary();
+
 			return pResource;
 		}
 	}
@@ -296,6 +327,8 @@ Common::List<Resource *>::iterator ResourceManager::deleteResource(Resource *pRe
 	// Remove the resource from the hash table
 	_resourceHashMap.erase(pResource->_fileName);
 
+	_usedMemory -= pResource->_memoryUsage;
+
 	// Delete the resource from the resource list
 	Common::List<Resource *>::iterator result = _resources.erase(pResource->_iterator);
 
@@ -306,6 +339,29 @@ Common::List<Resource *>::iterator ResourceManager::deleteResource(Resource *pRe
 	return result;
 }
 
+/**
+ * Deletes a resource to free memory, and remembers that it was released
+ */
+Common::List<Resource *>::iterator ResourceManager::evictResource(Resource *pResource) {
+	debugC(kDebugResource, "Releasing resource \"%s\" (%u bytes)", pResource->getFileName().c_str(), pResource->_memoryUsage);
+
+	if (_evictedResources.size() >= SWORD25_RESOURCECACHE_MAX_EVICTED)
+		_evictedResources.clear();
+	_evictedResources[pResource->getFileName()] = true;
+	++_evictionCount;
+
+	return deleteResource(pResource);
+}
+
+/**
+ * Updates the memory usage of a resource, which may change while it is loaded
+ */
+void ResourceManager::updateMemoryUsage(Resource *pResource) {
+	const uint memoryUsage = pResource->getMemoryUsage();
+	_usedMemory = _usedMemory - pResource->_memoryUsage + memoryUsage;
+	pResource->_memoryUsage = memoryUsage;
+}
+
 /**
  * Returns a pointer to a loaded resource. If any error occurs, NULL will be returned.
  * @param UniquefileName        The absolute path and filename
@@ -88,14 +88,45 @@ public:
 	 */
 	void dumpLockedResources();
 
+	/**
+	 * Sets the number of bytes the loaded resources may take up in memory.
+	 * When a newly loaded resource exceeds this, the least recently used
+	 * resources which are not locked are released.
+	 */
+	void setMaxMemoryUsage(uint maxMemoryUsage);
+
+	uint getMaxMemoryUsage() const {
+		return _maxMemoryUsage;
+	}
+
+	/**
+	 * Returns the number of bytes currently taken up by the loaded resources
+	 */
+	uint getUsedMemory() const {
+		return _usedMemory;
+	}
+
+	/**
+	 * Returns the number of resources released to stay within the memory limit
+	 */
+	uint getEvictionCount() const {
+		return _evictionCount;
+	}
+
+	/**
+	 * Returns how often a resource had to be loaded again after it was
+	 * released to stay within the memory limit
+	 */
+	uint getReloadCount() const {
+		return _reloadCount;
+	}
+
 private:
 	/**
 	 * Creates a new resource manager
 	 * Only the BS_Kernel class can generate copies this class. Thus, the constructor is private
 	 */
-	ResourceManager(Kernel *pKernel) :
-		_kernelPtr(pKernel)
-	{}
+	ResourceManager(Kernel *pKernel);
 	virtual ~ResourceManager();
 
 	/**
@@ -123,6 +154,16 @@ private:
 	 */
 	Common::List<Resource *>::iterator deleteResource(Resource *pResource);
 
+	/**
+	 * Deletes a resource to free memory, and remembers that it was released
+	 */
+	Common::List<Resource *>::iterator evictResource(Resource *pResource);
+
+	/**
+	 * Updates the memory usage of a resource, which may change while it is loaded
+	 */
+	void updateMemoryUsage(Resource *pResource);
+
 	/**
 	 * Returns a pointer to a loaded resource. If any error occurs, NULL will be returned.
 	 * @param UniqueFileName        The absolute path and filename
@@ -139,6 +180,16 @@ private:
 	Common::List<Resource *> _resources;
 	typedef Common::HashMap<Common::String, Resource *> ResMap;
 	ResMap _resourceHashMap;
+
+	uint _usedMemory;
+	uint _maxMemoryUsage;
+	uint _evictionCount;
+	uint _reloadCount;
+	/**
+	 * The file names of the resources released by deleteResourcesIfNecessary()
+	 * since the cache was last emptied, up to SWORD25_RESOURCECACHE_MAX_EVICTED
+	 */
+	Common::HashMap<Common::String, bool> _evictedResources;
 };
 
 } // End of namespace Sword25
@@ -92,6 +92,12 @@ public:
 		return _type;
 	}
 
+	/**
+	 * Returns the number of bytes the resource takes up in memory. This
+	 * is what the ResourceManager budgets its cache by.
+	 */
+	virtual uint getMemoryUsage() const = 0;
+
 protected:
 	virtual ~Resource() {}
 
@@ -99,6 +105,7 @@ private:
 	Common::String _fileName;          ///< The absolute filename
 	uint _refCount;          ///< The number of locks
 	uint _type;              ///< The type of the resource
+	uint _memoryUsage;       ///< The memory usage accounted for by the ResourceManager
 	Common::List<Resource *>::iterator _iterator;        ///< Points to the resource position in the LRU list
 };
 
@@ -50,6 +50,11 @@ public:
 		debugC(1, kDebugSound, "SoundResource: Unloading file %s", _fname.c_str());
 	}
 
+	// The sound data is streamed from the file when played
+	virtual uint getMemoryUsage() const {
+		return sizeof(*this);
+	}
+
 private:
 	Common::String _fname;
 };
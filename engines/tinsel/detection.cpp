@@ -97,6 +97,7 @@ public:
 	}
 
 	virtual bool createInstance(OSystem *syst, Engine **engine, const ADGameDescription *desc) const;
+	virtual bool getDetectionFileNames(Common::StringArray &fileNames) const { return false; }
 	const ADGameDescription *fallbackDetect(const FileMap &allFiles, const Common::FSList &fslist) const;
 
 	virtual bool hasFeature(MetaEngineFeature f) const;
@@ -132,6 +132,8 @@ public:
 		_directoryGlobs = directoryGlobs;
 	}
 
+	virtual bool getDetectionFileNames(Common::StringArray &fileNames) const { return false; }
+
 	virtual const ADGameDescription *fallbackDetect(const FileMap &allFiles, const Common::FSList &fslist) const {
 		return detectGameFilebased(allFiles, fslist, Toon::fileBasedFallback);
 	}
@@ -60,7 +60,6 @@ BaseRenderOSystem::BaseRenderOSystem(BaseGame *inGame) : BaseRenderer(inGame) {
 	_ratioX = _ratioY = 1.0f;
 	setAlphaMod(255);
 	setColorMod(255, 255, 255);
-	_dirtyRect = nullptr;
 	_disableDirtyRects = false;
 	if (ConfMan.hasKey("dirty_rects")) {
 		_disableDirtyRects = !ConfMan.getBool("dirty_rects");
@@ -73,16 +72,13 @@ BaseRenderOSystem::~BaseRenderOSystem() {
 	while (it != _renderQueue.end()) {
 		RenderTicket *ticket = *it;
 		it = _renderQueue.erase(it);
-		delete ticket;
+		deleteTicket(ticket);
 	}
 
-	delete _dirtyRect;
-
 	_renderSurface->free();
 	delete _renderSurface;
 	_blankSurface->free();
 	delete _blankSurface;
-	TransparentSurface::destroyLookup();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -168,8 +164,7 @@ bool BaseRenderOSystem::indicatorFlip() {
 bool BaseRenderOSystem::flip() {
 	if (_skipThisFrame) {
 		_skipThisFrame = false;
-		delete _dirtyRect;
-		_dirtyRect = nullptr;
+		_dirtyRects.reset();
 		g_system->updateScreen();
 		_needsFlip = false;
 		_drawNum = 1;
@@ -185,7 +180,7 @@ bool BaseRenderOSystem::flip() {
 			if ((*it)->_wantsDraw == false) {
 				RenderTicket *ticket = *it;
 				it = _renderQueue.erase(it);
-				delete ticket;
+				deleteTicket(ticket);
 			} else {
 				(*it)->_wantsDraw = false;
 				++it;
@@ -196,9 +191,7 @@ bool BaseRenderOSystem::flip() {
 		if (_disableDirtyRects) {
 			g_system->copyRectToScreen((byte *)_renderSurface->pixels, _renderSurface->pitch, 0, 0, _renderSurface->w, _renderSurface->h);
 		}
-		//  g_system->copyRectToScreen((byte *)_renderSurface->pixels, _renderSurface->pitch, _dirtyRect->left, _dirtyRect->top, _dirtyRect->width(), _dirtyRect->height());
-		delete _dirtyRect;
-		_dirtyRect = nullptr;
+		_dirtyRects.reset();
 		g_system->updateScreen();
 		_needsFlip = false;
 	}
@@ -295,26 +288,31 @@ void BaseRenderOSystem::drawSurface(BaseSurfaceOSystem *owner, const Graphics::S
 			_batchNum++;
 		}
 		compare._colorMod = _colorMod;
-		RenderQueueIterator it;
-		// Avoid calling end() and operator* every time, when potentially going through
-		// LOTS of tickets.
-		RenderQueueIterator endIterator = _renderQueue.end();
-		RenderTicket *compareTicket = nullptr;
-		for (it = _lastAddedTicket; it != endIterator; ++it) {
-			compareTicket = *it;
-			if (*(compareTicket) == compare && compareTicket->_isValid) {
-				compareTicket->_colorMod = _colorMod;
-				if (_disableDirtyRects) {
+		if (_disableDirtyRects) {
+			RenderQueueIterator it;
+			// Avoid calling end() and operator* every time, when potentially going through
+			// LOTS of tickets.
+			RenderQueueIterator endIterator = _renderQueue.end();
+			RenderTicket *compareTicket = nullptr;
+			for (it = _lastAddedTicket; it != endIterator; ++it) {
+				compareTicket = *it;
+				if (*(compareTicket) == compare && compareTicket->_isValid) {
+					compareTicket->_colorMod = _colorMod;
 					drawFromSurface(compareTicket);
-				} else {
-					drawFromTicket(compareTicket);
-					_previousTicket = compareTicket;
+					return;
 				}
+			}
+		} else {
+			RenderTicket *compareTicket = findReusableTicket(compare);
+			if (compareTicket) {
+				compareTicket->_colorMod = _colorMod;
+				drawFromTicket(compareTicket);
+				_previousTicket = compareTicket;
 				return;
 			}
 		}
 	}
-	RenderTicket *ticket = new RenderTicket(owner, surf, srcRect, dstRect, mirrorX, mirrorY, disableAlpha);
+	RenderTicket *ticket = createTicket(owner, surf, srcRect, dstRect, mirrorX, mirrorY, disableAlpha);
 	ticket->_colorMod = _colorMod;
 	if (!_disableDirtyRects) {
 		drawFromTicket(ticket);
@@ -367,17 +365,87 @@ void BaseRenderOSystem::repeatLastDraw(int offsetX, int offsetY, int numTimesX,
 
 void BaseRenderOSystem::invalidateTicket(RenderTicket *renderTicket) {
 	addDirtyRect(renderTicket->_dstRect);
+	if (renderTicket->_isValid) {
+		unlinkTicket(renderTicket);
+	}
 	renderTicket->_isValid = false;
 //	renderTicket->_canDelete = true; // TODO: Maybe readd this, to avoid even more duplicates.
 }
 
 void BaseRenderOSystem::invalidateTicketsFromSurface(BaseSurfaceOSystem *surf) {
-	RenderQueueIterator it;
-	for (it = _renderQueue.begin(); it != _renderQueue.end(); ++it) {
-		if ((*it)->_owner == surf) {
-			invalidateTicket(*it);
+	TicketIndex::iterator first = _ticketsByOwner.find(surf);
+	if (first == _ticketsByOwner.end()) {
+		return;
+	}
+	RenderTicket *ticket = first->_value;
+	_ticketsByOwner.erase(first);
+	while (ticket) {
+		RenderTicket *next = ticket->_nextOwnerTicket;
+		ticket->_prevOwnerTicket = ticket->_nextOwnerTicket = nullptr;
+		ticket->_isValid = false;
+		addDirtyRect(ticket->_dstRect);
+		ticket = next;
+	}
+}
+
+RenderTicket *BaseRenderOSystem::createTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRect, bool mirrorX, bool mirrorY, bool disableAlpha) {
+	RenderTicket *ticket = new (_ticketPool) RenderTicket(owner, surf, srcRect, dstRect, mirrorX, mirrorY, disableAlpha);
+	if (owner) {
+		RenderTicket *&first = _ticketsByOwner[owner];
+		ticket->_nextOwnerTicket = first;
+		if (first) {
+			first->_prevOwnerTicket = ticket;
 		}
+		first = ticket;
 	}
+	return ticket;
+}
+
+void BaseRenderOSystem::deleteTicket(RenderTicket *ticket) {
+	if (ticket->_isValid) {
+		unlinkTicket(ticket);
+	}
+	_ticketPool.deleteChunk(ticket);
+}
+
+void BaseRenderOSystem::unlinkTicket(RenderTicket *ticket) {
+	if (!ticket->_owner) {
+		return;
+	}
+	if (ticket->_prevOwnerTicket) {
+		ticket->_prevOwnerTicket->_nextOwnerTicket = ticket->_nextOwnerTicket;
+	} else if (ticket->_nextOwnerTicket) {
+		_ticketsByOwner[ticket->_owner] = ticket->_nextOwnerTicket;
+	} else {
+		_ticketsByOwner.erase(ticket->_owner);
+	}
+	if (ticket->_nextOwnerTicket) {
+		ticket->_nextOwnerTicket->_prevOwnerTicket = ticket->_prevOwnerTicket;
+	}
+	ticket->_prevOwnerTicket = ticket->_nextOwnerTicket = nullptr;
+}
+
+RenderTicket *BaseRenderOSystem::findReusableTicket(RenderTicket &compare) {
+	// Tickets from before _lastAddedTicket have already been drawn this frame.
+	// The queue is ordered by _drawNum, so instead of walking the queue from
+	// there, look for the matching ticket of the same owner that comes first
+	// after it.
+	if (_lastAddedTicket == _renderQueue.end()) {
+		return nullptr;
+	}
+	uint32 minDrawNum = (*_lastAddedTicket)->_drawNum;
+
+	TicketIndex::iterator first = _ticketsByOwner.find(compare._owner);
+	if (first == _ticketsByOwner.end()) {
+		return nullptr;
+	}
+	RenderTicket *found = nullptr;
+	for (RenderTicket *ticket = first->_value; ticket; ticket = ticket->_nextOwnerTicket) {
+		if (ticket->_drawNum >= minDrawNum && (!found || ticket->_drawNum < found->_drawNum) && *ticket == compare) {
+			found = ticket;
+		}
+	}
+	return found;
 }
 
 void BaseRenderOSystem::drawFromTicket(RenderTicket *renderTicket) {
@@ -439,12 +507,7 @@ void BaseRenderOSystem::drawFromTicket(RenderTicket *renderTicket) {
 }
 
 void BaseRenderOSystem::addDirtyRect(const Common::Rect &rect) {
-	if (!_dirtyRect) {
-		_dirtyRect = new Common::Rect(rect);
-	} else {
-		_dirtyRect->extend(rect);
-	}
-	_dirtyRect->clip(_renderRect);
+	_dirtyRects.addDirtyRect(rect, _renderRect);
 }
 
 void BaseRenderOSystem::drawTickets() {
@@ -459,14 +522,14 @@ void BaseRenderOSystem::drawTickets() {
 			RenderTicket *ticket = *it;
 			addDirtyRect((*it)->_dstRect);
 			it = _renderQueue.erase(it);
-			delete ticket;
+			deleteTicket(ticket);
 			decrement++;
 		} else {
 			(*it)->_drawNum -= decrement;
 			++it;
 		}
 	}
-	if (!_dirtyRect || _dirtyRect->width() == 0 || _dirtyRect->height() == 0) {
+	if (_dirtyRects.isEmpty()) {
 		it = _renderQueue.begin();
 		while (it != _renderQueue.end()) {
 			RenderTicket *ticket = *it;
@@ -479,32 +542,43 @@ void BaseRenderOSystem::drawTickets() {
 	// draw, we need to keep track of what it was prior to draw.
 	uint32 oldColorMod = _colorMod;
 
-	// Apply the clear-color to the dirty rect.
-	_renderSurface->fillRect(*_dirtyRect, _clearColor);
+	// The dirty rects don't overlap, so every ticket can simply be drawn
+	// into each of them in turn.
+	const Common::Array<Common::Rect> &dirtyRects = _dirtyRects.getRects();
+
+	// Apply the clear-color to the dirty rects.
+	for (uint i = 0; i < dirtyRects.size(); i++) {
+		_renderSurface->fillRect(dirtyRects[i], _clearColor);
+	}
 	_drawNum = 1;
 	for (it = _renderQueue.begin(); it != _renderQueue.end(); ++it) {
 		RenderTicket *ticket = *it;
 		assert(ticket->_drawNum == _drawNum++);
-		if (ticket->_dstRect.intersects(*_dirtyRect)) {
-			// dstClip is the area we want redrawn.
-			Common::Rect dstClip(ticket->_dstRect);
-			// reduce it to the dirty rect
-			dstClip.clip(*_dirtyRect);
-			// we need to keep track of the position to redraw the dirty rect
-			Common::Rect pos(dstClip);
-			int16 offsetX = ticket->_dstRect.left;
-			int16 offsetY = ticket->_dstRect.top;
-			// convert from screen-coords to surface-coords.
-			dstClip.translate(-offsetX, -offsetY);
-
-			_colorMod = ticket->_colorMod;
-			drawFromSurface(ticket, &pos, &dstClip);
-			_needsFlip = true;
+		for (uint i = 0; i < dirtyRects.size(); i++) {
+			if (ticket->_dstRect.intersects(dirtyRects[i])) {
+				// dstClip is the area we want redrawn.
+				Common::Rect dstClip(ticket->_dstRect);
+				// reduce it to the dirty rect
+				dstClip.clip(dirtyRects[i]);
+				// we need to keep track of the position to redraw the dirty rect
+				Common::Rect pos(dstClip);
+				int16 offsetX = ticket->_dstRect.left;
+				int16 offsetY = ticket->_dstRect.top;
+				// convert from screen-coords to surface-coords.
+				dstClip.translate(-offsetX, -offsetY);
+
+				_colorMod = ticket->_colorMod;
+				drawFromSurface(ticket, &pos, &dstClip);
+				_needsFlip = true;
+			}
 		}
 		// Some tickets want redraw but don't actually clip the dirty area (typically the ones that shouldnt become clear-color)
 		ticket->_wantsDraw = false;
 	}
-	g_system->copyRectToScreen((byte *)_renderSurface->getBasePtr(_dirtyRect->left, _dirtyRect->top), _renderSurface->pitch, _dirtyRect->left, _dirtyRect->top, _dirtyRect->width(), _dirtyRect->height());
+	for (uint i = 0; i < dirtyRects.size(); i++) {
+		const Common::Rect &rect = dirtyRects[i];
+		g_system->copyRectToScreen((byte *)_renderSurface->getBasePtr(rect.left, rect.top), _renderSurface->pitch, rect.left, rect.top, rect.width(), rect.height());
+	}
 
 	// Revert the colorMod-state.
 	_colorMod = oldColorMod;
@@ -517,7 +591,7 @@ void BaseRenderOSystem::drawTickets() {
 			RenderTicket *ticket = *it;
 			addDirtyRect((*it)->_dstRect);
 			it = _renderQueue.erase(it);
-			delete ticket;
+			deleteTicket(ticket);
 			decrement++;
 		} else {
 			(*it)->_drawNum -= decrement;
@@ -646,7 +720,7 @@ void BaseRenderOSystem::endSaveLoad() {
 	while (it != _renderQueue.end()) {
 		RenderTicket *ticket = *it;
 		it = _renderQueue.erase(it);
-		delete ticket;
+		deleteTicket(ticket);
 	}
 	_lastAddedTicket = _renderQueue.begin();
 	_previousTicket = nullptr;
@@ -30,13 +30,16 @@
 #define WINTERMUTE_BASE_RENDERER_SDL_H
 
 #include "engines/wintermute/base/gfx/base_renderer.h"
+#include "engines/wintermute/base/gfx/osystem/dirty_rect_container.h"
+#include "engines/wintermute/base/gfx/osystem/render_ticket.h"
 #include "common/rect.h"
 #include "graphics/surface.h"
 #include "common/list.h"
+#include "common/hashmap.h"
+#include "common/memorypool.h"
 
 namespace Wintermute {
 class BaseSurfaceOSystem;
-class RenderTicket;
 class BaseRenderOSystem : public BaseRenderer {
 public:
 	BaseRenderOSystem(BaseGame *inGame);
@@ -90,8 +93,24 @@ private:
 	void drawFromSurface(RenderTicket *ticket);
 	// Dirty-rects:
 	void drawFromSurface(RenderTicket *ticket, Common::Rect *dstRect, Common::Rect *clipRect);
+	// Tickets come from _ticketPool, and valid ones are indexed by their owner:
+	RenderTicket *createTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRect, bool mirrorX, bool mirrorY, bool disableAlpha);
+	void deleteTicket(RenderTicket *ticket);
+	void unlinkTicket(RenderTicket *ticket);
+	RenderTicket *findReusableTicket(RenderTicket &compare);
 	typedef Common::List<RenderTicket *>::iterator RenderQueueIterator;
-	Common::Rect *_dirtyRect;
+
+	struct SurfacePtrHash {
+		uint operator()(const BaseSurfaceOSystem *surf) const {
+			return (uint)((size_t)surf >> 3);
+		}
+	};
+	typedef Common::HashMap<BaseSurfaceOSystem *, RenderTicket *, SurfacePtrHash> TicketIndex;
+
+	Common::ObjectPool<RenderTicket, 256> _ticketPool;
+	// First valid ticket of every surface that has any
+	TicketIndex _ticketsByOwner;
+	DirtyRectContainer _dirtyRects;
 	Common::List<RenderTicket *> _renderQueue;
 	RenderQueueIterator _lastAddedTicket;
 	RenderTicket *_previousTicket;
@@ -0,0 +1,111 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "engines/wintermute/base/gfx/osystem/dirty_rect_container.h"
+
+namespace Wintermute {
+
+DirtyRectContainer::DirtyRectContainer() {
+}
+
+void DirtyRectContainer::addDirtyRect(const Common::Rect &rect, const Common::Rect &clipRect) {
+	Common::Rect newRect(rect);
+	newRect.clip(clipRect);
+	if (newRect.isEmpty()) {
+		return;
+	}
+
+	insert(newRect);
+
+	// Too many rects, merge the pairs that waste the fewest pixels.
+	while (_rects.size() > kMaxRects) {
+		uint bestA = 0, bestB = 1;
+		uint32 bestWaste = 0xFFFFFFFF;
+		for (uint i = 0; i < _rects.size(); i++) {
+			for (uint j = i + 1; j < _rects.size(); j++) {
+				uint32 waste = wastedArea(_rects[i], _rects[j]);
+				if (waste < bestWaste) {
+					bestWaste = waste;
+					bestA = i;
+					bestB = j;
+				}
+			}
+		}
+		Common::Rect boundingBox(_rects[bestA]);
+		boundingBox.extend(_rects[bestB]);
+		_rects.remove_at(bestB);
+		_rects.remove_at(bestA);
+		insert(boundingBox);
+	}
+}
+
+void DirtyRectContainer::insert(Common::Rect newRect) {
+	// Swallow every rect that the new one should be merged with. Growing the
+	// new rect can make it mergeable with rects checked before, so start over
+	// after each merge.
+	bool merged = true;
+	while (merged) {
+		merged = false;
+		for (uint i = 0; i < _rects.size(); i++) {
+			if (_rects[i].contains(newRect)) {
+				return;
+			}
+			if (shouldMerge(_rects[i], newRect)) {
+				newRect.extend(_rects[i]);
+				_rects.remove_at(i);
+				merged = true;
+				break;
+			}
+		}
+	}
+	_rects.push_back(newRect);
+}
+
+void DirtyRectContainer::reset() {
+	_rects.clear();
+}
+
+uint32 DirtyRectContainer::getArea() const {
+	uint32 total = 0;
+	for (uint i = 0; i < _rects.size(); i++) {
+		total += area(_rects[i]);
+	}
+	return total;
+}
+
+bool DirtyRectContainer::shouldMerge(const Common::Rect &a, const Common::Rect &b) {
+	// Overlapping rects are always merged, so that nothing is drawn twice.
+	if (a.intersects(b)) {
+		return true;
+	}
+
+	return wastedArea(a, b) <= (area(a) + area(b)) / 2 + kRectOverhead;
+}
+
+uint32 DirtyRectContainer::wastedArea(const Common::Rect &a, const Common::Rect &b) {
+	// Only used for disjoint rects
+	Common::Rect boundingBox(a);
+	boundingBox.extend(b);
+	return area(boundingBox) - area(a) - area(b);
+}
+
+} // end of namespace Wintermute
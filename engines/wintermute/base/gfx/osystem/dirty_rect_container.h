@@ -0,0 +1,76 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef WINTERMUTE_DIRTY_RECT_CONTAINER_H
+#define WINTERMUTE_DIRTY_RECT_CONTAINER_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Wintermute {
+
+/**
+ * The set of screen areas that have to be redrawn in the next frame.
+ *
+ * Rather than growing a single bounding box, which turns two small sprites
+ * in opposite corners into a full screen redraw, every change is kept as a
+ * separate rectangle. Rectangles that overlap, or that are close enough that
+ * their bounding box wastes few pixels, are merged, so the list always holds
+ * a handful of disjoint rectangles.
+ */
+class DirtyRectContainer {
+public:
+	DirtyRectContainer();
+
+	/** Marks rect as dirty, clipped to clipRect */
+	void addDirtyRect(const Common::Rect &rect, const Common::Rect &clipRect);
+	void reset();
+
+	bool isEmpty() const { return _rects.empty(); }
+	/** The disjoint dirty rectangles, in no particular order */
+	const Common::Array<Common::Rect> &getRects() const { return _rects; }
+	/** The number of dirty pixels */
+	uint32 getArea() const;
+
+private:
+	enum {
+		/**
+		 * Every dirty rectangle means another pass over the render queue and
+		 * another copyRectToScreen call, so beyond this many the closest ones
+		 * are merged.
+		 */
+		kMaxRects = 16,
+		/** Pixels we are willing to redraw needlessly to save a rectangle */
+		kRectOverhead = 32 * 32
+	};
+
+	static uint32 area(const Common::Rect &rect) { return rect.width() * rect.height(); }
+	static bool shouldMerge(const Common::Rect &a, const Common::Rect &b);
+	static uint32 wastedArea(const Common::Rect &a, const Common::Rect &b);
+	void insert(Common::Rect newRect);
+
+	Common::Array<Common::Rect> _rects;
+};
+
+} // end of namespace Wintermute
+
+#endif
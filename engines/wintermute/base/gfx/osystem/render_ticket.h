@@ -38,7 +38,7 @@ class BaseSurfaceOSystem;
 class RenderTicket {
 public:
 	RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRest, bool mirrorX = false, bool mirrorY = false, bool disableAlpha = false);
-	RenderTicket() : _isValid(true), _wantsDraw(false), _drawNum(0) {}
+	RenderTicket() : _isValid(true), _wantsDraw(false), _drawNum(0), _prevOwnerTicket(nullptr), _nextOwnerTicket(nullptr) {}
 	~RenderTicket();
 	const Graphics::Surface *getSurface() { return _surface; }
 	// Non-dirty-rects:
@@ -55,6 +55,9 @@ public:
 	uint32 _colorMod;
 
 	BaseSurfaceOSystem *_owner;
+	// Links between the valid tickets of the same owner, maintained by BaseRenderOSystem
+	RenderTicket *_prevOwnerTicket;
+	RenderTicket *_nextOwnerTicket;
 	bool operator==(RenderTicket &a);
 	const Common::Rect *getSrcRect() { return &_srcRect; }
 private:
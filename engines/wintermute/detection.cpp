@@ -87,6 +87,8 @@ public:
 		return "Copyright (c) 2011 Jan Nedoma";
 	}
 
+	virtual bool getDetectionFileNames(Common::StringArray &fileNames) const { return false; }
+
 	virtual const ADGameDescription *fallbackDetect(const FileMap &allFiles, const Common::FSList &fslist) const {
 		// Set some defaults
 		s_fallbackDesc.extra = "";
@@ -0,0 +1,496 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "engines/wintermute/graphics/transparent_surface_simd.h"
+#include "common/cpudetect.h"
+
+// The vectorized kernels assume the pixels are stored as B, G, R, A bytes.
+#ifdef SCUMM_LITTLE_ENDIAN
+#ifdef SCUMMVM_HAVE_X86_SIMD
+#define BLIT_USE_X86_SIMD
+#include <immintrin.h>
+#endif
+#ifdef SCUMMVM_HAVE_NEON
+#define BLIT_USE_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace Wintermute {
+
+#pragma mark -
+#pragma mark --- Scalar kernels ---
+#pragma mark -
+
+#ifdef SCUMM_LITTLE_ENDIAN
+static const int aIndex = 3;
+static const int bIndex = 0;
+static const int gIndex = 1;
+static const int rIndex = 2;
+#else
+static const int aIndex = 0;
+static const int bIndex = 3;
+static const int gIndex = 2;
+static const int rIndex = 1;
+#endif
+
+static const int bShift = 0;//img->format.bShift;
+static const int gShift = 8;//img->format.gShift;
+static const int rShift = 16;//img->format.rShift;
+static const int aShift = 24;//img->format.aShift;
+
+static const int bShiftTarget = 0;//target.format.bShift;
+static const int gShiftTarget = 8;//target.format.gShift;
+static const int rShiftTarget = 16;//target.format.rShift;
+
+static void blitOpaqueScalar(const byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
+	const byte *in;
+	byte *out;
+
+	for (uint32 i = 0; i < height; i++) {
+		out = outo;
+		in = ino;
+		memcpy(out, in, width * 4);
+		for (uint32 j = 0; j < width; j++) {
+			out[aIndex] = 0xFF;
+			out += 4;
+		}
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+static void blitAlphaScalar(const byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
+	const byte *in;
+	byte *out;
+
+	for (uint32 i = 0; i < height; i++) {
+		out = outo;
+		in = ino;
+		for (uint32 j = 0; j < width; j++) {
+			uint32 pix = *(const uint32 *)in;
+			uint32 oPix = *(uint32 *) out;
+			int b = (pix >> bShift) & 0xff;
+			int g = (pix >> gShift) & 0xff;
+			int r = (pix >> rShift) & 0xff;
+			int a = (pix >> aShift) & 0xff;
+			int outb, outg, outr, outa;
+			in += inStep;
+
+			switch (a) {
+				case 0: // Full transparency
+					out += 4;
+					break;
+				case 255: // Full opacity
+					outb = b;
+					outg = g;
+					outr = r;
+					outa = a;
+
+					out[aIndex] = outa;
+					out[bIndex] = outb;
+					out[gIndex] = outg;
+					out[rIndex] = outr;
+					out += 4;
+					break;
+
+				default: // alpha blending
+					outa = 255;
+
+					outb = (((oPix >> bShiftTarget) & 0xff) * (255 - a)) >> 8;
+					outg = (((oPix >> gShiftTarget) & 0xff) * (255 - a)) >> 8;
+					outr = (((oPix >> rShiftTarget) & 0xff) * (255 - a)) >> 8;
+					outb += (b * a) >> 8;
+					outg += (g * a) >> 8;
+					outr += (r * a) >> 8;
+
+					out[aIndex] = outa;
+					out[bIndex] = outb;
+					out[gIndex] = outg;
+					out[rIndex] = outr;
+					out += 4;
+			}
+		}
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+static void blitColorModScalar(const byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, int ca, int cr, int cg, int cb) {
+	const byte *in;
+	byte *out;
+
+	for (uint32 i = 0; i < height; i++) {
+		out = outo;
+		in = ino;
+		for (uint32 j = 0; j < width; j++) {
+			uint32 pix = *(const uint32 *)in;
+			uint32 o_pix = *(uint32 *) out;
+			int b = (pix >> bShift) & 0xff;
+			int g = (pix >> gShift) & 0xff;
+			int r = (pix >> rShift) & 0xff;
+			int a = (pix >> aShift) & 0xff;
+			int outb, outg, outr, outa;
+			in += inStep;
+
+			if (ca != 255) {
+				a = a * ca >> 8;
+			}
+
+			switch (a) {
+			case 0: // Full transparency
+				out += 4;
+				break;
+			case 255: // Full opacity
+				if (cb != 255)
+					outb = (b * cb) >> 8;
+				else
+					outb = b;
+
+				if (cg != 255)
+					outg = (g * cg) >> 8;
+				else
+					outg = g;
+
+				if (cr != 255)
+					outr = (r * cr) >> 8;
+				else
+					outr = r;
+				outa = a;
+				out[aIndex] = outa;
+				out[bIndex] = outb;
+				out[gIndex] = outg;
+				out[rIndex] = outr;
+				out += 4;
+				break;
+
+			default: // alpha blending
+				outa = 255;
+				outb = (o_pix >> bShiftTarget) & 0xff;
+				outg = (o_pix >> gShiftTarget) & 0xff;
+				outr = (o_pix >> rShiftTarget) & 0xff;
+				if (cb == 0)
+					outb = 0;
+				else if (cb != 255)
+					outb += ((b - outb) * a * cb) >> 16;
+				else
+					outb += ((b - outb) * a) >> 8;
+				if (cg == 0)
+					outg = 0;
+				else if (cg != 255)
+					outg += ((g - outg) * a * cg) >> 16;
+				else
+					outg += ((g - outg) * a) >> 8;
+				if (cr == 0)
+					outr = 0;
+				else if (cr != 255)
+					outr += ((r - outr) * a * cr) >> 16;
+				else
+					outr += ((r - outr) * a) >> 8;
+				out[aIndex] = outa;
+				out[bIndex] = outb;
+				out[gIndex] = outg;
+				out[rIndex] = outr;
+				out += 4;
+			}
+		}
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+static const BlitKernels s_scalarKernels = { blitOpaqueScalar, blitAlphaScalar, blitColorModScalar, "scalar" };
+
+/*
+ * The vectorized kernels handle four (SSE2) or sixteen (NEON) pixels at a
+ * time and leave the rest of each row to the scalar kernels.
+ *
+ * The SSE2 kernels keep using the scalar code for the color modulated blend
+ * and for flipped alpha blits, which they do not speed up.
+ *
+ * The color modulated blend computes ((x - o) * a * c) >> 16 for every
+ * channel. When c is 255 the scalar code uses ((x - o) * a) >> 8 instead,
+ * which is the same as using 256 for c, so every channel gets a factor k
+ * that is either c or 256. The same factor also gives the result for fully
+ * opaque pixels, (x * k) >> 8.
+ */
+
+#ifdef BLIT_USE_X86_SIMD
+
+#pragma mark -
+#pragma mark --- SSE2 kernels ---
+#pragma mark -
+
+// Replicate the alpha of every pixel into its other channels
+SCUMMVM_TARGET_SSE2
+static inline __m128i broadcastAlphaSSE2(__m128i pixels16) {
+	return _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels16, 0xFF), 0xFF);
+}
+
+SCUMMVM_TARGET_SSE2
+static inline __m128i selectSSE2(__m128i mask, __m128i a, __m128i b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+SCUMMVM_TARGET_SSE2
+static void blitOpaqueSSE2(const byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
+	const __m128i alphaMask = _mm_set1_epi32((int)0xFF000000);
+
+	for (uint32 i = 0; i < height; i++) {
+		const byte *in = ino;
+		byte *out = outo;
+		uint32 j = 0;
+		for (; j + 4 <= width; j += 4, in += 16, out += 16)
+			_mm_storeu_si128((__m128i *)out, _mm_or_si128(_mm_loadu_si128((const __m128i *)in), alphaMask));
+
+		blitOpaqueScalar(in, out, width - j, 1, pitch, inStep, inoStep);
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+SCUMMVM_TARGET_SSE2
+static void blitAlphaSSE2(const byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i full = _mm_set1_epi32(255);
+	const __m128i max16 = _mm_set1_epi16(255);
+	const __m128i alphaMask = _mm_set1_epi32((int)0xFF000000);
+
+	if (inStep < 0) {
+		blitAlphaScalar(ino, outo, width, height, pitch, inStep, inoStep);
+		return;
+	}
+
+	for (uint32 i = 0; i < height; i++) {
+		const byte *in = ino;
+		byte *out = outo;
+		uint32 j = 0;
+		for (; j + 4 <= width; j += 4, in += 16, out += 16) {
+			const __m128i src = _mm_loadu_si128((const __m128i *)in);
+			const __m128i alpha = _mm_srli_epi32(src, 24);
+			const __m128i transparent = _mm_cmpeq_epi32(alpha, zero);
+			const __m128i opaque = _mm_cmpeq_epi32(alpha, full);
+
+			if (_mm_movemask_epi8(transparent) == 0xFFFF)
+				continue;
+			if (_mm_movemask_epi8(opaque) == 0xFFFF) {
+				_mm_storeu_si128((__m128i *)out, src);
+				continue;
+			}
+
+			const __m128i dst = _mm_loadu_si128((const __m128i *)out);
+			const __m128i srcLo = _mm_unpacklo_epi8(src, zero);
+			const __m128i srcHi = _mm_unpackhi_epi8(src, zero);
+			const __m128i dstLo = _mm_unpacklo_epi8(dst, zero);
+			const __m128i dstHi = _mm_unpackhi_epi8(dst, zero);
+			const __m128i aLo = broadcastAlphaSSE2(srcLo);
+			const __m128i aHi = broadcastAlphaSSE2(srcHi);
+
+			// (o * (255 - a)) >> 8 + (x * a) >> 8, the products fit in 16 bits
+			const __m128i resLo = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(dstLo, _mm_sub_epi16(max16, aLo)), 8),
+			                                    _mm_srli_epi16(_mm_mullo_epi16(srcLo, aLo), 8));
+			const __m128i resHi = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(dstHi, _mm_sub_epi16(max16, aHi)), 8),
+			                                    _mm_srli_epi16(_mm_mullo_epi16(srcHi, aHi), 8));
+			const __m128i blended = _mm_or_si128(_mm_packus_epi16(resLo, resHi), alphaMask);
+
+			_mm_storeu_si128((__m128i *)out, selectSSE2(transparent, dst, selectSSE2(opaque, src, blended)));
+		}
+
+		blitAlphaScalar(in, out, width - j, 1, pitch, inStep, inoStep);
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+static const BlitKernels s_sse2Kernels = { blitOpaqueSSE2, blitAlphaSSE2, blitColorModScalar, "SSE2" };
+
+#endif // BLIT_USE_X86_SIMD
+
+#ifdef BLIT_USE_NEON
+
+#pragma mark -
+#pragma mark --- NEON kernels ---
+#pragma mark -
+
+static inline uint8x16_t reverseNEON(uint8x16_t v) {
+	v = vrev64q_u8(v);
+	return vextq_u8(v, v, 8);
+}
+
+// Load sixteen pixels in the order they are written to the target, split
+// into their channels
+static inline uint8x16x4_t loadPixelsNEON(const byte *in, int32 inStep) {
+	if (inStep > 0)
+		return vld4q_u8(in);
+
+	uint8x16x4_t pixels = vld4q_u8(in - 60);
+	for (int c = 0; c < 4; c++)
+		pixels.val[c] = reverseNEON(pixels.val[c]);
+	return pixels;
+}
+
+// (x * y) >> 8
+static inline uint8x16_t mulShiftNEON(uint8x16_t x, uint8x16_t y) {
+	return vcombine_u8(vshrn_n_u16(vmull_u8(vget_low_u8(x), vget_low_u8(y)), 8),
+	                   vshrn_n_u16(vmull_u8(vget_high_u8(x), vget_high_u8(y)), 8));
+}
+
+// o + (((x - o) * m) >> 16) for eight channels
+static inline uint8x8_t blendHalfNEON(uint8x8_t x, uint8x8_t o, uint16x8_t m) {
+	const int16x8_t diff = vreinterpretq_s16_u16(vsubl_u8(x, o));
+	const int32x4_t p0 = vmulq_s32(vmovl_s16(vget_low_s16(diff)), vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(m))));
+	const int32x4_t p1 = vmulq_s32(vmovl_s16(vget_high_s16(diff)), vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(m))));
+	const int16x8_t delta = vcombine_s16(vmovn_s32(vshrq_n_s32(p0, 16)), vmovn_s32(vshrq_n_s32(p1, 16)));
+	return vqmovun_s16(vaddq_s16(vreinterpretq_s16_u16(vmovl_u8(o)), delta));
+}
+
+static void blitOpaqueNEON(const byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
+	const uint32x4_t alphaMask = vdupq_n_u32(0xFF000000);
+
+	for (uint32 i = 0; i < height; i++) {
+		const byte *in = ino;
+		byte *out = outo;
+		uint32 j = 0;
+		for (; j + 4 <= width; j += 4, in += 16, out += 16)
+			vst1q_u32((uint32 *)out, vorrq_u32(vld1q_u32((const uint32 *)in), alphaMask));
+
+		blitOpaqueScalar(in, out, width - j, 1, pitch, inStep, inoStep);
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+static void blitAlphaNEON(const byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep) {
+	const uint8x16_t zero = vdupq_n_u8(0);
+	const uint8x16_t full = vdupq_n_u8(255);
+
+	for (uint32 i = 0; i < height; i++) {
+		const byte *in = ino;
+		byte *out = outo;
+		uint32 j = 0;
+		for (; j + 16 <= width; j += 16, in += 16 * inStep, out += 64) {
+			const uint8x16x4_t src = loadPixelsNEON(in, inStep);
+			const uint8x16x4_t dst = vld4q_u8(out);
+			const uint8x16_t alpha = src.val[3];
+			const uint8x16_t invAlpha = vmvnq_u8(alpha);
+			const uint8x16_t transparent = vceqq_u8(alpha, zero);
+			const uint8x16_t opaque = vceqq_u8(alpha, full);
+
+			uint8x16x4_t res;
+			for (int c = 0; c < 3; c++) {
+				const uint8x16_t blended = vaddq_u8(mulShiftNEON(dst.val[c], invAlpha), mulShiftNEON(src.val[c], alpha));
+				res.val[c] = vbslq_u8(transparent, dst.val[c], vbslq_u8(opaque, src.val[c], blended));
+			}
+			res.val[3] = vbslq_u8(transparent, dst.val[3], full);
+			vst4q_u8(out, res);
+		}
+
+		blitAlphaScalar(in, out, width - j, 1, pitch, inStep, inoStep);
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+static void blitColorModNEON(const byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, int ca, int cr, int cg, int cb) {
+	const uint8x16_t zero = vdupq_n_u8(0);
+	const uint8x16_t full = vdupq_n_u8(255);
+	// In B, G, R order, like the channels
+	const int colors[3] = { cb, cg, cr };
+
+	for (uint32 i = 0; i < height; i++) {
+		const byte *in = ino;
+		byte *out = outo;
+		uint32 j = 0;
+		for (; j + 16 <= width; j += 16, in += 16 * inStep, out += 64) {
+			const uint8x16x4_t src = loadPixelsNEON(in, inStep);
+			const uint8x16x4_t dst = vld4q_u8(out);
+			uint8x16_t alpha = src.val[3];
+			if (ca != 255)
+				alpha = mulShiftNEON(alpha, vdupq_n_u8(ca));
+			const uint8x16_t transparent = vceqq_u8(alpha, zero);
+			const uint8x16_t opaque = vceqq_u8(alpha, full);
+
+			uint8x16x4_t res;
+			for (int c = 0; c < 3; c++) {
+				const int color = colors[c];
+				uint8x16_t opaqueRes, blended;
+				if (color == 0) {
+					opaqueRes = blended = zero;
+				} else {
+					uint16x8_t mLo, mHi;
+					if (color == 255) {
+						opaqueRes = src.val[c];
+						mLo = vshll_n_u8(vget_low_u8(alpha), 8);
+						mHi = vshll_n_u8(vget_high_u8(alpha), 8);
+					} else {
+						const uint8x8_t factor = vdup_n_u8(color);
+						opaqueRes = mulShiftNEON(src.val[c], vdupq_n_u8(color));
+						mLo = vmull_u8(vget_low_u8(alpha), factor);
+						mHi = vmull_u8(vget_high_u8(alpha), factor);
+					}
+					blended = vcombine_u8(blendHalfNEON(vget_low_u8(src.val[c]), vget_low_u8(dst.val[c]), mLo),
+					                      blendHalfNEON(vget_high_u8(src.val[c]), vget_high_u8(dst.val[c]), mHi));
+				}
+				res.val[c] = vbslq_u8(transparent, dst.val[c], vbslq_u8(opaque, opaqueRes, blended));
+			}
+			res.val[3] = vbslq_u8(transparent, dst.val[3], full);
+			vst4q_u8(out, res);
+		}
+
+		blitColorModScalar(in, out, width - j, 1, pitch, inStep, inoStep, ca, cr, cg, cb);
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
+static const BlitKernels s_neonKernels = { blitOpaqueNEON, blitAlphaNEON, blitColorModNEON, "NEON" };
+
+#endif // BLIT_USE_NEON
+
+#pragma mark -
+
+static const BlitKernels *detectBlitKernels() {
+#ifdef BLIT_USE_X86_SIMD
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2))
+		return &s_sse2Kernels;
+#endif
+#ifdef BLIT_USE_NEON
+	if (Common::hasCPUFeature(Common::kCPUFeatureNEON))
+		return &s_neonKernels;
+#endif
+	return &s_scalarKernels;
+}
+
+const BlitKernels &getBlitKernels() {
+	// Detection always yields the same result, so it does not matter if
+	// two threads happen to run it at the same time.
+	static const BlitKernels *kernels = 0;
+	if (!kernels)
+		kernels = detectBlitKernels();
+	return *kernels;
+}
+
+const BlitKernels &getScalarBlitKernels() {
+	return s_scalarKernels;
+}
+
+} // End of namespace Wintermute
@@ -0,0 +1,73 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ 
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef WINTERMUTE_TRANSPARENT_SURFACE_SIMD_H
+#define WINTERMUTE_TRANSPARENT_SURFACE_SIMD_H
+
+#include "common/scummsys.h"
+
+namespace Wintermute {
+
+/**
+ * The pixel loops of TransparentSurface::blit(). All of them blit a block of
+ * 32 bpp pixels, reading rows from ino (advancing by inoStep bytes per row
+ * and inStep bytes per pixel, which are negative when flipping) and writing
+ * them to outo (advancing by pitch bytes per row).
+ *
+ * The vectorized implementations produce exactly the same output as the
+ * plain C++ ones, whichever is selected.
+ */
+struct BlitKernels {
+	/**
+	 * Copy the pixels, making them fully opaque. Like the original code,
+	 * this ignores horizontal flipping.
+	 */
+	void (*blitOpaque)(const byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep);
+
+	/** Alpha blend the pixels onto the target. */
+	void (*blitAlpha)(const byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep);
+
+	/**
+	 * Alpha blend the pixels onto the target, modulating them with the
+	 * given color. The color components must already be multiplied with the
+	 * alpha of the color, as done by blit().
+	 */
+	void (*blitColorMod)(const byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, int ca, int cr, int cg, int cb);
+
+	/** Name of the implementation, for debugging purposes. */
+	const char *name;
+};
+
+/**
+ * Return the fastest blit kernels supported by the CPU we are running on.
+ */
+const BlitKernels &getBlitKernels();
+
+/**
+ * Return the plain C++ blit kernels. These serve as the reference for the
+ * vectorized implementations.
+ */
+const BlitKernels &getScalarBlitKernels();
+
+} // End of namespace Wintermute
+
+#endif
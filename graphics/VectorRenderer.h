@@ -266,6 +266,11 @@ public:
 		_activeSurface = surface;
 	}
 
+	/**
+	 * Returns the active drawing surface.
+	 */
+	Surface *getSurface() { return _activeSurface; }
+
 	/**
 	 * Fills the active surface with the specified fg/bg color or the active gradient.
 	 * Defaults to using the active Foreground color for filling.
@@ -468,6 +473,39 @@ public:
 	                        const Common::Rect &area, Graphics::TextAlign alignH,
 	                        GUI::ThemeEngine::TextAlignVertical alignV, int deltax, bool useEllipsis) = 0;
 
+	/**
+	 * The part of the drawing state which is not necessarily set by each
+	 * DrawStep, and hence carries over from the previously drawn steps:
+	 * colors not set by a step and gradient factors of 0 leave the current
+	 * values untouched.
+	 */
+	struct DrawingState {
+		uint32 fgColor, bgColor, gradientStart, gradientEnd, bevelColor;
+		int gradientFactor;
+		bool disableShadows;
+
+		bool operator==(const DrawingState &s) const {
+			return fgColor == s.fgColor && bgColor == s.bgColor && gradientStart == s.gradientStart
+			    && gradientEnd == s.gradientEnd && bevelColor == s.bevelColor
+			    && gradientFactor == s.gradientFactor && disableShadows == s.disableShadows;
+		}
+	};
+
+	/**
+	 * Returns the current drawing state, see DrawingState.
+	 */
+	virtual void getDrawingState(DrawingState &state) const {
+		state.fgColor = state.bgColor = state.gradientStart = state.gradientEnd = state.bevelColor = 0;
+		state.gradientFactor = _gradientFactor;
+		state.disableShadows = _disableShadows;
+	}
+
+	/**
+	 * Applies the settings of a DrawStep to the renderer like drawStep(),
+	 * but does not draw anything.
+	 */
+	void setDrawStepState(const DrawStep &step, uint32 extra = 0);
+
 	/**
 	 * Allows to temporarily enable/disable all shadows drawing.
 	 * i.e. for performance issues, blitting, etc
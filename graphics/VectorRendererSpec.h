@@ -68,6 +68,15 @@ public:
 	void setBevelColor(uint8 r, uint8 g, uint8 b) { _bevelColor = _format.RGBToColor(r, g, b); }
 	void setGradientColors(uint8 r1, uint8 g1, uint8 b1, uint8 r2, uint8 g2, uint8 b2);
 
+	void getDrawingState(DrawingState &state) const {
+		VectorRenderer::getDrawingState(state);
+		state.fgColor = _fgColor;
+		state.bgColor = _bgColor;
+		state.gradientStart = _gradientStart;
+		state.gradientEnd = _gradientEnd;
+		state.bevelColor = _bevelColor;
+	}
+
 	void copyFrame(OSystem *sys, const Common::Rect &r);
 	void copyWholeFrame(OSystem *sys) { copyFrame(sys, Common::Rect(0, 0, _activeSurface->w, _activeSurface->h)); }
 
@@ -0,0 +1,207 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include "graphics/scaler/hqx_patterns.h"
+#include "graphics/scaler/intern.h"
+#include "common/util.h"
+
+#if defined(SCUMMVM_HAVE_X86_SIMD)
+#include <emmintrin.h>
+#endif
+
+#if defined(SCUMMVM_HAVE_NEON)
+#include <arm_neon.h>
+#endif
+
+//	 +----+----+----+
+//	 |    |    |    |
+//	 | w1 | w2 | w3 |
+//	 +----+----+----+
+//	 |    |    |    |
+//	 | w4 | w5 | w6 |
+//	 +----+----+----+
+//	 |    |    |    |
+//	 | w7 | w8 | w9 |
+//	 +----+----+----+
+
+void hqx_patterns_def(const uint16 *p, uint32 nextlineSrc, const uint32 *rgbToYuv, int width, uint8 *patterns) {
+	for (int x = 0; x < width; ++x, ++p) {
+		const int w1 = *(p - 1 - nextlineSrc);
+		const int w2 = *(p - nextlineSrc);
+		const int w3 = *(p + 1 - nextlineSrc);
+		const int w4 = *(p - 1);
+		const int w5 = *(p);
+		const int w6 = *(p + 1);
+		const int w7 = *(p - 1 + nextlineSrc);
+		const int w8 = *(p + nextlineSrc);
+		const int w9 = *(p + 1 + nextlineSrc);
+
+		int pattern = 0;
+		const int yuv5 = rgbToYuv[w5];
+		if (w5 != w1 && diffYUV(yuv5, rgbToYuv[w1])) pattern |= 0x0001;
+		if (w5 != w2 && diffYUV(yuv5, rgbToYuv[w2])) pattern |= 0x0002;
+		if (w5 != w3 && diffYUV(yuv5, rgbToYuv[w3])) pattern |= 0x0004;
+		if (w5 != w4 && diffYUV(yuv5, rgbToYuv[w4])) pattern |= 0x0008;
+		if (w5 != w6 && diffYUV(yuv5, rgbToYuv[w6])) pattern |= 0x0010;
+		if (w5 != w7 && diffYUV(yuv5, rgbToYuv[w7])) pattern |= 0x0020;
+		if (w5 != w8 && diffYUV(yuv5, rgbToYuv[w8])) pattern |= 0x0040;
+		if (w5 != w9 && diffYUV(yuv5, rgbToYuv[w9])) pattern |= 0x0080;
+		patterns[x] = pattern;
+	}
+}
+
+/*
+ * The vectorized implementations first look up the YUV values of the three
+ * rows around a chunk of pixels, and then compare four pixels at a time.
+ *
+ * diffYUV() checks whether Y differs by more than 48, U by more than 7 or
+ * V by more than 6. The YUV values are stored as 0x00YYUUVV, so this is a
+ * per byte comparison of the absolute differences against 0xFF300706. The
+ * top byte is zero in both values and never exceeds its threshold. If two
+ * pixels have the same color their YUV values are equal, so the w5 != wN
+ * shortcut of the C implementation does not change the result.
+ */
+
+#if defined(SCUMMVM_HAVE_X86_SIMD) || defined(SCUMMVM_HAVE_NEON)
+
+static const uint32 kYUVThresholds = 0xFF300706;
+
+static inline void hqx_load_yuv(const uint16 *p, const uint32 *rgbToYuv, int count, uint32 *yuv) {
+	for (int i = 0; i < count; ++i)
+		yuv[i] = rgbToYuv[p[i]];
+}
+
+#endif
+
+#if defined(SCUMMVM_HAVE_X86_SIMD)
+
+/* Returns bit for every pixel in yuv5 that differs from the one in yuv */
+SCUMMVM_TARGET_SSE2
+static inline __m128i hqx_diff_sse2(__m128i yuv5, const uint32 *yuv, __m128i thresholds, int bit) {
+	const __m128i other = _mm_loadu_si128((const __m128i *)yuv);
+	const __m128i diff = _mm_or_si128(_mm_subs_epu8(yuv5, other), _mm_subs_epu8(other, yuv5));
+	const __m128i same = _mm_cmpeq_epi32(_mm_subs_epu8(diff, thresholds), _mm_setzero_si128());
+	return _mm_andnot_si128(same, _mm_set1_epi32(bit));
+}
+
+SCUMMVM_TARGET_SSE2
+void hqx_patterns_sse2(const uint16 *src, uint32 nextlineSrc, const uint32 *rgbToYuv, int width, uint8 *patterns) {
+	const __m128i thresholds = _mm_set1_epi32(kYUVThresholds);
+	uint32 yuv[3][kHQxPatternChunk + 2];
+
+	while (width >= 4) {
+		const int count = MIN<int>(width, kHQxPatternChunk) & ~3;
+		hqx_load_yuv(src - 1 - nextlineSrc, rgbToYuv, count + 2, yuv[0]);
+		hqx_load_yuv(src - 1, rgbToYuv, count + 2, yuv[1]);
+		hqx_load_yuv(src - 1 + nextlineSrc, rgbToYuv, count + 2, yuv[2]);
+
+		for (int i = 0; i < count; i += 4) {
+			const __m128i yuv5 = _mm_loadu_si128((const __m128i *)&yuv[1][i + 1]);
+			__m128i pattern = hqx_diff_sse2(yuv5, &yuv[0][i], thresholds, 0x0001);
+			pattern = _mm_or_si128(pattern, hqx_diff_sse2(yuv5, &yuv[0][i + 1], thresholds, 0x0002));
+			pattern = _mm_or_si128(pattern, hqx_diff_sse2(yuv5, &yuv[0][i + 2], thresholds, 0x0004));
+			pattern = _mm_or_si128(pattern, hqx_diff_sse2(yuv5, &yuv[1][i], thresholds, 0x0008));
+			pattern = _mm_or_si128(pattern, hqx_diff_sse2(yuv5, &yuv[1][i + 2], thresholds, 0x0010));
+			pattern = _mm_or_si128(pattern, hqx_diff_sse2(yuv5, &yuv[2][i], thresholds, 0x0020));
+			pattern = _mm_or_si128(pattern, hqx_diff_sse2(yuv5, &yuv[2][i + 1], thresholds, 0x0040));
+			pattern = _mm_or_si128(pattern, hqx_diff_sse2(yuv5, &yuv[2][i + 2], thresholds, 0x0080));
+
+			pattern = _mm_packs_epi32(pattern, pattern);
+			const uint32 packed = _mm_cvtsi128_si32(_mm_packus_epi16(pattern, pattern));
+			memcpy(patterns + i, &packed, 4);
+		}
+
+		src += count;
+		patterns += count;
+		width -= count;
+	}
+
+	hqx_patterns_def(src, nextlineSrc, rgbToYuv, width, patterns);
+}
+
+#endif
+
+#if defined(SCUMMVM_HAVE_NEON)
+
+/* Returns bit for every pixel in yuv5 that differs from the one in yuv */
+static inline uint32x4_t hqx_diff_neon(uint32x4_t yuv5, const uint32 *yuv, uint8x16_t thresholds, uint32 bit) {
+	const uint8x16_t diff = vabdq_u8(vreinterpretq_u8_u32(yuv5), vreinterpretq_u8_u32(vld1q_u32(yuv)));
+	const uint32x4_t over = vreinterpretq_u32_u8(vcgtq_u8(diff, thresholds));
+	return vandq_u32(vtstq_u32(over, over), vdupq_n_u32(bit));
+}
+
+void hqx_patterns_neon(const uint16 *src, uint32 nextlineSrc, const uint32 *rgbToYuv, int width, uint8 *patterns) {
+	const uint8x16_t thresholds = vreinterpretq_u8_u32(vdupq_n_u32(kYUVThresholds));
+	uint32 yuv[3][kHQxPatternChunk + 2];
+
+	while (width >= 4) {
+		const int count = MIN<int>(width, kHQxPatternChunk) & ~3;
+		hqx_load_yuv(src - 1 - nextlineSrc, rgbToYuv, count + 2, yuv[0]);
+		hqx_load_yuv(src - 1, rgbToYuv, count + 2, yuv[1]);
+		hqx_load_yuv(src - 1 + nextlineSrc, rgbToYuv, count + 2, yuv[2]);
+
+		for (int i = 0; i < count; i += 4) {
+			const uint32x4_t yuv5 = vld1q_u32(&yuv[1][i + 1]);
+			uint32x4_t pattern = hqx_diff_neon(yuv5, &yuv[0][i], thresholds, 0x0001);
+			pattern = vorrq_u32(pattern, hqx_diff_neon(yuv5, &yuv[0][i + 1], thresholds, 0x0002));
+			pattern = vorrq_u32(pattern, hqx_diff_neon(yuv5, &yuv[0][i + 2], thresholds, 0x0004));
+			pattern = vorrq_u32(pattern, hqx_diff_neon(yuv5, &yuv[1][i], thresholds, 0x0008));
+			pattern = vorrq_u32(pattern, hqx_diff_neon(yuv5, &yuv[1][i + 2], thresholds, 0x0010));
+			pattern = vorrq_u32(pattern, hqx_diff_neon(yuv5, &yuv[2][i], thresholds, 0x0020));
+			pattern = vorrq_u32(pattern, hqx_diff_neon(yuv5, &yuv[2][i + 1], thresholds, 0x0040));
+			pattern = vorrq_u32(pattern, hqx_diff_neon(yuv5, &yuv[2][i + 2], thresholds, 0x0080));
+
+			const uint16x4_t pattern16 = vmovn_u32(pattern);
+			const uint8x8_t pattern8 = vmovn_u16(vcombine_u16(pattern16, pattern16));
+			const uint32 packed = vget_lane_u32(vreinterpret_u32_u8(pattern8), 0);
+			memcpy(patterns + i, &packed, 4);
+		}
+
+		src += count;
+		patterns += count;
+		width -= count;
+	}
+
+	hqx_patterns_def(src, nextlineSrc, rgbToYuv, width, patterns);
+}
+
+#endif
+
+typedef void (*HQxPatternsProc)(const uint16 *, uint32, const uint32 *, int, uint8 *);
+
+static HQxPatternsProc detectHQxPatterns() {
+#if defined(SCUMMVM_HAVE_X86_SIMD)
+	if (Common::hasCPUFeature(Common::kCPUFeatureSSE2))
+		return hqx_patterns_sse2;
+#endif
+#if defined(SCUMMVM_HAVE_NEON)
+	if (Common::hasCPUFeature(Common::kCPUFeatureNEON))
+		return hqx_patterns_neon;
+#endif
+	return hqx_patterns_def;
+}
+
+void hqx_patterns(const uint16 *src, uint32 nextlineSrc, const uint32 *rgbToYuv, int width, uint8 *patterns) {
+	static HQxPatternsProc proc = 0;
+	if (!proc)
+		proc = detectHQxPatterns();
+	proc(src, nextlineSrc, rgbToYuv, width, patterns);
+}
@@ -0,0 +1,58 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef GRAPHICS_SCALER_HQX_PATTERNS_H
+#define GRAPHICS_SCALER_HQX_PATTERNS_H
+
+#include "common/scummsys.h"
+#include "common/cpudetect.h"
+
+enum {
+	/** The HQ scalers compute the patterns of this many pixels at once */
+	kHQxPatternChunk = 64
+};
+
+/**
+ * Compute the patterns the HQ scalers use to pick the interpolation of each
+ * pixel. Bit n of a pattern is set if neighbour n of the pixel (counting
+ * w1 to w9 from the top left, without the pixel itself) differs from the
+ * pixel by more than the diffYUV() threshold.
+ *
+ * @param src			the first pixel, its neighbours are read as well
+ * @param nextlineSrc	the source pitch in pixels
+ * @param rgbToYuv		the RGBtoYUV table of the current pixel format
+ * @param width			the number of pixels
+ * @param patterns		receives one pattern per pixel
+ */
+void hqx_patterns(const uint16 *src, uint32 nextlineSrc, const uint32 *rgbToYuv, int width, uint8 *patterns);
+
+/** The C implementation of hqx_patterns(), for reference */
+void hqx_patterns_def(const uint16 *src, uint32 nextlineSrc, const uint32 *rgbToYuv, int width, uint8 *patterns);
+
+#if defined(SCUMMVM_HAVE_X86_SIMD)
+void hqx_patterns_sse2(const uint16 *src, uint32 nextlineSrc, const uint32 *rgbToYuv, int width, uint8 *patterns);
+#endif
+
+#if defined(SCUMMVM_HAVE_NEON)
+void hqx_patterns_neon(const uint16 *src, uint32 nextlineSrc, const uint32 *rgbToYuv, int width, uint8 *patterns);
+#endif
+
+#endif
@@ -19,7 +19,7 @@
  */
 
 /*
- * This file contains a C and MMX implementation of the Scale2x effect.
+ * This file contains a C, MMX, SSE2 and NEON implementation of the Scale2x effect.
  *
  * You can find an high level description of the effect at :
  *
@@ -36,6 +36,14 @@
 
 #include "graphics/scaler/scale2x.h"
 
+#if defined(SCUMMVM_HAVE_X86_SIMD)
+#include <emmintrin.h>
+#endif
+
+#if defined(SCUMMVM_HAVE_NEON)
+#include <arm_neon.h>
+#endif
+
 /***************************************************************************/
 /* Scale2x C implementation */
 
@@ -500,3 +508,115 @@ void scale2x_32_mmx(scale2x_uint32* dst0, scale2x_uint32* dst1, const scale2x_ui
 }
 
 #endif
+
+/***************************************************************************/
+/* Scale2x SSE2 implementation */
+
+#if defined(SCUMMVM_HAVE_X86_SIMD)
+
+/*
+ * Apply the Scale2x effect at a single row, eight pixels at a time.
+ * Uses the same pixel map as scale2x_8_mmx_single(). The pixels left over
+ * at the end of the row are handled by the C implementation.
+ */
+SCUMMVM_TARGET_SSE2
+static inline void scale2x_16_sse2_single(scale2x_uint16* dst, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count) {
+	while (count >= 8) {
+		const __m128i B = _mm_loadu_si128((const __m128i *)src0);
+		const __m128i D = _mm_loadu_si128((const __m128i *)(src1 - 1));
+		const __m128i E = _mm_loadu_si128((const __m128i *)src1);
+		const __m128i F = _mm_loadu_si128((const __m128i *)(src1 + 1));
+		const __m128i H = _mm_loadu_si128((const __m128i *)src2);
+
+		/* no edge if B == H or D == F */
+		const __m128i noEdge = _mm_or_si128(_mm_cmpeq_epi16(B, H), _mm_cmpeq_epi16(D, F));
+		const __m128i left = _mm_andnot_si128(noEdge, _mm_cmpeq_epi16(D, B));
+		const __m128i right = _mm_andnot_si128(noEdge, _mm_cmpeq_epi16(F, B));
+
+		const __m128i a = _mm_or_si128(_mm_and_si128(left, B), _mm_andnot_si128(left, E));
+		const __m128i b = _mm_or_si128(_mm_and_si128(right, B), _mm_andnot_si128(right, E));
+
+		_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(a, b));
+		_mm_storeu_si128((__m128i *)(dst + 8), _mm_unpackhi_epi16(a, b));
+
+		src0 += 8;
+		src1 += 8;
+		src2 += 8;
+		dst += 16;
+		count -= 8;
+	}
+
+	scale2x_16_def_single(dst, src0, src1, src2, count);
+}
+
+/**
+ * Scale by a factor of 2 a row of pixels of 16 bits.
+ * This function operates like scale2x_16_def(), but uses SSE2 instructions.
+ * It must only be called if Common::hasCPUFeature(kCPUFeatureSSE2) is true.
+ * @param src0 Pointer at the first pixel of the previous row.
+ * @param src1 Pointer at the first pixel of the current row.
+ * @param src2 Pointer at the first pixel of the next row.
+ * @param count Length in pixels of the src0, src1 and src2 rows.
+ * @param dst0 First destination row, double length in pixels.
+ * @param dst1 Second destination row, double length in pixels.
+ */
+void scale2x_16_sse2(scale2x_uint16* dst0, scale2x_uint16* dst1, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count) {
+	scale2x_16_sse2_single(dst0, src0, src1, src2, count);
+	scale2x_16_sse2_single(dst1, src2, src1, src0, count);
+}
+
+#endif
+
+/***************************************************************************/
+/* Scale2x NEON implementation */
+
+#if defined(SCUMMVM_HAVE_NEON)
+
+/*
+ * Apply the Scale2x effect at a single row, eight pixels at a time.
+ * Works like scale2x_16_sse2_single().
+ */
+static inline void scale2x_16_neon_single(scale2x_uint16* dst, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count) {
+	while (count >= 8) {
+		const uint16x8_t B = vld1q_u16(src0);
+		const uint16x8_t D = vld1q_u16(src1 - 1);
+		const uint16x8_t E = vld1q_u16(src1);
+		const uint16x8_t F = vld1q_u16(src1 + 1);
+		const uint16x8_t H = vld1q_u16(src2);
+
+		/* no edge if B == H or D == F */
+		const uint16x8_t noEdge = vorrq_u16(vceqq_u16(B, H), vceqq_u16(D, F));
+		const uint16x8_t left = vbicq_u16(vceqq_u16(D, B), noEdge);
+		const uint16x8_t right = vbicq_u16(vceqq_u16(F, B), noEdge);
+
+		uint16x8x2_t result;
+		result.val[0] = vbslq_u16(left, B, E);
+		result.val[1] = vbslq_u16(right, B, E);
+		vst2q_u16(dst, result);
+
+		src0 += 8;
+		src1 += 8;
+		src2 += 8;
+		dst += 16;
+		count -= 8;
+	}
+
+	scale2x_16_def_single(dst, src0, src1, src2, count);
+}
+
+/**
+ * Scale by a factor of 2 a row of pixels of 16 bits.
+ * This function operates like scale2x_16_def(), but uses NEON instructions.
+ * @param src0 Pointer at the first pixel of the previous row.
+ * @param src1 Pointer at the first pixel of the current row.
+ * @param src2 Pointer at the first pixel of the next row.
+ * @param count Length in pixels of the src0, src1 and src2 rows.
+ * @param dst0 First destination row, double length in pixels.
+ * @param dst1 Second destination row, double length in pixels.
+ */
+void scale2x_16_neon(scale2x_uint16* dst0, scale2x_uint16* dst1, const scale2x_uint16* src0, const scale2x_uint16* src1, const scale2x_uint16* src2, unsigned count) {
+	scale2x_16_neon_single(dst0, src0, src1, src2, count);
+	scale2x_16_neon_single(dst1, src2, src1, src0, count);
+}
+
+#endif
@@ -19,7 +19,7 @@
  */
 
 /*
- * This file contains a C and MMX implementation of the Scale2x effect.
+ * This file contains a C, SSE2 and NEON implementation of the Scale3x effect.
  *
  * You can find an high level description of the effect at :
  *
@@ -36,6 +36,14 @@
 
 #include "graphics/scaler/scale3x.h"
 
+#if defined(SCUMMVM_HAVE_X86_SIMD)
+#include <emmintrin.h>
+#endif
+
+#if defined(SCUMMVM_HAVE_NEON)
+#include <arm_neon.h>
+#endif
+
 /***************************************************************************/
 /* Scale3x C implementation */
 
@@ -220,3 +228,257 @@ void scale3x_32_def(scale3x_uint32* dst0, scale3x_uint32* dst1, scale3x_uint32*
 	scale3x_32_def_center(dst1, src0, src1, src2, count);
 	scale3x_32_def_border(dst2, src2, src1, src0, count);
 }
+
+/***************************************************************************/
+/* Scale3x SSE2 implementation */
+
+#if defined(SCUMMVM_HAVE_X86_SIMD)
+
+/*
+ * The SSE2 and NEON implementations use this pixel map, like the MMX
+ * implementation of Scale2x:
+ *
+ *      ABC (src0)
+ *      DEF (src1)
+ *      GHI (src2)
+ *
+ * and compute the three new pixels of E for the border or center row.
+ */
+
+SCUMMVM_TARGET_SSE2
+static inline __m128i scale3x_sse2_select(__m128i mask, __m128i a, __m128i b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/*
+ * Write three vectors of eight pixels interleaved, i.e. a0 b0 c0 a1 b1 c1
+ * and so on. SSE2 has no word shuffle across 64 bit halves, so the pixels
+ * are moved into place with whole register shifts and masked together.
+ */
+SCUMMVM_TARGET_SSE2
+static inline void scale3x_16_sse2_store(scale3x_uint16* dst, __m128i a, __m128i b, __m128i c) {
+	const __m128i ab0 = _mm_unpacklo_epi16(a, b); /* a0 b0 a1 b1 a2 b2 a3 b3 */
+	const __m128i ab1 = _mm_unpackhi_epi16(a, b); /* a4 b4 a5 b5 a6 b6 a7 b7 */
+	const __m128i cUp = _mm_slli_si128(c, 4);     /* c moved up by two pixels */
+	const __m128i cDown = _mm_srli_si128(c, 4);   /* c moved down by two pixels */
+
+	/* masks selecting pixel 0, 1, ... 7 */
+	const __m128i m0 = _mm_set_epi16(0, 0, 0, 0, 0, 0, 0, -1);
+	const __m128i m1 = _mm_slli_si128(m0, 2);
+	const __m128i m2 = _mm_slli_si128(m0, 4);
+	const __m128i m3 = _mm_slli_si128(m0, 6);
+	const __m128i m4 = _mm_slli_si128(m0, 8);
+	const __m128i m5 = _mm_slli_si128(m0, 10);
+	const __m128i m6 = _mm_slli_si128(m0, 12);
+	const __m128i m7 = _mm_slli_si128(m0, 14);
+
+	/* a0 b0 c0 a1 b1 c1 a2 b2 */
+	__m128i out = _mm_and_si128(ab0, _mm_or_si128(m0, m1));
+	out = _mm_or_si128(out, _mm_and_si128(cUp, m2));
+	out = _mm_or_si128(out, _mm_and_si128(_mm_slli_si128(ab0, 2), _mm_or_si128(m3, m4)));
+	out = _mm_or_si128(out, _mm_and_si128(_mm_slli_si128(c, 8), m5));
+	out = _mm_or_si128(out, _mm_slli_si128(_mm_srli_si128(ab0, 8), 12));
+	_mm_storeu_si128((__m128i *)dst, out);
+
+	/* c2 a3 b3 c3 a4 b4 c4 a5 */
+	out = _mm_and_si128(cDown, m0);
+	out = _mm_or_si128(out, _mm_and_si128(_mm_srli_si128(ab0, 10), _mm_or_si128(m1, m2)));
+	out = _mm_or_si128(out, _mm_and_si128(c, m3));
+	out = _mm_or_si128(out, _mm_and_si128(_mm_slli_si128(ab1, 8), _mm_or_si128(m4, m5)));
+	out = _mm_or_si128(out, _mm_and_si128(cUp, m6));
+	out = _mm_or_si128(out, _mm_and_si128(_mm_slli_si128(ab1, 10), m7));
+	_mm_storeu_si128((__m128i *)(dst + 8), out);
+
+	/* b5 c5 a6 b6 c6 a7 b7 c7 */
+	out = _mm_and_si128(_mm_srli_si128(ab1, 6), m0);
+	out = _mm_or_si128(out, _mm_and_si128(_mm_srli_si128(c, 8), m1));
+	out = _mm_or_si128(out, _mm_and_si128(_mm_srli_si128(ab1, 4), _mm_or_si128(m2, m3)));
+	out = _mm_or_si128(out, _mm_and_si128(cDown, m4));
+	out = _mm_or_si128(out, _mm_and_si128(_mm_srli_si128(ab1, 2), _mm_or_si128(m5, m6)));
+	out = _mm_or_si128(out, _mm_and_si128(c, m7));
+	_mm_storeu_si128((__m128i *)(dst + 16), out);
+}
+
+SCUMMVM_TARGET_SSE2
+static inline void scale3x_16_sse2_border(scale3x_uint16* dst, const scale3x_uint16* src0, const scale3x_uint16* src1, const scale3x_uint16* src2, unsigned count) {
+	while (count >= 8) {
+		const __m128i A = _mm_loadu_si128((const __m128i *)(src0 - 1));
+		const __m128i B = _mm_loadu_si128((const __m128i *)src0);
+		const __m128i C = _mm_loadu_si128((const __m128i *)(src0 + 1));
+		const __m128i D = _mm_loadu_si128((const __m128i *)(src1 - 1));
+		const __m128i E = _mm_loadu_si128((const __m128i *)src1);
+		const __m128i F = _mm_loadu_si128((const __m128i *)(src1 + 1));
+		const __m128i H = _mm_loadu_si128((const __m128i *)src2);
+
+		/* no edge if B == H or D == F */
+		const __m128i noEdge = _mm_or_si128(_mm_cmpeq_epi16(B, H), _mm_cmpeq_epi16(D, F));
+		const __m128i DB = _mm_cmpeq_epi16(D, B);
+		const __m128i FB = _mm_cmpeq_epi16(F, B);
+
+		/* (D == B && E != C) || (F == B && E != A) */
+		const __m128i middle = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi16(E, C), DB), _mm_andnot_si128(_mm_cmpeq_epi16(E, A), FB));
+
+		scale3x_16_sse2_store(dst,
+			scale3x_sse2_select(_mm_andnot_si128(noEdge, DB), D, E),
+			scale3x_sse2_select(_mm_andnot_si128(noEdge, middle), B, E),
+			scale3x_sse2_select(_mm_andnot_si128(noEdge, FB), F, E));
+
+		src0 += 8;
+		src1 += 8;
+		src2 += 8;
+		dst += 24;
+		count -= 8;
+	}
+
+	scale3x_16_def_border(dst, src0, src1, src2, count);
+}
+
+SCUMMVM_TARGET_SSE2
+static inline void scale3x_16_sse2_center(scale3x_uint16* dst, const scale3x_uint16* src0, const scale3x_uint16* src1, const scale3x_uint16* src2, unsigned count) {
+	while (count >= 8) {
+		const __m128i A = _mm_loadu_si128((const __m128i *)(src0 - 1));
+		const __m128i B = _mm_loadu_si128((const __m128i *)src0);
+		const __m128i C = _mm_loadu_si128((const __m128i *)(src0 + 1));
+		const __m128i D = _mm_loadu_si128((const __m128i *)(src1 - 1));
+		const __m128i E = _mm_loadu_si128((const __m128i *)src1);
+		const __m128i F = _mm_loadu_si128((const __m128i *)(src1 + 1));
+		const __m128i G = _mm_loadu_si128((const __m128i *)(src2 - 1));
+		const __m128i H = _mm_loadu_si128((const __m128i *)src2);
+		const __m128i I = _mm_loadu_si128((const __m128i *)(src2 + 1));
+
+		/* no edge if B == H or D == F */
+		const __m128i noEdge = _mm_or_si128(_mm_cmpeq_epi16(B, H), _mm_cmpeq_epi16(D, F));
+
+		/* (D == B && E != G) || (D == H && E != A) */
+		const __m128i left = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi16(E, G), _mm_cmpeq_epi16(D, B)), _mm_andnot_si128(_mm_cmpeq_epi16(E, A), _mm_cmpeq_epi16(D, H)));
+		/* (F == B && E != I) || (F == H && E != C) */
+		const __m128i right = _mm_or_si128(_mm_andnot_si128(_mm_cmpeq_epi16(E, I), _mm_cmpeq_epi16(F, B)), _mm_andnot_si128(_mm_cmpeq_epi16(E, C), _mm_cmpeq_epi16(F, H)));
+
+		scale3x_16_sse2_store(dst,
+			scale3x_sse2_select(_mm_andnot_si128(noEdge, left), D, E),
+			E,
+			scale3x_sse2_select(_mm_andnot_si128(noEdge, right), F, E));
+
+		src0 += 8;
+		src1 += 8;
+		src2 += 8;
+		dst += 24;
+		count -= 8;
+	}
+
+	scale3x_16_def_center(dst, src0, src1, src2, count);
+}
+
+/**
+ * Scale by a factor of 3 a row of pixels of 16 bits.
+ * This function operates like scale3x_16_def(), but uses SSE2 instructions.
+ * It must only be called if Common::hasCPUFeature(kCPUFeatureSSE2) is true.
+ * @param src0 Pointer at the first pixel of the previous row.
+ * @param src1 Pointer at the first pixel of the current row.
+ * @param src2 Pointer at the first pixel of the next row.
+ * @param count Length in pixels of the src0, src1 and src2 rows.
+ * @param dst0 First destination row, triple length in pixels.
+ * @param dst1 Second destination row, triple length in pixels.
+ * @param dst2 Third destination row, triple length in pixels.
+ */
+void scale3x_16_sse2(scale3x_uint16* dst0, scale3x_uint16* dst1, scale3x_uint16* dst2, const scale3x_uint16* src0, const scale3x_uint16* src1, const scale3x_uint16* src2, unsigned count) {
+	scale3x_16_sse2_border(dst0, src0, src1, src2, count);
+	scale3x_16_sse2_center(dst1, src0, src1, src2, count);
+	scale3x_16_sse2_border(dst2, src2, src1, src0, count);
+}
+
+#endif
+
+/***************************************************************************/
+/* Scale3x NEON implementation */
+
+#if defined(SCUMMVM_HAVE_NEON)
+
+static inline void scale3x_16_neon_border(scale3x_uint16* dst, const scale3x_uint16* src0, const scale3x_uint16* src1, const scale3x_uint16* src2, unsigned count) {
+	while (count >= 8) {
+		const uint16x8_t A = vld1q_u16(src0 - 1);
+		const uint16x8_t B = vld1q_u16(src0);
+		const uint16x8_t C = vld1q_u16(src0 + 1);
+		const uint16x8_t D = vld1q_u16(src1 - 1);
+		const uint16x8_t E = vld1q_u16(src1);
+		const uint16x8_t F = vld1q_u16(src1 + 1);
+		const uint16x8_t H = vld1q_u16(src2);
+
+		/* no edge if B == H or D == F */
+		const uint16x8_t noEdge = vorrq_u16(vceqq_u16(B, H), vceqq_u16(D, F));
+		const uint16x8_t DB = vceqq_u16(D, B);
+		const uint16x8_t FB = vceqq_u16(F, B);
+
+		/* (D == B && E != C) || (F == B && E != A) */
+		const uint16x8_t middle = vorrq_u16(vbicq_u16(DB, vceqq_u16(E, C)), vbicq_u16(FB, vceqq_u16(E, A)));
+
+		uint16x8x3_t result;
+		result.val[0] = vbslq_u16(vbicq_u16(DB, noEdge), D, E);
+		result.val[1] = vbslq_u16(vbicq_u16(middle, noEdge), B, E);
+		result.val[2] = vbslq_u16(vbicq_u16(FB, noEdge), F, E);
+		vst3q_u16(dst, result);
+
+		src0 += 8;
+		src1 += 8;
+		src2 += 8;
+		dst += 24;
+		count -= 8;
+	}
+
+	scale3x_16_def_border(dst, src0, src1, src2, count);
+}
+
+static inline void scale3x_16_neon_center(scale3x_uint16* dst, const scale3x_uint16* src0, const scale3x_uint16* src1, const scale3x_uint16* src2, unsigned count) {
+	while (count >= 8) {
+		const uint16x8_t A = vld1q_u16(src0 - 1);
+		const uint16x8_t B = vld1q_u16(src0);
+		const uint16x8_t C = vld1q_u16(src0 + 1);
+		const uint16x8_t D = vld1q_u16(src1 - 1);
+		const uint16x8_t E = vld1q_u16(src1);
+		const uint16x8_t F = vld1q_u16(src1 + 1);
+		const uint16x8_t G = vld1q_u16(src2 - 1);
+		const uint16x8_t H = vld1q_u16(src2);
+		const uint16x8_t I = vld1q_u16(src2 + 1);
+
+		/* no edge if B == H or D == F */
+		const uint16x8_t noEdge = vorrq_u16(vceqq_u16(B, H), vceqq_u16(D, F));
+
+		/* (D == B && E != G) || (D == H && E != A) */
+		const uint16x8_t left = vorrq_u16(vbicq_u16(vceqq_u16(D, B), vceqq_u16(E, G)), vbicq_u16(vceqq_u16(D, H), vceqq_u16(E, A)));
+		/* (F == B && E != I) || (F == H && E != C) */
+		const uint16x8_t right = vorrq_u16(vbicq_u16(vceqq_u16(F, B), vceqq_u16(E, I)), vbicq_u16(vceqq_u16(F, H), vceqq_u16(E, C)));
+
+		uint16x8x3_t result;
+		result.val[0] = vbslq_u16(vbicq_u16(left, noEdge), D, E);
+		result.val[1] = E;
+		result.val[2] = vbslq_u16(vbicq_u16(right, noEdge), F, E);
+		vst3q_u16(dst, result);
+
+		src0 += 8;
+		src1 += 8;
+		src2 += 8;
+		dst += 24;
+		count -= 8;
+	}
+
+	scale3x_16_def_center(dst, src0, src1, src2, count);
+}
+
+/**
+ * Scale by a factor of 3 a row of pixels of 16 bits.
+ * This function operates like scale3x_16_def(), but uses NEON instructions.
+ * @param src0 Pointer at the first pixel of the previous row.
+ * @param src1 Pointer at the first pixel of the current row.
+ * @param src2 Pointer at the first pixel of the next row.
+ * @param count Length in pixels of the src0, src1 and src2 rows.
+ * @param dst0 First destination row, triple length in pixels.
+ * @param dst1 Second destination row, triple length in pixels.
+ * @param dst2 Third destination row, triple length in pixels.
+ */
+void scale3x_16_neon(scale3x_uint16* dst0, scale3x_uint16* dst1, scale3x_uint16* dst2, const scale3x_uint16* src0, const scale3x_uint16* src1, const scale3x_uint16* src2, unsigned count) {
+	scale3x_16_neon_border(dst0, src0, src1, src2, count);
+	scale3x_16_neon_center(dst1, src0, src1, src2, count);
+	scale3x_16_neon_border(dst2, src2, src1, src0, count);
+}
+
+#endif
@@ -0,0 +1,584 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "gui/ThemeCache.h"
+#include "gui/ThemeEval.h"
+
+#include "common/algorithm.h"
+#include "common/debug.h"
+#include "common/md5.h"
+#include "common/fs.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+#include "graphics/VectorRenderer.h"
+
+namespace GUI {
+
+enum {
+	kThemeCacheTag = MKTAG('S', 'T', 'X', 'C'),
+	kThemeCacheVersion = 1
+};
+
+/** The recorded calls, each followed by its arguments */
+enum ThemeCacheCall {
+	kCallEnd = 0,
+
+	kCallAddDrawStep,
+	kCallAddDrawData,
+	kCallAddFont,
+	kCallAddTextColor,
+	kCallAddBitmap,
+	kCallAddTextData,
+	kCallCreateCursor,
+
+	kCallSetVar,
+	kCallAddDialog,
+	kCallAddLayout,
+	kCallAddWidget,
+	kCallAddImportedLayout,
+	kCallAddSpace,
+	kCallAddPadding,
+	kCallCloseLayout,
+	kCallCloseDialog
+};
+
+/** The drawing functions of DrawSteps are stored as index into this table */
+static const Graphics::DrawingFunctionCallback kDrawingFunctions[] = {
+	&Graphics::VectorRenderer::drawCallback_CIRCLE,
+	&Graphics::VectorRenderer::drawCallback_SQUARE,
+	&Graphics::VectorRenderer::drawCallback_ROUNDSQ,
+	&Graphics::VectorRenderer::drawCallback_BEVELSQ,
+	&Graphics::VectorRenderer::drawCallback_LINE,
+	&Graphics::VectorRenderer::drawCallback_TRIANGLE,
+	&Graphics::VectorRenderer::drawCallback_FILLSURFACE,
+	&Graphics::VectorRenderer::drawCallback_TAB,
+	&Graphics::VectorRenderer::drawCallback_VOID,
+	&Graphics::VectorRenderer::drawCallback_BITMAP,
+	&Graphics::VectorRenderer::drawCallback_CROSS
+};
+
+static void writeColor(Common::WriteStream &stream, const Graphics::DrawStep::Color &color) {
+	stream.writeByte(color.r);
+	stream.writeByte(color.g);
+	stream.writeByte(color.b);
+	stream.writeByte(color.set);
+}
+
+static void readColor(Common::ReadStream &stream, Graphics::DrawStep::Color &color) {
+	color.r = stream.readByte();
+	color.g = stream.readByte();
+	color.b = stream.readByte();
+	color.set = stream.readByte() != 0;
+}
+
+ThemeCache::ThemeCache(const Common::String &themeId, const Common::String &key)
+	: _key(key), _calls(DisposeAfterUse::YES) {
+
+	// Themes are usually identified by their file path, only use the file
+	// name and only keep characters which are safe in file names
+	uint start = themeId.size();
+	while (start > 0 && themeId[start - 1] != '/' && themeId[start - 1] != '\\' && themeId[start - 1] != ':')
+		--start;
+
+	_fileName = "theme-";
+	for (uint i = start; i < themeId.size(); ++i)
+		_fileName += Common::isAlnum(themeId[i]) ? themeId[i] : '_';
+	_fileName += ".cache";
+}
+
+Common::String ThemeCache::computeKey(Common::Archive &archive, const Common::ArchiveMemberList &stxFiles) {
+	// The STX files are listed in no particular order, sort them so the key
+	// does not depend on it
+	Common::Array<Common::String> names;
+	names.push_back("THEMERC");
+	for (Common::ArchiveMemberList::const_iterator i = stxFiles.begin(); i != stxFiles.end(); ++i)
+		names.push_back((*i)->getName());
+	Common::sort(names.begin() + 1, names.end());
+
+	Common::String key;
+	for (uint i = 0; i < names.size(); ++i) {
+		Common::SeekableReadStream *stream = archive.createReadStreamForMember(names[i]);
+		if (!stream)
+			return Common::String();
+
+		key += Common::computeStreamMD5AsString(*stream);
+		delete stream;
+	}
+
+	return key;
+}
+
+Common::String ThemeCache::computeKey(const Common::FSNode &theme, const Common::ArchiveMemberList &stxFiles) {
+	if (!theme.exists())
+		return Common::String();
+
+	// A zipped theme is a single file. Otherwise list the files the same
+	// way as the MD5 key does.
+	Common::Array<Common::FSNode> files;
+	if (theme.isDirectory()) {
+		Common::Array<Common::String> names;
+		names.push_back("THEMERC");
+		for (Common::ArchiveMemberList::const_iterator i = stxFiles.begin(); i != stxFiles.end(); ++i)
+			names.push_back((*i)->getName());
+		Common::sort(names.begin() + 1, names.end());
+
+		for (uint i = 0; i < names.size(); ++i)
+			files.push_back(theme.getChild(names[i]));
+	} else {
+		files.push_back(theme);
+	}
+
+	Common::String key("stat");
+	for (uint i = 0; i < files.size(); ++i) {
+		const int32 size = files[i].getFileSize();
+		const uint32 time = files[i].getModificationTime();
+		if (size < 0 || time == 0)
+			return Common::String();
+
+		key += Common::String::format(":%s:%d:%u", files[i].getName().c_str(), size, time);
+	}
+
+	return key;
+}
+
+Common::String ThemeCache::computeKey(const byte *data, uint32 size) {
+	Common::MemoryReadStream stream(data, size);
+	return Common::computeStreamMD5AsString(stream);
+}
+
+bool ThemeCache::load(ThemeEngine *engine) {
+	if (_key.empty())
+		return false;
+
+	Common::SeekableReadStream *file = g_system->createCacheReadStream(_fileName);
+	if (!file)
+		return false;
+
+	bool result = false;
+	if (file->readUint32BE() == kThemeCacheTag && file->readUint32BE() == kThemeCacheVersion
+	        && readString(*file) == SCUMMVM_THEME_VERSION_STR
+	        && file->readUint16BE() == g_system->getOverlayWidth()
+	        && file->readUint16BE() == g_system->getOverlayHeight()
+	        && readString(*file) == _key) {
+		// Make sure the file is intact before replaying anything
+		const uint32 size = file->readUint32BE();
+		uint8 digest[16], fileDigest[16];
+		file->read(fileDigest, sizeof(fileDigest));
+
+		const int32 start = file->pos();
+		if (!file->err() && file->size() - start == (int32)size + 1 && Common::computeStreamMD5(*file, digest, size)
+		        && !memcmp(digest, fileDigest, sizeof(digest)) && file->seek(start))
+			result = replay(engine, *file);
+
+		if (!result)
+			warning("Theme cache file '%s' is corrupted", _fileName.c_str());
+	} else {
+		debug(3, "Theme cache file '%s' is outdated", _fileName.c_str());
+	}
+
+	delete file;
+	return result;
+}
+
+bool ThemeCache::save() {
+	if (_key.empty())
+		return false;
+
+	Common::WriteStream *file = g_system->createCacheWriteStream(_fileName);
+	if (!file)
+		return false;
+
+	file->writeUint32BE(kThemeCacheTag);
+	file->writeUint32BE(kThemeCacheVersion);
+
+	const Common::String version(SCUMMVM_THEME_VERSION_STR);
+	file->writeUint16BE(version.size());
+	file->writeString(version);
+	file->writeUint16BE(g_system->getOverlayWidth());
+	file->writeUint16BE(g_system->getOverlayHeight());
+	file->writeUint16BE(_key.size());
+	file->writeString(_key);
+
+	uint8 digest[16];
+	Common::MemoryReadStream calls(_calls.getData(), _calls.size());
+	Common::computeStreamMD5(calls, digest, _calls.size());
+
+	file->writeUint32BE(_calls.size());
+	file->write(digest, sizeof(digest));
+	file->write(_calls.getData(), _calls.size());
+	file->writeByte(kCallEnd);
+
+	file->finalize();
+	const bool result = !file->err();
+	delete file;
+
+	if (!result)
+		warning("Could not write theme cache file '%s'", _fileName.c_str());
+	return result;
+}
+
+void ThemeCache::writeString(const Common::String &str) {
+	_calls.writeUint16BE(str.size());
+	_calls.writeString(str);
+}
+
+Common::String ThemeCache::readString(Common::ReadStream &stream) {
+	Common::String str;
+	for (uint16 size = stream.readUint16BE(); size > 0 && !stream.eos(); --size)
+		str += (char)stream.readByte();
+	return str;
+}
+
+void ThemeCache::addDrawStep(const Common::String &drawDataId, const Graphics::DrawStep &step, const Common::String &bitmap) {
+	uint function = 0;
+	while (function < ARRAYSIZE(kDrawingFunctions) && kDrawingFunctions[function] != step.drawingCall)
+		++function;
+	assert(function < ARRAYSIZE(kDrawingFunctions));
+
+	_calls.writeByte(kCallAddDrawStep);
+	writeString(drawDataId);
+
+	writeColor(_calls, step.fgColor);
+	writeColor(_calls, step.bgColor);
+	writeColor(_calls, step.gradColor1);
+	writeColor(_calls, step.gradColor2);
+	writeColor(_calls, step.bevelColor);
+
+	_calls.writeByte(step.autoWidth);
+	_calls.writeByte(step.autoHeight);
+	_calls.writeSint16BE(step.x);
+	_calls.writeSint16BE(step.y);
+	_calls.writeSint16BE(step.w);
+	_calls.writeSint16BE(step.h);
+
+	_calls.writeSint16BE(step.padding.left);
+	_calls.writeSint16BE(step.padding.top);
+	_calls.writeSint16BE(step.padding.right);
+	_calls.writeSint16BE(step.padding.bottom);
+
+	_calls.writeByte(step.xAlign);
+	_calls.writeByte(step.yAlign);
+
+	_calls.writeByte(step.shadow);
+	_calls.writeByte(step.stroke);
+	_calls.writeByte(step.factor);
+	_calls.writeByte(step.radius);
+	_calls.writeByte(step.bevel);
+	_calls.writeByte(step.fillMode);
+	_calls.writeUint32BE(step.extraData);
+	_calls.writeUint32BE(step.scale);
+
+	_calls.writeByte(function);
+	writeString(bitmap);
+}
+
+void ThemeCache::addDrawData(const Common::String &data, bool cached) {
+	_calls.writeByte(kCallAddDrawData);
+	writeString(data);
+	_calls.writeByte(cached);
+}
+
+void ThemeCache::addFont(TextData textId, const Common::String &file, const Common::String &scalableFile, int pointsize) {
+	_calls.writeByte(kCallAddFont);
+	_calls.writeSByte(textId);
+	writeString(file);
+	writeString(scalableFile);
+	_calls.writeSint32BE(pointsize);
+}
+
+void ThemeCache::addTextColor(TextColor colorId, int r, int g, int b) {
+	_calls.writeByte(kCallAddTextColor);
+	_calls.writeByte(colorId);
+	_calls.writeByte(r);
+	_calls.writeByte(g);
+	_calls.writeByte(b);
+}
+
+void ThemeCache::addBitmap(const Common::String &filename) {
+	_calls.writeByte(kCallAddBitmap);
+	writeString(filename);
+}
+
+void ThemeCache::addTextData(const Common::String &drawDataId, TextData textId, TextColor colorId, Graphics::TextAlign alignH, ThemeEngine::TextAlignVertical alignV) {
+	_calls.writeByte(kCallAddTextData);
+	writeString(drawDataId);
+	_calls.writeSByte(textId);
+	_calls.writeByte(colorId);
+	_calls.writeByte(alignH);
+	_calls.writeByte(alignV);
+}
+
+void ThemeCache::createCursor(const Common::String &filename, int hotspotX, int hotspotY) {
+	_calls.writeByte(kCallCreateCursor);
+	writeString(filename);
+	_calls.writeSint16BE(hotspotX);
+	_calls.writeSint16BE(hotspotY);
+}
+
+void ThemeCache::setVar(const Common::String &name, int val) {
+	_calls.writeByte(kCallSetVar);
+	writeString(name);
+	_calls.writeSint32BE(val);
+}
+
+void ThemeCache::addDialog(const Common::String &name, const Common::String &overlays, bool enabled, int inset) {
+	_calls.writeByte(kCallAddDialog);
+	writeString(name);
+	writeString(overlays);
+	_calls.writeByte(enabled);
+	_calls.writeSint16BE(inset);
+}
+
+void ThemeCache::addLayout(ThemeLayout::LayoutType type, int spacing, bool center) {
+	_calls.writeByte(kCallAddLayout);
+	_calls.writeByte(type);
+	_calls.writeSint16BE(spacing);
+	_calls.writeByte(center);
+}
+
+void ThemeCache::addWidget(const Common::String &name, int w, int h, const Common::String &type, bool enabled, Graphics::TextAlign align) {
+	_calls.writeByte(kCallAddWidget);
+	writeString(name);
+	_calls.writeSint16BE(w);
+	_calls.writeSint16BE(h);
+	writeString(type);
+	_calls.writeByte(enabled);
+	_calls.writeByte(align);
+}
+
+void ThemeCache::addImportedLayout(const Common::String &name) {
+	_calls.writeByte(kCallAddImportedLayout);
+	writeString(name);
+}
+
+void ThemeCache::addSpace(int size) {
+	_calls.writeByte(kCallAddSpace);
+	_calls.writeSint16BE(size);
+}
+
+void ThemeCache::addPadding(int16 l, int16 r, int16 t, int16 b) {
+	_calls.writeByte(kCallAddPadding);
+	_calls.writeSint16BE(l);
+	_calls.writeSint16BE(r);
+	_calls.writeSint16BE(t);
+	_calls.writeSint16BE(b);
+}
+
+void ThemeCache::closeLayout() {
+	_calls.writeByte(kCallCloseLayout);
+}
+
+void ThemeCache::closeDialog() {
+	_calls.writeByte(kCallCloseDialog);
+}
+
+bool ThemeCache::replay(ThemeEngine *engine, Common::SeekableReadStream &stream) {
+	ThemeEval *eval = engine->getEvaluator();
+	// The layout stack of ThemeEval must not be popped past the dialog
+	int layoutDepth = 0;
+
+	while (!stream.err() && !stream.eos()) {
+		const byte call = stream.readByte();
+
+		switch (call) {
+		case kCallEnd:
+			return layoutDepth == 0;
+
+		case kCallAddDrawStep: {
+			const Common::String drawDataId = readString(stream);
+
+			Graphics::DrawStep step;
+			step.blitSrc = 0;
+
+			readColor(stream, step.fgColor);
+			readColor(stream, step.bgColor);
+			readColor(stream, step.gradColor1);
+			readColor(stream, step.gradColor2);
+			readColor(stream, step.bevelColor);
+
+			step.autoWidth = stream.readByte() != 0;
+			step.autoHeight = stream.readByte() != 0;
+			step.x = stream.readSint16BE();
+			step.y = stream.readSint16BE();
+			step.w = stream.readSint16BE();
+			step.h = stream.readSint16BE();
+
+			step.padding.left = stream.readSint16BE();
+			step.padding.top = stream.readSint16BE();
+			step.padding.right = stream.readSint16BE();
+			step.padding.bottom = stream.readSint16BE();
+
+			step.xAlign = (Graphics::DrawStep::VectorAlignment)stream.readByte();
+			step.yAlign = (Graphics::DrawStep::VectorAlignment)stream.readByte();
+
+			step.shadow = stream.readByte();
+			step.stroke = stream.readByte();
+			step.factor = stream.readByte();
+			step.radius = stream.readByte();
+			step.bevel = stream.readByte();
+			step.fillMode = stream.readByte();
+			step.extraData = stream.readUint32BE();
+			step.scale = stream.readUint32BE();
+
+			const uint function = stream.readByte();
+			if (function >= ARRAYSIZE(kDrawingFunctions))
+				return false;
+			step.drawingCall = kDrawingFunctions[function];
+
+			const Common::String bitmap = readString(stream);
+			if (!bitmap.empty()) {
+				step.blitSrc = engine->getBitmap(bitmap);
+				if (!step.blitSrc)
+					return false;
+			}
+
+			engine->addDrawStep(drawDataId, step);
+			} break;
+
+		case kCallAddDrawData: {
+			const Common::String data = readString(stream);
+			if (!engine->addDrawData(data, stream.readByte() != 0))
+				return false;
+			} break;
+
+		case kCallAddFont: {
+			const TextData textId = (TextData)stream.readSByte();
+			const Common::String file = readString(stream);
+			const Common::String scalableFile = readString(stream);
+			const int pointsize = stream.readSint32BE();
+			if (textId < 0 || textId >= kTextDataMAX || !engine->addFont(textId, file, scalableFile, pointsize))
+				return false;
+			} break;
+
+		case kCallAddTextColor: {
+			const TextColor colorId = (TextColor)stream.readByte();
+			const int r = stream.readByte();
+			const int g = stream.readByte();
+			const int b = stream.readByte();
+			if (colorId >= kTextColorMAX || !engine->addTextColor(colorId, r, g, b))
+				return false;
+			} break;
+
+		case kCallAddBitmap:
+			if (!engine->addBitmap(readString(stream)))
+				return false;
+			break;
+
+		case kCallAddTextData: {
+			const Common::String drawDataId = readString(stream);
+			const TextData textId = (TextData)stream.readSByte();
+			const TextColor colorId = (TextColor)stream.readByte();
+			const Graphics::TextAlign alignH = (Graphics::TextAlign)stream.readByte();
+			const ThemeEngine::TextAlignVertical alignV = (ThemeEngine::TextAlignVertical)stream.readByte();
+			if (!engine->addTextData(drawDataId, textId, colorId, alignH, alignV))
+				return false;
+			} break;
+
+		case kCallCreateCursor: {
+			const Common::String filename = readString(stream);
+			const int hotspotX = stream.readSint16BE();
+			const int hotspotY = stream.readSint16BE();
+			if (!engine->createCursor(filename, hotspotX, hotspotY))
+				return false;
+			} break;
+
+		case kCallSetVar: {
+			const Common::String name = readString(stream);
+			eval->setVar(name, stream.readSint32BE());
+			} break;
+
+		case kCallAddDialog: {
+			if (layoutDepth != 0)
+				return false;
+			const Common::String name = readString(stream);
+			const Common::String overlays = readString(stream);
+			const bool enabled = stream.readByte() != 0;
+			eval->addDialog(name, overlays, enabled, stream.readSint16BE());
+			layoutDepth = 1;
+			} break;
+
+		case kCallAddLayout: {
+			if (layoutDepth == 0)
+				return false;
+			const ThemeLayout::LayoutType type = (ThemeLayout::LayoutType)stream.readByte();
+			const int spacing = stream.readSint16BE();
+			eval->addLayout(type, spacing, stream.readByte() != 0);
+			++layoutDepth;
+			} break;
+
+		case kCallAddWidget: {
+			if (layoutDepth == 0)
+				return false;
+			const Common::String name = readString(stream);
+			const int w = stream.readSint16BE();
+			const int h = stream.readSint16BE();
+			const Common::String type = readString(stream);
+			const bool enabled = stream.readByte() != 0;
+			eval->addWidget(name, w, h, type, enabled, (Graphics::TextAlign)stream.readByte());
+			} break;
+
+		case kCallAddImportedLayout:
+			if (layoutDepth == 0 || !eval->addImportedLayout(readString(stream)))
+				return false;
+			break;
+
+		case kCallAddSpace:
+			if (layoutDepth == 0)
+				return false;
+			eval->addSpace(stream.readSint16BE());
+			break;
+
+		case kCallAddPadding: {
+			if (layoutDepth == 0)
+				return false;
+			const int16 l = stream.readSint16BE();
+			const int16 r = stream.readSint16BE();
+			const int16 t = stream.readSint16BE();
+			const int16 b = stream.readSint16BE();
+			eval->addPadding(l, r, t, b);
+			} break;
+
+		case kCallCloseLayout:
+			if (layoutDepth <= 1)
+				return false;
+			eval->closeLayout();
+			--layoutDepth;
+			break;
+
+		case kCallCloseDialog:
+			if (layoutDepth != 1)
+				return false;
+			eval->closeDialog();
+			layoutDepth = 0;
+			break;
+
+		default:
+			return false;
+		}
+	}
+
+	return false;
+}
+
+} // End of namespace GUI
@@ -0,0 +1,140 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GUI_THEME_CACHE_H
+#define GUI_THEME_CACHE_H
+
+#include "common/archive.h"
+#include "common/fs.h"
+#include "common/memstream.h"
+#include "common/str.h"
+
+#include "graphics/font.h"
+
+#include "gui/ThemeEngine.h"
+#include "gui/ThemeLayout.h"
+
+namespace Graphics {
+struct DrawStep;
+}
+
+namespace GUI {
+
+/**
+ * Binary cache of a parsed theme.
+ *
+ * Parsing the STX files is the slowest part of loading a theme. While a
+ * theme is parsed, all calls the ThemeParser makes into ThemeEngine and
+ * ThemeEval are recorded here, with all palette colors, variables and
+ * resolution dependent values already resolved. The recording is stored in
+ * the cache directory of the backend (see OSystem::createCacheWriteStream()),
+ * and on later loads it is replayed on the engine directly instead of
+ * parsing the XML again.
+ *
+ * A cache file is only used if it was written for the same STX data (see
+ * computeKey()), the same theme format version and the same overlay size,
+ * since the layouts depend on it.
+ */
+class ThemeCache {
+public:
+	/**
+	 * @param themeId	Identifier or file path of the theme, the cache
+	 *					file name is derived from it
+	 * @param key		Key of the theme data, see computeKey()
+	 */
+	ThemeCache(const Common::String &themeId, const Common::String &key);
+
+	/**
+	 * Computes the key of a theme from the contents of its THEMERC and
+	 * STX files.
+	 */
+	static Common::String computeKey(Common::Archive &archive, const Common::ArchiveMemberList &stxFiles);
+
+	/**
+	 * Computes the key of a theme from the sizes and modification times of
+	 * its files, which is much cheaper than hashing them.
+	 *
+	 * @param theme		The theme directory or zip file
+	 * @return the key, or an empty string if the file system does not
+	 *         provide sizes or modification times
+	 */
+	static Common::String computeKey(const Common::FSNode &theme, const Common::ArchiveMemberList &stxFiles);
+
+	/** Computes the key of a theme held in memory, like the builtin one. */
+	static Common::String computeKey(const byte *data, uint32 size);
+
+	/**
+	 * Replays the cached theme on the given engine, if there is a valid
+	 * cache file.
+	 *
+	 * @return true if the theme was loaded. If false is returned, parts of
+	 *         the theme might still have been added to the engine.
+	 */
+	bool load(ThemeEngine *engine);
+
+	/** Writes the recorded calls to the cache file. */
+	bool save();
+
+	/**
+	 * Recording of the ThemeEngine calls.
+	 * @{
+	 */
+	void addDrawStep(const Common::String &drawDataId, const Graphics::DrawStep &step, const Common::String &bitmap);
+	void addDrawData(const Common::String &data, bool cached);
+	void addFont(TextData textId, const Common::String &file, const Common::String &scalableFile, int pointsize);
+	void addTextColor(TextColor colorId, int r, int g, int b);
+	void addBitmap(const Common::String &filename);
+	void addTextData(const Common::String &drawDataId, TextData textId, TextColor colorId, Graphics::TextAlign alignH, ThemeEngine::TextAlignVertical alignV);
+	void createCursor(const Common::String &filename, int hotspotX, int hotspotY);
+	/** @} */
+
+	/**
+	 * Recording of the ThemeEval calls.
+	 * @{
+	 */
+	void setVar(const Common::String &name, int val);
+	void addDialog(const Common::String &name, const Common::String &overlays, bool enabled, int inset);
+	void addLayout(ThemeLayout::LayoutType type, int spacing, bool center);
+	void addWidget(const Common::String &name, int w, int h, const Common::String &type, bool enabled, Graphics::TextAlign align);
+	void addImportedLayout(const Common::String &name);
+	void addSpace(int size);
+	void addPadding(int16 l, int16 r, int16 t, int16 b);
+	void closeLayout();
+	void closeDialog();
+	/** @} */
+
+private:
+	void writeString(const Common::String &str);
+	static Common::String readString(Common::ReadStream &stream);
+
+	bool replay(ThemeEngine *engine, Common::SeekableReadStream &stream);
+
+	Common::String _fileName;
+	Common::String _key;
+
+	/** The recorded calls */
+	Common::MemoryWriteStreamDynamic _calls;
+};
+
+} // End of namespace GUI
+
+#endif
@@ -37,9 +37,11 @@
 #include "graphics/decoders/bmp.h"
 
 #include "gui/widget.h"
+#include "gui/ThemeCache.h"
 #include "gui/ThemeEngine.h"
 #include "gui/ThemeEval.h"
 #include "gui/ThemeParser.h"
+#include "gui/ThemeRenderCache.h"
 
 namespace GUI {
 
@@ -75,6 +77,9 @@ struct WidgetDrawData {
 
 	bool _buffer;
 
+	/** Whether the rendered steps may be stored in the ThemeRenderCache */
+	bool _cacheable;
+
 
 	/**
 	 * Calculates the background threshold offset of a given DrawData item.
@@ -84,6 +89,13 @@ struct WidgetDrawData {
 	 * value will be added when restoring the background of the widget.
 	 */
 	void calcBackgroundOffset();
+
+	/**
+	 * Checks whether all DrawSteps only draw within the widget area plus the
+	 * background offset, which is required for caching them. This is not
+	 * the case for steps filling the whole surface or scaling positions.
+	 */
+	void calcCacheable();
 };
 
 class ThemeItem {
@@ -224,9 +236,38 @@ void ThemeItemDrawData::drawSelf(bool draw, bool restore) {
 		_engine->restoreBackground(extendedRect);
 
 	if (draw) {
+		Graphics::VectorRenderer *renderer = _engine->renderer();
+		Graphics::Surface *surface = renderer->getSurface();
+		ThemeRenderCache *cache = _data->_cacheable ? _engine->renderCache() : 0;
+
+		Common::Rect rect;
+		if (cache && extendedRect.isValidRect()) {
+			rect = extendedRect;
+			rect.clip(surface->w, surface->h);
+		}
+		if (rect.isEmpty())
+			cache = 0;
+
+		ThemeRenderCache::Key key;
+		if (cache) {
+			key.drawData = _data;
+			key.area = _area;
+			key.dynamicData = _dynamicData;
+			renderer->getDrawingState(key.state);
+		}
+
 		Common::List<Graphics::DrawStep>::const_iterator step;
-		for (step = _data->_steps.begin(); step != _data->_steps.end(); ++step)
-			_engine->renderer()->drawStep(_area, *step, _dynamicData);
+		if (cache && cache->draw(*surface, key, rect)) {
+			// Leave the renderer in the same state as after rendering
+			for (step = _data->_steps.begin(); step != _data->_steps.end(); ++step)
+				renderer->setDrawStepState(*step, _dynamicData);
+		} else {
+			for (step = _data->_steps.begin(); step != _data->_steps.end(); ++step)
+				renderer->drawStep(_area, *step, _dynamicData);
+
+			if (cache)
+				cache->store(*surface);
+		}
 	}
 
 	_engine->addDirtyRect(extendedRect);
@@ -267,11 +308,12 @@ ThemeEngine::ThemeEngine(Common::String id, GraphicsMode mode) :
 	_system(0), _vectorRenderer(0),
 	_buffering(false), _bytesPerPixel(0),  _graphicsMode(kGfxDisabled),
 	_font(0), _initOk(false), _themeOk(false), _enabled(false), _themeFiles(),
-	_cursor(0) {
+	_themeCache(0), _cursor(0) {
 
 	_system = g_system;
 	_parser = new ThemeParser(this);
 	_themeEval = new GUI::ThemeEval();
+	_renderCache = new ThemeRenderCache(kRenderCacheSize);
 
 	_useCursor = false;
 
@@ -325,6 +367,7 @@ ThemeEngine::~ThemeEngine() {
 
 	delete _parser;
 	delete _themeEval;
+	delete _renderCache;
 	delete[] _cursor;
 }
 
@@ -515,6 +558,9 @@ void ThemeEngine::setGraphicsMode(GraphicsMode mode) {
 	delete _vectorRenderer;
 	_vectorRenderer = Graphics::createRenderer(mode);
 	_vectorRenderer->setSurface(&_screen);
+
+	// The new renderer might draw differently
+	_renderCache->clear();
 }
 
 void WidgetDrawData::calcBackgroundOffset() {
@@ -531,6 +577,16 @@ void WidgetDrawData::calcBackgroundOffset() {
 	_backgroundOffset = maxShadow;
 }
 
+void WidgetDrawData::calcCacheable() {
+	_cacheable = true;
+	for (Common::List<Graphics::DrawStep>::const_iterator step = _steps.begin();
+	        step != _steps.end(); ++step) {
+		if (step->drawingCall == &Graphics::VectorRenderer::drawCallback_FILLSURFACE
+		        || (step->scale != 0 && step->scale != (1 << 16)))
+			_cacheable = false;
+	}
+}
+
 void ThemeEngine::restoreBackground(Common::Rect r) {
 	r.clip(_screen.w, _screen.h);
 	_vectorRenderer->blitSurface(&_backBuffer, r);
@@ -542,6 +598,16 @@ void ThemeEngine::restoreBackground(Common::Rect r) {
  * Theme elements management
  *********************************************************/
 void ThemeEngine::addDrawStep(const Common::String &drawDataId, const Graphics::DrawStep &step) {
+	if (_themeCache) {
+		// Bitmaps are stored by name, look up the one of the step
+		Common::String bitmap;
+		for (ImagesMap::const_iterator i = _bitmaps.begin(); step.blitSrc && i != _bitmaps.end(); ++i) {
+			if (i->_value == step.blitSrc)
+				bitmap = i->_key;
+		}
+		_themeCache->addDrawStep(drawDataId, step, bitmap);
+	}
+
 	DrawData id = parseDrawDataId(drawDataId);
 
 	assert(_widgets[id] != 0);
@@ -549,6 +615,9 @@ void ThemeEngine::addDrawStep(const Common::String &drawDataId, const Graphics::
 }
 
 bool ThemeEngine::addTextData(const Common::String &drawDataId, TextData textId, TextColor colorId, Graphics::TextAlign alignH, TextAlignVertical alignV) {
+	if (_themeCache)
+		_themeCache->addTextData(drawDataId, textId, colorId, alignH, alignV);
+
 	DrawData id = parseDrawDataId(drawDataId);
 
 	if (id == -1 || textId == -1 || colorId == kTextColorMAX || !_widgets[id])
@@ -563,6 +632,9 @@ bool ThemeEngine::addTextData(const Common::String &drawDataId, TextData textId,
 }
 
 bool ThemeEngine::addFont(TextData textId, const Common::String &file, const Common::String &scalableFile, const int pointsize) {
+	if (_themeCache)
+		_themeCache->addFont(textId, file, scalableFile, pointsize);
+
 	if (textId == -1)
 		return false;
 
@@ -603,6 +675,9 @@ bool ThemeEngine::addFont(TextData textId, const Common::String &file, const Com
 }
 
 bool ThemeEngine::addTextColor(TextColor colorId, int r, int g, int b) {
+	if (_themeCache)
+		_themeCache->addTextColor(colorId, r, g, b);
+
 	if (colorId >= kTextColorMAX)
 		return false;
 
@@ -619,6 +694,9 @@ bool ThemeEngine::addTextColor(TextColor colorId, int r, int g, int b) {
 }
 
 bool ThemeEngine::addBitmap(const Common::String &filename) {
+	if (_themeCache)
+		_themeCache->addBitmap(filename);
+
 	// Nothing has to be done if the bitmap already has been loaded.
 	Graphics::Surface *surf = _bitmaps[filename];
 	if (surf)
@@ -650,6 +728,9 @@ bool ThemeEngine::addBitmap(const Common::String &filename) {
 }
 
 bool ThemeEngine::addDrawData(const Common::String &data, bool cached) {
+	if (_themeCache)
+		_themeCache->addDrawData(data, cached);
+
 	DrawData id = parseDrawDataId(data);
 
 	if (id == -1)
@@ -691,13 +772,16 @@ void ThemeEngine::loadTheme(const Common::String &themeId) {
 			warning("Missing data asset: '%s'", kDrawDataDefaults[i].name);
 		} else {
 			_widgets[i]->calcBackgroundOffset();
+			_widgets[i]->calcCacheable();
 		}
 	}
 }
 
 void ThemeEngine::unloadTheme() {
-	if (!_themeOk)
-		return;
+	// The cached pixels refer to the draw data
+	debug(3, "Widget render cache: %u hits, %u full renders, %u bytes",
+	      _renderCache->getHits(), _renderCache->getMisses(), _renderCache->getSize());
+	_renderCache->clear();
 
 	for (int i = 0; i < kDrawDataMAX; ++i) {
 		delete _widgets[i];
@@ -729,15 +813,24 @@ bool ThemeEngine::loadDefaultXML() {
 #include "themes/default.inc"
 	    ;
 
-	if (!_parser->loadBuffer((const byte *)defaultXML, strlen(defaultXML)))
-		return false;
-
 	_themeName = "ScummVM Classic Theme (Builtin Version)";
 	_themeId = "builtin";
 	_themeFile.clear();
 
+	ThemeCache cache(_themeId, ThemeCache::computeKey((const byte *)defaultXML, strlen(defaultXML)));
+	if (loadThemeCache(cache))
+		return true;
+
+	if (!_parser->loadBuffer((const byte *)defaultXML, strlen(defaultXML)))
+		return false;
+
+	setThemeCache(&cache);
 	bool result = _parser->parse();
 	_parser->close();
+	setThemeCache(0);
+
+	if (result)
+		cache.save();
 
 	return result;
 #else
@@ -775,31 +868,68 @@ bool ThemeEngine::loadThemeXML(const Common::String &themeId) {
 		return false;
 	}
 
+	//
+	// Use the binary cache of the theme if it is up to date, this is
+	// much faster than parsing the STX files. The cache is keyed on the
+	// sizes and modification times of the theme directory or zip
+	// file. Hashing the STX files is only needed if the file system does
+	// not tell when they changed.
+	//
+	Common::String cacheKey;
+	if (!_themeFile.empty())
+		cacheKey = ThemeCache::computeKey(Common::FSNode(_themeFile), members);
+	if (cacheKey.empty())
+		cacheKey = ThemeCache::computeKey(*_themeArchive, members);
+
+	ThemeCache cache(themeId, cacheKey);
+	if (loadThemeCache(cache))
+		return true;
+
 	//
 	// Loop over all STX files, load and parse them
 	//
-	for (Common::ArchiveMemberList::iterator i = members.begin(); i != members.end(); ++i) {
+	bool result = true;
+	setThemeCache(&cache);
+
+	for (Common::ArchiveMemberList::iterator i = members.begin(); result && i != members.end(); ++i) {
 		assert((*i)->getName().hasSuffix(".stx"));
 
 		if (_parser->loadStream((*i)->createReadStream()) == false) {
 			warning("Failed to load STX file '%s'", (*i)->getDisplayName().c_str());
-			_parser->close();
-			return false;
-		}
-
-		if (_parser->parse() == false) {
+			result = false;
+		} else if (_parser->parse() == false) {
 			warning("Failed to parse STX file '%s'", (*i)->getDisplayName().c_str());
-			_parser->close();
-			return false;
+			result = false;
 		}
 
 		_parser->close();
 	}
 
+	setThemeCache(0);
+
+	if (!result)
+		return false;
+
+	cache.save();
+
 	assert(!_themeName.empty());
 	return true;
 }
 
+bool ThemeEngine::loadThemeCache(ThemeCache &cache) {
+	if (cache.load(this))
+		return true;
+
+	// Remove anything an invalid cache file might have added already
+	unloadTheme();
+	return false;
+}
+
+void ThemeEngine::setThemeCache(ThemeCache *cache) {
+	_themeCache = cache;
+	_themeEval->setCache(cache);
+}
+
 
 
 /**********************************************************
@@ -1290,6 +1420,9 @@ void ThemeEngine::openDialog(bool doBuffer, ShadingStyle style) {
 }
 
 bool ThemeEngine::createCursor(const Common::String &filename, int hotspotX, int hotspotY) {
+	if (_themeCache)
+		_themeCache->createCursor(filename, hotspotX, hotspotY);
+
 	if (!_system->hasFeature(OSystem::kFeatureCursorPalette))
 		return true;
 
@@ -55,9 +55,11 @@ struct TextDrawData;
 struct TextColorData;
 class Dialog;
 class GuiObject;
+class ThemeCache;
 class ThemeEval;
 class ThemeItem;
 class ThemeParser;
+class ThemeRenderCache;
 
 /**
  * DrawData sets enumeration.
@@ -249,6 +251,9 @@ public:
 	/** Constant value to expand dirty rectangles, to make sure they are fully copied */
 	static const int kDirtyRectangleThreshold = 1;
 
+	/** Maximum number of bytes used for caching rendered widget backgrounds */
+	static const uint32 kRenderCacheSize = 2 * 1024 * 1024;
+
 	struct Renderer {
 		const char *name;
 		const char *shortname;
@@ -483,6 +488,7 @@ public:
 
 	inline ThemeEval *getEvaluator() { return _themeEval; }
 	inline Graphics::VectorRenderer *renderer() { return _vectorRenderer; }
+	inline ThemeRenderCache *renderCache() { return _renderCache; }
 
 	inline bool supportsImages() const { return true; }
 	inline bool ownCursor() const { return _useCursor; }
@@ -543,6 +549,20 @@ protected:
 	 */
 	bool loadDefaultXML();
 
+	/**
+	 * Loads the theme from the given binary cache, see ThemeCache.
+	 *
+	 * @returns true if the theme was loaded, false if the cache is not
+	 *          usable and the theme must be parsed.
+	 */
+	bool loadThemeCache(ThemeCache &cache);
+
+	/**
+	 * Records all theme data added to the engine and its evaluator in the
+	 * given cache, or stops recording if 0 is passed.
+	 */
+	void setThemeCache(ThemeCache *cache);
+
 	/**
 	 * Unloads the currently loaded theme so another one can
 	 * be loaded.
@@ -616,6 +636,9 @@ protected:
 	/** Theme getEvaluator (changed from GUI::Eval to add functionality) */
 	GUI::ThemeEval *_themeEval;
 
+	/** Rendered widget backgrounds, see ThemeRenderCache */
+	GUI::ThemeRenderCache *_renderCache;
+
 	/** Main screen surface. This is blitted straight into the overlay. */
 	Graphics::Surface _screen;
 
@@ -673,6 +696,9 @@ protected:
 	Common::Archive *_themeArchive;
 	Common::SearchSet _themeFiles;
 
+	/** Records the theme while it is parsed, 0 otherwise */
+	ThemeCache *_themeCache;
+
 	bool _useCursor;
 	int _cursorHotspotX, _cursorHotspotY;
 	enum {
@@ -81,6 +81,9 @@ Graphics::TextAlign ThemeEval::getWidgetTextHAlign(const Common::String &widget)
 }
 
 void ThemeEval::addWidget(const Common::String &name, int w, int h, const Common::String &type, bool enabled, Graphics::TextAlign align) {
+	if (_cache)
+		_cache->addWidget(name, w, h, type, enabled, align);
+
 	int typeW = -1;
 	int typeH = -1;
 	Graphics::TextAlign typeAlign = Graphics::kTextAlignInvalid;
@@ -97,10 +100,13 @@ void ThemeEval::addWidget(const Common::String &name, int w, int h, const Common
 								typeAlign == Graphics::kTextAlignInvalid ? align : typeAlign);
 
 	_curLayout.top()->addChild(widget);
-	setVar(_curDialog + "." + name + ".Enabled", enabled ? 1 : 0);
+	_vars[_curDialog + "." + name + ".Enabled"] = enabled ? 1 : 0;
 }
 
 void ThemeEval::addDialog(const Common::String &name, const Common::String &overlays, bool enabled, int inset) {
+	if (_cache)
+		_cache->addDialog(name, overlays, enabled, inset);
+
 	int16 x, y;
 	uint16 w, h;
 
@@ -131,10 +137,13 @@ void ThemeEval::addDialog(const Common::String &name, const Common::String &over
 
 	_curLayout.push(layout);
 	_curDialog = name;
-	setVar(name + ".Enabled", enabled ? 1 : 0);
+	_vars[name + ".Enabled"] = enabled ? 1 : 0;
 }
 
 void ThemeEval::addLayout(ThemeLayout::LayoutType type, int spacing, bool center) {
+	if (_cache)
+		_cache->addLayout(type, spacing, center);
+
 	ThemeLayout *layout = 0;
 
 	if (spacing == -1)
@@ -156,6 +165,9 @@ void ThemeEval::addLayout(ThemeLayout::LayoutType type, int spacing, bool center
 }
 
 void ThemeEval::addSpace(int size) {
+	if (_cache)
+		_cache->addSpace(size);
+
 	ThemeLayout *space = new ThemeLayoutSpacing(_curLayout.top(), size);
 	_curLayout.top()->addChild(space);
 }
@@ -164,6 +176,9 @@ bool ThemeEval::addImportedLayout(const Common::String &name) {
 	if (!_layouts.contains(name))
 		return false;
 
+	if (_cache)
+		_cache->addImportedLayout(name);
+
 	_curLayout.top()->importLayout(_layouts[name]);
 	return true;
 }
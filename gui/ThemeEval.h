@@ -31,6 +31,7 @@
 #include "common/textconsole.h"
 #include "graphics/font.h"
 
+#include "gui/ThemeCache.h"
 #include "gui/ThemeLayout.h"
 
 namespace GUI {
@@ -41,7 +42,7 @@ class ThemeEval {
 	typedef Common::HashMap<Common::String, ThemeLayout *> LayoutsMap;
 
 public:
-	ThemeEval() {
+	ThemeEval() : _cache(0) {
 		buildBuiltinVars();
 	}
 
@@ -70,7 +71,11 @@ public:
 		return def;
 	}
 
-	void setVar(const Common::String &name, int val) { _vars[name] = val; }
+	void setVar(const Common::String &name, int val) {
+		if (_cache)
+			_cache->setVar(name, val);
+		_vars[name] = val;
+	}
 
 	bool hasVar(const Common::String &name) { return _vars.contains(name) || _builtin.contains(name); }
 
@@ -80,10 +85,30 @@ public:
 	bool addImportedLayout(const Common::String &name);
 	void addSpace(int size);
 
-	void addPadding(int16 l, int16 r, int16 t, int16 b) { _curLayout.top()->setPadding(l, r, t, b); }
+	void addPadding(int16 l, int16 r, int16 t, int16 b) {
+		if (_cache)
+			_cache->addPadding(l, r, t, b);
+		_curLayout.top()->setPadding(l, r, t, b);
+	}
 
-	void closeLayout() { _curLayout.pop(); }
-	void closeDialog() { _curLayout.pop()->reflowLayout(); _curDialog.clear(); }
+	void closeLayout() {
+		if (_cache)
+			_cache->closeLayout();
+		_curLayout.pop();
+	}
+
+	void closeDialog() {
+		if (_cache)
+			_cache->closeDialog();
+		_curLayout.pop()->reflowLayout();
+		_curDialog.clear();
+	}
+
+	/**
+	 * Sets the cache which records all changes to the layouts and
+	 * variables, or 0 to stop recording.
+	 */
+	void setCache(ThemeCache *cache) { _cache = cache; }
 
 	bool getWidgetData(const Common::String &widget, int16 &x, int16 &y, uint16 &w, uint16 &h);
 
@@ -104,6 +129,8 @@ private:
 	LayoutsMap _layouts;
 	Common::Stack<ThemeLayout *> _curLayout;
 	Common::String _curDialog;
+
+	ThemeCache *_cache;
 };
 
 } // End of namespace GUI
@@ -0,0 +1,143 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "gui/ThemeRenderCache.h"
+
+namespace GUI {
+
+ThemeRenderCache::ThemeRenderCache(uint32 maxSize)
+	: _pending(0), _maxSize(maxSize), _size(0), _hits(0), _misses(0) {
+}
+
+ThemeRenderCache::~ThemeRenderCache() {
+	clear();
+}
+
+bool ThemeRenderCache::draw(Graphics::Surface &surface, const Key &key, const Common::Rect &rect) {
+	assert(rect.left >= 0 && rect.top >= 0 && rect.right <= surface.w && rect.bottom <= surface.h);
+
+	if (_pending) {
+		delete[] _pending->pixels;
+		delete _pending;
+		_pending = 0;
+	}
+
+	EntryMap::iterator i = _entries.find(key);
+	if (i != _entries.end()) {
+		Entry *entry = i->_value;
+
+		if (entry->rect == rect && compareRect(surface, rect, entry->pixels)) {
+			const byte *src = entry->pixels + entry->size / 2;
+			const uint rowSize = rect.width() * surface.format.bytesPerPixel;
+			for (int y = rect.top; y < rect.bottom; ++y, src += rowSize)
+				memcpy(surface.getBasePtr(rect.left, y), src, rowSize);
+
+			_lru.erase(entry->lruPosition);
+			_lru.push_front(entry);
+			entry->lruPosition = _lru.begin();
+
+			++_hits;
+			return true;
+		}
+
+		// Something else is below the widget now, the entry is replaced
+		// once the widget has been rendered
+		removeEntry(entry);
+	}
+
+	++_misses;
+
+	// Do not let a single entry push out most of the others
+	const uint32 size = rect.width() * rect.height() * surface.format.bytesPerPixel * 2;
+	if (size == 0 || size > _maxSize / 2)
+		return false;
+
+	_pending = new Entry;
+	_pending->key = key;
+	_pending->rect = rect;
+	_pending->size = size;
+	_pending->pixels = new byte[size];
+	copyRect(surface, rect, _pending->pixels);
+
+	return false;
+}
+
+void ThemeRenderCache::store(const Graphics::Surface &surface) {
+	if (!_pending)
+		return;
+
+	Entry *entry = _pending;
+	_pending = 0;
+
+	copyRect(surface, entry->rect, entry->pixels + entry->size / 2);
+
+	_entries[entry->key] = entry;
+	_lru.push_front(entry);
+	entry->lruPosition = _lru.begin();
+	_size += entry->size;
+
+	while (_size > _maxSize)
+		removeEntry(_lru.back());
+}
+
+void ThemeRenderCache::clear() {
+	for (EntryList::iterator i = _lru.begin(); i != _lru.end(); ++i) {
+		delete[] (*i)->pixels;
+		delete *i;
+	}
+
+	_lru.clear();
+	_entries.clear();
+	_size = 0;
+
+	if (_pending) {
+		delete[] _pending->pixels;
+		delete _pending;
+		_pending = 0;
+	}
+}
+
+void ThemeRenderCache::copyRect(const Graphics::Surface &surface, const Common::Rect &rect, byte *dst) const {
+	const uint rowSize = rect.width() * surface.format.bytesPerPixel;
+	for (int y = rect.top; y < rect.bottom; ++y, dst += rowSize)
+		memcpy(dst, surface.getBasePtr(rect.left, y), rowSize);
+}
+
+bool ThemeRenderCache::compareRect(const Graphics::Surface &surface, const Common::Rect &rect, const byte *pixels) const {
+	const uint rowSize = rect.width() * surface.format.bytesPerPixel;
+	for (int y = rect.top; y < rect.bottom; ++y, pixels += rowSize) {
+		if (memcmp(pixels, surface.getBasePtr(rect.left, y), rowSize))
+			return false;
+	}
+	return true;
+}
+
+void ThemeRenderCache::removeEntry(Entry *entry) {
+	_entries.erase(entry->key);
+	_lru.erase(entry->lruPosition);
+	_size -= entry->size;
+
+	delete[] entry->pixels;
+	delete entry;
+}
+
+} // End of namespace GUI
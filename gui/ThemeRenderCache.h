@@ -0,0 +1,141 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GUI_THEME_RENDER_CACHE_H
+#define GUI_THEME_RENDER_CACHE_H
+
+#include "common/hashmap.h"
+#include "common/list.h"
+#include "common/rect.h"
+
+#include "graphics/surface.h"
+#include "graphics/VectorRenderer.h"
+
+namespace GUI {
+
+/**
+ * Remembers the pixels of rendered widget backgrounds, so redrawing the
+ * same widget does not have to run its DrawSteps through the vector
+ * renderer again.
+ *
+ * The steps blend with whatever is below the widget (shadows, antialiased
+ * edges) and depend on the position (gradient dithering, shadows clipped
+ * at the screen edges). An entry therefore stores the pixels of the
+ * widget area before and after rendering, and is only used if the target
+ * surface still contains the same pixels as before rendering. This makes
+ * blitting from the cache give exactly the same result as rendering.
+ *
+ * The entries are limited to a total size in bytes. The least recently
+ * used ones are dropped first.
+ */
+class ThemeRenderCache {
+public:
+	struct Key {
+		/** The drawn WidgetDrawData */
+		const void *drawData;
+		/** The area passed to the DrawSteps */
+		Common::Rect area;
+		uint32 dynamicData;
+		Graphics::VectorRenderer::DrawingState state;
+
+		bool operator==(const Key &k) const {
+			return drawData == k.drawData && area == k.area && dynamicData == k.dynamicData && state == k.state;
+		}
+	};
+
+	/**
+	 * @param maxSize	Maximum number of bytes used for cached pixels
+	 */
+	explicit ThemeRenderCache(uint32 maxSize);
+	~ThemeRenderCache();
+
+	/**
+	 * Draws the cached pixels for the given key into the surface, if the
+	 * surface is unchanged since they were rendered.
+	 *
+	 * @param surface	The surface to draw to
+	 * @param key		Identifies what to draw
+	 * @param rect		The rect of the surface affected by drawing, must be
+	 *					within the surface
+	 * @return true if the pixels were drawn. Otherwise, the caller needs
+	 *         to render them and call store() afterwards.
+	 */
+	bool draw(Graphics::Surface &surface, const Key &key, const Common::Rect &rect);
+
+	/**
+	 * Stores the pixels of the rect of the last unsuccessful draw() call,
+	 * after they have been rendered.
+	 */
+	void store(const Graphics::Surface &surface);
+
+	/** Drops all entries */
+	void clear();
+
+	/** Number of draw() calls which drew cached pixels */
+	uint32 getHits() const { return _hits; }
+	/** Number of draw() calls which required rendering */
+	uint32 getMisses() const { return _misses; }
+	/** Number of bytes of all entries */
+	uint32 getSize() const { return _size; }
+
+private:
+	struct Entry;
+
+	struct KeyHash {
+		uint operator()(const Key &k) const {
+			return (uint)(size_t)k.drawData ^ (k.area.left << 20) ^ (k.area.top << 10) ^ k.area.right ^ (k.area.bottom << 5) ^ k.dynamicData ^ k.state.fgColor ^ k.state.bgColor;
+		}
+	};
+
+	typedef Common::List<Entry *> EntryList;
+	typedef Common::HashMap<Key, Entry *, KeyHash> EntryMap;
+
+	struct Entry {
+		Key key;
+		Common::Rect rect;
+		/** The pixels of rect before and after rendering, one after the other */
+		byte *pixels;
+		uint32 size;
+		/** Position in _lru */
+		EntryList::iterator lruPosition;
+	};
+
+	void copyRect(const Graphics::Surface &surface, const Common::Rect &rect, byte *dst) const;
+	bool compareRect(const Graphics::Surface &surface, const Common::Rect &rect, const byte *pixels) const;
+	void removeEntry(Entry *entry);
+
+	EntryMap _entries;
+	/** The most recently used entries first */
+	EntryList _lru;
+
+	/** The entry for which draw() failed, waiting for store() */
+	Entry *_pending;
+
+	uint32 _maxSize;
+	uint32 _size;
+	uint32 _hits;
+	uint32 _misses;
+};
+
+} // End of namespace GUI
+
+#endif
@@ -21,6 +21,8 @@
 
 #include "base/version.h"
 
+#include "engines/md5cache.h"
+
 #include "common/config-manager.h"
 #include "common/events.h"
 #include "common/fs.h"
@@ -842,6 +844,7 @@ void LauncherDialog::addGame() {
 			// ...so let's determine a list of candidates, games that
 			// could be contained in the specified directory.
 			GameList candidates(EngineMan.detectGames(files));
+			MD5Cache.flush();
 
 			int idx;
 			if (candidates.empty()) {
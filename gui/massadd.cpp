@@ -19,6 +19,7 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  */
 
+#include "engines/md5cache.h"
 #include "engines/metaengine.h"
 #include "common/algorithm.h"
 #include "common/config-manager.h"
@@ -162,7 +163,9 @@ void MassAddDialog::handleCommand(CommandSender *sender, uint32 cmd, uint32 data
 
 		close();
 	} else if (cmd == kCancelCmd) {
-		// User cancelled, so we don't do anything and just leave.
+		// User cancelled, so we don't do anything and just leave. The MD5
+		// sums computed so far are kept for the next scan, though.
+		MD5Cache.flush();
 		_games.clear();
 		close();
 	} else {
@@ -252,6 +255,11 @@ void MassAddDialog::handleTickle() {
 	Common::String buf;
 
 	if (_scanStack.empty()) {
+		// Remember the MD5 sums for rescanning. Having looked at a whole
+		// collection, this is a good time to forget about removed files.
+		MD5Cache.prune();
+		MD5Cache.flush();
+
 		// Enable the OK button
 		_okButton->setEnabled(true);
 
@@ -17,10 +17,12 @@ MODULE_OBJS := \
 	saveload.o \
 	saveload-dialog.o \
 	themebrowser.o \
+	ThemeCache.o \
 	ThemeEngine.o \
 	ThemeEval.o \
 	ThemeLayout.o \
 	ThemeParser.o \
+	ThemeRenderCache.o \
 	Tooltip.o \
 	widget.o \
 	widgets/editable.o \
@@ -22,6 +22,7 @@
 #include "gui/saveload-dialog.h"
 #include "common/translation.h"
 #include "common/config-manager.h"
+#include "common/system.h"
 
 #include "gui/message.h"
 #include "gui/gui-manager.h"
@@ -534,6 +535,12 @@ enum {
 	kNewSaveCmd = 'SAVE'
 };
 
+enum {
+	// Upper bound (in milliseconds) we want to spend loading save infos in
+	// handleTickle.
+	kMaxLoadTime = 20
+};
+
 SaveLoadChooserGrid::SaveLoadChooserGrid(const Common::String &title, bool saveMode)
 	: SaveLoadChooserDialog("SaveLoadChooser", saveMode), _lines(0), _columns(0), _entriesPerPage(0),
 	_curPage(0), _newSaveContainer(0), _nextFreeSaveSlot(0), _buttons() {
@@ -616,12 +623,23 @@ void SaveLoadChooserGrid::handleMouseWheel(int x, int y, int direction) {
 	}
 }
 
+void SaveLoadChooserGrid::handleTickle() {
+	const uint32 start = g_system->getMillis();
+	while (loadNextSaveInfo() && g_system->getMillis() - start < kMaxLoadTime)
+		;
+
+	SaveLoadChooserDialog::handleTickle();
+}
+
 void SaveLoadChooserGrid::open() {
 	SaveLoadChooserDialog::open();
 
 	_saveList = _metaEngine->listSaves(_target.c_str());
 	_resultString.clear();
 
+	// The saves might have changed while the dialog was closed
+	_saveInfos.clear();
+
 	// Load information to restore the last page the user had open.
 	assert(_entriesPerPage != 0);
 	const uint lastPos = ConfMan.getInt("gui_saveload_last_pos");
@@ -786,6 +804,7 @@ void SaveLoadChooserGrid::close() {
 
 	SaveLoadChooserDialog::close();
 	hideButtons();
+	_saveInfos.clear();
 }
 
 int SaveLoadChooserGrid::runIntern() {
@@ -849,53 +868,21 @@ void SaveLoadChooserGrid::updateSaves() {
 	hideButtons();
 
 	for (uint i = _curPage * _entriesPerPage, curNum = 0; i < _saveList.size() && curNum < _entriesPerPage; ++i, ++curNum) {
-		const uint saveSlot = _saveList[i].getSaveSlot();
-
-		SaveStateDescriptor desc = _metaEngine->querySaveMetaInfos(_target.c_str(), saveSlot);
-		SlotButton &curButton = _buttons[curNum];
-		curButton.setVisible(true);
-		const Graphics::Surface *thumbnail = desc.getThumbnail();
-		if (thumbnail) {
-			curButton.button->setGfx(desc.getThumbnail());
-		} else {
-			curButton.button->setGfx(kThumbnailWidth, kThumbnailHeight2, 0, 0, 0);
-		}
-		curButton.description->setLabel(Common::String::format("%d. %s", saveSlot, desc.getDescription().c_str()));
-
-		Common::String tooltip(_("Name: "));
-		tooltip += desc.getDescription();
-
-		if (_saveDateSupport) {
-			const Common::String &saveDate = desc.getSaveDate();
-			if (!saveDate.empty()) {
-				tooltip += "\n";
-				tooltip +=  _("Date: ") + saveDate;
-			}
-
-			const Common::String &saveTime = desc.getSaveTime();
-			if (!saveTime.empty()) {
-				tooltip += "\n";
-				tooltip += _("Time: ") + saveTime;
-			}
-		}
-
-		if (_playTimeSupport) {
-			const Common::String &playTime = desc.getPlayTime();
-			if (!playTime.empty()) {
-				tooltip += "\n";
-				tooltip += _("Playtime: ") + playTime;
-			}
-		}
-
-		curButton.button->setTooltip(tooltip);
+		// Until the meta infos have been loaded, show the description known
+		// from the save list and an empty thumbnail.
+		SaveInfoMap::const_iterator info = _saveInfos.find(_saveList[i].getSaveSlot());
+		if (info != _saveInfos.end())
+			updateSaveButton(i, info->_value, true);
+		else
+			updateSaveButton(i, _saveList[i], false);
+	}
 
-		// In save mode we disable the button, when it's write protected.
-		// TODO: Maybe we should not display it at all then?
-		if (_saveMode && desc.getWriteProtectedFlag()) {
-			curButton.button->setEnabled(false);
-		} else {
-			curButton.button->setEnabled(true);
-		}
+	// Forget about the saves far away from the current page, so the
+	// thumbnails do not pile up when paging through many saves.
+	for (uint i = 0; _entriesPerPage != 0 && i < _saveList.size(); ++i) {
+		const uint page = i / _entriesPerPage;
+		if (page + 1 < _curPage || page > _curPage + 1)
+			_saveInfos.erase(_saveList[i].getSaveSlot());
 	}
 
 	const uint numPages = (_entriesPerPage != 0 && !_saveList.empty()) ? ((_saveList.size() + _entriesPerPage - 1) / _entriesPerPage) : 1;
@@ -912,6 +899,85 @@ void SaveLoadChooserGrid::updateSaves() {
 		_nextButton->setEnabled(false);
 }
 
+void SaveLoadChooserGrid::updateSaveButton(uint saveIndex, const SaveStateDescriptor &desc, bool loaded) {
+	const int saveSlot = _saveList[saveIndex].getSaveSlot();
+	SlotButton &curButton = _buttons[saveIndex - _curPage * _entriesPerPage];
+	curButton.setVisible(true);
+	const Graphics::Surface *thumbnail = desc.getThumbnail();
+	if (thumbnail) {
+		curButton.button->setGfx(desc.getThumbnail());
+	} else {
+		curButton.button->setGfx(kThumbnailWidth, kThumbnailHeight2, 0, 0, 0);
+	}
+	curButton.description->setLabel(Common::String::format("%d. %s", saveSlot, desc.getDescription().c_str()));
+
+	Common::String tooltip(_("Name: "));
+	tooltip += desc.getDescription();
+
+	if (_saveDateSupport) {
+		const Common::String &saveDate = desc.getSaveDate();
+		if (!saveDate.empty()) {
+			tooltip += "\n";
+			tooltip +=  _("Date: ") + saveDate;
+		}
+
+		const Common::String &saveTime = desc.getSaveTime();
+		if (!saveTime.empty()) {
+			tooltip += "\n";
+			tooltip += _("Time: ") + saveTime;
+		}
+	}
+
+	if (_playTimeSupport) {
+		const Common::String &playTime = desc.getPlayTime();
+		if (!playTime.empty()) {
+			tooltip += "\n";
+			tooltip += _("Playtime: ") + playTime;
+		}
+	}
+
+	curButton.button->setTooltip(tooltip);
+
+	// In save mode we disable the button, when it's write protected.
+	// TODO: Maybe we should not display it at all then?
+	// Until this is known, the button stays disabled as well.
+	if (_saveMode && (!loaded || desc.getWriteProtectedFlag())) {
+		curButton.button->setEnabled(false);
+	} else {
+		curButton.button->setEnabled(true);
+	}
+}
+
+bool SaveLoadChooserGrid::loadNextSaveInfo() {
+	if (_entriesPerPage == 0 || _saveList.empty())
+		return false;
+
+	// Load the current page first, then prefetch the next page and finally
+	// the previous one.
+	const uint pages[3] = { _curPage, _curPage + 1, _curPage - 1 };
+	for (uint p = 0; p < ARRAYSIZE(pages); ++p) {
+		if ((p == 2 && _curPage == 0) || pages[p] * _entriesPerPage >= _saveList.size())
+			continue;
+
+		const uint end = MIN<uint>((pages[p] + 1) * _entriesPerPage, _saveList.size());
+		for (uint i = pages[p] * _entriesPerPage; i < end; ++i) {
+			const int saveSlot = _saveList[i].getSaveSlot();
+			if (_saveInfos.contains(saveSlot))
+				continue;
+
+			const SaveStateDescriptor &desc = _saveInfos[saveSlot] = _metaEngine->querySaveMetaInfos(_target.c_str(), saveSlot);
+
+			if (pages[p] == _curPage) {
+				updateSaveButton(i, desc, true);
+				_buttons[i - _curPage * _entriesPerPage].button->draw();
+			}
+			return true;
+		}
+	}
+
+	return false;
+}
+
 SavenameDialog::SavenameDialog()
 	: Dialog("SavenameDialog") {
 	_title = new StaticTextWidget(this, "SavenameDialog.DescriptionText", Common::String());
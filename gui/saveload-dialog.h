@@ -22,6 +22,8 @@
 #ifndef GUI_SAVELOAD_DIALOG_H
 #define GUI_SAVELOAD_DIALOG_H
 
+#include "common/hashmap.h"
+
 #include "gui/dialog.h"
 #include "gui/widgets/list.h"
 
@@ -163,6 +165,7 @@ public:
 protected:
 	virtual void handleCommand(CommandSender *sender, uint32 cmd, uint32 data);
 	virtual void handleMouseWheel(int x, int y, int direction);
+	virtual void handleTickle();
 private:
 	virtual int runIntern();
 
@@ -171,6 +174,14 @@ private:
 	uint _curPage;
 	SaveStateList _saveList;
 
+	/**
+	 * Meta infos of the saves around the current page, by save slot. They
+	 * are queried in handleTickle(), so the dialog can be shown and paged
+	 * through before all save files have been read.
+	 */
+	typedef Common::HashMap<int, SaveStateDescriptor> SaveInfoMap;
+	SaveInfoMap _saveInfos;
+
 	ButtonWidget *_nextButton;
 	ButtonWidget *_prevButton;
 
@@ -200,6 +211,15 @@ private:
 	void destroyButtons();
 	void hideButtons();
 	void updateSaves();
+	void updateSaveButton(uint saveIndex, const SaveStateDescriptor &desc, bool loaded);
+
+	/**
+	 * Queries the meta infos of one save of the current page or, once they
+	 * are all known, of the next or previous page.
+	 *
+	 * @return false if there was nothing left to load
+	 */
+	bool loadNextSaveInfo();
 };
 
 #endif // !DISABLE_SAVELOADCHOOSER_GRID
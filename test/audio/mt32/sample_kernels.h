@@ -0,0 +1,163 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/softsynth/mt32/mt32emu.h"
+
+#include "../../helpers/test_random.h"
+
+class MT32SampleKernelsTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		// Not a multiple of the vector sizes, to test the remainder handling
+		kLength = 203
+	};
+
+	/** Seed for nextTestRandom() */
+	uint32 _seed;
+
+	void fillSamples(MT32Emu::Bit16s *buffer, int count) {
+		// Make sure the extreme values are covered as well
+		static const MT32Emu::Bit16s extremes[] = { -32768, 32767, -1, 0, 1, -32767 };
+		for (int i = 0; i < count; ++i)
+			buffer[i] = (i < ARRAYSIZE(extremes)) ? extremes[i] : (MT32Emu::Bit16s)nextTestRandom(_seed);
+	}
+
+	void fillFloats(float *buffer, int count) {
+		// Values around the clipping limits and exact integers after scaling
+		// by 8192 or 16384, where flooring and truncation differ most.
+		static const float specials[] = { 0.0f, -0.0f, 1.0f, -1.0f, 3.9999f, -4.0f, -4.0001f, 5.0f, -5.0f, 1e10f, -1e10f,
+			1.0f / 8192, -1.0f / 8192, 0.5f / 8192, -0.5f / 8192, -1.5f / 16384 };
+		for (int i = 0; i < count; ++i) {
+			if (i < ARRAYSIZE(specials))
+				buffer[i] = specials[i];
+			else
+				buffer[i] = ((int)(nextTestRandom(_seed) % 200001) - 100000) / 20000.0f;
+		}
+	}
+
+	void compareConversion(MT32Emu::FloatToBit16sFunc reference, MT32Emu::FloatToBit16sFunc fast) {
+		float source[kLength];
+		MT32Emu::Bit16s expected[kLength];
+		MT32Emu::Bit16s result[kLength];
+
+		static const float gains[] = { 1.0f, 0.68f, 1.7f };
+		for (int g = 0; g < ARRAYSIZE(gains); ++g) {
+			for (int len = kLength - 8; len <= kLength; ++len) {
+				fillFloats(source, kLength);
+				memset(expected, 0x55, sizeof(expected));
+				memset(result, 0x55, sizeof(result));
+
+				reference(expected, source, len, gains[g]);
+				fast(result, source, len, gains[g]);
+
+				TS_ASSERT_EQUALS(memcmp(expected, result, sizeof(result)), 0);
+			}
+		}
+	}
+
+public:
+	void setUp() {
+		_seed = 1;
+	}
+
+	void test_mix_partial() {
+		const MT32Emu::SampleKernels &fast = MT32Emu::getSampleKernels();
+		const MT32Emu::SampleKernels &reference = MT32Emu::getScalarSampleKernels();
+
+		MT32Emu::Bit16s samples[kLength];
+		float expectedLeft[kLength], expectedRight[kLength];
+		float resultLeft[kLength], resultRight[kLength];
+
+		static const float volumes[] = { 0.0f, 0.125f, 0.4f, 1.0f / 3 };
+		for (int l = 0; l < ARRAYSIZE(volumes); ++l) {
+			for (int r = 0; r < ARRAYSIZE(volumes); ++r) {
+				fillSamples(samples, kLength);
+				for (int i = 0; i < kLength; ++i) {
+					expectedLeft[i] = resultLeft[i] = (MT32Emu::Bit16s)nextTestRandom(_seed) / 7.0f;
+					expectedRight[i] = resultRight[i] = (MT32Emu::Bit16s)nextTestRandom(_seed) / 3.0f;
+				}
+
+				reference.mixPartial(expectedLeft, expectedRight, samples, kLength - l, volumes[l], volumes[r]);
+				fast.mixPartial(resultLeft, resultRight, samples, kLength - l, volumes[l], volumes[r]);
+
+				TS_ASSERT_EQUALS(memcmp(expectedLeft, resultLeft, sizeof(resultLeft)), 0);
+				TS_ASSERT_EQUALS(memcmp(expectedRight, resultRight, sizeof(resultRight)), 0);
+			}
+		}
+	}
+
+	void test_float_to_bit16s() {
+		const MT32Emu::SampleKernels &fast = MT32Emu::getSampleKernels();
+		const MT32Emu::SampleKernels &reference = MT32Emu::getScalarSampleKernels();
+
+		compareConversion(reference.floatToBit16sNice, fast.floatToBit16sNice);
+		compareConversion(reference.floatToBit16sPure, fast.floatToBit16sPure);
+		compareConversion(reference.floatToBit16sReverb, fast.floatToBit16sReverb);
+		compareConversion(reference.floatToBit16sGeneration1, fast.floatToBit16sGeneration1);
+		compareConversion(reference.floatToBit16sGeneration2, fast.floatToBit16sGeneration2);
+	}
+
+	void test_float_to_bit16s_values() {
+		const MT32Emu::SampleKernels &kernels = MT32Emu::getSampleKernels();
+
+		const float source[8] = { 0.0f, 1.0f, -1.0f, -0.5f / 8192, 2.0f / 8192, 5.0f, -5.0f, 1.5f / 8192 };
+		MT32Emu::Bit16s target[8];
+
+		kernels.floatToBit16sReverb(target, source, 8, 1.0f);
+		TS_ASSERT_EQUALS(target[0], 0);
+		TS_ASSERT_EQUALS(target[1], 8192);
+		TS_ASSERT_EQUALS(target[2], -8192);
+		TS_ASSERT_EQUALS(target[3], -1);
+		TS_ASSERT_EQUALS(target[4], 2);
+		TS_ASSERT_EQUALS(target[5], 32767);
+		TS_ASSERT_EQUALS(target[6], -32768);
+		TS_ASSERT_EQUALS(target[7], 1);
+
+		kernels.floatToBit16sGeneration1(target, source, 8, 1.0f);
+		TS_ASSERT_EQUALS(target[1], 16384);
+		TS_ASSERT_EQUALS(target[3], -2);
+		TS_ASSERT_EQUALS(target[4], 4);
+
+		kernels.floatToBit16sGeneration2(target, source, 8, 1.0f);
+		TS_ASSERT_EQUALS(target[1], 16384);
+		TS_ASSERT_EQUALS(target[3], -1);
+		TS_ASSERT_EQUALS(target[4], 4);
+	}
+
+	void test_mix_streams() {
+		const MT32Emu::SampleKernels &fast = MT32Emu::getSampleKernels();
+		const MT32Emu::SampleKernels &reference = MT32Emu::getScalarSampleKernels();
+
+		MT32Emu::Bit16s streams[6][kLength];
+		MT32Emu::Bit16s expected[kLength * 2];
+		MT32Emu::Bit16s result[kLength * 2];
+
+		for (int len = kLength - 16; len <= kLength; ++len) {
+			for (int i = 0; i < 6; ++i)
+				fillSamples(streams[i], kLength);
+			memset(expected, 0x55, sizeof(expected));
+			memset(result, 0x55, sizeof(result));
+
+			reference.mixStreams(expected, streams[0], streams[1], streams[2], streams[3], streams[4], streams[5], len);
+			fast.mixStreams(result, streams[0], streams[1], streams[2], streams[3], streams[4], streams[5], len);
+
+			TS_ASSERT_EQUALS(memcmp(expected, result, sizeof(result)), 0);
+		}
+
+		// Check the interleaving and clipping
+		for (int i = 0; i < 6; ++i)
+			memset(streams[i], 0, sizeof(streams[i]));
+		streams[0][3] = 30000;
+		streams[2][3] = 30000;
+		streams[1][9] = -30000;
+		streams[5][9] = -30000;
+		streams[4][10] = 123;
+		fast.mixStreams(result, streams[0], streams[1], streams[2], streams[3], streams[4], streams[5], 16);
+		TS_ASSERT_EQUALS(result[6], 32767);
+		TS_ASSERT_EQUALS(result[7], 0);
+		TS_ASSERT_EQUALS(result[18], 0);
+		TS_ASSERT_EQUALS(result[19], -32768);
+		TS_ASSERT_EQUALS(result[20], 123);
+		TS_ASSERT_EQUALS(result[21], 0);
+	}
+};
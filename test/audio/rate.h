@@ -0,0 +1,241 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/rate.h"
+#include "audio/rate_simd.h"
+#include "audio/mixer.h"
+
+#include "helper.h"
+#include "../helpers/test_random.h"
+
+class RateConverterTestSuite : public CxxTest::TestSuite
+{
+private:
+	static int16 nextSample(uint32 &seed) {
+		return (int16)(nextTestRandom(seed) >> 8);
+	}
+
+	static void fillSamples(int16 *buffer, int count, uint32 seed) {
+		// Make sure the extreme values are covered as well
+		static const int16 extremes[] = { -32768, 32767, -1, 0, 1, -32767 };
+		for (int i = 0; i < count; ++i)
+			buffer[i] = (i < ARRAYSIZE(extremes)) ? extremes[i] : nextSample(seed);
+	}
+
+	void compareKernels(bool stereo, bool reverseStereo) {
+		const Audio::RateMixKernels &fast = Audio::getRateMixKernels();
+		const Audio::RateMixKernels &reference = Audio::getScalarRateMixKernels();
+
+		// An odd frame count exercises the remainder handling as well
+		const int frames = 37;
+		int16 in[frames * 2];
+		int16 expected[frames * 2];
+		int16 result[frames * 2];
+
+		static const Audio::st_volume_t volumes[] = { 0, 1, 17, 127, 128, 200, 255, 256 };
+		for (int l = 0; l < ARRAYSIZE(volumes); ++l) {
+			for (int r = 0; r < ARRAYSIZE(volumes); ++r) {
+				fillSamples(in, frames * 2, l * 16 + r);
+				fillSamples(expected, frames * 2, l * 16 + r + 1000);
+				memcpy(result, expected, sizeof(result));
+
+				if (stereo) {
+					reference.mixStereo(expected, in, frames, volumes[l], volumes[r], reverseStereo);
+					fast.mixStereo(result, in, frames, volumes[l], volumes[r], reverseStereo);
+				} else {
+					reference.mixMono(expected, in, frames, volumes[l], volumes[r]);
+					fast.mixMono(result, in, frames, volumes[l], volumes[r]);
+				}
+
+				TS_ASSERT_EQUALS(memcmp(expected, result, sizeof(result)), 0);
+			}
+		}
+	}
+
+	static Audio::SeekableAudioStream *createConstantStream(int16 value, int rate, int frames, bool isStereo) {
+		const int samples = frames * (isStereo ? 2 : 1);
+		int16 *data = (int16 *)malloc(samples * sizeof(int16));
+		for (int i = 0; i < samples; ++i)
+			WRITE_LE_UINT16(&data[i], value);
+
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream((const byte *)data, samples * sizeof(int16), DisposeAfterUse::YES);
+		return Audio::makeRawStream(stream, rate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN | (isStereo ? Audio::FLAG_STEREO : 0));
+	}
+
+	static Audio::SeekableAudioStream *createImpulseStream(int16 value, int position, int rate, int frames) {
+		int16 *data = (int16 *)calloc(frames, sizeof(int16));
+		WRITE_LE_UINT16(&data[position], value);
+
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream((const byte *)data, frames * sizeof(int16), DisposeAfterUse::YES);
+		return Audio::makeRawStream(stream, rate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN);
+	}
+
+	void checkSincImpulse(int inRate, int outRate, int frames, int position, int taps, Audio::RateConverterQuality quality) {
+		// The output lags behind the input by taps / 2 input samples, so
+		// the impulse has to come out at that (output) position. Once the
+		// stream ended, another taps input samples are flushed out.
+		const int16 value = 16384;
+		Audio::SeekableAudioStream *s = createImpulseStream(value, position, inRate, frames);
+
+		const int outFrames = (frames + taps) * outRate / inRate;
+		int16 *result = new int16[(outFrames + 16) * 2];
+		memset(result, 0, sizeof(int16) * (outFrames + 16) * 2);
+
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, false, false, quality);
+		TS_ASSERT_EQUALS(converter->flow(*s, result, outFrames + 16, 256, 256), outFrames);
+		TS_ASSERT(!converter->hasPendingOutput());
+
+		int peak = 0;
+		int32 sum = 0;
+		for (int i = 0; i < outFrames; ++i) {
+			if (result[i * 2] > result[peak * 2])
+				peak = i;
+			sum += result[i * 2];
+		}
+		TS_ASSERT_EQUALS(peak, ((position + taps / 2) * outRate + inRate / 2) / inRate);
+
+		// Every filter phase has unity gain
+		TS_ASSERT_DELTA(sum, value * outRate / inRate, value / 64);
+
+		delete converter;
+		delete[] result;
+		delete s;
+	}
+
+	void checkSincConstant(int inRate, int outRate, bool isStereo, Audio::RateConverterQuality quality) {
+		// Every filter phase has unity gain, so a constant signal has to
+		// come out unchanged once the filter is filled.
+		const int16 value = -12345;
+		Audio::SeekableAudioStream *s = createConstantStream(value, inRate, inRate, isStereo);
+
+		const int frames = outRate / 2;
+		int16 *result = new int16[frames * 2];
+		memset(result, 0, sizeof(int16) * frames * 2);
+
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, isStereo, false, quality);
+		TS_ASSERT_EQUALS(converter->flow(*s, result, frames, 256, 256), frames);
+
+		for (int i = 256; i < frames * 2; ++i)
+			TS_ASSERT_DELTA(result[i], value, 1);
+
+		delete converter;
+		delete[] result;
+		delete s;
+	}
+
+public:
+	void test_mix_kernels_mono() {
+		compareKernels(false, false);
+	}
+
+	void test_mix_kernels_stereo() {
+		compareKernels(true, false);
+	}
+
+	void test_mix_kernels_reverse_stereo() {
+		compareKernels(true, true);
+	}
+
+	void test_copy_converter_reverse_stereo() {
+		const int frames = 1000;
+		int16 *sine;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(frames, 1, &sine, false, true);
+
+		int16 *result = new int16[frames * 2];
+		memset(result, 0, sizeof(int16) * frames * 2);
+
+		Audio::RateConverter *converter = Audio::makeRateConverter(frames, frames, true, true);
+		TS_ASSERT_EQUALS(converter->flow(*s, result, frames, 200, 100), frames);
+
+		for (int i = 0; i < frames; ++i) {
+			TS_ASSERT_EQUALS(result[i * 2 + 1], (sine[i * 2] * 200) / Audio::Mixer::kMaxMixerVolume);
+			TS_ASSERT_EQUALS(result[i * 2], (sine[i * 2 + 1] * 100) / Audio::Mixer::kMaxMixerVolume);
+		}
+
+		delete converter;
+		delete[] result;
+		delete[] sine;
+		delete s;
+	}
+
+	void test_simple_converter_mono() {
+		// Halving the rate just drops every other sample. The output size is
+		// larger than the converter's intermediate buffer.
+		const int inRate = 4000;
+		int16 *sine;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(inRate, 1, &sine, false, false);
+
+		const int frames = inRate / 2;
+		int16 *result = new int16[frames * 2];
+		memset(result, 0, sizeof(int16) * frames * 2);
+
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, inRate / 2, false);
+		TS_ASSERT_EQUALS(converter->flow(*s, result, frames, 256, 64), frames);
+
+		for (int i = 0; i < frames; ++i) {
+			TS_ASSERT_EQUALS(result[i * 2], sine[i * 2 + 1]);
+			TS_ASSERT_EQUALS(result[i * 2 + 1], (sine[i * 2 + 1] * 64) / Audio::Mixer::kMaxMixerVolume);
+		}
+
+		// The input is exhausted now
+		TS_ASSERT_EQUALS(converter->flow(*s, result, frames, 256, 256), 0);
+
+		delete converter;
+		delete[] result;
+		delete[] sine;
+		delete s;
+	}
+
+	void test_sinc_converter_upsample() {
+		checkSincConstant(22050, 44100, false, Audio::kRateConverterSincMedium);
+		checkSincConstant(11025, 48000, true, Audio::kRateConverterSincLow);
+	}
+
+	void test_sinc_converter_downsample() {
+		checkSincConstant(44100, 22050, true, Audio::kRateConverterSincHigh);
+		// The sinc converter is not limited to rates below 65536 Hz
+		checkSincConstant(96000, 44100, false, Audio::kRateConverterSincMedium);
+	}
+
+	void test_sinc_converter_output_length() {
+		// Converting one second of audio has to give one second of output,
+		// plus the filter length (8 taps) of flushed out samples
+		Audio::SeekableAudioStream *s = createConstantStream(1000, 22050, 22050, true);
+
+		int16 *result = new int16[44100 * 4];
+		Audio::RateConverter *converter = Audio::makeRateConverter(22050, 44100, true, false, Audio::kRateConverterSincLow);
+		TS_ASSERT_EQUALS(converter->flow(*s, result, 44100 * 2, 256, 256), 44100 + 16);
+
+		delete converter;
+		delete[] result;
+		delete s;
+	}
+
+	void test_sinc_converter_impulse() {
+		checkSincImpulse(22050, 44100, 200, 100, 16, Audio::kRateConverterSincMedium);
+		checkSincImpulse(11025, 44100, 200, 51, 8, Audio::kRateConverterSincLow);
+	}
+
+	void test_sinc_converter_tail() {
+		// An impulse in the very last input sample
+		checkSincImpulse(22050, 44100, 200, 199, 16, Audio::kRateConverterSincMedium);
+		checkSincImpulse(44100, 44100 / 3, 300, 299, 96, Audio::kRateConverterSincHigh);
+	}
+
+	void test_sinc_converter_tail_in_small_chunks() {
+		// The filter delay has to be flushed out by later flow() calls as
+		// well, if the output buffer ends before it
+		Audio::SeekableAudioStream *s = createConstantStream(1000, 22050, 64, false);
+		Audio::RateConverter *converter = Audio::makeRateConverter(22050, 44100, false, false, Audio::kRateConverterSincMedium);
+
+		int16 result[16 * 2];
+		int frames = 0;
+		for (int i = 0; i < 20; ++i) {
+			TS_ASSERT_EQUALS(s->endOfStream() && !converter->hasPendingOutput(), frames == 128 + 32);
+			frames += converter->flow(*s, result, 16, 256, 256);
+		}
+		TS_ASSERT_EQUALS(frames, 128 + 32);
+
+		delete converter;
+		delete s;
+	}
+};
@@ -0,0 +1,48 @@
+#ifndef TEST_BENCHMARK_H
+#define TEST_BENCHMARK_H
+
+// The benchmarks measure time and print their results, which needs a few
+// functions common/forbidden.h would otherwise block.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include <stdio.h>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+namespace Benchmark {
+
+/**
+ * Return the current wall clock time in microseconds.
+ */
+static inline double now() {
+#ifdef WIN32
+	LARGE_INTEGER frequency, counter;
+	QueryPerformanceFrequency(&frequency);
+	QueryPerformanceCounter(&counter);
+	return (double)counter.QuadPart * 1000000.0 / frequency.QuadPart;
+#else
+	struct timeval tv;
+	gettimeofday(&tv, 0);
+	return tv.tv_sec * 1000000.0 + tv.tv_usec;
+#endif
+}
+
+/**
+ * Print the result of a benchmark run.
+ *
+ * @param name       name of the benchmark
+ * @param usecs      total time the benchmark took, in microseconds
+ * @param iterations number of iterations the time was spent on
+ */
+static inline void report(const char *name, double usecs, unsigned int iterations) {
+	printf("\n  %-48s %12.3f us/iter (%u iterations)", name, usecs / iterations, iterations);
+	fflush(stdout);
+}
+
+} // End of namespace Benchmark
+
+#endif
@@ -0,0 +1,299 @@
+#include <cxxtest/TestSuite.h>
+
+#include "engines/advancedDetector.h"
+#include "engines/engine.h"
+
+#include "common/algorithm.h"
+
+#include "../helpers/test_random.h"
+
+// Only referenced by AdvancedMetaEngine::createInstance(), which the
+// benchmark never calls. Saves linking the engine core and the GUI.
+bool Engine::warnUserAboutUnsupportedGame() {
+	return false;
+}
+
+/**
+ * An engine with generated game descriptions. The file properties are
+ * derived from the file names, so detection runs without touching the
+ * file system. Files can be marked as modified, which changes their MD5
+ * sum or size.
+ */
+class SyntheticMetaEngine : public AdvancedMetaEngine {
+public:
+	enum {
+		kGames = 400,
+		kFileNames = 80,
+		kFilesPerGame = 3
+	};
+
+	enum Modification {
+		kModifiedMD5,
+		kModifiedSize
+	};
+
+	typedef AdvancedMetaEngine::FileMap FileMap;
+	typedef Common::HashMap<Common::String, Modification, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> ModificationMap;
+
+	SyntheticMetaEngine(const ADGameDescription *descs, const PlainGameDescriptor *gameids)
+		: AdvancedMetaEngine(descs, sizeof(ADGameDescription), gameids), _modifications(0) {
+	}
+
+	virtual const char *getName() const { return "Synthetic"; }
+	virtual const char *getOriginalCopyright() const { return ""; }
+
+	ADGameDescList detect(const FileMap &allFiles, const ModificationMap &modifications) {
+		_modifications = &modifications;
+		return detectGame(Common::FSNode(), allFiles, Common::UNK_LANG, Common::kPlatformUnknown, "");
+	}
+
+	/**
+	 * Detects the games the way detectGame() did before it had a file
+	 * index: get the properties of every file of every game description,
+	 * then compare them to every file of every game description. Only
+	 * covers what the synthetic games use.
+	 */
+	ADGameDescList detectReference(const FileMap &allFiles, const ModificationMap &modifications) {
+		_modifications = &modifications;
+
+		const ADGameDescription *g;
+		const ADGameFileDescription *fileDesc;
+
+		ADFilePropertiesMap filesProps;
+		for (g = (const ADGameDescription *)_gameDescriptors; g->gameid; ++g) {
+			for (fileDesc = g->filesDescriptions; fileDesc->fileName; ++fileDesc) {
+				ADFileProperties tmp;
+				if (!filesProps.contains(fileDesc->fileName) && getFileProperties(Common::FSNode(), allFiles, *g, fileDesc->fileName, tmp))
+					filesProps[fileDesc->fileName] = tmp;
+			}
+		}
+
+		ADGameDescList matched;
+		int maxFilesMatched = 0;
+
+		for (g = (const ADGameDescription *)_gameDescriptors; g->gameid; ++g) {
+			bool fileMissing = false;
+			int curFilesMatched = 0;
+
+			for (fileDesc = g->filesDescriptions; fileDesc->fileName; ++fileDesc) {
+				if (!filesProps.contains(fileDesc->fileName)) {
+					fileMissing = true;
+					break;
+				}
+
+				const ADFileProperties &props = filesProps[fileDesc->fileName];
+				if ((fileDesc->md5 != NULL && fileDesc->md5 != props.md5) || (fileDesc->fileSize != -1 && fileDesc->fileSize != props.size)) {
+					fileMissing = true;
+					break;
+				}
+
+				++curFilesMatched;
+			}
+
+			if (fileMissing)
+				continue;
+
+			if (curFilesMatched > maxFilesMatched) {
+				maxFilesMatched = curFilesMatched;
+				matched.clear();
+				matched.push_back(g);
+			} else if (curFilesMatched == maxFilesMatched) {
+				matched.push_back(g);
+			}
+		}
+
+		return matched;
+	}
+
+	static Common::String fileName(int engine, int file) {
+		return Common::String::format("e%02d_file%02d.dat", engine, file);
+	}
+
+	static int32 size(const Common::String &fileName) {
+		return fileName.size();
+	}
+
+	static Common::String md5(const Common::String &fileName) {
+		Common::String name(fileName);
+		name.toLowercase();
+		return "md5:" + name;
+	}
+
+protected:
+	virtual bool createInstance(OSystem *syst, Engine **engine, const ADGameDescription *desc) const {
+		return false;
+	}
+
+	virtual bool getFileProperties(const Common::FSNode &parent, const FileMap &allFiles, const ADGameDescription &game, const Common::String fname, ADFileProperties &fileProps) const {
+		if (!allFiles.contains(fname))
+			return false;
+
+		fileProps.size = size(fname);
+		fileProps.md5 = md5(fname);
+
+		ModificationMap::const_iterator modification = _modifications->find(fname);
+		if (modification != _modifications->end()) {
+			if (modification->_value == kModifiedMD5)
+				fileProps.md5 += "-modified";
+			else
+				fileProps.size++;
+		}
+
+		return true;
+	}
+
+private:
+	/** The modified files of the directory being detected */
+	const ModificationMap *_modifications;
+};
+
+class AdvancedDetectorBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kEngines = 50,
+		kDirs = 200,
+		kOtherFilesPerDir = 40
+	};
+
+	/** Seed for nextTestRandom() */
+	uint32 _seed;
+
+	/** Backing store of the strings referenced by the game descriptions */
+	Common::Array<char *> _strings;
+	const char *makeString(const Common::String &str) {
+		char *copy = new char[str.size() + 1];
+		memcpy(copy, str.c_str(), str.size() + 1);
+		_strings.push_back(copy);
+		return copy;
+	}
+
+	/** Does the game description match the unmodified files? */
+	Common::Array<bool> _validGames;
+
+	ADGameDescription *createGames(int engine) {
+		ADGameDescription *descs = new ADGameDescription[SyntheticMetaEngine::kGames + 1];
+		memset(descs, 0, sizeof(ADGameDescription) * (SyntheticMetaEngine::kGames + 1));
+
+		for (int i = 0; i < SyntheticMetaEngine::kGames; ++i) {
+			descs[i].gameid = "synthetic";
+			descs[i].extra = makeString(Common::String::format("%d", i));
+			descs[i].language = Common::EN_ANY;
+			descs[i].platform = Common::kPlatformPC;
+			descs[i].flags = ADGF_NO_FLAGS;
+			descs[i].guioptions = GUIO0();
+
+			// Some game descriptions never match, like the ones of versions
+			// which are not around
+			const bool valid = nextTestRandom(_seed, 10) != 0;
+			_validGames.push_back(valid);
+
+			for (int f = 0; f < SyntheticMetaEngine::kFilesPerGame; ++f) {
+				// Many games of an engine share their file names, and only
+				// differ in MD5 sums and sizes. Check the MD5 sum, the size,
+				// or both.
+				const Common::String name = SyntheticMetaEngine::fileName(engine, nextTestRandom(_seed, SyntheticMetaEngine::kFileNames));
+				const uint checks = nextTestRandom(_seed, 3);
+				descs[i].filesDescriptions[f].fileName = makeString(name);
+				descs[i].filesDescriptions[f].md5 = (checks == 1) ? NULL : makeString(SyntheticMetaEngine::md5(name) + (valid ? "" : "-old"));
+				descs[i].filesDescriptions[f].fileSize = (checks == 0) ? -1 : SyntheticMetaEngine::size(name) + (valid ? 0 : 1);
+			}
+		}
+
+		return descs;
+	}
+
+	static bool sameGames(const ADGameDescList &a, const ADGameDescList &b) {
+		if (a.size() != b.size())
+			return false;
+		for (uint i = 0; i < a.size(); ++i) {
+			if (a[i] != b[i])
+				return false;
+		}
+		return true;
+	}
+
+public:
+	void test_detect_games() {
+		_seed = 1;
+
+		static const PlainGameDescriptor gameids[] = {
+			{ "synthetic", "Synthetic game" },
+			{ 0, 0 }
+		};
+
+		ADGameDescription *descs[kEngines];
+		SyntheticMetaEngine *engines[kEngines];
+		for (int e = 0; e < kEngines; ++e) {
+			descs[e] = createGames(e);
+			engines[e] = new SyntheticMetaEngine(descs[e], gameids);
+		}
+
+		// Every fourth directory contains the files of a game, all of them
+		// contain unrelated files as well. Every other game directory also
+		// contains the files of another game of the same engine, one of which
+		// is modified.
+		Common::Array<SyntheticMetaEngine::FileMap> dirs;
+		Common::Array<SyntheticMetaEngine::ModificationMap> modifications;
+		dirs.resize(kDirs);
+		modifications.resize(kDirs);
+		for (int d = 0; d < kDirs; ++d) {
+			for (int f = 0; f < kOtherFilesPerDir; ++f)
+				dirs[d][Common::String::format("file%04d.bin", nextTestRandom(_seed, 10000))] = Common::FSNode();
+
+			if (d % 4 != 0)
+				continue;
+
+			// detectGame() reports games with all files present but without
+			// a match, which needs g_system. Always add a matching game.
+			const int engine = nextTestRandom(_seed, kEngines);
+			int game;
+			do {
+				game = nextTestRandom(_seed, SyntheticMetaEngine::kGames);
+			} while (!_validGames[engine * SyntheticMetaEngine::kGames + game]);
+
+			const ADGameFileDescription *fileDesc;
+			for (fileDesc = descs[engine][game].filesDescriptions; fileDesc->fileName; ++fileDesc)
+				dirs[d][fileDesc->fileName] = Common::FSNode();
+
+			if (d % 8 != 0)
+				continue;
+
+			const ADGameDescription &other = descs[engine][nextTestRandom(_seed, SyntheticMetaEngine::kGames)];
+			for (fileDesc = other.filesDescriptions; fileDesc->fileName; ++fileDesc) {
+				if (dirs[d].contains(fileDesc->fileName))
+					continue;
+
+				dirs[d][fileDesc->fileName] = Common::FSNode();
+				if (modifications[d].empty())
+					modifications[d][fileDesc->fileName] = nextTestRandom(_seed, 2) ? SyntheticMetaEngine::kModifiedMD5 : SyntheticMetaEngine::kModifiedSize;
+			}
+		}
+
+		uint detected = 0;
+		const double start = Benchmark::now();
+		for (int d = 0; d < kDirs; ++d) {
+			for (int e = 0; e < kEngines; ++e)
+				detected += engines[e]->detect(dirs[d], modifications[d]).size();
+		}
+		const double elapsed = Benchmark::now() - start;
+
+		Benchmark::report("detectGame, 50 engines x 400 games", elapsed, kDirs);
+		printf(" -> %u matches", detected);
+
+		for (int d = 0; d < kDirs; ++d) {
+			for (int e = 0; e < kEngines; ++e)
+				TS_ASSERT(sameGames(engines[e]->detect(dirs[d], modifications[d]), engines[e]->detectReference(dirs[d], modifications[d])));
+		}
+		TS_ASSERT(detected >= kDirs / 4);
+
+		for (int e = 0; e < kEngines; ++e) {
+			delete engines[e];
+			delete[] descs[e];
+		}
+		for (uint i = 0; i < _strings.size(); ++i)
+			delete[] _strings[i];
+		_strings.clear();
+		_validGames.clear();
+	}
+};
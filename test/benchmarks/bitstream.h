@@ -0,0 +1,331 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/bitstream.h"
+#include "common/huffman.h"
+#include "common/memstream.h"
+#include "common/substream.h"
+
+#include "video/binkdata.h"
+
+#include "../helpers/huffman_helper.h"
+
+/**
+ * Common::BitStreamImpl as it was before it had a cache: it reads one data
+ * value at a time through the ReadStream interface and assembles multi-bit
+ * values bit by bit.
+ */
+template<int valueBits, bool isLE, bool isMSB2LSB>
+class LegacyBitStream : public Common::BitStream {
+private:
+	Common::SeekableReadStream *_stream;
+
+	uint32 _value;
+	uint8  _inValue;
+
+	inline uint32 readData() {
+		if (valueBits == 8)
+			return _stream->readByte();
+		if (valueBits == 16)
+			return isLE ? _stream->readUint16LE() : _stream->readUint16BE();
+		return isLE ? _stream->readUint32LE() : _stream->readUint32BE();
+	}
+
+	inline void readValue() {
+		if ((size() - pos()) < valueBits)
+			error("LegacyBitStream::readValue(): End of bit stream reached");
+
+		_value = readData();
+		if (_stream->err() || _stream->eos())
+			error("LegacyBitStream::readValue(): Read error");
+
+		if (isMSB2LSB)
+			_value <<= 32 - valueBits;
+	}
+
+public:
+	LegacyBitStream(Common::SeekableReadStream &stream) : _stream(&stream), _value(0), _inValue(0) {
+	}
+
+	uint32 getBit() {
+		if (_inValue == 0)
+			readValue();
+
+		int b = 0;
+		if (isMSB2LSB)
+			b = ((_value & 0x80000000) == 0) ? 0 : 1;
+		else
+			b = ((_value & 1) == 0) ? 0 : 1;
+
+		if (isMSB2LSB)
+			_value <<= 1;
+		else
+			_value >>= 1;
+
+		_inValue = (_inValue + 1) % valueBits;
+
+		return b;
+	}
+
+	uint32 getBits(uint8 n) {
+		if (n == 0)
+			return 0;
+
+		uint32 v = 0;
+
+		if (isMSB2LSB) {
+			while (n-- > 0)
+				v = (v << 1) | getBit();
+		} else {
+			for (uint32 i = 0; i < n; i++)
+				v = (v >> 1) | (((uint32) getBit()) << 31);
+
+			v >>= (32 - n);
+		}
+
+		return v;
+	}
+
+	uint32 peekBit() {
+		return peekBits(1);
+	}
+
+	uint32 peekBits(uint8 n) {
+		if (_inValue != 0 && n <= valueBits - _inValue) {
+			if (n == 0)
+				return 0;
+
+			if (isMSB2LSB)
+				return _value >> (32 - n);
+			else
+				return _value & (0xFFFFFFFF >> (32 - n));
+		}
+
+		uint32 value   = _value;
+		uint8  inValue = _inValue;
+		uint32 curPos  = _stream->pos();
+
+		uint32 v = getBits(n);
+
+		_stream->seek(curPos);
+		_inValue = inValue;
+		_value   = value;
+
+		return v;
+	}
+
+	void addBit(uint32 &x, uint32 n) {
+		if (isMSB2LSB)
+			x = (x << 1) | getBit();
+		else
+			x = (x & ~(1 << n)) | (getBit() << n);
+	}
+
+	bool isMSBFirst() const {
+		return isMSB2LSB;
+	}
+
+	void rewind() {
+		_stream->seek(0);
+
+		_value   = 0;
+		_inValue = 0;
+	}
+
+	void skip(uint32 n) {
+		if (_inValue != 0 && n < (uint32)(valueBits - _inValue)) {
+			if (isMSB2LSB)
+				_value <<= n;
+			else
+				_value >>= n;
+
+			_inValue += n;
+			return;
+		}
+
+		while (n-- > 0)
+			getBit();
+	}
+
+	uint32 pos() const {
+		if (_stream->pos() == 0)
+			return 0;
+
+		uint32 p = (_inValue == 0) ? _stream->pos() : ((_stream->pos() - 1) & ~((uint32) ((valueBits >> 3) - 1)));
+		return p * 8 + _inValue;
+	}
+
+	uint32 size() const {
+		return (_stream->size() & ~((uint32) ((valueBits >> 3) - 1))) * 8;
+	}
+
+	bool eos() const {
+		return _stream->eos() || (pos() >= size());
+	}
+};
+
+class BitStreamBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kDataSize = 1024 * 1024
+	};
+
+	/** Seed for nextTestRandom() */
+	uint32 _seed;
+
+	byte *createRandomData() {
+		byte *data = new byte[kDataSize];
+		for (uint32 i = 0; i < kDataSize; i++)
+			data[i] = nextTestRandom(_seed, 256);
+		return data;
+	}
+
+	/** Read values of 1 to 16 bits, like a typical bit stream parser does. */
+	static uint32 readMixedBits(Common::BitStream &bits, uint32 count) {
+		uint32 sum = 0;
+		for (uint32 i = 0; i < count; i++)
+			sum += bits.getBits((i % 16) + 1);
+		return sum;
+	}
+
+	/** Peek at 9 bits and skip some of them, like a table decoder does. */
+	static uint32 peekAndSkip(Common::BitStream &bits, uint32 count) {
+		uint32 sum = 0;
+		for (uint32 i = 0; i < count; i++) {
+			const uint32 v = bits.peekBits(9);
+			sum += v;
+			bits.skip((v & 7) + 1);
+		}
+		return sum;
+	}
+
+public:
+	void test_get_bits() {
+		_seed = 1;
+		byte *data = createRandomData();
+
+		// The average value is 8.5 bits wide
+		const uint32 count = kDataSize * 8 / 9;
+
+		Common::MemoryReadStream legacyStream(data, kDataSize);
+		LegacyBitStream<32, true, false> legacyBits(legacyStream);
+		double start = Benchmark::now();
+		const uint32 reference = readMixedBits(legacyBits, count);
+		Benchmark::report("getBits(1..16), old implementation", Benchmark::now() - start, count);
+
+		Common::MemoryReadStream stream(data, kDataSize);
+		Common::BitStream32LELSB bits(stream);
+		start = Benchmark::now();
+		TS_ASSERT_EQUALS(readMixedBits(bits, count), reference);
+		Benchmark::report("getBits(1..16), memory", Benchmark::now() - start, count);
+		TS_ASSERT_EQUALS(bits.pos(), legacyBits.pos());
+
+		// A SeekableSubReadStream takes the path for streams not in memory
+		Common::MemoryReadStream parentStream(data, kDataSize);
+		Common::SeekableSubReadStream subStream(&parentStream, 0, kDataSize);
+		Common::BitStream32LELSB streamBits(subStream);
+		start = Benchmark::now();
+		TS_ASSERT_EQUALS(readMixedBits(streamBits, count), reference);
+		Benchmark::report("getBits(1..16), SeekableReadStream", Benchmark::now() - start, count);
+
+		// Without going through the vtable
+		Common::MemoryReadStream directStream(data, kDataSize);
+		Common::BitStream32LELSB directBits(directStream);
+		uint32 sum = 0;
+		start = Benchmark::now();
+		for (uint32 i = 0; i < count; i++)
+			sum += directBits.getBits((i % 16) + 1);
+		Benchmark::report("getBits(1..16), memory, non-virtual", Benchmark::now() - start, count);
+		TS_ASSERT_EQUALS(sum, reference);
+
+		delete[] data;
+	}
+
+	void test_get_bit() {
+		_seed = 2;
+		byte *data = createRandomData();
+
+		const uint32 count = kDataSize * 8;
+
+		Common::MemoryReadStream legacyStream(data, kDataSize);
+		LegacyBitStream<8, false, true> legacyBits(legacyStream);
+		uint32 reference = 0;
+		double start = Benchmark::now();
+		for (uint32 i = 0; i < count; i++)
+			reference += legacyBits.getBit() << (i & 7);
+		Benchmark::report("getBit(), 8 bit MSB, old implementation", Benchmark::now() - start, count);
+
+		Common::MemoryReadStream stream(data, kDataSize);
+		Common::BitStream8MSB bits(stream);
+		Common::BitStream &bitsRef = bits;
+		uint32 sum = 0;
+		start = Benchmark::now();
+		for (uint32 i = 0; i < count; i++)
+			sum += bitsRef.getBit() << (i & 7);
+		Benchmark::report("getBit(), 8 bit MSB, memory", Benchmark::now() - start, count);
+
+		TS_ASSERT_EQUALS(sum, reference);
+		TS_ASSERT(bits.eos());
+
+		delete[] data;
+	}
+
+	void test_peek_and_skip() {
+		_seed = 3;
+		byte *data = createRandomData();
+
+		// Every step skips 4.5 bits on average
+		const uint32 count = kDataSize * 8 / 5;
+
+		Common::MemoryReadStream legacyStream(data, kDataSize);
+		LegacyBitStream<32, false, true> legacyBits(legacyStream);
+		double start = Benchmark::now();
+		const uint32 reference = peekAndSkip(legacyBits, count);
+		Benchmark::report("peekBits(9) + skip(), old implementation", Benchmark::now() - start, count);
+
+		Common::MemoryReadStream stream(data, kDataSize);
+		Common::BitStream32BEMSB bits(stream);
+		start = Benchmark::now();
+		TS_ASSERT_EQUALS(peekAndSkip(bits, count), reference);
+		Benchmark::report("peekBits(9) + skip(), memory", Benchmark::now() - start, count);
+		TS_ASSERT_EQUALS(bits.pos(), legacyBits.pos());
+
+		delete[] data;
+	}
+
+	void test_bink_symbols() {
+		// Decode the Bink code books from random data with Common::Huffman,
+		// on top of both bit stream implementations
+		_seed = 4;
+		byte *data = createRandomData();
+
+		Common::Huffman *huffman[16];
+		for (int i = 0; i < 16; i++)
+			huffman[i] = new Common::Huffman(Video::binkHuffmanLengths[i][15], 16, Video::binkHuffmanCodes[i], Video::binkHuffmanLengths[i]);
+
+		const uint32 count = kDataSize * 8 / 7;
+
+		Common::MemoryReadStream legacyStream(data, kDataSize);
+		LegacyBitStream<32, true, false> legacyBits(legacyStream);
+		uint32 reference = 0;
+		double start = Benchmark::now();
+		for (uint32 i = 0; i < count; i++)
+			reference += huffman[(i / 64) & 15]->getSymbol(legacyBits);
+		Benchmark::report("Bink symbols, old implementation", Benchmark::now() - start, count);
+
+		Common::MemoryReadStream stream(data, kDataSize);
+		Common::BitStream32LELSB bits(stream);
+		uint32 sum = 0;
+		start = Benchmark::now();
+		for (uint32 i = 0; i < count; i++)
+			sum += huffman[(i / 64) & 15]->getSymbol(bits);
+		Benchmark::report("Bink symbols, memory", Benchmark::now() - start, count);
+
+		TS_ASSERT_EQUALS(sum, reference);
+		TS_ASSERT_EQUALS(bits.pos(), legacyBits.pos());
+
+		for (int i = 0; i < 16; i++)
+			delete huffman[i];
+		delete[] data;
+	}
+};
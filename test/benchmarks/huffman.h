@@ -0,0 +1,123 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/bitstream.h"
+#include "common/huffman.h"
+#include "common/memstream.h"
+
+#include "video/binkdata.h"
+
+#include "../helpers/huffman_helper.h"
+
+class HuffmanBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kDataSize = 1024 * 1024
+	};
+
+	/**
+	 * Decodes a symbol the way Common::Huffman did before it had lookup
+	 * tables, one bit at a time and scanning all codes of each length.
+	 */
+	static uint32 getSymbolReference(Common::BitStream &bits, uint32 count, const uint32 *codes, const uint8 *lengths) {
+		uint32 code = 0;
+		for (uint32 length = 1; length <= 32; length++) {
+			bits.addBit(code, length - 1);
+
+			for (uint32 i = 0; i < count; i++) {
+				if (lengths[i] == length && codes[i] == code)
+					return i;
+			}
+		}
+
+		return 0xFFFFFFFF;
+	}
+
+	/** Seed for nextTestRandom() */
+	uint32 _seed;
+
+	byte *createRandomData() {
+		byte *data = new byte[kDataSize];
+		for (uint32 i = 0; i < kDataSize; i++)
+			data[i] = nextTestRandom(_seed, 256);
+		return data;
+	}
+
+public:
+	void test_bink_symbols() {
+		// The Bink code books are complete, so random data is a valid stream
+		// of their codes. Decode it like the video decoder does, switching
+		// between the code books.
+		_seed = 1;
+		byte *data = createRandomData();
+
+		Common::Huffman *huffman[16];
+		for (int i = 0; i < 16; i++)
+			huffman[i] = new Common::Huffman(Video::binkHuffmanLengths[i][15], 16, Video::binkHuffmanCodes[i], Video::binkHuffmanLengths[i]);
+
+		const uint32 symbolCount = kDataSize * 8 / 7;
+		Common::Array<uint32> reference, decoded;
+		reference.reserve(symbolCount);
+		decoded.reserve(symbolCount);
+
+		Common::MemoryReadStream referenceStream(data, kDataSize);
+		Common::BitStream32LELSB referenceBits(referenceStream);
+		double start = Benchmark::now();
+		for (uint32 i = 0; i < symbolCount; i++) {
+			const int book = (i / 64) & 15;
+			reference.push_back(getSymbolReference(referenceBits, 16, Video::binkHuffmanCodes[book], Video::binkHuffmanLengths[book]));
+		}
+		Benchmark::report("Bink symbols, bit by bit", Benchmark::now() - start, symbolCount);
+
+		Common::MemoryReadStream stream(data, kDataSize);
+		Common::BitStream32LELSB bits(stream);
+		start = Benchmark::now();
+		for (uint32 i = 0; i < symbolCount; i++)
+			decoded.push_back(huffman[(i / 64) & 15]->getSymbol(bits));
+		Benchmark::report("Bink symbols, Common::Huffman", Benchmark::now() - start, symbolCount);
+
+		TS_ASSERT_EQUALS(bits.pos(), referenceBits.pos());
+		TS_ASSERT(decoded == reference);
+
+		for (int i = 0; i < 16; i++)
+			delete huffman[i];
+		delete[] data;
+	}
+
+	void test_long_codes() {
+		// A code book like the SVQ1 mean values, with codes of up to 16 bits
+		_seed = 2;
+
+		Common::Array<uint8> lengths;
+		Common::Array<uint32> codes;
+		makeHuffmanLengths(256, 16, _seed, lengths);
+		makeHuffmanCodes(lengths, true, codes);
+
+		byte *data = createRandomData();
+		Common::Huffman huffman(0, codes.size(), &codes[0], &lengths[0]);
+
+		const uint32 symbolCount = kDataSize * 8 / 16;
+		Common::Array<uint32> reference, decoded;
+		reference.reserve(symbolCount);
+		decoded.reserve(symbolCount);
+
+		Common::MemoryReadStream referenceStream(data, kDataSize);
+		Common::BitStream32BEMSB referenceBits(referenceStream);
+		double start = Benchmark::now();
+		for (uint32 i = 0; i < symbolCount; i++)
+			reference.push_back(getSymbolReference(referenceBits, codes.size(), &codes[0], &lengths[0]));
+		Benchmark::report("16 bit codes, bit by bit", Benchmark::now() - start, symbolCount);
+
+		Common::MemoryReadStream stream(data, kDataSize);
+		Common::BitStream32BEMSB bits(stream);
+		start = Benchmark::now();
+		for (uint32 i = 0; i < symbolCount; i++)
+			decoded.push_back(huffman.getSymbol(bits));
+		Benchmark::report("16 bit codes, Common::Huffman", Benchmark::now() - start, symbolCount);
+
+		TS_ASSERT_EQUALS(bits.pos(), referenceBits.pos());
+		TS_ASSERT(decoded == reference);
+
+		delete[] data;
+	}
+};
@@ -0,0 +1,217 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer_intern.h"
+#include "audio/audiostream.h"
+
+#include "common/system.h"
+
+#include "../audio/helper.h"
+
+#ifdef POSIX
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Just enough of an OSystem for MixerImpl: mutexes and the clock.
+ */
+class MixerBenchmarkSystem : public OSystem {
+public:
+	virtual const GraphicsMode *getSupportedGraphicsModes() const { return 0; }
+	virtual int getDefaultGraphicsMode() const { return 0; }
+	virtual bool setGraphicsMode(int mode) { return false; }
+	virtual int getGraphicsMode() const { return 0; }
+	virtual Graphics::PixelFormat getScreenFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	virtual Common::List<Graphics::PixelFormat> getSupportedFormats() const { return Common::List<Graphics::PixelFormat>(); }
+	virtual void initSize(uint width, uint height, const Graphics::PixelFormat *format = NULL) {}
+	virtual int16 getHeight() { return 0; }
+	virtual int16 getWidth() { return 0; }
+	virtual PaletteManager *getPaletteManager() { return 0; }
+	virtual void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {}
+	virtual Graphics::Surface *lockScreen() { return 0; }
+	virtual void unlockScreen() {}
+	virtual void fillScreen(uint32 col) {}
+	virtual void updateScreen() {}
+	virtual void setShakePos(int shakeOffset) {}
+	virtual void showOverlay() {}
+	virtual void hideOverlay() {}
+	virtual Graphics::PixelFormat getOverlayFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	virtual void clearOverlay() {}
+	virtual void grabOverlay(void *buf, int pitch) {}
+	virtual void copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) {}
+	virtual int16 getOverlayHeight() { return 0; }
+	virtual int16 getOverlayWidth() { return 0; }
+	virtual bool showMouse(bool visible) { return false; }
+	virtual void warpMouse(int x, int y) {}
+	virtual void setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale = false, const Graphics::PixelFormat *format = NULL) {}
+	virtual uint32 getMillis() { return (uint32)(Benchmark::now() / 1000.0); }
+	virtual void getTimeAndDate(TimeDate &t) const { memset(&t, 0, sizeof(t)); }
+	virtual Audio::Mixer *getMixer() { return 0; }
+	virtual void quit() {}
+	virtual void displayMessageOnOSD(const char *msg) {}
+	virtual void logMessage(LogMessageType::Type type, const char *message) { fputs(message, stdout); }
+
+#ifdef POSIX
+	virtual void delayMillis(uint msecs) { usleep(msecs * 1000); }
+
+	virtual MutexRef createMutex() {
+		pthread_mutexattr_t attr;
+		pthread_mutexattr_init(&attr);
+		pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+		pthread_mutex_t *mutex = new pthread_mutex_t;
+		pthread_mutex_init(mutex, &attr);
+		pthread_mutexattr_destroy(&attr);
+		return (MutexRef)mutex;
+	}
+
+	virtual void lockMutex(MutexRef mutex) { pthread_mutex_lock((pthread_mutex_t *)mutex); }
+	virtual void unlockMutex(MutexRef mutex) { pthread_mutex_unlock((pthread_mutex_t *)mutex); }
+
+	virtual void deleteMutex(MutexRef mutex) {
+		pthread_mutex_destroy((pthread_mutex_t *)mutex);
+		delete (pthread_mutex_t *)mutex;
+	}
+#else
+	virtual void delayMillis(uint msecs) {}
+	virtual MutexRef createMutex() { return 0; }
+	virtual void lockMutex(MutexRef mutex) {}
+	virtual void unlockMutex(MutexRef mutex) {}
+	virtual void deleteMutex(MutexRef mutex) {}
+#endif
+};
+
+class MixerBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kOutputRate = 44100,
+		kChunkFrames = 1024,
+		kStops = 500,
+		// Time the audio thread waits for the device after each pass
+		kPeriodUsecs = 2000,
+		kBackgroundSounds = 8,
+		// Busy threads per core, so the mixer threads get preempted
+		kLoadPerCore = 2,
+		kMaxLoadThreads = 64
+	};
+
+	Audio::MixerImpl *_mixer;
+	volatile bool _controlDone;
+
+	uint _callbacks;
+	double _callbackTotal;
+	double _callbackWorst;
+
+#ifdef POSIX
+	/**
+	 * The audio thread, which mixes chunks until the control side is done
+	 * and measures how long each mixCallback() call takes.
+	 */
+	static void *audioThread(void *arg) {
+		MixerBenchmarkSuite *suite = (MixerBenchmarkSuite *)arg;
+		byte *buffer = new byte[kChunkFrames * 4];
+
+		while (!suite->_controlDone) {
+			const double start = Benchmark::now();
+			suite->_mixer->mixCallback(buffer, kChunkFrames * 4);
+			const double elapsed = Benchmark::now() - start;
+
+			suite->_callbacks++;
+			suite->_callbackTotal += elapsed;
+			if (elapsed > suite->_callbackWorst)
+				suite->_callbackWorst = elapsed;
+			usleep(kPeriodUsecs);
+		}
+
+		delete[] buffer;
+		return 0;
+	}
+
+	static void *loadThread(void *arg) {
+		MixerBenchmarkSuite *suite = (MixerBenchmarkSuite *)arg;
+		volatile uint32 value = 0;
+		while (!suite->_controlDone)
+			value = value * 1103515245 + 12345;
+		return 0;
+	}
+#endif
+
+	/**
+	 * Mix chunks on an audio thread, while the calling thread starts,
+	 * changes and stops a sound kStops times. Some busy threads keep all
+	 * cores loaded meanwhile.
+	 */
+	void benchmarkMixer(const char *name, bool lockFree) {
+#ifdef POSIX
+		MixerBenchmarkSystem system;
+		OSystem *oldSystem = g_system;
+		g_system = &system;
+
+		_mixer = new Audio::MixerImpl(&system, kOutputRate, lockFree);
+		_mixer->setReady(true);
+		_mixer->setRateConverterQuality(Audio::kRateConverterSincMedium);
+		// MixerImpl hides the short forms of playStream()
+		Audio::Mixer *mixer = _mixer;
+
+		for (int i = 0; i < kBackgroundSounds; ++i) {
+			Audio::AudioStream *stream = Audio::makeLoopingAudioStream(createSineStream<int16>(22050, 1, 0, false, true), 0);
+			mixer->playStream(Audio::Mixer::kPlainSoundType, 0, stream);
+		}
+
+		_controlDone = false;
+		_callbacks = 0;
+		_callbackTotal = 0;
+		_callbackWorst = 0;
+
+		pthread_t load[kMaxLoadThreads];
+		const int loadThreads = MIN<int>(sysconf(_SC_NPROCESSORS_ONLN) * kLoadPerCore, kMaxLoadThreads);
+		for (int i = 0; i < loadThreads; ++i)
+			pthread_create(&load[i], 0, loadThread, this);
+
+		pthread_t thread;
+		pthread_create(&thread, 0, audioThread, this);
+
+		double stopTotal = 0;
+		double stopWorst = 0;
+		for (int i = 0; i < kStops; ++i) {
+			Audio::SoundHandle handle;
+			mixer->playStream(Audio::Mixer::kSFXSoundType, &handle, createSineStream<int16>(22050, 1, 0, false, false));
+			for (int volume = 0; volume < 256; volume += 32)
+				_mixer->setChannelVolume(handle, volume);
+
+			const double start = Benchmark::now();
+			_mixer->stopHandle(handle);
+			const double elapsed = Benchmark::now() - start;
+
+			stopTotal += elapsed;
+			if (elapsed > stopWorst)
+				stopWorst = elapsed;
+			usleep(500);
+		}
+
+		_controlDone = true;
+		pthread_join(thread, 0);
+		for (int i = 0; i < loadThreads; ++i)
+			pthread_join(load[i], 0);
+		delete _mixer;
+		g_system = oldSystem;
+
+		Common::String label = Common::String::format("%s callback", name);
+		Benchmark::report(label.c_str(), _callbackTotal, _callbacks);
+		printf(" -> worst %.1f us", _callbackWorst);
+
+		label = Common::String::format("%s stopHandle", name);
+		Benchmark::report(label.c_str(), stopTotal, kStops);
+		printf(" -> worst %.1f us", stopWorst);
+#endif
+	}
+
+public:
+	void test_mutex() {
+		benchmarkMixer("mutex", false);
+	}
+
+	void test_lock_free() {
+		benchmarkMixer("lock-free", true);
+	}
+};
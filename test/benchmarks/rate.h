@@ -0,0 +1,87 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/rate.h"
+#include "audio/rate_simd.h"
+#include "audio/audiostream.h"
+
+#include "common/memstream.h"
+
+#include "../audio/helper.h"
+
+class RateConverterBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kChannels = 32,
+		kOutputRate = 44100,
+		kChunkFrames = 1024
+	};
+
+	void benchmarkConverter(const char *name, int inRate, bool isStereo, Audio::RateConverterQuality quality) {
+		// Convert one second of audio for each channel, in chunks like
+		// the mixer would use.
+		Audio::SeekableAudioStream *streams[kChannels];
+		Audio::RateConverter *converters[kChannels];
+		for (int i = 0; i < kChannels; ++i) {
+			streams[i] = createSineStream<int16>(inRate, 1, 0, false, isStereo);
+			converters[i] = Audio::makeRateConverter(inRate, kOutputRate, isStereo, false, quality);
+		}
+
+		int16 *buffer = new int16[kChunkFrames * 2];
+		memset(buffer, 0, kChunkFrames * 2 * sizeof(int16));
+
+		const double start = Benchmark::now();
+		for (int frames = 0; frames < kOutputRate; frames += kChunkFrames) {
+			for (int i = 0; i < kChannels; ++i)
+				converters[i]->flow(*streams[i], buffer, kChunkFrames, 128, 128);
+		}
+		const double elapsed = Benchmark::now() - start;
+
+		// One iteration is one second of audio for a single channel
+		Benchmark::report(name, elapsed, kChannels);
+		printf(" -> %d channels use %.1f%% of a core", kChannels, elapsed / 10000.0);
+
+		for (int i = 0; i < kChannels; ++i) {
+			delete converters[i];
+			delete streams[i];
+		}
+		delete[] buffer;
+	}
+
+public:
+	void test_mix_kernels() {
+		printf("\n  Mixing kernels: %s", Audio::getRateMixKernels().name);
+	}
+
+	void test_linear_mono() {
+		benchmarkConverter("linear 22050 Hz mono", 22050, false, Audio::kRateConverterLinear);
+	}
+
+	void test_linear_stereo() {
+		benchmarkConverter("linear 22050 Hz stereo", 22050, true, Audio::kRateConverterLinear);
+	}
+
+	void test_sinc_low_mono() {
+		benchmarkConverter("sinc low 22050 Hz mono", 22050, false, Audio::kRateConverterSincLow);
+	}
+
+	void test_sinc_medium_mono() {
+		benchmarkConverter("sinc medium 22050 Hz mono", 22050, false, Audio::kRateConverterSincMedium);
+	}
+
+	void test_sinc_high_mono() {
+		benchmarkConverter("sinc high 22050 Hz mono", 22050, false, Audio::kRateConverterSincHigh);
+	}
+
+	void test_sinc_medium_stereo() {
+		benchmarkConverter("sinc medium 22050 Hz stereo", 22050, true, Audio::kRateConverterSincMedium);
+	}
+
+	void test_sinc_high_stereo() {
+		benchmarkConverter("sinc high 22050 Hz stereo", 22050, true, Audio::kRateConverterSincHigh);
+	}
+
+	void test_sinc_high_downsample() {
+		benchmarkConverter("sinc high 96000 Hz stereo", 96000, true, Audio::kRateConverterSincHigh);
+	}
+};
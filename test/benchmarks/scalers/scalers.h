@@ -0,0 +1,156 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/scaler.h"
+#include "graphics/scaler/scale2x.h"
+#include "graphics/scaler/scale3x.h"
+#include "graphics/scaler/hqx_patterns.h"
+
+#include "common/array.h"
+
+#include "../../helpers/test_random.h"
+
+#ifdef USE_HQ_SCALERS
+extern "C" uint32 *RGBtoYUV;
+#endif
+
+class ScalersBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kWidth = 320,
+		kHeight = 200,
+		// The scalers read one pixel around the rect, keep some more
+		kBorder = 2,
+		kPitch = kWidth + 2 * kBorder,
+		kIterations = 64
+	};
+
+	Common::Array<uint16> _src;
+	Common::Array<uint16> _dst;
+
+	/**
+	 * Fill the source with blocks of a few colors, some similar ones, and
+	 * some noise, so all paths of the scalers are taken.
+	 */
+	void fillSource() {
+		uint32 seed = 1;
+		const uint16 colors[5] = { 0x0000, 0xF800, 0xF820, 0x07E0, 0xFFFF };
+		_src.resize(kPitch * (kHeight + 2 * kBorder));
+		for (int y = 0; y < kHeight + 2 * kBorder; ++y) {
+			for (int x = 0; x < kPitch; ++x) {
+				uint16 color = colors[((x / 7) ^ (y / 5)) % 5];
+				if ((nextTestRandom(seed) & 15) == 0)
+					color = nextTestRandom(seed) & 0xFFFF;
+				_src[y * kPitch + x] = color;
+			}
+		}
+	}
+
+	const uint16 *srcPixels() const {
+		return &_src[kBorder * kPitch + kBorder];
+	}
+
+	void benchmarkScaler(const char *name, ScalerProc *scalerProc, int scale) {
+		_dst.resize(kWidth * scale * kHeight * scale);
+
+		const double start = Benchmark::now();
+		for (int i = 0; i < kIterations; ++i)
+			scalerProc((const uint8 *)srcPixels(), kPitch * 2, (uint8 *)&_dst[0], kWidth * scale * 2, kWidth, kHeight);
+		Benchmark::report(name, Benchmark::now() - start, kIterations);
+	}
+
+	/**
+	 * Time a scaler against its C implementation. The output is checked by
+	 * the scalers test suite.
+	 */
+	void compareScaler(const char *name, ScalerProc *scalerProc, int scale, double referenceTime) {
+		const double start = Benchmark::now();
+		for (int i = 0; i < kIterations; ++i)
+			scalerProc((const uint8 *)srcPixels(), kPitch * 2, (uint8 *)&_dst[0], kWidth * scale * 2, kWidth, kHeight);
+		const double time = Benchmark::now() - start;
+
+		Benchmark::report(name, time, kIterations);
+		printf(" -> %.2fx", referenceTime / time);
+	}
+
+public:
+	void setUp() {
+		fillSource();
+	}
+
+	void test_scale2x() {
+		const int dstPitch = kWidth * 2;
+		_dst.resize(dstPitch * kHeight * 2);
+
+		const double start = Benchmark::now();
+		for (int i = 0; i < kIterations; ++i) {
+			for (int y = 0; y < kHeight; ++y) {
+				const uint16 *src = srcPixels() + y * kPitch;
+				uint16 *dst = &_dst[y * 2 * dstPitch];
+				scale2x_16_def(dst, dst + dstPitch, src - kPitch, src, src + kPitch, kWidth);
+			}
+		}
+		const double referenceTime = Benchmark::now() - start;
+		Benchmark::report("AdvMame2x C", referenceTime, kIterations);
+
+		compareScaler("AdvMame2x", AdvMame2x, 2, referenceTime);
+	}
+
+	void test_scale3x() {
+		const int dstPitch = kWidth * 3;
+		_dst.resize(dstPitch * kHeight * 3);
+
+		const double start = Benchmark::now();
+		for (int i = 0; i < kIterations; ++i) {
+			for (int y = 0; y < kHeight; ++y) {
+				const uint16 *src = srcPixels() + y * kPitch;
+				uint16 *dst = &_dst[y * 3 * dstPitch];
+				scale3x_16_def(dst, dst + dstPitch, dst + 2 * dstPitch, src - kPitch, src, src + kPitch, kWidth);
+			}
+		}
+		const double referenceTime = Benchmark::now() - start;
+		Benchmark::report("AdvMame3x C", referenceTime, kIterations);
+
+		compareScaler("AdvMame3x", AdvMame3x, 3, referenceTime);
+	}
+
+	void test_hqx_patterns() {
+#ifdef USE_HQ_SCALERS
+		const int formats[2] = { 555, 565 };
+		for (int f = 0; f < 2; ++f) {
+			InitScalers(formats[f]);
+
+			uint8 reference[kWidth], patterns[kWidth];
+
+			double start = Benchmark::now();
+			for (int i = 0; i < kIterations; ++i) {
+				for (int y = 0; y < kHeight; ++y)
+					hqx_patterns_def(srcPixels() + y * kPitch, kPitch, RGBtoYUV, kWidth, reference);
+			}
+			const double referenceTime = Benchmark::now() - start;
+
+			start = Benchmark::now();
+			for (int i = 0; i < kIterations; ++i) {
+				for (int y = 0; y < kHeight; ++y)
+					hqx_patterns(srcPixels() + y * kPitch, kPitch, RGBtoYUV, kWidth, patterns);
+			}
+			const double time = Benchmark::now() - start;
+
+			Benchmark::report(formats[f] == 555 ? "HQx patterns 555 C" : "HQx patterns 565 C", referenceTime, kIterations);
+			Benchmark::report(formats[f] == 555 ? "HQx patterns 555" : "HQx patterns 565", time, kIterations);
+			printf(" -> %.2fx", referenceTime / time);
+
+			DestroyScalers();
+		}
+#endif
+	}
+
+	void test_hqx() {
+#ifdef USE_HQ_SCALERS
+		InitScalers(565);
+		benchmarkScaler("HQ2x", HQ2x, 2);
+		benchmarkScaler("HQ3x", HQ3x, 3);
+		DestroyScalers();
+#endif
+	}
+};
@@ -0,0 +1,162 @@
+#include <cxxtest/TestSuite.h>
+
+#include "backends/graphics/surfacesdl/surfacesdl-scalerjobs.h"
+#include "graphics/scaler.h"
+
+#include "common/str.h"
+
+#include "../../helpers/test_random.h"
+
+class ScalerJobsBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kIterations = 64,
+		// The border around the source pixels the scalers may access, like
+		// the temporary screen of SurfaceSdlGraphicsManager
+		kBorder = 2
+	};
+
+	/**
+	 * Fill the source with blocks of a few colors, with some noise, so the
+	 * HQ scalers see both flat areas and edges.
+	 */
+	static void fillSource(Common::Array<uint16> &src, int pitch, int height) {
+		uint32 seed = 1;
+		const uint16 colors[4] = { 0x0000, 0xF800, 0x07E0, 0xFFFF };
+		for (int y = 0; y < height; ++y) {
+			for (int x = 0; x < pitch; ++x) {
+				uint16 color = colors[((x / 8) ^ (y / 6)) & 3];
+				if ((nextTestRandom(seed) & 15) == 0)
+					color = nextTestRandom(seed) & 0xFFFF;
+				src[y * pitch + x] = color;
+			}
+		}
+	}
+
+	void benchmarkScaler(const char *name, ScalerProc *scalerProc, int scale, int width, int height) {
+		InitScalers(565);
+
+		const int srcPitch = width + 2 * kBorder;
+		Common::Array<uint16> src;
+		src.resize(srcPitch * (height + 2 * kBorder));
+		fillSource(src, srcPitch, height + 2 * kBorder);
+		const uint8 *srcPixels = (const uint8 *)&src[kBorder * srcPitch + kBorder];
+
+		const int dstPitch = width * scale;
+		Common::Array<uint16> reference;
+		reference.resize(dstPitch * height * scale);
+		Common::Array<uint16> dst;
+		dst.resize(dstPitch * height * scale);
+
+		// The serial path, a single scaler call for the whole screen
+		double start = Benchmark::now();
+		for (int i = 0; i < kIterations; ++i)
+			scalerProc(srcPixels, srcPitch * 2, (uint8 *)&reference[0], dstPitch * 2, width, height);
+		const double serialTime = Benchmark::now() - start;
+
+		Common::String label = Common::String::format("%s %dx%d serial", name, width, height);
+		Benchmark::report(label.c_str(), serialTime, kIterations);
+
+		const int maxThreads = ScalerJobQueue::getDefaultThreadCount();
+		for (int threads = 1; threads <= maxThreads; threads *= 2) {
+			ScalerJobQueue queue(threads);
+			memset(&dst[0], 0, dst.size() * 2);
+
+			start = Benchmark::now();
+			for (int i = 0; i < kIterations; ++i) {
+				queue.addJob(srcPixels, srcPitch * 2, (uint8 *)&dst[0], dstPitch * 2, width, height, scale);
+				queue.run(scalerProc);
+			}
+			const double time = Benchmark::now() - start;
+
+			TS_ASSERT(!memcmp(&reference[0], &dst[0], dst.size() * 2));
+
+			label = Common::String::format("%s %dx%d %d thread(s)", name, width, height, queue.getThreadCount());
+			Benchmark::report(label.c_str(), time, kIterations);
+			printf(" -> %.2fx", serialTime / time);
+
+			if (threads < maxThreads && threads * 2 > maxThreads)
+				threads = maxThreads / 2;
+		}
+
+		DestroyScalers();
+	}
+
+public:
+	void test_cores() {
+		printf("\n  CPU cores used: %d", ScalerJobQueue::getDefaultThreadCount());
+	}
+
+	void test_hq2x() {
+		benchmarkScaler("HQ2x", HQ2x, 2, 320, 200);
+		benchmarkScaler("HQ2x", HQ2x, 2, 640, 480);
+	}
+
+	void test_hq3x() {
+		benchmarkScaler("HQ3x", HQ3x, 3, 320, 200);
+	}
+
+	void test_advmame3x() {
+		benchmarkScaler("AdvMame3x", AdvMame3x, 3, 320, 200);
+	}
+
+	void test_tv2x() {
+		benchmarkScaler("TV2x", TV2x, 2, 320, 200);
+	}
+
+	void test_dirty_rects() {
+		// Several separate rects, like a game updating a few sprites
+		InitScalers(565);
+
+		const int width = 320, height = 200, scale = 3;
+		const int srcPitch = width + 2 * kBorder;
+		Common::Array<uint16> src;
+		src.resize(srcPitch * (height + 2 * kBorder));
+		fillSource(src, srcPitch, height + 2 * kBorder);
+		const uint8 *srcPixels = (const uint8 *)&src[kBorder * srcPitch + kBorder];
+
+		const int dstPitch = width * scale;
+		Common::Array<uint16> reference;
+		reference.resize(dstPitch * height * scale);
+		Common::Array<uint16> dst;
+		dst.resize(dstPitch * height * scale);
+
+		const int rects[][4] = {
+			{  10,  10,  64,  48 }, { 100,  20,  32,  32 }, { 200,  50,  96,  64 },
+			{  40, 120, 120,  70 }, { 250, 150,  50,  40 }, { 180, 100,  17,  33 }
+		};
+		const int rectCount = ARRAYSIZE(rects);
+
+		double start = Benchmark::now();
+		for (int i = 0; i < kIterations; ++i) {
+			for (int r = 0; r < rectCount; ++r) {
+				const int *rect = rects[r];
+				HQ3x(srcPixels + rect[1] * srcPitch * 2 + rect[0] * 2, srcPitch * 2,
+				     (uint8 *)&reference[rect[1] * scale * dstPitch + rect[0] * scale], dstPitch * 2, rect[2], rect[3]);
+			}
+		}
+		const double serialTime = Benchmark::now() - start;
+		Benchmark::report("HQ3x dirty rects serial", serialTime, kIterations);
+
+		ScalerJobQueue queue;
+		start = Benchmark::now();
+		for (int i = 0; i < kIterations; ++i) {
+			for (int r = 0; r < rectCount; ++r) {
+				const int *rect = rects[r];
+				queue.addJob(srcPixels + rect[1] * srcPitch * 2 + rect[0] * 2, srcPitch * 2,
+				             (uint8 *)&dst[rect[1] * scale * dstPitch + rect[0] * scale], dstPitch * 2, rect[2], rect[3], scale);
+			}
+			queue.run(HQ3x);
+		}
+		const double time = Benchmark::now() - start;
+
+		TS_ASSERT(!memcmp(&reference[0], &dst[0], dst.size() * 2));
+
+		Common::String label = Common::String::format("HQ3x dirty rects %d thread(s)", queue.getThreadCount());
+		Benchmark::report(label.c_str(), time, kIterations);
+		printf(" -> %.2fx", serialTime / time);
+
+		DestroyScalers();
+	}
+};
@@ -0,0 +1,145 @@
+#include <cxxtest/TestSuite.h>
+
+#include "engines/wintermute/graphics/transparent_surface.h"
+#include "engines/wintermute/graphics/transparent_surface_simd.h"
+
+#include "common/str.h"
+
+#include "../../helpers/test_random.h"
+
+class TransparentSurfaceBenchmarkSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kTargetWidth = 800,
+		kTargetHeight = 600,
+		kPixelsPerRun = 4 * 1024 * 1024
+	};
+
+	enum AlphaType {
+		kAlphaBinary,  ///< Only fully transparent and fully opaque pixels
+		kAlphaSprite   ///< Opaque center, transparent border, blended edge
+	};
+
+	enum BlitMode {
+		kBlitOpaque,
+		kBlitAlpha,
+		kBlitColorMod
+	};
+
+	static void createSprite(Graphics::Surface &surf, int size, AlphaType alphaType) {
+		surf.create(size, size, Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24));
+
+		// A round sprite with random colors, like a particle
+		uint32 seed = size;
+		const int radius = size / 2;
+		for (int y = 0; y < size; ++y) {
+			for (int x = 0; x < size; ++x) {
+				const int dx = x - radius, dy = y - radius;
+				const int dist = dx * dx + dy * dy;
+				uint32 alpha;
+				if (alphaType == kAlphaBinary)
+					alpha = dist < radius * radius ? 255 : 0;
+				else if (dist < (radius - 4) * (radius - 4))
+					alpha = 255;
+				else if (dist < radius * radius)
+					alpha = nextTestRandom(seed) % 254 + 1;
+				else
+					alpha = 0;
+				*(uint32 *)surf.getBasePtr(x, y) = (alpha << 24) | (nextTestRandom(seed) & 0xFFFFFF);
+			}
+		}
+	}
+
+	static void fillTarget(Graphics::Surface &target) {
+		uint32 seed = 1;
+		for (int y = 0; y < target.h; ++y)
+			for (int x = 0; x < target.w; ++x)
+				*(uint32 *)target.getBasePtr(x, y) = 0xFF000000 | (nextTestRandom(seed) & 0xFFFFFF);
+	}
+
+	static void blitWith(const Wintermute::BlitKernels &kernels, BlitMode mode, const Graphics::Surface &sprite, Graphics::Surface &target, int x, int y, bool flip, uint32 color) {
+		const byte *ino = (const byte *)sprite.getBasePtr(flip ? sprite.w - 1 : 0, 0);
+		byte *outo = (byte *)target.getBasePtr(x, y);
+		const int32 inStep = flip ? -4 : 4;
+
+		switch (mode) {
+		case kBlitOpaque:
+			kernels.blitOpaque(ino, outo, sprite.w, sprite.h, target.pitch, inStep, sprite.pitch);
+			break;
+		case kBlitAlpha:
+			kernels.blitAlpha(ino, outo, sprite.w, sprite.h, target.pitch, inStep, sprite.pitch);
+			break;
+		case kBlitColorMod:
+			kernels.blitColorMod(ino, outo, sprite.w, sprite.h, target.pitch, inStep, sprite.pitch,
+			                     (color >> 24) & 0xFF, (color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF);
+			break;
+		}
+	}
+
+	double timeBlits(const Wintermute::BlitKernels &kernels, BlitMode mode, const Graphics::Surface &sprite, Graphics::Surface &target, bool flip, uint32 color, int iterations) {
+		const double start = Benchmark::now();
+		for (int i = 0; i < iterations; ++i)
+			blitWith(kernels, mode, sprite, target, (i * 37) % (kTargetWidth - sprite.w), (i * 23) % (kTargetHeight - sprite.h), flip, color);
+		return Benchmark::now() - start;
+	}
+
+	void benchmarkBlit(const char *name, BlitMode mode, AlphaType alphaType, int size, bool flip = false, uint32 color = 0xFFFFFFFF) {
+		Graphics::Surface sprite, scalarTarget, simdTarget;
+		createSprite(sprite, size, alphaType);
+		scalarTarget.create(kTargetWidth, kTargetHeight, sprite.format);
+		simdTarget.create(kTargetWidth, kTargetHeight, sprite.format);
+		fillTarget(scalarTarget);
+		fillTarget(simdTarget);
+
+		const int iterations = kPixelsPerRun / (size * size);
+		const Wintermute::BlitKernels &scalar = Wintermute::getScalarBlitKernels();
+		const Wintermute::BlitKernels &simd = Wintermute::getBlitKernels();
+
+		const double scalarTime = timeBlits(scalar, mode, sprite, scalarTarget, flip, color, iterations);
+		const double simdTime = timeBlits(simd, mode, sprite, simdTarget, flip, color, iterations);
+
+		Common::String label = Common::String::format("%s %dx%d scalar", name, size, size);
+		Benchmark::report(label.c_str(), scalarTime, iterations);
+		label = Common::String::format("%s %dx%d %s", name, size, size, simd.name);
+		Benchmark::report(label.c_str(), simdTime, iterations);
+		printf(" -> %.2fx", scalarTime / simdTime);
+
+		sprite.free();
+		scalarTarget.free();
+		simdTarget.free();
+	}
+
+public:
+	void test_kernels() {
+		printf("\n  Blit kernels: %s", Wintermute::getBlitKernels().name);
+	}
+
+	void test_opaque() {
+		benchmarkBlit("opaque", kBlitOpaque, kAlphaSprite, 64);
+		benchmarkBlit("opaque", kBlitOpaque, kAlphaSprite, 256);
+	}
+
+	void test_binary_alpha() {
+		benchmarkBlit("binary alpha", kBlitAlpha, kAlphaBinary, 32);
+		benchmarkBlit("binary alpha", kBlitAlpha, kAlphaBinary, 128);
+	}
+
+	void test_alpha() {
+		benchmarkBlit("alpha", kBlitAlpha, kAlphaSprite, 16);
+		benchmarkBlit("alpha", kBlitAlpha, kAlphaSprite, 32);
+		benchmarkBlit("alpha", kBlitAlpha, kAlphaSprite, 64);
+		benchmarkBlit("alpha", kBlitAlpha, kAlphaSprite, 256);
+	}
+
+	void test_alpha_flipped() {
+		benchmarkBlit("alpha flipped", kBlitAlpha, kAlphaSprite, 64, true);
+	}
+
+	void test_color_mod() {
+		benchmarkBlit("color mod", kBlitColorMod, kAlphaSprite, 32, false, 0xFFFF8040);
+		benchmarkBlit("color mod", kBlitColorMod, kAlphaSprite, 64, false, 0xFF00C0FF);
+		benchmarkBlit("color mod + alpha", kBlitColorMod, kAlphaSprite, 64, false, 0x80707070);
+		benchmarkBlit("color mod + alpha flipped", kBlitColorMod, kAlphaSprite, 64, true, 0xC0FF00FF);
+	}
+};
@@ -0,0 +1,235 @@
+/* Generated file, do not edit */
+
+#ifndef CXXTEST_RUNNING
+#define CXXTEST_RUNNING
+#endif
+
+#include "./test/cxxtest_mingw.h"
+#include "./test/benchmark.h"
+#include <cxxtest/TestListener.h>
+#include <cxxtest/TestTracker.h>
+#include <cxxtest/TestRunner.h>
+#include <cxxtest/RealDescriptions.h>
+#include <cxxtest/StdioPrinter.h>
+
+int main() {
+ return CxxTest::StdioPrinter().run();
+}
+#include "test/benchmarks/advanced_detector.h"
+
+static AdvancedDetectorBenchmarkSuite suite_AdvancedDetectorBenchmarkSuite;
+
+static CxxTest::List Tests_AdvancedDetectorBenchmarkSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_AdvancedDetectorBenchmarkSuite( "test/benchmarks/advanced_detector.h", 150, "AdvancedDetectorBenchmarkSuite", suite_AdvancedDetectorBenchmarkSuite, Tests_AdvancedDetectorBenchmarkSuite );
+
+static class TestDescription_AdvancedDetectorBenchmarkSuite_test_detect_games : public CxxTest::RealTestDescription {
+public:
+ TestDescription_AdvancedDetectorBenchmarkSuite_test_detect_games() : CxxTest::RealTestDescription( Tests_AdvancedDetectorBenchmarkSuite, suiteDescription_AdvancedDetectorBenchmarkSuite, 217, "test_detect_games" ) {}
+ void runTest() { suite_AdvancedDetectorBenchmarkSuite.test_detect_games(); }
+} testDescription_AdvancedDetectorBenchmarkSuite_test_detect_games;
+
+#include "test/benchmarks/bitstream.h"
+
+static BitStreamBenchmarkSuite suite_BitStreamBenchmarkSuite;
+
+static CxxTest::List Tests_BitStreamBenchmarkSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_BitStreamBenchmarkSuite( "test/benchmarks/bitstream.h", 166, "BitStreamBenchmarkSuite", suite_BitStreamBenchmarkSuite, Tests_BitStreamBenchmarkSuite );
+
+static class TestDescription_BitStreamBenchmarkSuite_test_get_bits : public CxxTest::RealTestDescription {
+public:
+ TestDescription_BitStreamBenchmarkSuite_test_get_bits() : CxxTest::RealTestDescription( Tests_BitStreamBenchmarkSuite, suiteDescription_BitStreamBenchmarkSuite, 203, "test_get_bits" ) {}
+ void runTest() { suite_BitStreamBenchmarkSuite.test_get_bits(); }
+} testDescription_BitStreamBenchmarkSuite_test_get_bits;
+
+static class TestDescription_BitStreamBenchmarkSuite_test_get_bit : public CxxTest::RealTestDescription {
+public:
+ TestDescription_BitStreamBenchmarkSuite_test_get_bit() : CxxTest::RealTestDescription( Tests_BitStreamBenchmarkSuite, suiteDescription_BitStreamBenchmarkSuite, 244, "test_get_bit" ) {}
+ void runTest() { suite_BitStreamBenchmarkSuite.test_get_bit(); }
+} testDescription_BitStreamBenchmarkSuite_test_get_bit;
+
+static class TestDescription_BitStreamBenchmarkSuite_test_peek_and_skip : public CxxTest::RealTestDescription {
+public:
+ TestDescription_BitStreamBenchmarkSuite_test_peek_and_skip() : CxxTest::RealTestDescription( Tests_BitStreamBenchmarkSuite, suiteDescription_BitStreamBenchmarkSuite, 273, "test_peek_and_skip" ) {}
+ void runTest() { suite_BitStreamBenchmarkSuite.test_peek_and_skip(); }
+} testDescription_BitStreamBenchmarkSuite_test_peek_and_skip;
+
+static class TestDescription_BitStreamBenchmarkSuite_test_bink_symbols : public CxxTest::RealTestDescription {
+public:
+ TestDescription_BitStreamBenchmarkSuite_test_bink_symbols() : CxxTest::RealTestDescription( Tests_BitStreamBenchmarkSuite, suiteDescription_BitStreamBenchmarkSuite, 296, "test_bink_symbols" ) {}
+ void runTest() { suite_BitStreamBenchmarkSuite.test_bink_symbols(); }
+} testDescription_BitStreamBenchmarkSuite_test_bink_symbols;
+
+#include "test/benchmarks/huffman.h"
+
+static HuffmanBenchmarkSuite suite_HuffmanBenchmarkSuite;
+
+static CxxTest::List Tests_HuffmanBenchmarkSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_HuffmanBenchmarkSuite( "test/benchmarks/huffman.h", 11, "HuffmanBenchmarkSuite", suite_HuffmanBenchmarkSuite, Tests_HuffmanBenchmarkSuite );
+
+static class TestDescription_HuffmanBenchmarkSuite_test_bink_symbols : public CxxTest::RealTestDescription {
+public:
+ TestDescription_HuffmanBenchmarkSuite_test_bink_symbols() : CxxTest::RealTestDescription( Tests_HuffmanBenchmarkSuite, suiteDescription_HuffmanBenchmarkSuite, 47, "test_bink_symbols" ) {}
+ void runTest() { suite_HuffmanBenchmarkSuite.test_bink_symbols(); }
+} testDescription_HuffmanBenchmarkSuite_test_bink_symbols;
+
+static class TestDescription_HuffmanBenchmarkSuite_test_long_codes : public CxxTest::RealTestDescription {
+public:
+ TestDescription_HuffmanBenchmarkSuite_test_long_codes() : CxxTest::RealTestDescription( Tests_HuffmanBenchmarkSuite, suiteDescription_HuffmanBenchmarkSuite, 87, "test_long_codes" ) {}
+ void runTest() { suite_HuffmanBenchmarkSuite.test_long_codes(); }
+} testDescription_HuffmanBenchmarkSuite_test_long_codes;
+
+#include "test/benchmarks/mixer.h"
+
+static MixerBenchmarkSuite suite_MixerBenchmarkSuite;
+
+static CxxTest::List Tests_MixerBenchmarkSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_MixerBenchmarkSuite( "test/benchmarks/mixer.h", 83, "MixerBenchmarkSuite", suite_MixerBenchmarkSuite, Tests_MixerBenchmarkSuite );
+
+static class TestDescription_MixerBenchmarkSuite_test_mutex : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MixerBenchmarkSuite_test_mutex() : CxxTest::RealTestDescription( Tests_MixerBenchmarkSuite, suiteDescription_MixerBenchmarkSuite, 210, "test_mutex" ) {}
+ void runTest() { suite_MixerBenchmarkSuite.test_mutex(); }
+} testDescription_MixerBenchmarkSuite_test_mutex;
+
+static class TestDescription_MixerBenchmarkSuite_test_lock_free : public CxxTest::RealTestDescription {
+public:
+ TestDescription_MixerBenchmarkSuite_test_lock_free() : CxxTest::RealTestDescription( Tests_MixerBenchmarkSuite, suiteDescription_MixerBenchmarkSuite, 214, "test_lock_free" ) {}
+ void runTest() { suite_MixerBenchmarkSuite.test_lock_free(); }
+} testDescription_MixerBenchmarkSuite_test_lock_free;
+
+#include "test/benchmarks/rate.h"
+
+static RateConverterBenchmarkSuite suite_RateConverterBenchmarkSuite;
+
+static CxxTest::List Tests_RateConverterBenchmarkSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_RateConverterBenchmarkSuite( "test/benchmarks/rate.h", 11, "RateConverterBenchmarkSuite", suite_RateConverterBenchmarkSuite, Tests_RateConverterBenchmarkSuite );
+
+static class TestDescription_RateConverterBenchmarkSuite_test_mix_kernels : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RateConverterBenchmarkSuite_test_mix_kernels() : CxxTest::RealTestDescription( Tests_RateConverterBenchmarkSuite, suiteDescription_RateConverterBenchmarkSuite, 52, "test_mix_kernels" ) {}
+ void runTest() { suite_RateConverterBenchmarkSuite.test_mix_kernels(); }
+} testDescription_RateConverterBenchmarkSuite_test_mix_kernels;
+
+static class TestDescription_RateConverterBenchmarkSuite_test_linear_mono : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RateConverterBenchmarkSuite_test_linear_mono() : CxxTest::RealTestDescription( Tests_RateConverterBenchmarkSuite, suiteDescription_RateConverterBenchmarkSuite, 56, "test_linear_mono" ) {}
+ void runTest() { suite_RateConverterBenchmarkSuite.test_linear_mono(); }
+} testDescription_RateConverterBenchmarkSuite_test_linear_mono;
+
+static class TestDescription_RateConverterBenchmarkSuite_test_linear_stereo : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RateConverterBenchmarkSuite_test_linear_stereo() : CxxTest::RealTestDescription( Tests_RateConverterBenchmarkSuite, suiteDescription_RateConverterBenchmarkSuite, 60, "test_linear_stereo" ) {}
+ void runTest() { suite_RateConverterBenchmarkSuite.test_linear_stereo(); }
+} testDescription_RateConverterBenchmarkSuite_test_linear_stereo;
+
+static class TestDescription_RateConverterBenchmarkSuite_test_sinc_low_mono : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RateConverterBenchmarkSuite_test_sinc_low_mono() : CxxTest::RealTestDescription( Tests_RateConverterBenchmarkSuite, suiteDescription_RateConverterBenchmarkSuite, 64, "test_sinc_low_mono" ) {}
+ void runTest() { suite_RateConverterBenchmarkSuite.test_sinc_low_mono(); }
+} testDescription_RateConverterBenchmarkSuite_test_sinc_low_mono;
+
+static class TestDescription_RateConverterBenchmarkSuite_test_sinc_medium_mono : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RateConverterBenchmarkSuite_test_sinc_medium_mono() : CxxTest::RealTestDescription( Tests_RateConverterBenchmarkSuite, suiteDescription_RateConverterBenchmarkSuite, 68, "test_sinc_medium_mono" ) {}
+ void runTest() { suite_RateConverterBenchmarkSuite.test_sinc_medium_mono(); }
+} testDescription_RateConverterBenchmarkSuite_test_sinc_medium_mono;
+
+static class TestDescription_RateConverterBenchmarkSuite_test_sinc_high_mono : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RateConverterBenchmarkSuite_test_sinc_high_mono() : CxxTest::RealTestDescription( Tests_RateConverterBenchmarkSuite, suiteDescription_RateConverterBenchmarkSuite, 72, "test_sinc_high_mono" ) {}
+ void runTest() { suite_RateConverterBenchmarkSuite.test_sinc_high_mono(); }
+} testDescription_RateConverterBenchmarkSuite_test_sinc_high_mono;
+
+static class TestDescription_RateConverterBenchmarkSuite_test_sinc_medium_stereo : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RateConverterBenchmarkSuite_test_sinc_medium_stereo() : CxxTest::RealTestDescription( Tests_RateConverterBenchmarkSuite, suiteDescription_RateConverterBenchmarkSuite, 76, "test_sinc_medium_stereo" ) {}
+ void runTest() { suite_RateConverterBenchmarkSuite.test_sinc_medium_stereo(); }
+} testDescription_RateConverterBenchmarkSuite_test_sinc_medium_stereo;
+
+static class TestDescription_RateConverterBenchmarkSuite_test_sinc_high_stereo : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RateConverterBenchmarkSuite_test_sinc_high_stereo() : CxxTest::RealTestDescription( Tests_RateConverterBenchmarkSuite, suiteDescription_RateConverterBenchmarkSuite, 80, "test_sinc_high_stereo" ) {}
+ void runTest() { suite_RateConverterBenchmarkSuite.test_sinc_high_stereo(); }
+} testDescription_RateConverterBenchmarkSuite_test_sinc_high_stereo;
+
+static class TestDescription_RateConverterBenchmarkSuite_test_sinc_high_downsample : public CxxTest::RealTestDescription {
+public:
+ TestDescription_RateConverterBenchmarkSuite_test_sinc_high_downsample() : CxxTest::RealTestDescription( Tests_RateConverterBenchmarkSuite, suiteDescription_RateConverterBenchmarkSuite, 84, "test_sinc_high_downsample" ) {}
+ void runTest() { suite_RateConverterBenchmarkSuite.test_sinc_high_downsample(); }
+} testDescription_RateConverterBenchmarkSuite_test_sinc_high_downsample;
+
+#include "test/benchmarks/scalers/scalers.h"
+
+static ScalersBenchmarkSuite suite_ScalersBenchmarkSuite;
+
+static CxxTest::List Tests_ScalersBenchmarkSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_ScalersBenchmarkSuite( "test/benchmarks/scalers/scalers.h", 16, "ScalersBenchmarkSuite", suite_ScalersBenchmarkSuite, Tests_ScalersBenchmarkSuite );
+
+static class TestDescription_ScalersBenchmarkSuite_test_scale2x : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ScalersBenchmarkSuite_test_scale2x() : CxxTest::RealTestDescription( Tests_ScalersBenchmarkSuite, suiteDescription_ScalersBenchmarkSuite, 81, "test_scale2x" ) {}
+ void runTest() { suite_ScalersBenchmarkSuite.test_scale2x(); }
+} testDescription_ScalersBenchmarkSuite_test_scale2x;
+
+static class TestDescription_ScalersBenchmarkSuite_test_scale3x : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ScalersBenchmarkSuite_test_scale3x() : CxxTest::RealTestDescription( Tests_ScalersBenchmarkSuite, suiteDescription_ScalersBenchmarkSuite, 99, "test_scale3x" ) {}
+ void runTest() { suite_ScalersBenchmarkSuite.test_scale3x(); }
+} testDescription_ScalersBenchmarkSuite_test_scale3x;
+
+static class TestDescription_ScalersBenchmarkSuite_test_hqx_patterns : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ScalersBenchmarkSuite_test_hqx_patterns() : CxxTest::RealTestDescription( Tests_ScalersBenchmarkSuite, suiteDescription_ScalersBenchmarkSuite, 117, "test_hqx_patterns" ) {}
+ void runTest() { suite_ScalersBenchmarkSuite.test_hqx_patterns(); }
+} testDescription_ScalersBenchmarkSuite_test_hqx_patterns;
+
+static class TestDescription_ScalersBenchmarkSuite_test_hqx : public CxxTest::RealTestDescription {
+public:
+ TestDescription_ScalersBenchmarkSuite_test_hqx() : CxxTest::RealTestDescription( Tests_ScalersBenchmarkSuite, suiteDescription_ScalersBenchmarkSuite, 148, "test_hqx" ) {}
+ void runTest() { suite_ScalersBenchmarkSuite.test_hqx(); }
+} testDescription_ScalersBenchmarkSuite_test_hqx;
+
+#include "test/benchmarks/wintermute/transparent_surface.h"
+
+static TransparentSurfaceBenchmarkSuite suite_TransparentSurfaceBenchmarkSuite;
+
+static CxxTest::List Tests_TransparentSurfaceBenchmarkSuite = { 0, 0 };
+CxxTest::StaticSuiteDescription suiteDescription_TransparentSurfaceBenchmarkSuite( "test/benchmarks/wintermute/transparent_surface.h", 10, "TransparentSurfaceBenchmarkSuite", suite_TransparentSurfaceBenchmarkSuite, Tests_TransparentSurfaceBenchmarkSuite );
+
+static class TestDescription_TransparentSurfaceBenchmarkSuite_test_kernels : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TransparentSurfaceBenchmarkSuite_test_kernels() : CxxTest::RealTestDescription( Tests_TransparentSurfaceBenchmarkSuite, suiteDescription_TransparentSurfaceBenchmarkSuite, 114, "test_kernels" ) {}
+ void runTest() { suite_TransparentSurfaceBenchmarkSuite.test_kernels(); }
+} testDescription_TransparentSurfaceBenchmarkSuite_test_kernels;
+
+static class TestDescription_TransparentSurfaceBenchmarkSuite_test_opaque : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TransparentSurfaceBenchmarkSuite_test_opaque() : CxxTest::RealTestDescription( Tests_TransparentSurfaceBenchmarkSuite, suiteDescription_TransparentSurfaceBenchmarkSuite, 118, "test_opaque" ) {}
+ void runTest() { suite_TransparentSurfaceBenchmarkSuite.test_opaque(); }
+} testDescription_TransparentSurfaceBenchmarkSuite_test_opaque;
+
+static class TestDescription_TransparentSurfaceBenchmarkSuite_test_binary_alpha : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TransparentSurfaceBenchmarkSuite_test_binary_alpha() : CxxTest::RealTestDescription( Tests_TransparentSurfaceBenchmarkSuite, suiteDescription_TransparentSurfaceBenchmarkSuite, 123, "test_binary_alpha" ) {}
+ void runTest() { suite_TransparentSurfaceBenchmarkSuite.test_binary_alpha(); }
+} testDescription_TransparentSurfaceBenchmarkSuite_test_binary_alpha;
+
+static class TestDescription_TransparentSurfaceBenchmarkSuite_test_alpha : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TransparentSurfaceBenchmarkSuite_test_alpha() : CxxTest::RealTestDescription( Tests_TransparentSurfaceBenchmarkSuite, suiteDescription_TransparentSurfaceBenchmarkSuite, 128, "test_alpha" ) {}
+ void runTest() { suite_TransparentSurfaceBenchmarkSuite.test_alpha(); }
+} testDescription_TransparentSurfaceBenchmarkSuite_test_alpha;
+
+static class TestDescription_TransparentSurfaceBenchmarkSuite_test_alpha_flipped : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TransparentSurfaceBenchmarkSuite_test_alpha_flipped() : CxxTest::RealTestDescription( Tests_TransparentSurfaceBenchmarkSuite, suiteDescription_TransparentSurfaceBenchmarkSuite, 135, "test_alpha_flipped" ) {}
+ void runTest() { suite_TransparentSurfaceBenchmarkSuite.test_alpha_flipped(); }
+} testDescription_TransparentSurfaceBenchmarkSuite_test_alpha_flipped;
+
+static class TestDescription_TransparentSurfaceBenchmarkSuite_test_color_mod : public CxxTest::RealTestDescription {
+public:
+ TestDescription_TransparentSurfaceBenchmarkSuite_test_color_mod() : CxxTest::RealTestDescription( Tests_TransparentSurfaceBenchmarkSuite, suiteDescription_TransparentSurfaceBenchmarkSuite, 139, "test_color_mod" ) {}
+ void runTest() { suite_TransparentSurfaceBenchmarkSuite.test_color_mod(); }
+} testDescription_TransparentSurfaceBenchmarkSuite_test_color_mod;
+
+#include <cxxtest/Root.cpp>
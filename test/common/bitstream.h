@@ -2,6 +2,7 @@
 
 #include "common/bitstream.h"
 #include "common/memstream.h"
+#include "common/substream.h"
 
 class BitStreamTestSuite : public CxxTest::TestSuite
 {
@@ -149,4 +150,60 @@ class BitStreamTestSuite : public CxxTest::TestSuite
 		TS_ASSERT_EQUALS(bs.peekBits(5), 12u);
 		TS_ASSERT(!bs.eos());
 	}
+
+	void test_get_bits_32() {
+		byte contents[] = { 0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0, 0x0F, 0xED, 0xCB, 0xA9 };
+
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+
+		Common::BitStream32BEMSB bs(ms);
+		TS_ASSERT_EQUALS(bs.getBits(4), 0x1u);
+		TS_ASSERT_EQUALS(bs.getBits(32), 0x23456789u);
+		TS_ASSERT_EQUALS(bs.peekBits(32), 0xABCDEF00u);
+		TS_ASSERT_EQUALS(bs.getBits(32), 0xABCDEF00u);
+		TS_ASSERT_EQUALS(bs.getBits(28), 0xFEDCBA9u);
+		TS_ASSERT(bs.eos());
+
+		Common::BitStream32LELSB bsLSB(ms);
+		TS_ASSERT_EQUALS(bsLSB.getBits(4), 0x2u);
+		TS_ASSERT_EQUALS(bsLSB.getBits(32), 0xA7856341u);
+		TS_ASSERT_EQUALS(bsLSB.getBits(32), 0xFF0DEBC9u);
+		TS_ASSERT_EQUALS(bsLSB.getBits(28), 0xA9CBED0u);
+		TS_ASSERT(bsLSB.eos());
+	}
+
+	void test_stream_not_in_memory() {
+		// Bit streams on other streams read them in blocks, compare that to
+		// reading directly from memory
+		byte contents[1000];
+		for (int i = 0; i < 1000; i++)
+			contents[i] = i * 7 + (i >> 3);
+
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+		Common::SeekableSubReadStream ss(&ms, 0, sizeof(contents));
+
+		Common::BitStream16LEMSB memoryBits(ms);
+		Common::BitStream16LEMSB streamBits(ss);
+		TS_ASSERT_EQUALS(streamBits.size(), 8000u);
+
+		for (int i = 0; i < 500; i++) {
+			TS_ASSERT_EQUALS(streamBits.getBits(i % 14 + 1), memoryBits.getBits(i % 14 + 1));
+			TS_ASSERT_EQUALS(streamBits.peekBits(9), memoryBits.peekBits(9));
+		}
+		TS_ASSERT_EQUALS(streamBits.pos(), memoryBits.pos());
+
+		// Skip back and forth across the read blocks
+		streamBits.skip(3000);
+		memoryBits.skip(3000);
+		TS_ASSERT_EQUALS(streamBits.pos(), memoryBits.pos());
+		TS_ASSERT_EQUALS(streamBits.getBits(17), memoryBits.getBits(17));
+
+		streamBits.rewind();
+		TS_ASSERT_EQUALS(streamBits.pos(), 0u);
+		TS_ASSERT_EQUALS(streamBits.getBits(16), (uint32)READ_LE_UINT16(contents));
+
+		streamBits.skip(7974);
+		TS_ASSERT_EQUALS(streamBits.getBits(10), (uint32)(READ_LE_UINT16(contents + 998) & 0x3FF));
+		TS_ASSERT(streamBits.eos());
+	}
 };
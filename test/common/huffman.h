@@ -0,0 +1,113 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/bitstream.h"
+#include "common/huffman.h"
+#include "common/memstream.h"
+
+#include "../helpers/huffman_helper.h"
+
+class HuffmanTestSuite : public CxxTest::TestSuite
+{
+	private:
+	/**
+	 * Encode random symbols with a random code and decode them again,
+	 * through both the lookup tables and, for the last codes of the
+	 * stream, bit by bit.
+	 */
+	void checkRandomCode(bool isMSB2LSB, uint32 count, uint8 maxLength, uint32 seed) {
+		Common::Array<uint8> lengths;
+		Common::Array<uint32> codes;
+		makeHuffmanLengths(count, maxLength, seed, lengths);
+		makeHuffmanCodes(lengths, isMSB2LSB, codes);
+
+		Common::Array<uint32> symbols;
+		for (uint32 i = 0; i < count; i++)
+			symbols.push_back(i * 3 + 7);
+
+		Common::Array<uint32> message;
+		HuffmanWriter writer(isMSB2LSB);
+		for (int i = 0; i < 4000; i++) {
+			const uint32 index = nextTestRandom(seed, count);
+			message.push_back(symbols[index]);
+			writer.putCode(codes[index], lengths[index]);
+		}
+		const Common::Array<byte> &data = writer.finish();
+
+		Common::Huffman huffman(0, count, &codes[0], &lengths[0], &symbols[0]);
+		Common::MemoryReadStream ms(&data[0], data.size());
+
+		Common::BitStream *bits;
+		if (isMSB2LSB)
+			bits = new Common::BitStream8MSB(ms);
+		else
+			bits = new Common::BitStream32LELSB(ms);
+
+		for (uint32 i = 0; i < message.size(); i++)
+			TS_ASSERT_EQUALS(huffman.getSymbol(*bits), message[i]);
+		TS_ASSERT(bits->size() - bits->pos() < 32);
+
+		delete bits;
+	}
+
+	public:
+	void test_get_symbol() {
+		// 0 -> 'a', 10 -> 'b', 110 -> 'c', 111 -> 'd'
+		const uint32 codes[] = { 0, 2, 6, 7 };
+		const uint8 lengths[] = { 1, 2, 3, 3 };
+		const uint32 symbols[] = { 'a', 'b', 'c', 'd' };
+
+		// 10 111 0 110 0 10 0 10 111 000...
+		byte contents[] = { 0xBB, 0x25, 0xC0, 0x00 };
+
+		Common::Huffman huffman(0, 4, codes, lengths, symbols);
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+		Common::BitStream8MSB bs(ms);
+
+		TS_ASSERT_EQUALS(huffman.getSymbol(bs), (uint32)'b');
+		TS_ASSERT_EQUALS(huffman.getSymbol(bs), (uint32)'d');
+		TS_ASSERT_EQUALS(huffman.getSymbol(bs), (uint32)'a');
+		TS_ASSERT_EQUALS(huffman.getSymbol(bs), (uint32)'c');
+		TS_ASSERT_EQUALS(huffman.getSymbol(bs), (uint32)'a');
+		TS_ASSERT_EQUALS(huffman.getSymbol(bs), (uint32)'b');
+		TS_ASSERT_EQUALS(huffman.getSymbol(bs), (uint32)'a');
+		TS_ASSERT_EQUALS(huffman.getSymbol(bs), (uint32)'b');
+		TS_ASSERT_EQUALS(huffman.getSymbol(bs), (uint32)'d');
+		TS_ASSERT_EQUALS(bs.pos(), 18u);
+	}
+
+	void test_set_symbols() {
+		const uint32 codes[] = { 0, 2, 6, 7 };
+		const uint8 lengths[] = { 1, 2, 3, 3 };
+		const uint32 symbols[] = { 'a', 'b', 'c', 'd' };
+
+		byte contents[] = { 0xBB, 0x25, 0xC0, 0x00 };
+
+		Common::Huffman huffman(0, 4, codes, lengths);
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+		Common::BitStream8MSB bs(ms);
+
+		TS_ASSERT_EQUALS(huffman.getSymbol(bs), 1u);
+		TS_ASSERT_EQUALS(huffman.getSymbol(bs), 3u);
+
+		huffman.setSymbols(symbols);
+		TS_ASSERT_EQUALS(huffman.getSymbol(bs), (uint32)'a');
+		TS_ASSERT_EQUALS(huffman.getSymbol(bs), (uint32)'c');
+
+		huffman.setSymbols();
+		TS_ASSERT_EQUALS(huffman.getSymbol(bs), 0u);
+		TS_ASSERT_EQUALS(huffman.getSymbol(bs), 1u);
+	}
+
+	void test_short_codes() {
+		checkRandomCode(true, 16, 8, 1);
+		checkRandomCode(false, 16, 8, 2);
+	}
+
+	void test_long_codes() {
+		// Codes longer than a lookup table, down to several subtables
+		checkRandomCode(true, 300, 24, 3);
+		checkRandomCode(false, 300, 24, 4);
+		checkRandomCode(true, 40, 32, 5);
+		checkRandomCode(false, 40, 32, 6);
+	}
+};
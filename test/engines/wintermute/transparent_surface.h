@@ -0,0 +1,94 @@
+#include <cxxtest/TestSuite.h>
+
+#include "engines/wintermute/graphics/transparent_surface_simd.h"
+
+#include "../../helpers/test_random.h"
+
+class TransparentSurfaceTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		// Not a multiple of the vector width, to cover the remainder
+		kWidth = 37,
+		kHeight = 5,
+		kPitch = kWidth * 4
+	};
+
+	enum BlitMode {
+		kBlitOpaque,
+		kBlitAlpha,
+		kBlitColorMod
+	};
+
+	/**
+	 * Fill the pixels with random colors. A third of them is fully
+	 * transparent and another third fully opaque.
+	 */
+	static void fillPixels(byte *pixels, uint32 &seed) {
+		for (int i = 0; i < kWidth * kHeight; ++i) {
+			uint32 alpha = nextTestRandom(seed, 3);
+			if (alpha == 1)
+				alpha = 255;
+			else if (alpha == 2)
+				alpha = nextTestRandom(seed, 254) + 1;
+			WRITE_UINT32(pixels + i * 4, (alpha << 24) | (nextTestRandom(seed) & 0xFFFFFF));
+		}
+	}
+
+	static void blitWith(const Wintermute::BlitKernels &kernels, BlitMode mode, const byte *sprite, byte *target, bool flip, uint32 color) {
+		const byte *ino = flip ? sprite + (kWidth - 1) * 4 : sprite;
+		const int32 inStep = flip ? -4 : 4;
+
+		switch (mode) {
+		case kBlitOpaque:
+			kernels.blitOpaque(ino, target, kWidth, kHeight, kPitch, inStep, kPitch);
+			break;
+		case kBlitAlpha:
+			kernels.blitAlpha(ino, target, kWidth, kHeight, kPitch, inStep, kPitch);
+			break;
+		case kBlitColorMod:
+			kernels.blitColorMod(ino, target, kWidth, kHeight, kPitch, inStep, kPitch,
+			                     (color >> 24) & 0xFF, (color >> 16) & 0xFF, (color >> 8) & 0xFF, color & 0xFF);
+			break;
+		}
+	}
+
+	/**
+	 * Check that the kernels selected for this CPU give exactly the same
+	 * output as the scalar ones.
+	 */
+	void checkKernels(BlitMode mode, bool flip, uint32 color = 0xFFFFFFFF) {
+		byte sprite[kPitch * kHeight];
+		byte expected[kPitch * kHeight];
+		byte result[kPitch * kHeight];
+
+		uint32 seed = mode * 1000 + flip * 100 + (color & 0xFF);
+		fillPixels(sprite, seed);
+		fillPixels(expected, seed);
+		memcpy(result, expected, sizeof(result));
+
+		blitWith(Wintermute::getScalarBlitKernels(), mode, sprite, expected, flip, color);
+		blitWith(Wintermute::getBlitKernels(), mode, sprite, result, flip, color);
+
+		TS_ASSERT_EQUALS(memcmp(expected, result, sizeof(result)), 0);
+	}
+
+public:
+	void test_opaque() {
+		checkKernels(kBlitOpaque, false);
+	}
+
+	void test_alpha() {
+		checkKernels(kBlitAlpha, false);
+		checkKernels(kBlitAlpha, true);
+	}
+
+	void test_color_mod() {
+		// Channels of 0 and 255 take special paths in the scalar code
+		static const uint32 colors[] = { 0xFFFFFFFF, 0xFFFF8040, 0xFF00C0FF, 0x80707070, 0xC0FF00FF, 0x01FFFFFF, 0xFF000000 };
+		for (int i = 0; i < ARRAYSIZE(colors); ++i) {
+			checkKernels(kBlitColorMod, false, colors[i]);
+			checkKernels(kBlitColorMod, true, colors[i]);
+		}
+	}
+};
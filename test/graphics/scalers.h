@@ -0,0 +1,113 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/scaler.h"
+#include "graphics/scaler/scale2x.h"
+#include "graphics/scaler/scale3x.h"
+#include "graphics/scaler/hqx_patterns.h"
+
+#include "common/array.h"
+
+#include "../helpers/test_random.h"
+
+#ifdef USE_HQ_SCALERS
+extern "C" uint32 *RGBtoYUV;
+#endif
+
+class ScalersTestSuite : public CxxTest::TestSuite
+{
+private:
+	enum {
+		kMaxWidth = 75,
+		kHeight = 9,
+		// The scalers read one pixel around the rect, keep some more
+		kBorder = 2,
+		kPitch = kMaxWidth + 2 * kBorder
+	};
+
+	Common::Array<uint16> _src;
+
+	/**
+	 * Fill the source with blocks of a few colors, some similar ones, and
+	 * some noise, so all paths of the scalers are taken.
+	 */
+	void fillSource(uint32 seed) {
+		const uint16 colors[5] = { 0x0000, 0xF800, 0xF820, 0x07E0, 0xFFFF };
+		_src.resize(kPitch * (kHeight + 2 * kBorder));
+		for (int y = 0; y < kHeight + 2 * kBorder; ++y) {
+			for (int x = 0; x < kPitch; ++x) {
+				uint16 color = colors[((x / 3) ^ (y / 2)) % 5];
+				if ((nextTestRandom(seed) & 7) == 0)
+					color = nextTestRandom(seed) & 0xFFFF;
+				_src[y * kPitch + x] = color;
+			}
+		}
+	}
+
+	const uint16 *srcPixels() const {
+		return &_src[kBorder * kPitch + kBorder];
+	}
+
+	/**
+	 * Check the output of a scaler against the C implementation, called
+	 * row by row through the given function.
+	 */
+	template<class RowProc>
+	void checkScaler(ScalerProc *scalerProc, int scale, RowProc rowProc) {
+		// Widths which are not a multiple of the vector width cover the
+		// remainder handling as well
+		static const int widths[] = { 1, 7, 8, 9, 16, 31, 64, 75 };
+		for (int w = 0; w < ARRAYSIZE(widths); ++w) {
+			const int width = widths[w];
+			const int dstPitch = width * scale;
+			fillSource(width);
+
+			Common::Array<uint16> reference, result;
+			reference.resize(dstPitch * kHeight * scale);
+			result.resize(dstPitch * kHeight * scale);
+
+			for (int y = 0; y < kHeight; ++y)
+				rowProc(&reference[y * scale * dstPitch], dstPitch, srcPixels() + y * kPitch, width);
+			scalerProc((const uint8 *)srcPixels(), kPitch * 2, (uint8 *)&result[0], dstPitch * 2, width, kHeight);
+
+			TS_ASSERT_EQUALS(memcmp(&reference[0], &result[0], reference.size() * 2), 0);
+		}
+	}
+
+	static void scale2xRow(uint16 *dst, int dstPitch, const uint16 *src, int width) {
+		scale2x_16_def(dst, dst + dstPitch, src - kPitch, src, src + kPitch, width);
+	}
+
+	static void scale3xRow(uint16 *dst, int dstPitch, const uint16 *src, int width) {
+		scale3x_16_def(dst, dst + dstPitch, dst + 2 * dstPitch, src - kPitch, src, src + kPitch, width);
+	}
+
+public:
+	void test_scale2x() {
+		checkScaler(AdvMame2x, 2, scale2xRow);
+	}
+
+	void test_scale3x() {
+		checkScaler(AdvMame3x, 3, scale3xRow);
+	}
+
+	void test_hqx_patterns() {
+#ifdef USE_HQ_SCALERS
+		const int formats[2] = { 555, 565 };
+		for (int f = 0; f < 2; ++f) {
+			InitScalers(formats[f]);
+
+			for (int width = 1; width <= kMaxWidth; ++width) {
+				fillSource(width);
+				for (int y = 0; y < kHeight; ++y) {
+					uint8 reference[kMaxWidth], patterns[kMaxWidth];
+					hqx_patterns_def(srcPixels() + y * kPitch, kPitch, RGBtoYUV, width, reference);
+					hqx_patterns(srcPixels() + y * kPitch, kPitch, RGBtoYUV, width, patterns);
+					TS_ASSERT_EQUALS(memcmp(reference, patterns, width), 0);
+				}
+			}
+
+			DestroyScalers();
+		}
+#endif
+	}
+};
@@ -0,0 +1,211 @@
+#include <cxxtest/TestSuite.h>
+
+#include "gui/ThemeCache.h"
+#include "gui/ThemeEngine.h"
+#include "gui/ThemeEval.h"
+
+#include "common/array.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/memstream.h"
+#include "common/system.h"
+
+#include "backends/fs/fs-factory.h"
+
+/**
+ * Appends everything written to it to an array.
+ */
+class ThemeCacheTestStream : public Common::WriteStream {
+public:
+	ThemeCacheTestStream(Common::Array<byte> &data) : _data(data) {
+		_data.clear();
+	}
+
+	virtual uint32 write(const void *dataPtr, uint32 dataSize) {
+		for (uint32 i = 0; i < dataSize; ++i)
+			_data.push_back(((const byte *)dataPtr)[i]);
+		return dataSize;
+	}
+
+private:
+	Common::Array<byte> &_data;
+};
+
+/**
+ * A file system without any files, for the search paths set up by
+ * SearchMan and ThemeEngine.
+ */
+class ThemeCacheTestFilesystemFactory : public FilesystemFactory {
+public:
+	virtual AbstractFSNode *makeCurrentDirectoryFileNode() const { return 0; }
+	virtual AbstractFSNode *makeFileNodePath(const Common::String &path) const { return 0; }
+	virtual AbstractFSNode *makeRootFileNode() const { return 0; }
+};
+
+/**
+ * Just enough of an OSystem for ThemeEngine and ThemeCache: the overlay
+ * size and cache files, which are kept in memory.
+ */
+class ThemeCacheTestSystem : public OSystem {
+public:
+	typedef Common::HashMap<Common::String, Common::Array<byte> > FileMap;
+
+	FileMap _cacheFiles;
+	int16 _overlayWidth;
+	int16 _overlayHeight;
+
+	ThemeCacheTestSystem() : _overlayWidth(320), _overlayHeight(200) {
+		_fsFactory = new ThemeCacheTestFilesystemFactory();
+	}
+
+	virtual Common::SeekableReadStream *createCacheReadStream(const Common::String &name) {
+		if (!_cacheFiles.contains(name))
+			return 0;
+
+		const Common::Array<byte> &data = _cacheFiles[name];
+		byte *copy = (byte *)malloc(data.size());
+		memcpy(copy, data.begin(), data.size());
+		return new Common::MemoryReadStream(copy, data.size(), DisposeAfterUse::YES);
+	}
+
+	virtual Common::WriteStream *createCacheWriteStream(const Common::String &name) {
+		return new ThemeCacheTestStream(_cacheFiles[name]);
+	}
+
+	virtual const GraphicsMode *getSupportedGraphicsModes() const { return 0; }
+	virtual int getDefaultGraphicsMode() const { return 0; }
+	virtual bool setGraphicsMode(int mode) { return false; }
+	virtual int getGraphicsMode() const { return 0; }
+	virtual Graphics::PixelFormat getScreenFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	virtual Common::List<Graphics::PixelFormat> getSupportedFormats() const { return Common::List<Graphics::PixelFormat>(); }
+	virtual void initSize(uint width, uint height, const Graphics::PixelFormat *format = NULL) {}
+	virtual int16 getHeight() { return 0; }
+	virtual int16 getWidth() { return 0; }
+	virtual PaletteManager *getPaletteManager() { return 0; }
+	virtual void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {}
+	virtual Graphics::Surface *lockScreen() { return 0; }
+	virtual void unlockScreen() {}
+	virtual void fillScreen(uint32 col) {}
+	virtual void updateScreen() {}
+	virtual void setShakePos(int shakeOffset) {}
+	virtual void showOverlay() {}
+	virtual void hideOverlay() {}
+	virtual Graphics::PixelFormat getOverlayFormat() const { return Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0); }
+	virtual void clearOverlay() {}
+	virtual void grabOverlay(void *buf, int pitch) {}
+	virtual void copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) {}
+	virtual int16 getOverlayHeight() { return _overlayHeight; }
+	virtual int16 getOverlayWidth() { return _overlayWidth; }
+	virtual bool showMouse(bool visible) { return false; }
+	virtual void warpMouse(int x, int y) {}
+	virtual void setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale = false, const Graphics::PixelFormat *format = NULL) {}
+	virtual uint32 getMillis() { return 0; }
+	virtual void delayMillis(uint msecs) {}
+	virtual MutexRef createMutex() { return 0; }
+	virtual void lockMutex(MutexRef mutex) {}
+	virtual void unlockMutex(MutexRef mutex) {}
+	virtual void deleteMutex(MutexRef mutex) {}
+	virtual void getTimeAndDate(TimeDate &t) const { memset(&t, 0, sizeof(t)); }
+	virtual Audio::Mixer *getMixer() { return 0; }
+	virtual void quit() {}
+	virtual void displayMessageOnOSD(const char *msg) {}
+	virtual void logMessage(LogMessageType::Type type, const char *message) {}
+};
+
+class ThemeCacheTestSuite : public CxxTest::TestSuite
+{
+private:
+	ThemeCacheTestSystem *_system;
+	OSystem *_oldSystem;
+
+	/** Records a few variables and a dialog with one widget, and saves them */
+	void saveTheme(const Common::String &key) {
+		GUI::ThemeCache cache("/themes/test.zip", key);
+		cache.setVar("Globals.Test.Width", 42);
+		cache.setVar("Globals.Test.Height", -7);
+		cache.addDialog("Dialog.TestDialog", "screen", true, 10);
+		cache.addLayout(GUI::ThemeLayout::kLayoutVertical, 4, false);
+		cache.addPadding(1, 2, 3, 4);
+		cache.addWidget("Button", 100, 20, "", true, Graphics::kTextAlignCenter);
+		cache.addSpace(8);
+		cache.closeLayout();
+		cache.closeDialog();
+		TS_ASSERT(cache.save());
+	}
+
+	bool loadTheme(GUI::ThemeEngine &engine, const Common::String &key) {
+		GUI::ThemeCache cache("/themes/test.zip", key);
+		return cache.load(&engine);
+	}
+
+public:
+	void setUp() {
+		_system = new ThemeCacheTestSystem();
+		_oldSystem = g_system;
+		g_system = _system;
+	}
+
+	void tearDown() {
+		g_system = _oldSystem;
+		delete _system;
+	}
+
+	void test_round_trip() {
+		saveTheme("key");
+		TS_ASSERT(_system->_cacheFiles.contains("theme-test_zip.cache"));
+
+		GUI::ThemeEngine engine("builtin", GUI::ThemeEngine::kGfxDisabled);
+		TS_ASSERT(loadTheme(engine, "key"));
+
+		GUI::ThemeEval *eval = engine.getEvaluator();
+		TS_ASSERT_EQUALS(eval->getVar("Globals.Test.Width", 0), 42);
+		TS_ASSERT_EQUALS(eval->getVar("Globals.Test.Height", 0), -7);
+
+		int16 x, y;
+		uint16 w, h;
+		TS_ASSERT(eval->getWidgetData("TestDialog", x, y, w, h));
+		TS_ASSERT_EQUALS(x, 10);
+		TS_ASSERT_EQUALS(y, 10);
+		TS_ASSERT_EQUALS(w, 320 - 2 * 10);
+		TS_ASSERT_EQUALS(h, 200 - 2 * 10);
+
+		// Widgets are placed relative to the dialog
+		TS_ASSERT(eval->getWidgetData("TestDialog.Button", x, y, w, h));
+		TS_ASSERT_EQUALS(x, 1);
+		TS_ASSERT_EQUALS(y, 3);
+		TS_ASSERT_EQUALS(w, 100);
+		TS_ASSERT_EQUALS(h, 20);
+		TS_ASSERT_EQUALS(eval->getWidgetTextHAlign("TestDialog.Button"), Graphics::kTextAlignCenter);
+	}
+
+	void test_outdated() {
+		saveTheme("key");
+
+		GUI::ThemeEngine engine("builtin", GUI::ThemeEngine::kGfxDisabled);
+		TS_ASSERT(!loadTheme(engine, "other key"));
+		TS_ASSERT(!loadTheme(engine, ""));
+		TS_ASSERT(!engine.getEvaluator()->hasVar("Globals.Test.Width"));
+
+		// The layouts depend on the overlay size
+		_system->_overlayWidth = 640;
+		TS_ASSERT(!loadTheme(engine, "key"));
+		TS_ASSERT(!engine.getEvaluator()->hasVar("Globals.Test.Width"));
+	}
+
+	void test_corrupted() {
+		saveTheme("key");
+
+		Common::Array<byte> &data = _system->_cacheFiles["theme-test_zip.cache"];
+		const Common::Array<byte> original = data;
+		GUI::ThemeEngine engine("builtin", GUI::ThemeEngine::kGfxDisabled);
+
+		data[data.size() - 5] ^= 0x10;
+		TS_ASSERT(!loadTheme(engine, "key"));
+		TS_ASSERT(!engine.getEvaluator()->hasVar("Globals.Test.Width"));
+
+		data = original;
+		data.resize(data.size() - 1);
+		TS_ASSERT(!loadTheme(engine, "key"));
+		TS_ASSERT(!engine.getEvaluator()->hasVar("Globals.Test.Width"));
+	}
+};
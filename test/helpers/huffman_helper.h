@@ -0,0 +1,91 @@
+#ifndef TEST_HELPERS_HUFFMAN_HELPER_H
+#define TEST_HELPERS_HUFFMAN_HELPER_H
+
+#include "common/array.h"
+#include "common/scummsys.h"
+
+#include "test_random.h"
+
+/**
+ * Create the code lengths of a complete prefix code, by splitting leaves
+ * of the code tree until there are enough of them. Recently split leaves
+ * are preferred, which makes for long codes.
+ */
+inline void makeHuffmanLengths(uint32 count, uint8 maxLength, uint32 &seed, Common::Array<uint8> &lengths) {
+	lengths.clear();
+	lengths.push_back(0);
+
+	uint32 last = 0;
+	while (lengths.size() < count) {
+		uint32 leaf = last;
+		while (lengths[leaf] >= maxLength || (leaf == last && nextTestRandom(seed, 2) == 0))
+			leaf = nextTestRandom(seed, lengths.size());
+
+		lengths[leaf]++;
+		lengths.push_back(lengths[leaf]);
+		last = nextTestRandom(seed, 2) ? leaf : lengths.size() - 1;
+	}
+}
+
+/**
+ * Create the canonical codes for the given code lengths. For LSB2MSB bit
+ * streams, the first bit of each code is its LSB.
+ */
+inline void makeHuffmanCodes(const Common::Array<uint8> &lengths, bool isMSB2LSB, Common::Array<uint32> &codes) {
+	codes.resize(lengths.size());
+
+	uint32 code = 0;
+	for (uint8 length = 1; length <= 32; length++) {
+		for (uint32 i = 0; i < lengths.size(); i++) {
+			if (lengths[i] != length)
+				continue;
+
+			codes[i] = code++;
+
+			if (!isMSB2LSB) {
+				uint32 reversed = 0;
+				for (uint8 b = 0; b < length; b++)
+					reversed |= ((codes[i] >> b) & 1) << (length - 1 - b);
+				codes[i] = reversed;
+			}
+		}
+		code <<= 1;
+	}
+}
+
+/**
+ * Writes codes into a buffer the same way a BitStream8MSB, respectively a
+ * LSB2MSB bit stream of little-endian values, reads them.
+ */
+class HuffmanWriter {
+public:
+	HuffmanWriter(bool isMSB2LSB) : _isMSB2LSB(isMSB2LSB), _bits(0) {
+	}
+
+	void putCode(uint32 code, uint8 length) {
+		for (uint8 i = 0; i < length; i++)
+			putBit(_isMSB2LSB ? (code >> (length - 1 - i)) & 1 : (code >> i) & 1);
+	}
+
+	/** Pad the data to a multiple of 32 bits, and return it. */
+	const Common::Array<byte> &finish() {
+		while (_data.size() % 4)
+			_data.push_back(0);
+		return _data;
+	}
+
+private:
+	void putBit(uint32 bit) {
+		if (_bits % 8 == 0)
+			_data.push_back(0);
+		if (bit)
+			_data.back() |= _isMSB2LSB ? (0x80 >> (_bits % 8)) : (1 << (_bits % 8));
+		_bits++;
+	}
+
+	bool _isMSB2LSB;
+	uint32 _bits;
+	Common::Array<byte> _data;
+};
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef TEST_HELPERS_TEST_RANDOM_H
+#define TEST_HELPERS_TEST_RANDOM_H
+
+#include "common/scummsys.h"
+
+/**
+ * A simple LCG for the random data of the tests and benchmarks, which has
+ * to be the same on every run. Common::RandomSource needs g_system.
+ *
+ * @return the next 24 bit random number
+ */
+inline uint32 nextTestRandom(uint32 &seed) {
+	seed = seed * 1103515245 + 12345;
+	return seed >> 8;
+}
+
+/**
+ * @return the next random number from 0 to max - 1
+ */
+inline uint32 nextTestRandom(uint32 &seed, uint32 max) {
+	return nextTestRandom(seed) % max;
+}
+
+#endif
@@ -5,8 +5,22 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h
-TEST_LIBS    := audio/libaudio.a common/libcommon.a
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/gui/*.h
+TEST_LIBS    := gui/libgui.a graphics/libgraphics.a audio/libaudio.a common/libcommon.a
+
+ifdef USE_MT32EMU
+TESTS        += $(srcdir)/test/audio/mt32/*.h
+TEST_LIBS    := audio/softsynth/mt32/libmt32.a $(TEST_LIBS)
+endif
+
+ifdef USE_SCALERS
+TESTS        += $(srcdir)/test/graphics/*.h
+endif
+
+ifdef ENABLE_WINTERMUTE
+TESTS        += $(srcdir)/test/engines/wintermute/*.h
+TEST_LIBS    := engines/wintermute/graphics/transparent_surface_simd.o $(TEST_LIBS)
+endif
 
 #
 TEST_FLAGS   := --runner=StdioPrinter --no-std --no-eh --include=$(srcdir)/test/cxxtest_mingw.h
@@ -21,6 +35,26 @@ ifdef HAVE_GCC3
 TEST_CFLAGS  +=  -Wno-format
 endif
 
+# Benchmarks use the same framework, but are only built and run by the
+# 'benchmark' target. Edit BENCHMARKS and BENCHMARK_LIBS to add more.
+BENCHMARKS      := $(srcdir)/test/benchmarks/*.h
+BENCHMARK_LIBS  := engines/advancedDetector.o engines/game.o engines/md5cache.o engines/savestate.o $(TEST_LIBS)
+BENCHMARK_FLAGS := $(TEST_FLAGS) --include=$(srcdir)/test/benchmark.h
+
+ifdef USE_SCALERS
+BENCHMARKS      += $(srcdir)/test/benchmarks/scalers/*.h
+endif
+
+ifdef ENABLE_WINTERMUTE
+BENCHMARKS      += $(srcdir)/test/benchmarks/wintermute/*.h
+BENCHMARK_LIBS  := engines/wintermute/graphics/transparent_surface.o $(BENCHMARK_LIBS)
+endif
+
+ifdef SDL_BACKEND
+BENCHMARKS      += $(srcdir)/test/benchmarks/sdl/*.h
+BENCHMARK_LIBS  := backends/graphics/surfacesdl/surfacesdl-scalerjobs.o $(BENCHMARK_LIBS)
+endif
+
 # Enable this to get an X11 GUI for the error reporter.
 #TEST_FLAGS   += --gui=X11Gui
 #TEST_LDFLAGS += -L/usr/X11R6/lib -lX11
@@ -34,9 +68,17 @@ test/runner.cpp: $(TESTS)
 	@mkdir -p test
 	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
 
+benchmark: test/benchrunner
+	./test/benchrunner
+test/benchrunner: test/benchrunner.cpp $(BENCHMARK_LIBS)
+	$(QUIET_LINK)$(CXX) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -o $@ $+ $(TEST_LDFLAGS)
+test/benchrunner.cpp: $(BENCHMARKS)
+	@mkdir -p test
+	$(srcdir)/test/cxxtest/cxxtestgen.py $(BENCHMARK_FLAGS) -o $@ $+
+
 
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner
+	-$(RM) test/runner.cpp test/runner test/benchrunner.cpp test/benchrunner
 
-.PHONY: test clean-test
+.PHONY: test benchmark clean-test
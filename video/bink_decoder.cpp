@@ -31,7 +31,7 @@
 #include "common/textconsole.h"
 #include "common/math.h"
 #include "common/stream.h"
-#include "common/substream.h"
+#include "common/memstream.h"
 #include "common/file.h"
 #include "common/str.h"
 #include "common/bitstream.h"
@@ -182,14 +182,12 @@ void BinkDecoder::readNextPacket() {
 		if (audioPacketLength >= 4) {
 			// Get our track - audio index plus one as the first track is video
 			BinkAudioTrack *audioTrack = (BinkAudioTrack *)getTrack(i + 1);
-			uint32 audioPacketStart = _bink->pos();
-			uint32 audioPacketEnd   = _bink->pos() + audioPacketLength;
+			uint32 audioPacketEnd = _bink->pos() + audioPacketLength;
 
 			//                  Number of samples in bytes
 			audio.sampleCount = _bink->readUint32LE() / (2 * audio.channels);
 
-			audio.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-					audioPacketStart + 4, audioPacketEnd), true);
+			audio.bits = new Common::BitStream32LELSB(readPacket(audioPacketLength - 4), true);
 
 			audioTrack->decodePacket();
 
@@ -202,11 +200,7 @@ void BinkDecoder::readNextPacket() {
 		}
 	}
 
-	uint32 videoPacketStart = _bink->pos();
-	uint32 videoPacketEnd   = _bink->pos() + frameSize;
-
-	frame.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-			videoPacketStart, videoPacketEnd), true);
+	frame.bits = new Common::BitStream32LELSB(readPacket(frameSize), true);
 
 	videoTrack->decodePacket(frame);
 
@@ -214,6 +208,15 @@ void BinkDecoder::readNextPacket() {
 	frame.bits = 0;
 }
 
+Common::MemoryReadStream *BinkDecoder::readPacket(uint32 size) {
+	// Read the whole packet, so that the bit stream can work directly on the memory
+	byte *data = (byte *)malloc(size);
+	if (_bink->read(data, size) != size)
+		error("Failed to read Bink packet");
+
+	return new Common::MemoryReadStream(data, size, DisposeAfterUse::YES);
+}
+
 BinkDecoder::VideoFrame::VideoFrame() : bits(0) {
 }
 
@@ -45,6 +45,7 @@ class QueuingAudioStream;
 
 namespace Common {
 class SeekableReadStream;
+class MemoryReadStream;
 class BitStream;
 class Huffman;
 
@@ -351,6 +352,9 @@ private:
 	Common::Array<VideoFrame> _frames;      ///< All video frames.
 
 	void initAudioTrack(AudioInfo &audio);
+
+	/** Read a packet of this size from the current position into memory. */
+	Common::MemoryReadStream *readPacket(uint32 size);
 };
 
 } // End of namespace Video